@@ -0,0 +1,174 @@
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "mem/mem.h"
+
+DOCA_LOG_REGISTER(BENCH_AGENT);
+
+using namespace doca;
+
+/*
+ * Receive, and echo in ping-pong mode, ops messages then acknowledge the phase
+ *
+ * @ch [in]: Connected data endpoint
+ * @c [in]: Case being run
+ * @ops [in]: Messages in the phase
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t serve_chan_phase(CommEndpoint &ch, const struct bench_case &c, uint32_t ops) {
+    struct cc_recv_lease lease;
+    doca_error_t result;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        result = ch.RecvBorrow(&lease);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive message: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        if (c.type == BENCH_CHAN_PINGPONG) {
+            result = ch.SendTo(lease.data, lease.len);
+            if (result != DOCA_SUCCESS) {
+                DOCA_LOG_ERR("Failed to echo message: %s", doca_get_error_string(result));
+                ch.Release(lease);
+                return result;
+            }
+        }
+
+        result = ch.Release(lease);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    return ch.SendSuccessfulMsg();
+}
+
+static void serve_chan_worker(const struct bench_config &cfg, const struct bench_case &c, uint32_t thread,
+                              doca_error_t *result) {
+    cc_ep_attr attr;
+
+    attr.send_queue_size = c.queue_depth;
+    attr.recv_queue_size = c.queue_depth;
+    attr.wait = (wait_policy)c.wait;
+
+    try {
+        CommChannel<Host> ch(cfg.cc_dev_pci_addr, attr);
+
+        *result = ch.ConnectRetry(bench_service_name(c, thread).c_str());
+        if (*result != DOCA_SUCCESS) return;
+        *result = ch.SendSuccessfulMsg();
+        if (*result != DOCA_SUCCESS) return;
+
+        if (c.warmup > 0) {
+            *result = serve_chan_phase(ch, c, c.warmup);
+            if (*result != DOCA_SUCCESS) return;
+        }
+        for (uint32_t trial = 0; trial < c.trials; trial++) {
+            *result = serve_chan_phase(ch, c, c.iterations);
+            if (*result != DOCA_SUCCESS) return;
+        }
+
+        ch.DisConnect();
+    } catch (const std::runtime_error &e) {
+        DOCA_LOG_ERR("Data endpoint %u: %s", thread, e.what());
+        *result = DOCA_ERROR_INITIALIZATION;
+    }
+}
+
+/*
+ * Host side of a Comm Channel case: one echo or sink thread per driver endpoint
+ *
+ * @cfg [in]: Program configuration
+ * @c [in]: Case being run
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t serve_chan(const struct bench_config &cfg, const struct bench_case &c) {
+    std::vector<doca_error_t> results(c.threads, DOCA_SUCCESS);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < c.threads; t++)
+        threads.emplace_back(serve_chan_worker, std::cref(cfg), std::cref(c), t, &results[t]);
+    for (auto &t : threads) t.join();
+
+    for (doca_error_t result : results)
+        if (result != DOCA_SUCCESS) return result;
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Host side of a DMA case: export one destination buffer per driver thread
+ *
+ * @ctrl [in]: Control endpoint
+ * @c [in]: Case being run
+ * @dmas [out]: Host DMA handles, kept until the driver is done
+ * @mmaps [out]: Exported buffers, kept until the driver is done
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t serve_dma(CommChannel<Host> &ctrl, const struct bench_case &c,
+                              std::vector<std::unique_ptr<DOCADma<Host>>> &dmas,
+                              std::vector<std::unique_ptr<MemMap>> &mmaps) {
+    doca_error_t result;
+
+    for (uint32_t t = 0; t < c.threads; t++) {
+        dmas.push_back(std::make_unique<DOCADma<Host>>());
+        mmaps.push_back(std::make_unique<MemMap>());
+        DOCADma<Host> &dma = *dmas.back();
+        MemMap &mmap = *mmaps.back();
+
+        result = dma.Init(mmap);
+        if (result != DOCA_SUCCESS) return result;
+        result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, c.size);
+        if (result != DOCA_SUCCESS) return result;
+        result = dma.ExportDesc(mmap, ctrl);
+        if (result != DOCA_SUCCESS) return result;
+        result = mmap.SendAddrAndOffset(ctrl);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t run_bench_agent(const struct bench_config &cfg) {
+    CommChannel<Host> ctrl(cfg.cc_dev_pci_addr);
+    struct bench_case c;
+    doca_error_t result;
+    size_t msg_len;
+
+    result = ctrl.ConnectRetry(BENCH_SERVICE_NAME);
+    if (result != DOCA_SUCCESS) return result;
+    result = ctrl.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    while (true) {
+        std::vector<std::unique_ptr<DOCADma<Host>>> dmas;
+        std::vector<std::unique_ptr<MemMap>> mmaps;
+
+        msg_len = sizeof(c);
+        result = ctrl.RecvFrom(&c, &msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive the next case: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (c.type == BENCH_DONE) break;
+
+        DOCA_LOG_INFO("Case %u: %s size %u depth %u threads %u wait %s", c.id, bench_type_name(c.type), c.size,
+                      c.queue_depth, c.threads, wait_policy_name(c.wait));
+        if (c.type == BENCH_CHAN_THROUGHPUT || c.type == BENCH_CHAN_PINGPONG)
+            result = serve_chan(cfg, c);
+        else
+            result = serve_dma(ctrl, c, dmas, mmaps);
+        if (result != DOCA_SUCCESS) return result;
+
+        /* Driver reports the end of the case, DMA buffers must stay valid until then */
+        result = ctrl.WaitForSuccessfulMsg();
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    return ctrl.SendSuccessfulMsg();
+}
@@ -0,0 +1,368 @@
+#include "bench_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+DOCA_LOG_REGISTER(BENCH_COMMON);
+
+#define CONFIG_LINE_SIZE 512 /* Longest config file line */
+
+static const char *bench_type_names[] = {"chan_throughput", "chan_pingpong", "dma_copy", "dma_async", "done"};
+
+const char *bench_type_name(uint32_t type) {
+    return type <= BENCH_DONE ? bench_type_names[type] : "unknown";
+}
+
+const char *wait_policy_name(uint32_t wait) { return wait == doca::WAIT_SLEEP ? "sleep" : "spin"; }
+
+std::string bench_service_name(const struct bench_case &c, uint32_t thread) {
+    return std::string(BENCH_SERVICE_NAME) + "_" + std::to_string(c.id) + "_t" + std::to_string(thread);
+}
+
+/*
+ * Copy a string parameter into a fixed size config field
+ *
+ * @dst [out]: Config field
+ * @src [in]: Parameter value
+ * @size [in]: Size of dst, terminator included
+ * @what [in]: Parameter description for the error message
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t copy_param(char *dst, const char *src, size_t size, const char *what) {
+    size_t len = strnlen(src, size);
+
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= size) {
+        DOCA_LOG_ERR("Entered %s exceeding the maximum size of %zu", what, size - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(dst, src, len + 1);
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct bench_config *cfg = (struct bench_config *)config;
+    return copy_param(cfg->cc_dev_pci_addr, (char *)param, DOCA_DEVINFO_PCI_ADDR_SIZE, "device PCI address");
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct bench_config *cfg = (struct bench_config *)config;
+    return copy_param(cfg->cc_dev_rep_pci_addr, (char *)param, DOCA_DEVINFO_REP_PCI_ADDR_SIZE,
+                      "device representor PCI address");
+}
+
+/*
+ * ARGP Callback - Handle side parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t mode_callback(void *param, void *config) {
+    struct bench_config *cfg = (struct bench_config *)config;
+    const char *mode = (char *)param;
+
+    if (strcmp(mode, "dpu") == 0)
+        cfg->mode = doca::DOCA_MODE_DPU;
+    else if (strcmp(mode, "host") == 0)
+        cfg->mode = doca::DOCA_MODE_HOST;
+    else {
+        DOCA_LOG_ERR("Unknown side %s, expected dpu or host", mode);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle config file parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t config_callback(void *param, void *config) {
+    struct bench_config *cfg = (struct bench_config *)config;
+    return copy_param(cfg->config_path, (char *)param, MAX_ARG_SIZE, "config path");
+}
+
+/*
+ * ARGP Callback - Handle result file parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct bench_config *cfg = (struct bench_config *)config;
+    return copy_param(cfg->output_path, (char *)param, MAX_ARG_SIZE, "output path");
+}
+
+using callback_func = doca_error_t (*)(void *, void *);
+
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_bench_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("m", "mode", "Side to run: dpu (default, drives the sweep) or host", mode_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("f", "config", "Sweep config file, needed only on DPU", config_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise", output_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+
+    return DOCA_SUCCESS;
+}
+
+/* Strip leading and trailing blanks in place */
+static char *trim(char *str) {
+    char *end;
+
+    while (*str == ' ' || *str == '\t') str++;
+    end = str + strlen(str);
+    while (end > str && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) end--;
+    *end = '\0';
+    return str;
+}
+
+/*
+ * Parse a comma separated list of positive integers
+ *
+ * @value [in]: List as written in the config file
+ * @list [out]: Parsed values
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t parse_uint_list(char *value, std::vector<uint32_t> *list) {
+    char *save, *item;
+
+    list->clear();
+    for (item = strtok_r(value, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        char *end;
+        unsigned long v;
+
+        item = trim(item);
+        v = strtoul(item, &end, 10);
+        if (end == item || *end != '\0' || v == 0 || v > UINT32_MAX) return DOCA_ERROR_INVALID_VALUE;
+        list->push_back(v);
+    }
+
+    return list->empty() ? DOCA_ERROR_INVALID_VALUE : DOCA_SUCCESS;
+}
+
+/*
+ * Apply one "key = value" line of the config file
+ *
+ * @key [in]: Key, trimmed
+ * @value [in]: Value, trimmed
+ * @cfg [in/out]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t apply_config(const char *key, char *value, struct bench_config *cfg) {
+    std::vector<uint32_t> list;
+    char *save, *item;
+
+    if (strcmp(key, "benchmarks") == 0) {
+        cfg->benchmarks.clear();
+        for (item = strtok_r(value, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+            uint32_t type;
+
+            item = trim(item);
+            for (type = 0; type < BENCH_DONE; type++)
+                if (strcmp(item, bench_type_names[type]) == 0) break;
+            if (type == BENCH_DONE) {
+                DOCA_LOG_ERR("Unknown benchmark %s", item);
+                return DOCA_ERROR_INVALID_VALUE;
+            }
+            cfg->benchmarks.push_back((enum bench_type)type);
+        }
+        return cfg->benchmarks.empty() ? DOCA_ERROR_INVALID_VALUE : DOCA_SUCCESS;
+    }
+
+    if (strcmp(key, "wait") == 0) {
+        cfg->waits.clear();
+        for (item = strtok_r(value, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+            item = trim(item);
+            if (strcmp(item, "spin") == 0)
+                cfg->waits.push_back(doca::WAIT_SPIN);
+            else if (strcmp(item, "sleep") == 0)
+                cfg->waits.push_back(doca::WAIT_SLEEP);
+            else {
+                DOCA_LOG_ERR("Unknown wait policy %s, expected spin or sleep", item);
+                return DOCA_ERROR_INVALID_VALUE;
+            }
+        }
+        return cfg->waits.empty() ? DOCA_ERROR_INVALID_VALUE : DOCA_SUCCESS;
+    }
+
+    if (strcmp(key, "perf") == 0) {
+        if (strcmp(value, "on") != 0 && strcmp(value, "off") != 0) {
+            DOCA_LOG_ERR("Invalid value for perf, expected on or off");
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        cfg->perf = strcmp(value, "on") == 0;
+        return DOCA_SUCCESS;
+    }
+
+    if (strcmp(key, "output") == 0) {
+        /* The command line wins over the config file */
+        if (cfg->output_path[0] != '\0') return DOCA_SUCCESS;
+        return copy_param(cfg->output_path, value, MAX_ARG_SIZE, "output path");
+    }
+
+    if (parse_uint_list(value, &list) != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Invalid value for %s, expected positive integers separated by commas", key);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (strcmp(key, "sizes") == 0)
+        cfg->sizes = list;
+    else if (strcmp(key, "queue_depths") == 0)
+        cfg->queue_depths = list;
+    else if (strcmp(key, "threads") == 0)
+        cfg->threads = list;
+    else if (strcmp(key, "warmup") == 0 || strcmp(key, "iterations") == 0 || strcmp(key, "trials") == 0) {
+        if (list.size() != 1) {
+            DOCA_LOG_ERR("%s takes a single value", key);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        if (key[0] == 'w')
+            cfg->warmup = list[0];
+        else if (key[0] == 'i')
+            cfg->iterations = list[0];
+        else
+            cfg->trials = list[0];
+    } else {
+        DOCA_LOG_ERR("Unknown config key %s", key);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t bench_load_config(const char *path, struct bench_config *cfg) {
+    char line[CONFIG_LINE_SIZE];
+    doca_error_t result;
+    int line_no = 0;
+    FILE *f;
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        DOCA_LOG_ERR("Failed to open config file %s: %s", path, strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *comment, *eq, *key;
+
+        line_no++;
+        comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        key = trim(line);
+        if (*key == '\0') continue;
+
+        eq = strchr(key, '=');
+        if (eq == NULL) {
+            DOCA_LOG_ERR("%s:%d: expected key = value", path, line_no);
+            fclose(f);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        *eq = '\0';
+
+        result = apply_config(trim(key), trim(eq + 1), cfg);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("%s:%d: invalid line", path, line_no);
+            fclose(f);
+            return result;
+        }
+    }
+    fclose(f);
+
+    if (cfg->benchmarks.empty()) {
+        DOCA_LOG_ERR("%s: no benchmarks configured", path);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+std::vector<bench_case> bench_cases(const struct bench_config &cfg) {
+    std::vector<bench_case> cases;
+    const std::vector<uint32_t> single_depth = {1};
+
+    for (enum bench_type type : cfg.benchmarks) {
+        const std::vector<uint32_t> &depths = type == BENCH_DMA_COPY ? single_depth : cfg.queue_depths;
+
+        for (uint32_t size : cfg.sizes)
+            for (uint32_t depth : depths)
+                for (uint32_t threads : cfg.threads)
+                    for (doca::wait_policy wait : cfg.waits) {
+                        struct bench_case c = {};
+
+                        c.id = cases.size();
+                        c.type = type;
+                        c.size = size;
+                        c.queue_depth = depth;
+                        c.threads = threads;
+                        c.wait = wait;
+                        c.warmup = cfg.warmup;
+                        c.iterations = cfg.iterations;
+                        c.trials = cfg.trials;
+                        cases.push_back(c);
+                    }
+    }
+
+    return cases;
+}
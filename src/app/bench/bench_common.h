@@ -0,0 +1,117 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "common.h"
+
+#define BENCH_SERVICE_NAME "doca_bench" /* Control endpoint, data endpoints append the case and thread */
+
+enum bench_type {
+    BENCH_CHAN_THROUGHPUT, /* DPU streams messages, host acknowledges every trial */
+    BENCH_CHAN_PINGPONG,   /* DPU sends, host echoes, DPU records the round trip */
+    BENCH_DMA_COPY,        /* Synchronous DmaCopy from DPU memory to the host, one job at a time */
+    BENCH_DMA_ASYNC,       /* Submit/Poll with queue_depth jobs in flight */
+    BENCH_DONE,            /* Sent to the host agent after the last case */
+};
+
+/* One point of the sweep, sent to the host agent over the control endpoint before it runs */
+struct bench_case {
+    uint32_t id;
+    uint32_t type;        /* enum bench_type */
+    uint32_t size;        /* Message or DMA job size in bytes */
+    uint32_t queue_depth; /* Endpoint queue size, or DMA jobs in flight */
+    uint32_t threads;     /* Parallel endpoints or DMA contexts */
+    uint32_t wait;        /* enum wait_policy */
+    uint32_t warmup;      /* Unmeasured operations per thread before the trials */
+    uint32_t iterations;  /* Measured operations per thread and trial */
+    uint32_t trials;
+};
+
+struct bench_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    doca::doca_app_mode mode = doca::DOCA_MODE_DPU;           /* DPU drives the sweep, host runs the agent */
+    char config_path[MAX_ARG_SIZE] = "";                      /* Sweep description, DPU only */
+    char output_path[MAX_ARG_SIZE] = "";                      /* Overrides the config file output */
+
+    /* Loaded from the config file */
+    std::vector<bench_type> benchmarks;
+    std::vector<uint32_t> sizes = {64};
+    std::vector<uint32_t> queue_depths = {CC_MAX_QUEUE_SIZE};
+    std::vector<uint32_t> threads = {1};
+    std::vector<doca::wait_policy> waits = {doca::WAIT_SPIN};
+    uint32_t warmup = 1000;
+    uint32_t iterations = 100000;
+    uint32_t trials = 5;
+    bool perf = false; /* CPU counters of the worker threads over the measured trials */
+};
+
+/*
+ * Register the command line parameters for doca_bench
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_bench_params(void);
+
+/*
+ * Load the sweep from a config file of "key = value" lines. '#' starts a
+ * comment, list values are comma separated:
+ *
+ *   benchmarks   = chan_throughput,chan_pingpong,dma_copy,dma_async
+ *   sizes        = 64,1024,4096
+ *   queue_depths = 10,64
+ *   threads      = 1,2,4
+ *   wait         = spin,sleep
+ *   warmup       = 1000
+ *   iterations   = 100000
+ *   trials       = 5
+ *   perf         = on
+ *   output       = results.json
+ *
+ * @path [in]: Config file
+ * @cfg [in/out]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bench_load_config(const char *path, struct bench_config *cfg);
+
+/*
+ * Cartesian product of the configured sweep, benchmarks outermost. Queue depth
+ * is not swept for dma_copy, which always has a single job in flight.
+ *
+ * @cfg [in]: Program configuration
+ * @return: list of cases to run, in order
+ */
+std::vector<bench_case> bench_cases(const struct bench_config &cfg);
+
+const char *bench_type_name(uint32_t type);
+const char *wait_policy_name(uint32_t wait);
+
+/*
+ * Service name of the data endpoint of one worker thread
+ *
+ * @c [in]: Case being run
+ * @thread [in]: Worker index
+ * @return: service name
+ */
+std::string bench_service_name(const struct bench_case &c, uint32_t thread);
+
+/*
+ * Drive the sweep on the DPU and write the results
+ *
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t run_bench_driver(const struct bench_config &cfg);
+
+/*
+ * Serve the host side of every case the driver sends until it is done
+ *
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t run_bench_agent(const struct bench_config &cfg);
@@ -0,0 +1,453 @@
+#include <doca_error.h>
+#include <doca_log.h>
+#include <time.h>
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "mem/mem.h"
+#include "stats/clock.h"
+#include "stats/histogram.h"
+#include "stats/perf_counters.h"
+#include "stats/report.h"
+#include "stats/summary.h"
+
+DOCA_LOG_REGISTER(BENCH_DRIVER);
+
+using namespace doca;
+
+#define SLEEP_IN_NANOS (10 * 1000) /* Poll interval of WAIT_SLEEP loops */
+
+/* State of one worker thread, kept for a whole case */
+struct bench_worker {
+    std::unique_ptr<CommChannel<Dpu>> ch;
+    std::unique_ptr<DOCADma<Dpu>> dma;
+    std::unique_ptr<MemMap> local;
+    std::unique_ptr<MemMap> remote;
+    std::vector<char> buf;
+    LatencyHistogram latency;
+    bool perf;            /* Count CPU events of measured phases */
+    perf_sample counters; /* Summed over measured phases */
+    uint64_t start_ns;
+    uint64_t end_ns;
+    doca_error_t result;
+};
+
+/*
+ * Send ops messages and wait for the host to acknowledge all of them
+ *
+ * @c [in]: Case being run
+ * @w [in]: Worker
+ * @ops [in]: Messages to send
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t chan_throughput_phase(const struct bench_case &c, struct bench_worker *w, uint32_t ops) {
+    doca_error_t result;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        result = w->ch->SendTo(w->buf.data(), c.size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send message: %s", doca_get_error_string(result));
+            return result;
+        }
+    }
+
+    return w->ch->WaitForSuccessfulMsg();
+}
+
+/*
+ * Send ops messages one at a time, waiting for each echo
+ *
+ * @c [in]: Case being run
+ * @w [in]: Worker
+ * @ops [in]: Round trips to run
+ * @measure [in]: Record round trip times
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t chan_pingpong_phase(const struct bench_case &c, struct bench_worker *w, uint32_t ops,
+                                        bool measure) {
+    doca_error_t result;
+    size_t msg_len;
+    uint64_t t0;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        t0 = NowNs();
+        result = w->ch->SendTo(w->buf.data(), c.size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send message: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        msg_len = w->buf.size();
+        result = w->ch->RecvFrom(w->buf.data(), &msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive echo: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (measure) w->latency.Record(NowNs() - t0);
+    }
+
+    return w->ch->WaitForSuccessfulMsg();
+}
+
+/*
+ * Run ops synchronous copies of the local buffer to the host
+ *
+ * @c [in]: Case being run
+ * @w [in]: Worker
+ * @ops [in]: Copies to run
+ * @measure [in]: Record job latencies
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dma_copy_phase(const struct bench_case &c, struct bench_worker *w, uint32_t ops, bool measure) {
+    doca_error_t result;
+    uint64_t t0;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        t0 = NowNs();
+        result = w->dma->DmaCopy(*w->local, *w->remote, c.size);
+        if (result != DOCA_SUCCESS) return result;
+        if (measure) w->latency.Record(NowNs() - t0);
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Run ops asynchronous copies of the local buffer to the host, keeping queue_depth jobs in flight
+ *
+ * @c [in]: Case being run
+ * @w [in]: Worker
+ * @ops [in]: Copies to run
+ * @measure [in]: Record job latencies, submission to completion
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dma_async_phase(const struct bench_case &c, struct bench_worker *w, uint32_t ops, bool measure) {
+    struct timespec ts = {
+        .tv_nsec = SLEEP_IN_NANOS,
+    };
+    std::vector<uint64_t> submit_ns(c.queue_depth);
+    std::vector<uint32_t> free_tags;
+    uint32_t submitted = 0, completed = 0;
+    doca_error_t result;
+    void *user_data;
+
+    for (uint32_t tag = 0; tag < c.queue_depth; tag++) free_tags.push_back(tag);
+
+    while (completed < ops) {
+        while (submitted < ops && !free_tags.empty()) {
+            uint32_t tag = free_tags.back();
+
+            submit_ns[tag] = NowNs();
+            result = w->dma->Submit(*w->local, 0, *w->remote, 0, c.size, (void *)(uintptr_t)tag);
+            if (result == DOCA_ERROR_AGAIN) break;
+            if (result != DOCA_SUCCESS) return result;
+            free_tags.pop_back();
+            submitted++;
+        }
+
+        result = w->dma->Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) {
+            if (c.wait == WAIT_SLEEP) nanosleep(&ts, NULL);
+            continue;
+        }
+        if (result != DOCA_SUCCESS) return result;
+
+        uint32_t tag = (uint32_t)(uintptr_t)user_data;
+        if (measure) w->latency.Record(NowNs() - submit_ns[tag]);
+        free_tags.push_back(tag);
+        completed++;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+static void run_worker(const struct bench_case &c, struct bench_worker *w, uint32_t ops, bool measure) {
+    /* Counters are per thread, and every phase runs on fresh threads */
+    PerfCounters perf;
+    perf_sample sample;
+
+    if (measure && w->perf) perf.Open();
+    w->start_ns = NowNs();
+    if (perf.IsOpen()) perf.Start();
+    switch (c.type) {
+        case BENCH_CHAN_THROUGHPUT:
+            w->result = chan_throughput_phase(c, w, ops);
+            break;
+        case BENCH_CHAN_PINGPONG:
+            w->result = chan_pingpong_phase(c, w, ops, measure);
+            break;
+        case BENCH_DMA_COPY:
+            w->result = dma_copy_phase(c, w, ops, measure);
+            break;
+        default:
+            w->result = dma_async_phase(c, w, ops, measure);
+            break;
+    }
+    if (perf.IsOpen() && perf.Stop(&sample) == DOCA_SUCCESS) w->counters.Merge(sample);
+    w->end_ns = NowNs();
+}
+
+/*
+ * Run one phase on every worker in parallel
+ *
+ * @c [in]: Case being run
+ * @workers [in]: Set up workers
+ * @ops [in]: Operations per worker
+ * @measure [in]: Record latencies
+ * @elapsed_ns [out]: From the first worker start to the last worker end
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_phase(const struct bench_case &c, std::vector<bench_worker> &workers, uint32_t ops,
+                              bool measure, uint64_t *elapsed_ns) {
+    std::vector<std::thread> threads;
+    uint64_t first = UINT64_MAX, last = 0;
+
+    for (auto &w : workers) threads.emplace_back(run_worker, std::cref(c), &w, ops, measure);
+    for (auto &t : threads) t.join();
+
+    for (auto &w : workers) {
+        if (w.result != DOCA_SUCCESS) return w.result;
+        first = std::min(first, w.start_ns);
+        last = std::max(last, w.end_ns);
+    }
+
+    *elapsed_ns = last - first;
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Bring up the data endpoints of a Comm Channel case. The host agent connects once it has the case.
+ *
+ * @ctrl [in]: Control endpoint
+ * @cfg [in]: Program configuration
+ * @c [in]: Case being run
+ * @workers [out]: One connected endpoint per thread
+ * @return: DOCA_SUCCESS on success, DOCA_ERROR_NOT_SUPPORTED if the case does not fit the device
+ */
+static doca_error_t setup_chan(CommChannel<Dpu> &ctrl, const struct bench_config &cfg, const struct bench_case &c,
+                               std::vector<bench_worker> &workers) {
+    doca_error_t result;
+    cc_ep_attr attr;
+
+    attr.send_queue_size = c.queue_depth;
+    attr.recv_queue_size = c.queue_depth;
+    attr.wait = (wait_policy)c.wait;
+
+    for (uint32_t t = 0; t < c.threads; t++) {
+        bench_worker &w = workers[t];
+
+        w.ch = std::make_unique<CommChannel<Dpu>>(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr, attr);
+        if (c.size > w.ch->MaxPayload() || w.ch->Attr().recv_queue_size != c.queue_depth) {
+            DOCA_LOG_WARN("Skipping case %u, %u byte messages at queue depth %u do not fit the device", c.id, c.size,
+                          c.queue_depth);
+            return DOCA_ERROR_NOT_SUPPORTED;
+        }
+        result = w.ch->Listen(bench_service_name(c, t).c_str());
+        if (result != DOCA_SUCCESS) return result;
+        w.buf.resize(w.ch->MaxPayload());
+    }
+
+    result = ctrl.SendTo(&c, sizeof(c));
+    if (result != DOCA_SUCCESS) return result;
+
+    for (auto &w : workers) {
+        result = w.ch->WaitForSuccessfulMsg();
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Set up one DMA context per thread, each copying to its own buffer exported by the host agent
+ *
+ * @ctrl [in]: Control endpoint
+ * @c [in]: Case being run
+ * @workers [out]: One started DMA context per thread
+ * @return: DOCA_SUCCESS on success, DOCA_ERROR_NOT_SUPPORTED if the case does not fit the device
+ */
+static doca_error_t setup_dma(CommChannel<Dpu> &ctrl, const struct bench_case &c, std::vector<bench_worker> &workers) {
+    doca_error_t result;
+
+    for (uint32_t t = 0; t < c.threads; t++) {
+        bench_worker &w = workers[t];
+
+        w.dma = std::make_unique<DOCADma<Dpu>>();
+        w.dma->SetWaitPolicy((wait_policy)c.wait);
+        if (c.size > w.dma->MaxBufSize() || c.queue_depth > WORKQ_DEPTH) {
+            DOCA_LOG_WARN("Skipping case %u, %u byte jobs at depth %u do not fit the device", c.id, c.size,
+                          c.queue_depth);
+            return DOCA_ERROR_NOT_SUPPORTED;
+        }
+
+        w.local = std::make_unique<MemMap>();
+        result = w.dma->Init(*w.local);
+        if (result != DOCA_SUCCESS) return result;
+        result = w.local->AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, c.size);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    result = ctrl.SendTo(&c, sizeof(c));
+    if (result != DOCA_SUCCESS) return result;
+
+    /* The host serves the case from here on, a failure can no longer be skipped */
+    try {
+        /* Host exports its buffers in thread order */
+        for (auto &w : workers) {
+            w.remote = std::make_unique<MemMap>(*w.dma, ctrl);
+            result = w.remote->RecvAddrAndOffset(ctrl);
+            if (result != DOCA_SUCCESS) return result;
+
+            result = w.dma->AddBuffer(*w.local);
+            if (result != DOCA_SUCCESS) return result;
+            result = w.dma->AddBuffer(*w.remote);
+            if (result != DOCA_SUCCESS) return result;
+        }
+    } catch (const std::runtime_error &e) {
+        DOCA_LOG_ERR("Failed to import the host buffers of case %u: %s", c.id, e.what());
+        return DOCA_ERROR_INITIALIZATION;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+static void teardown(std::vector<bench_worker> &workers) {
+    for (auto &w : workers) {
+        if (w.ch) w.ch->DisConnect();
+        if (w.dma && w.remote) {
+            w.dma->RmBuffer(*w.remote);
+            w.dma->RmBuffer(*w.local);
+            w.dma->Finalize();
+        }
+    }
+    workers.clear();
+}
+
+/*
+ * Run warmup and trials of one case and report them
+ *
+ * @ctrl [in]: Control endpoint
+ * @cfg [in]: Program configuration
+ * @c [in]: Case to run
+ * @report [in]: Result writer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_case(CommChannel<Dpu> &ctrl, const struct bench_config &cfg, const struct bench_case &c,
+                             ReportWriter &report) {
+    std::vector<bench_worker> workers(c.threads);
+    TrialSummary ops_per_sec, mb_per_sec;
+    LatencyHistogram latency;
+    perf_sample counters;
+    uint64_t total_ops = (uint64_t)c.iterations * c.threads * c.trials;
+    doca_error_t result;
+    uint64_t elapsed_ns;
+    bool is_chan = c.type == BENCH_CHAN_THROUGHPUT || c.type == BENCH_CHAN_PINGPONG;
+
+    try {
+        result = is_chan ? setup_chan(ctrl, cfg, c, workers) : setup_dma(ctrl, c, workers);
+    } catch (const std::runtime_error &e) {
+        DOCA_LOG_WARN("Skipping case %u: %s", c.id, e.what());
+        result = DOCA_ERROR_NOT_SUPPORTED;
+    }
+    /* Nothing reached the host yet for a skipped case */
+    if (result == DOCA_ERROR_NOT_SUPPORTED) {
+        teardown(workers);
+        return DOCA_SUCCESS;
+    }
+    if (result != DOCA_SUCCESS) goto done;
+
+    for (auto &w : workers) w.perf = cfg.perf;
+    if (c.warmup > 0) {
+        result = run_phase(c, workers, c.warmup, false, &elapsed_ns);
+        if (result != DOCA_SUCCESS) goto done;
+    }
+
+    for (uint32_t trial = 0; trial < c.trials; trial++) {
+        double ops;
+
+        result = run_phase(c, workers, c.iterations, true, &elapsed_ns);
+        if (result != DOCA_SUCCESS) goto done;
+
+        ops = elapsed_ns ? (double)c.iterations * c.threads * 1e9 / elapsed_ns : 0.0;
+        ops_per_sec.Add(ops);
+        mb_per_sec.Add(ops * c.size / 1e6);
+    }
+
+    for (auto &w : workers) {
+        latency.Merge(w.latency);
+        counters.Merge(w.counters);
+    }
+
+    DOCA_LOG_INFO("%s size %u depth %u threads %u wait %s: %.0f +- %.0f ops/s, %.1f MB/s, p50 %" PRIu64
+                  " ns, p99 %" PRIu64 " ns",
+                  bench_type_name(c.type), c.size, c.queue_depth, c.threads, wait_policy_name(c.wait),
+                  ops_per_sec.Mean(), ops_per_sec.Ci95(), mb_per_sec.Mean(), latency.Percentile(50.0),
+                  latency.Percentile(99.0));
+    if (cfg.perf) {
+        char line[256];
+        counters.Format(total_ops, line, sizeof(line));
+        DOCA_LOG_INFO("%s size %u: %s", bench_type_name(c.type), c.size, line);
+    }
+
+    if (report.IsOpen()) {
+        report.Add("benchmark", bench_type_name(c.type))
+            .Add("size", (uint64_t)c.size)
+            .Add("queue_depth", (uint64_t)c.queue_depth)
+            .Add("threads", (uint64_t)c.threads)
+            .Add("wait", wait_policy_name(c.wait))
+            .Add("iterations", (uint64_t)c.iterations)
+            .Add("trials", (uint64_t)c.trials)
+            .AddSummary("ops_", ops_per_sec)
+            .AddSummary("mbps_", mb_per_sec)
+            .AddHistogram("lat_", latency);
+        if (cfg.perf) report.AddPerf("cpu_", counters, total_ops);
+        result = report.EndRow();
+    }
+
+done:
+    teardown(workers);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Case %u failed: %s", c.id, doca_get_error_string(result));
+        return result;
+    }
+
+    /* Host keeps its side of the case up until this arrives */
+    return ctrl.SendSuccessfulMsg();
+}
+
+doca_error_t run_bench_driver(const struct bench_config &cfg) {
+    std::vector<bench_case> cases = bench_cases(cfg);
+    struct bench_case done = {};
+    ReportWriter report;
+    doca_error_t result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    CommChannel<Dpu> ctrl(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+    result = ctrl.Listen(BENCH_SERVICE_NAME);
+    if (result != DOCA_SUCCESS) return result;
+    result = ctrl.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    DOCA_LOG_INFO("Host agent connected, running %zu cases", cases.size());
+    for (const auto &c : cases) {
+        result = run_case(ctrl, cfg, c, report);
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    done.type = BENCH_DONE;
+    ctrl.SendTo(&done, sizeof(done));
+    if (result == DOCA_SUCCESS) result = ctrl.WaitForSuccessfulMsg();
+
+    report.Close();
+    return result;
+}
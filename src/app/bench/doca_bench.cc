@@ -0,0 +1,54 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "bench_common.h"
+
+DOCA_LOG_REGISTER(DOCA_BENCH::MAIN);
+
+int main(int argc, char *argv[]) {
+    struct bench_config cfg;
+    doca_error_t result;
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create standard log backend");
+        return result;
+    }
+
+    result = doca_argp_init("doca_bench", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = register_bench_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register doca_bench parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse sample input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    if (cfg.mode == doca::DOCA_MODE_DPU) {
+        if (cfg.config_path[0] == '\0') {
+            DOCA_LOG_ERR("The DPU side needs a sweep config file, pass it with --config");
+            doca_argp_destroy();
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        result = bench_load_config(cfg.config_path, &cfg);
+        if (result == DOCA_SUCCESS) result = run_bench_driver(cfg);
+    } else {
+        result = run_bench_agent(cfg);
+    }
+
+    doca_argp_destroy();
+
+    return result;
+}
@@ -15,6 +15,7 @@
 
 #include <doca_argp.h>
 #include <doca_log.h>
+#include <stdlib.h>
 #include <string.h>
 
 DOCA_LOG_REGISTER(CH_COMMON);
@@ -52,6 +53,109 @@ doca_error_t msg_size_callback(void *param, void *config) {
     return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle benchmark mode parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t mode_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    const char *mode = (char *)param;
+
+    if (strcmp(mode, "throughput") == 0)
+        cfg->bench_mode = CC_BENCH_THROUGHPUT;
+    else if (strcmp(mode, "pingpong") == 0)
+        cfg->bench_mode = CC_BENCH_PINGPONG;
+    else if (strcmp(mode, "oneway") == 0)
+        cfg->bench_mode = CC_BENCH_ONEWAY;
+    else {
+        DOCA_LOG_ERR("Unknown benchmark mode %s, expected throughput, pingpong or oneway", mode);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle measured iterations parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t iterations_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    int iterations = *(int *)param;
+
+    if (iterations <= 0) {
+        DOCA_LOG_ERR("Iterations must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->iterations = iterations;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle warmup iterations parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t warmup_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    int warmup = *(int *)param;
+
+    if (warmup < 0) {
+        DOCA_LOG_ERR("Warmup iterations must not be negative");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->warmup = warmup;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle message size sweep parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t sweep_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+
+    cfg->sweep = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
 /*
  * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
  *
@@ -78,10 +182,122 @@ static doca_error_t rep_pci_addr_callback(void *param, void *config) {
     return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle comma separated list of endpoint queue depths
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t queue_sizes_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    const char *str = (char *)param;
+    char *end;
+
+    cfg->queue_sizes.clear();
+    while (*str != '\0') {
+        unsigned long size = strtoul(str, &end, 10);
+        if (end == str || size == 0 || size > UINT16_MAX || (*end != ',' && *end != '\0')) {
+            DOCA_LOG_ERR("Invalid queue size list %s, expected positive integers separated by commas", (char *)param);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        cfg->queue_sizes.push_back(size);
+        str = *end == ',' ? end + 1 : end;
+    }
+
+    if (cfg->queue_sizes.empty()) {
+        DOCA_LOG_ERR("Queue size list is empty");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle flow control parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t flow_control_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+
+    cfg->flow_control = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle producer threads parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t threads_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    int threads = *(int *)param;
+
+    if (threads <= 0) {
+        DOCA_LOG_ERR("Threads must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->threads = threads;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle CPU performance counters parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t perf_callback(void *param, void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+
+    cfg->perf = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Validation - Check flags against each other once all are parsed
+ *
+ * @config [in]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t cc_validate(void *config) {
+    struct cc_config *cfg = (struct cc_config *)config;
+    size_t max_payload = CC_MAX_MSG_SIZE - (cfg->flow_control ? sizeof(doca::cc_fc_hdr) : 0);
+
+    /* The flow control header travels in the same message as the payload */
+    if (cfg->cc_msg_size == 0 || cfg->cc_msg_size > max_payload) {
+        DOCA_LOG_ERR("Message size must be between 1 and %zu bytes%s", max_payload,
+                     cfg->flow_control ? " with flow control" : "");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (!cfg->flow_control) return DOCA_SUCCESS;
+    for (uint16_t queue_size : cfg->queue_sizes) {
+        if (queue_size <= CC_FC_CTRL_SLOTS) {
+            DOCA_LOG_ERR("Queue size %u leaves no room for data, flow control needs more than %d slots", queue_size,
+                         CC_FC_CTRL_SLOTS);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+    }
+
+    return DOCA_SUCCESS;
+}
+
 doca_error_t register_cc_params(void) {
     doca_error_t result;
 
     struct doca_argp_param *dev_pci_addr_param, *rep_pci_addr_param, *msg_size_param;
+    struct doca_argp_param *mode_param, *iterations_param, *warmup_param, *sweep_param, *output_param;
+    struct doca_argp_param *queue_sizes_param, *flow_control_param, *threads_param, *perf_param;
 
     /* Create and register Comm Channel DOCA device PCI address */
     result = doca_argp_param_create(&dev_pci_addr_param);
@@ -135,5 +351,190 @@ doca_error_t register_cc_params(void) {
         return result;
     }
 
+    /* Create and register benchmark mode */
+    result = doca_argp_param_create(&mode_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(mode_param, "m");
+    doca_argp_param_set_long_name(mode_param, "mode");
+    doca_argp_param_set_description(mode_param, "Benchmark mode: throughput (default), pingpong or oneway");
+    doca_argp_param_set_callback(mode_param, mode_callback);
+    doca_argp_param_set_type(mode_param, DOCA_ARGP_TYPE_STRING);
+    result = doca_argp_register_param(mode_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register measured iterations */
+    result = doca_argp_param_create(&iterations_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(iterations_param, "n");
+    doca_argp_param_set_long_name(iterations_param, "iterations");
+    doca_argp_param_set_description(iterations_param, "Measured messages per message size");
+    doca_argp_param_set_callback(iterations_param, iterations_callback);
+    doca_argp_param_set_type(iterations_param, DOCA_ARGP_TYPE_INT);
+    result = doca_argp_register_param(iterations_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register warmup iterations */
+    result = doca_argp_param_create(&warmup_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(warmup_param, "w");
+    doca_argp_param_set_long_name(warmup_param, "warmup");
+    doca_argp_param_set_description(warmup_param, "Unmeasured warmup messages per message size");
+    doca_argp_param_set_callback(warmup_param, warmup_callback);
+    doca_argp_param_set_type(warmup_param, DOCA_ARGP_TYPE_INT);
+    result = doca_argp_register_param(warmup_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register message size sweep */
+    result = doca_argp_param_create(&sweep_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_long_name(sweep_param, "sweep");
+    doca_argp_param_set_description(sweep_param, "Sweep power of two message sizes from 8 bytes up to msg-size");
+    doca_argp_param_set_callback(sweep_param, sweep_callback);
+    doca_argp_param_set_type(sweep_param, DOCA_ARGP_TYPE_BOOLEAN);
+    result = doca_argp_register_param(sweep_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register result file path */
+    result = doca_argp_param_create(&output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(output_param, "o");
+    doca_argp_param_set_long_name(output_param, "output");
+    doca_argp_param_set_description(output_param,
+                                    "Result file of the measuring side, JSON if it ends in .json, CSV otherwise");
+    doca_argp_param_set_callback(output_param, output_callback);
+    doca_argp_param_set_type(output_param, DOCA_ARGP_TYPE_STRING);
+    result = doca_argp_register_param(output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register endpoint queue depths */
+    result = doca_argp_param_create(&queue_sizes_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(queue_sizes_param, "q");
+    doca_argp_param_set_long_name(queue_sizes_param, "queue-sizes");
+    doca_argp_param_set_description(queue_sizes_param,
+                                    "Comma separated endpoint send/receive queue depths, each run on a fresh endpoint");
+    doca_argp_param_set_callback(queue_sizes_param, queue_sizes_callback);
+    doca_argp_param_set_type(queue_sizes_param, DOCA_ARGP_TYPE_STRING);
+    result = doca_argp_register_param(queue_sizes_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register credit-based flow control */
+    result = doca_argp_param_create(&flow_control_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_long_name(flow_control_param, "flow-control");
+    doca_argp_param_set_description(flow_control_param, "Enable credit-based flow control (both sides)");
+    doca_argp_param_set_callback(flow_control_param, flow_control_callback);
+    doca_argp_param_set_type(flow_control_param, DOCA_ARGP_TYPE_BOOLEAN);
+    result = doca_argp_register_param(flow_control_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register producer threads */
+    result = doca_argp_param_create(&threads_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(threads_param, "t");
+    doca_argp_param_set_long_name(threads_param, "threads");
+    doca_argp_param_set_description(threads_param, "Max producer threads, scaled in powers of two (chan_mpsc only)");
+    doca_argp_param_set_callback(threads_param, threads_callback);
+    doca_argp_param_set_type(threads_param, DOCA_ARGP_TYPE_INT);
+    result = doca_argp_register_param(threads_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register CPU performance counters */
+    result = doca_argp_param_create(&perf_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_long_name(perf_param, "perf");
+    doca_argp_param_set_description(perf_param, "Report per-message CPU counters of the measured loop (server only)");
+    doca_argp_param_set_callback(perf_param, perf_callback);
+    doca_argp_param_set_type(perf_param, DOCA_ARGP_TYPE_BOOLEAN);
+    result = doca_argp_register_param(perf_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = doca_argp_register_validation_callback(cc_validate);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register validation callback: %s", doca_get_error_string(result));
+        return result;
+    }
+
     return DOCA_SUCCESS;
 }
+
+std::vector<size_t> cc_bench_sizes(const struct cc_config &cfg) {
+    std::vector<size_t> sizes;
+
+    if (!cfg.sweep) {
+        sizes.push_back(cfg.cc_msg_size);
+        return sizes;
+    }
+
+    for (size_t size = cfg.bench_mode == CC_BENCH_ONEWAY ? 32 : 8; size < cfg.cc_msg_size; size *= 2)
+        sizes.push_back(size);
+    sizes.push_back(cfg.cc_msg_size);
+    return sizes;
+}
+
+std::string cc_service_name(const struct cc_config &cfg, const char *base, uint16_t queue_size) {
+    if (cfg.queue_sizes.size() == 1) return base;
+    return std::string(base) + "_q" + std::to_string(queue_size);
+}
+
+std::vector<int> cc_thread_counts(const struct cc_config &cfg) {
+    std::vector<int> counts;
+
+    for (int threads = 1; threads < cfg.threads; threads *= 2) counts.push_back(threads);
+    counts.push_back(cfg.threads);
+    return counts;
+}
@@ -2,10 +2,37 @@
 
 #include <doca_dev.h>
 
+#include <string>
+#include <vector>
+
+#include "chan/comm_channel.h"
+
+enum cc_bench_mode {
+    CC_BENCH_THROUGHPUT, /* One-way sends, throughput computed on the sender */
+    CC_BENCH_PINGPONG,   /* Server sends, client echoes, server records per-message RTT */
+    CC_BENCH_ONEWAY,     /* Ping-pong with clocks synced, latency split into DPU->host and host->DPU */
+};
+
+/* Timestamps carried at the start of every one-way mode message */
+struct cc_oneway_hdr {
+    uint64_t dpu_send_ns;  /* DPU clock */
+    uint64_t host_recv_ns; /* Host clock */
+    uint64_t host_send_ns; /* Host clock */
+};
+
 struct cc_config {
     char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
     char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
-    size_t cc_msg_size = 1024;
+    size_t cc_msg_size = 1024;                                /* Message size, upper bound when sweeping */
+    enum cc_bench_mode bench_mode = CC_BENCH_THROUGHPUT;      /* Benchmark mode */
+    int iterations = 1000000;                                 /* Measured messages per message size */
+    int warmup = 1000;                                        /* Unmeasured messages per message size */
+    bool sweep = false;                                       /* Sweep message sizes up to cc_msg_size */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+    std::vector<uint16_t> queue_sizes = {CC_MAX_QUEUE_SIZE};  /* Endpoint queue depths, one endpoint each */
+    bool flow_control = false;                                /* Credit-based flow control on both endpoints */
+    int threads = 1;                                          /* Max producer threads, chan_mpsc only */
+    bool perf = false;                                        /* CPU counters around measured regions */
 };
 
 /*
@@ -14,3 +41,32 @@ struct cc_config {
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
 doca_error_t register_cc_params(void);
+
+/*
+ * Message sizes to run, in order. Without --sweep this is only cc_msg_size,
+ * otherwise powers of two starting at 8 bytes (32 in one-way mode, to fit
+ * the timestamps), capped by cc_msg_size.
+ *
+ * @cfg [in]: Program configuration
+ * @return: list of message sizes
+ */
+std::vector<size_t> cc_bench_sizes(const struct cc_config &cfg);
+
+/*
+ * Comm Channel service name for one endpoint of a queue depth sweep. Every depth
+ * gets its own name so the client cannot reach the previous server endpoint.
+ *
+ * @cfg [in]: Program configuration
+ * @base [in]: Service name without sweep suffix
+ * @queue_size [in]: Queue depth of the endpoint
+ * @return: service name
+ */
+std::string cc_service_name(const struct cc_config &cfg, const char *base, uint16_t queue_size);
+
+/*
+ * Producer thread counts to run: powers of two from 1, capped by threads.
+ *
+ * @cfg [in]: Program configuration
+ * @return: list of thread counts
+ */
+std::vector<int> cc_thread_counts(const struct cc_config &cfg);
@@ -1,24 +1,88 @@
 #include <doca_argp.h>
 
-
-
 #include "ch_common.h"
+#include "chan/clock_sync.h"
 #include "chan/comm_channel.h"
 #include "dev/device.h"
+#include "stats/clock.h"
 
 DOCA_LOG_REGISTER(CC_CLIENT::MAIN);
 
 const char *server_name = "doca_comm_ch_server";
-const int iteration = 1000000;
+
+/*
+ * Connect a fresh endpoint with the given queue depth and serve every message size on it
+ *
+ * @cfg [in]: Program configuration
+ * @queue_size [in]: Send and receive queue depth of the endpoint
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_endpoint(const struct cc_config &cfg, uint16_t queue_size) {
+    using namespace doca;
+    struct cc_oneway_hdr *hdr;
+    struct cc_recv_lease lease;
+    doca_error_t result;
+    cc_ep_attr attr;
+
+    attr.send_queue_size = queue_size;
+    attr.recv_queue_size = queue_size;
+    attr.flow_control = cfg.flow_control;
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr, attr);
+
+    /* The server brings up one endpoint per queue depth, it may not be listening yet */
+    std::string name = cc_service_name(cfg, server_name, queue_size);
+    result = ch.ConnectRetry(name.c_str());
+    if (result != DOCA_SUCCESS) return result;
+
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Server drives the size sweep, every phase has the same message count */
+    for (size_t phase = 0; phase < cc_bench_sizes(cfg).size(); phase++) {
+        if (cfg.bench_mode == CC_BENCH_ONEWAY) {
+            result = ClockSync::Serve(ch);
+            if (result != DOCA_SUCCESS) return result;
+        }
+
+        /* Messages are echoed straight out of the borrowed receive buffer, nothing is copied on the host */
+        for (int i = 0; i < cfg.warmup + cfg.iterations; i++) {
+            result = ch.RecvBorrow(&lease);
+            if (result != DOCA_SUCCESS) {
+                DOCA_LOG_ERR("Failed to receive message :%s", doca_get_error_string(result));
+                return result;
+            }
+
+            if (cfg.bench_mode == CC_BENCH_THROUGHPUT) {
+                result = ch.Release(lease);
+                if (result != DOCA_SUCCESS) return result;
+                continue;
+            }
+            if (cfg.bench_mode == CC_BENCH_ONEWAY) {
+                hdr = (struct cc_oneway_hdr *)lease.data;
+                hdr->host_recv_ns = NowNs();
+                hdr->host_send_ns = NowNs();
+            }
+            result = ch.SendTo(lease.data, lease.len);
+            if (result != DOCA_SUCCESS) {
+                DOCA_LOG_ERR("Failed to echo message :%s", doca_get_error_string(result));
+                ch.Release(lease);
+                return result;
+            }
+            result = ch.Release(lease);
+            if (result != DOCA_SUCCESS) return result;
+        }
+    }
+
+    result = ch.SendSuccessfulMsg();
+    ch.DisConnect();
+    return result;
+}
 
 int main(int argc, char *argv[]) {
     using namespace doca;
 
     doca_error_t result;
     struct cc_config cfg;
-    doca_app_mode mode = DOCA_MODE_HOST;
-    char *buf;
-    size_t msg_len;
 
     result = doca_log_create_standard_backend();
     if (result != DOCA_SUCCESS) {
@@ -46,32 +110,16 @@ int main(int argc, char *argv[]) {
         return result;
     }
 
-    CommChannel ch(mode, cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
-
-    result = ch.Connect(server_name);
-    if (result != DOCA_SUCCESS) {
-        goto argp_cleanup;
-    }
-    result = ch.SendSuccessfulMsg();
-    if (result != DOCA_SUCCESS) {
-        goto argp_cleanup;
-    }
-
-    buf = new char[cfg.cc_msg_size];
-    memset(buf, 42, cfg.cc_msg_size);
-
-    for (int i = 0; i < iteration; i++) {
-        msg_len = cfg.cc_msg_size;
-        result = ch.RecvFrom(buf, &msg_len);
-        if (result != DOCA_SUCCESS) {
-            DOCA_LOG_ERR("Failed to receive message :%s", doca_get_error_string(result));
+    for (uint16_t queue_size : cfg.queue_sizes) {
+        try {
+            result = run_endpoint(cfg, queue_size);
+        } catch (const std::exception &e) {
+            DOCA_LOG_ERR("Endpoint with queue size %u failed: %s", queue_size, e.what());
+            result = DOCA_ERROR_INITIALIZATION;
         }
+        if (result != DOCA_SUCCESS) break;
     }
 
-
-    ch.DisConnect();
-    delete buf;
-argp_cleanup:
     doca_argp_destroy();
 
     return result;
@@ -0,0 +1,172 @@
+#include <doca_argp.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "ch_common.h"
+#include "chan/comm_channel.h"
+#include "chan/send_ring.h"
+#include "stats/clock.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(CC_MPSC_CLIENT::MAIN);
+
+const char *server_name = "doca_comm_ch_mpsc_server";
+
+#define RING_CAPACITY 4096 /* Submission ring slots */
+#define DRAIN_BATCH 64     /* Messages sent per Drain call */
+
+/*
+ * Send count messages through the ring from nthreads producers while the calling thread drains it, and report
+ * the end to end message rate once the server acknowledged every message
+ *
+ * @ch [in]: Connected Comm Channel
+ * @ring [in]: Submission ring in front of ch
+ * @buf [in]: Message buffer
+ * @cfg [in]: Program configuration
+ * @nthreads [in]: Producer threads
+ * @report [in]: Result writer, rows are only written if it is open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_producers(doca::CommEndpoint &ch, doca::SendRing &ring, const char *buf,
+                                  const struct cc_config &cfg, int nthreads, doca::ReportWriter &report) {
+    std::atomic<bool> go(false), stop(false);
+    std::atomic<doca_error_t> enqueue_error(DOCA_SUCCESS);
+    std::atomic<uint64_t> full_retries(0);
+    std::vector<std::thread> producers;
+    doca_error_t result = DOCA_SUCCESS;
+    uint64_t total = cfg.warmup + cfg.iterations, drained = 0, start = 0, duration;
+    size_t sent;
+
+    for (int t = 0; t < nthreads; t++) {
+        /* Thread 0 also sends the warmup and the remainder of the split */
+        uint64_t count = cfg.iterations / nthreads + (t == 0 ? cfg.iterations % nthreads + cfg.warmup : 0);
+        producers.emplace_back([&, count]() {
+            doca_error_t err = DOCA_SUCCESS;
+            uint64_t retries = 0;
+            while (!go.load(std::memory_order_acquire))
+                ;
+            for (uint64_t i = 0; i < count && err == DOCA_SUCCESS; i++) {
+                /* A full ring only drains while the main thread is still running */
+                while ((err = ring.Enqueue(buf, cfg.cc_msg_size)) == DOCA_ERROR_AGAIN &&
+                       !stop.load(std::memory_order_relaxed))
+                    retries++;
+            }
+            if (err != DOCA_SUCCESS && err != DOCA_ERROR_AGAIN) {
+                DOCA_LOG_ERR("Failed to enqueue message: %s", doca_get_error_string(err));
+                enqueue_error.store(err, std::memory_order_relaxed);
+                stop.store(true, std::memory_order_relaxed);
+            }
+            full_retries.fetch_add(retries, std::memory_order_relaxed);
+        });
+    }
+
+    go.store(true, std::memory_order_release);
+    while (drained < total && !stop.load(std::memory_order_relaxed)) {
+        if (drained >= (uint64_t)cfg.warmup && start == 0) start = doca::NowNs();
+        result = ring.Drain(DRAIN_BATCH, &sent);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to drain the send ring: %s", doca_get_error_string(result));
+            stop.store(true, std::memory_order_relaxed);
+            break;
+        }
+        drained += sent;
+    }
+
+    for (auto &producer : producers) producer.join();
+    if (result != DOCA_SUCCESS) return result;
+    /* Producers stop on their first failed enqueue, the ring can no longer reach total */
+    result = enqueue_error.load(std::memory_order_relaxed);
+    if (result != DOCA_SUCCESS) return result;
+
+    /* The server acks after it received every message of this round */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+    duration = doca::NowNs() - start;
+
+    double mmsgs = (double)cfg.iterations * 1000.0 / duration;
+    DOCA_LOG_INFO("%d producers: %.3f Mmsg/s, %.1f MB/s, %" PRIu64 " full ring retries", nthreads, mmsgs,
+                  mmsgs * cfg.cc_msg_size, full_retries.load());
+
+    if (report.IsOpen()) {
+        report.Add("producers", (uint64_t)nthreads)
+            .Add("msg_size", (uint64_t)cfg.cc_msg_size)
+            .Add("messages", (uint64_t)cfg.iterations)
+            .Add("mmsg_per_sec", mmsgs)
+            .Add("mb_per_sec", mmsgs * cfg.cc_msg_size)
+            .Add("ring_full_retries", full_retries.load());
+        return report.EndRow();
+    }
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+
+    doca_error_t result;
+    struct cc_config cfg;
+    ReportWriter report;
+    cc_ep_attr attr;
+    char *buf;
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create standard log backend");
+        return result;
+    }
+
+    result = doca_argp_init("doca_comm_ch_mpsc_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = register_cc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register Comm Channel client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse sample input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) {
+            doca_argp_destroy();
+            return result;
+        }
+    }
+
+    attr.send_queue_size = cfg.queue_sizes.front();
+    attr.recv_queue_size = cfg.queue_sizes.front();
+    attr.flow_control = cfg.flow_control;
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr, attr);
+    SendRing ring(ch, RING_CAPACITY, cfg.cc_msg_size);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    buf = new char[cfg.cc_msg_size];
+    memset(buf, 42, cfg.cc_msg_size);
+
+    for (int nthreads : cc_thread_counts(cfg)) {
+        result = run_producers(ch, ring, buf, cfg, nthreads, report);
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    ch.DisConnect();
+    delete[] buf;
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
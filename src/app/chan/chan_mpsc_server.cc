@@ -0,0 +1,78 @@
+#include <doca_argp.h>
+
+#include "ch_common.h"
+#include "chan/comm_channel.h"
+
+DOCA_LOG_REGISTER(CC_MPSC_SERVER::MAIN);
+
+const char *server_name = "doca_comm_ch_mpsc_server";
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+
+    doca_error_t result;
+    struct cc_config cfg;
+    cc_ep_attr attr;
+    char *buf;
+    size_t msg_len;
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create standard log backend");
+        return result;
+    }
+
+    result = doca_argp_init("doca_comm_ch_mpsc_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = register_cc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register Comm Channel server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse sample input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    attr.send_queue_size = cfg.queue_sizes.front();
+    attr.recv_queue_size = cfg.queue_sizes.front();
+    attr.flow_control = cfg.flow_control;
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr, attr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    buf = new char[cfg.cc_msg_size];
+
+    /* One round per producer count, acked once all of its messages arrived */
+    for (size_t round = 0; round < cc_thread_counts(cfg).size(); round++) {
+        for (int i = 0; i < cfg.warmup + cfg.iterations; i++) {
+            msg_len = cfg.cc_msg_size;
+            result = ch.RecvFrom(buf, &msg_len);
+            if (result != DOCA_SUCCESS) {
+                DOCA_LOG_ERR("Failed to receive message: %s", doca_get_error_string(result));
+                goto buf_cleanup;
+            }
+        }
+
+        result = ch.SendSuccessfulMsg();
+        if (result != DOCA_SUCCESS) goto buf_cleanup;
+    }
+
+buf_cleanup:
+    delete[] buf;
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
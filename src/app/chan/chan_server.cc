@@ -1,24 +1,274 @@
 #include "chan/comm_channel.h"
 #include <doca_argp.h>
 
-#include <chrono>
-
 #include "ch_common.h"
+#include "chan/clock_sync.h"
+#include "stats/clock.h"
+#include "stats/histogram.h"
+#include "stats/perf_counters.h"
+#include "stats/report.h"
 
 DOCA_LOG_REGISTER(CC_SERVER::MAIN);
 
 const char *server_name = "doca_comm_ch_server";
-const int iteration = 1000000;
+
+/*
+ * Log the per-message CPU counters of a measured loop
+ *
+ * @perf [in]: Counters of the loop, NULL if disabled
+ * @msg_size [in]: Message size
+ * @cfg [in]: Program configuration
+ * @sample [in]: Counter deltas of the loop
+ */
+static void log_perf(doca::PerfCounters *perf, size_t msg_size, const struct cc_config &cfg,
+                     const doca::perf_sample &sample) {
+    char line[256];
+
+    if (perf == NULL) return;
+    sample.Format(cfg.iterations, line, sizeof(line));
+    DOCA_LOG_INFO("Size %zu: %s", msg_size, line);
+}
+
+/*
+ * Send warmup + iterations messages of msg_size and report the send throughput
+ *
+ * @ch [in]: Connected Comm Channel
+ * @buf [in]: Message buffer, at least msg_size long
+ * @msg_size [in]: Message size
+ * @cfg [in]: Program configuration
+ * @perf [in]: CPU counters of the measured messages, NULL if disabled
+ * @report [in]: Result writer, rows are only written if it is open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_throughput(doca::CommEndpoint &ch, char *buf, size_t msg_size, const struct cc_config &cfg,
+                                   doca::PerfCounters *perf, doca::ReportWriter &report) {
+    doca::perf_sample counters;
+    doca_error_t result;
+    uint64_t start = 0, duration;
+
+    for (int i = 0; i < cfg.warmup + cfg.iterations; i++) {
+        if (i == cfg.warmup) {
+            if (perf) perf->Start();
+            start = doca::NowNs();
+        }
+        result = ch.SendTo(buf, msg_size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send message: %s", doca_get_error_string(result));
+            return result;
+        }
+    }
+    duration = doca::NowNs() - start;
+    if (perf) perf->Stop(&counters);
+
+    /* bytes per microsecond == MB/s */
+    double mbps = static_cast<double>(msg_size * cfg.iterations) * 1000.0 / duration;
+    DOCA_LOG_INFO("Size %zu: throughput %f MB/s", msg_size, mbps);
+    log_perf(perf, msg_size, cfg, counters);
+
+    if (report.IsOpen()) {
+        report.Add("mode", "throughput")
+            .Add("queue_size", (uint64_t)ch.Attr().recv_queue_size)
+            .Add("flow_control", ch.Attr().flow_control ? "on" : "off")
+            .Add("msg_size", (uint64_t)msg_size)
+            .Add("iterations", (uint64_t)cfg.iterations)
+            .Add("mb_per_sec", mbps);
+        if (perf) report.AddPerf("", counters, cfg.iterations);
+        return report.EndRow();
+    }
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Ping-pong warmup + iterations messages of msg_size with the client and record the RTT of each measured one
+ *
+ * @ch [in]: Connected Comm Channel
+ * @buf [in]: Message buffer, at least msg_size long
+ * @msg_size [in]: Message size
+ * @cfg [in]: Program configuration
+ * @perf [in]: CPU counters of the measured round trips, NULL if disabled
+ * @report [in]: Result writer, rows are only written if it is open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_pingpong(doca::CommEndpoint &ch, char *buf, size_t msg_size, const struct cc_config &cfg,
+                                 doca::PerfCounters *perf, doca::ReportWriter &report) {
+    doca::LatencyHistogram rtt;
+    doca::perf_sample counters;
+    doca_error_t result;
+    uint64_t start;
+    size_t msg_len;
+
+    for (int i = 0; i < cfg.warmup + cfg.iterations; i++) {
+        if (i == cfg.warmup && perf) perf->Start();
+        start = doca::NowNs();
+        result = ch.SendTo(buf, msg_size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send ping: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        msg_len = msg_size;
+        result = ch.RecvFrom(buf, &msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive pong: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (i >= cfg.warmup) rtt.Record(doca::NowNs() - start);
+    }
+    if (perf) perf->Stop(&counters);
+
+    DOCA_LOG_INFO("Size %zu: RTT p50 %" PRIu64 " ns, p99 %" PRIu64 " ns, p99.9 %" PRIu64 " ns, max %" PRIu64 " ns",
+                  msg_size, rtt.Percentile(50.0), rtt.Percentile(99.0), rtt.Percentile(99.9), rtt.Max());
+    log_perf(perf, msg_size, cfg, counters);
+
+    if (report.IsOpen()) {
+        report.Add("mode", "pingpong")
+            .Add("queue_size", (uint64_t)ch.Attr().recv_queue_size)
+            .Add("flow_control", ch.Attr().flow_control ? "on" : "off")
+            .Add("msg_size", (uint64_t)msg_size)
+            .AddHistogram("rtt_", rtt);
+        if (perf) report.AddPerf("", counters, cfg.iterations);
+        return report.EndRow();
+    }
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Sync clocks with the client, then ping-pong timestamped messages and split every measured round trip into
+ * its DPU->host and host->DPU legs in the DPU timebase
+ *
+ * @ch [in]: Connected Comm Channel
+ * @sync [in]: Clock estimate, refreshed before every message size so drift is tracked over the sweep
+ * @buf [in]: Message buffer, at least msg_size long
+ * @msg_size [in]: Message size, at least sizeof(struct cc_oneway_hdr)
+ * @cfg [in]: Program configuration
+ * @perf [in]: CPU counters of the measured round trips, NULL if disabled
+ * @report [in]: Result writer, rows are only written if it is open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_oneway(doca::CommEndpoint &ch, doca::ClockSync &sync, char *buf, size_t msg_size,
+                               const struct cc_config &cfg, doca::PerfCounters *perf, doca::ReportWriter &report) {
+    doca::LatencyHistogram rtt, to_host, to_dpu;
+    doca::perf_sample counters;
+    struct cc_oneway_hdr *hdr = (struct cc_oneway_hdr *)buf;
+    doca_error_t result;
+    uint64_t start, end;
+    int64_t leg;
+    size_t msg_len;
+
+    if (msg_size < sizeof(*hdr)) {
+        DOCA_LOG_ERR("One-way mode needs messages of at least %zu bytes", sizeof(*hdr));
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    result = sync.Sync(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    for (int i = 0; i < cfg.warmup + cfg.iterations; i++) {
+        if (i == cfg.warmup && perf) perf->Start();
+        start = doca::NowNs();
+        hdr->dpu_send_ns = start;
+        result = ch.SendTo(buf, msg_size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send ping: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        msg_len = msg_size;
+        result = ch.RecvFrom(buf, &msg_len);
+        end = doca::NowNs();
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive pong: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (i < cfg.warmup) continue;
+
+        /* Legs can come out slightly negative when they are shorter than the sync error */
+        rtt.Record(end - start);
+        leg = (int64_t)(sync.FromPeer(hdr->host_recv_ns) - start);
+        to_host.Record(leg > 0 ? leg : 0);
+        leg = (int64_t)(end - sync.FromPeer(hdr->host_send_ns));
+        to_dpu.Record(leg > 0 ? leg : 0);
+    }
+    if (perf) perf->Stop(&counters);
+
+    DOCA_LOG_INFO("Size %zu: DPU->host p50 %" PRIu64 " ns, p99 %" PRIu64 " ns; host->DPU p50 %" PRIu64
+                  " ns, p99 %" PRIu64 " ns; sync error <= %" PRIu64 " ns",
+                  msg_size, to_host.Percentile(50.0), to_host.Percentile(99.0), to_dpu.Percentile(50.0),
+                  to_dpu.Percentile(99.0), sync.LastRtt() / 2);
+    log_perf(perf, msg_size, cfg, counters);
+
+    if (report.IsOpen()) {
+        report.Add("mode", "oneway")
+            .Add("queue_size", (uint64_t)ch.Attr().recv_queue_size)
+            .Add("flow_control", ch.Attr().flow_control ? "on" : "off")
+            .Add("msg_size", (uint64_t)msg_size)
+            .Add("sync_error_ns", sync.LastRtt() / 2)
+            .Add("drift_ppm", sync.DriftPpm())
+            .AddHistogram("rtt_", rtt)
+            .AddHistogram("d2h_", to_host)
+            .AddHistogram("h2d_", to_dpu);
+        if (perf) report.AddPerf("", counters, cfg.iterations);
+        return report.EndRow();
+    }
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Listen on a fresh endpoint with the given queue depth and run every message size on it
+ *
+ * @cfg [in]: Program configuration
+ * @queue_size [in]: Send and receive queue depth of the endpoint
+ * @buf [in]: Message buffer, cc_msg_size long
+ * @perf [in]: Opened CPU counters, NULL if disabled
+ * @report [in]: Result writer, rows are only written if it is open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_endpoint(const struct cc_config &cfg, uint16_t queue_size, char *buf,
+                                 doca::PerfCounters *perf, doca::ReportWriter &report) {
+    using namespace doca;
+    doca_error_t result;
+    cc_ep_attr attr;
+    ClockSync sync;
+
+    attr.send_queue_size = queue_size;
+    attr.recv_queue_size = queue_size;
+    attr.flow_control = cfg.flow_control;
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr, attr);
+
+    /* The device profile may cap messages below what the flags allowed */
+    if (cfg.cc_msg_size > ch.MaxPayload()) {
+        DOCA_LOG_ERR("Message size %zu exceeds the endpoint's %zu byte payload", cfg.cc_msg_size, ch.MaxPayload());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    result = ch.Listen(cc_service_name(cfg, server_name, queue_size).c_str());
+    if (result != DOCA_SUCCESS) return result;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    DOCA_LOG_INFO("Queue size %u, flow control %s", queue_size, cfg.flow_control ? "on" : "off");
+    for (size_t msg_size : cc_bench_sizes(cfg)) {
+        if (cfg.bench_mode == CC_BENCH_PINGPONG)
+            result = run_pingpong(ch, buf, msg_size, cfg, perf, report);
+        else if (cfg.bench_mode == CC_BENCH_ONEWAY)
+            result = run_oneway(ch, sync, buf, msg_size, cfg, perf, report);
+        else
+            result = run_throughput(ch, buf, msg_size, cfg, perf, report);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    /* Client acks once it has consumed every message */
+    return ch.WaitForSuccessfulMsg();
+}
 
 int main(int argc, char *argv[]) {
     using namespace doca;
-    using namespace std::chrono;
 
     doca_error_t result;
     struct cc_config cfg;
-    doca_app_mode mode = DOCA_MODE_DPU;
     char *buf;
-    int64_t duration;
+    ReportWriter report;
+    PerfCounters perf;
 
     result = doca_log_create_standard_backend();
     if (result != DOCA_SUCCESS) {
@@ -46,42 +296,32 @@ int main(int argc, char *argv[]) {
         return result;
     }
 
-    CommChannel ch(mode, cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
-
-    result = ch.Listen(server_name);
-    if (result != DOCA_SUCCESS) {
-        doca_argp_destroy();
-        return result;
-    }
-    result = ch.WaitForSuccessfulMsg();
-    if (result != DOCA_SUCCESS) {
-        doca_argp_destroy();
-        return result;
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) {
+            doca_argp_destroy();
+            return result;
+        }
     }
 
+    /* Without any counter the benchmark still runs, only the counter columns are dropped */
+    if (cfg.perf) perf.Open();
+
     buf = new char[cfg.cc_msg_size];
     memset(buf, 0, cfg.cc_msg_size);
 
-    auto start = high_resolution_clock::now();
-    decltype(start) end;
-
-    for (int i = 0; i < iteration; i++) {
-        result = ch.SendTo(buf, cfg.cc_msg_size);
-        if (result != DOCA_SUCCESS) {
-            DOCA_LOG_ERR("Failed to send message: %s", doca_get_error_string(result));
-            goto argp_cleanup;
+    for (uint16_t queue_size : cfg.queue_sizes) {
+        try {
+            result = run_endpoint(cfg, queue_size, buf, perf.IsOpen() ? &perf : NULL, report);
+        } catch (const std::exception &e) {
+            DOCA_LOG_ERR("Endpoint with queue size %u failed: %s", queue_size, e.what());
+            result = DOCA_ERROR_INITIALIZATION;
         }
+        if (result != DOCA_SUCCESS) break;
     }
 
-    end = high_resolution_clock::now();
-    duration = duration_cast<microseconds>(end - start).count();
-    DOCA_LOG_INFO("Throughput: %f MB/s", static_cast<double>(cfg.cc_msg_size * iteration) / duration);
-
-
-
-    delete buf;
-argp_cleanup:
+    delete[] buf;
     doca_argp_destroy();
-    
+
     return result;
-}
\ No newline at end of file
+}
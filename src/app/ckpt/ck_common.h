@@ -0,0 +1,31 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include "chan/comm_channel.h"
+#include "ckpt/checkpoint.h"
+
+struct ck_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    size_t region_size = 256UL << 20;                         /* Host region to checkpoint */
+    char file_path[MAX_ARG_SIZE] = "/tmp/doca_ckpt.img";      /* DPU-local checkpoint file */
+    doca::ckpt_attr ckpt;                                     /* Chunking, buffer ring and file I/O mode */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/*
+ * Value of the 64-bit word at a byte offset of the region. The host fills the
+ * region with it, wipes it after the checkpoint and checks it after the restore.
+ */
+static inline uint64_t ck_word(size_t offset) {
+    return (uint64_t)offset * 0x9e3779b97f4a7c15ULL + 1;
+}
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_ck_params(void);
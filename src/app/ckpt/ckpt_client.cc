@@ -0,0 +1,107 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include "chan/comm_channel.h"
+#include "ck_common.h"
+#include "dma/dma.h"
+
+DOCA_LOG_REGISTER(CK_CLIENT::MAIN);
+
+const char *server_name = "doca_ckpt_server";
+
+/*
+ * Export the region for the DPU to checkpoint, wipe it, and check the DPU restored it
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_region(doca::CommChannel<doca::Host> &ch, const struct ck_config &cfg) {
+    using namespace doca;
+    doca_error_t result;
+    uint64_t *words;
+    size_t nb_words = cfg.region_size / sizeof(uint64_t), bad = 0;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, cfg.region_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    words = (uint64_t *)mmap.Data();
+    for (size_t i = 0; i < nb_words; i++) words[i] = ck_word(i * sizeof(uint64_t));
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Checkpoint saved */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    memset(mmap.Data(), 0, mmap.Len());
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Checkpoint restored */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    for (size_t i = 0; i < nb_words; i++)
+        if (words[i] != ck_word(i * sizeof(uint64_t))) bad++;
+    if (bad > 0) {
+        DOCA_LOG_ERR("Region differs after the restore: %zu of %zu words", bad, nb_words);
+        return DOCA_ERROR_IO_FAILED;
+    }
+    DOCA_LOG_INFO("Region of %zu bytes restored intact from the DPU checkpoint", cfg.region_size);
+
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct ck_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_ckpt_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_ck_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register checkpoint client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    result = run_region(ch, cfg);
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
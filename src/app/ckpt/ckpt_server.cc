@@ -0,0 +1,148 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "chan/comm_channel.h"
+#include "ck_common.h"
+#include "dma/dma.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(CK_SERVER::MAIN);
+
+const char *server_name = "doca_ckpt_server";
+
+/*
+ * Log the stage throughputs of a save or restore and append them to the report if it is open
+ *
+ * @report [in]: Result writer
+ * @cfg [in]: Program configuration
+ * @phase [in]: save or restore
+ * @stats [in]: Checkpoint counters of the phase
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t report_phase(doca::ReportWriter &report, const struct ck_config &cfg, const char *phase,
+                                 const doca::ckpt_stats &stats) {
+    DOCA_LOG_INFO("%s: %.1f MB in %.1f ms, %.0f MB/s end to end; stages: DMA %.0f MB/s, CRC32C %.0f MB/s, "
+                  "file %.0f MB/s (%s)",
+                  phase, stats.bytes / 1e6, stats.total_ns / 1e6, stats.Throughput(), stats.Throughput(stats.dma_ns),
+                  stats.Throughput(stats.crc_ns), stats.Throughput(stats.io_ns),
+                  stats.direct_io ? "O_DIRECT" : "buffered");
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("phase", phase)
+        .Add("bytes", stats.bytes)
+        .Add("chunk_size", (uint64_t)cfg.ckpt.chunk_size)
+        .Add("buffers", (uint64_t)cfg.ckpt.nb_buffers)
+        .Add("direct_io", (uint64_t)stats.direct_io)
+        .Add("total_ns", stats.total_ns)
+        .Add("mb_per_sec", stats.Throughput())
+        .Add("dma_mb_per_sec", stats.Throughput(stats.dma_ns))
+        .Add("crc_mb_per_sec", stats.Throughput(stats.crc_ns))
+        .Add("io_mb_per_sec", stats.Throughput(stats.io_ns));
+    return report.EndRow();
+}
+
+/*
+ * Checkpoint the host region to the local file, then restore it once the host wiped it
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_checkpoint(doca::CommChannel<doca::Dpu> &ch, const struct ck_config &cfg) {
+    using namespace doca;
+    ReportWriter report;
+    ckpt_stats stats;
+    doca_error_t result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    /* The checkpoint buffers are the engine's only local memory */
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    Checkpointer ckpt(dma, remote_mmap, cfg.ckpt);
+
+    result = ckpt.Save(cfg.file_path);
+    if (result != DOCA_SUCCESS) return result;
+    ckpt.Snapshot(&stats);
+    result = report_phase(report, cfg, "save", stats);
+    if (result != DOCA_SUCCESS) return result;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Host region wiped */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = ckpt.Restore(cfg.file_path);
+    if (result != DOCA_SUCCESS) return result;
+    ckpt.Snapshot(&stats);
+    result = report_phase(report, cfg, "restore", stats);
+    if (result != DOCA_SUCCESS) return result;
+
+    dma.Finalize();
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct ck_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_ckpt_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_ck_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register checkpoint server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_checkpoint(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Checkpoint run failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,257 @@
+#include "co_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <stdlib.h>
+#include <string.h>
+
+DOCA_LOG_REGISTER(CO_COMMON);
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    const char *dev_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(dev_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_pci_addr, dev_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    const char *rep_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(rep_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device representor PCI address exceeding the maximum size of %d",
+                     DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_rep_pci_addr, rep_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle copy sizes parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t sizes_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    char list[MAX_ARG_SIZE];
+    char *save, *item, *end;
+    unsigned long value;
+
+    strncpy(list, (char *)param, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+
+    cfg->sizes.clear();
+    for (item = strtok_r(list, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        value = strtoul(item, &end, 10);
+        if (end == item || *end != '\0' || value == 0 || value > (1UL << 22)) {
+            DOCA_LOG_ERR("Copy sizes must be a comma separated list of KiB between 1 and %lu", 1UL << 22);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        cfg->sizes.push_back(value << 10);
+    }
+    if (cfg->sizes.empty()) {
+        DOCA_LOG_ERR("No copy size given");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle iterations parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t iterations_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Iterations must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->iterations = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle pipeline depth parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t depth_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Pipeline depth must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->depth = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle sleeping wait parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t sleep_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+
+    cfg->sleep_wait = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle bounce buffers parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bounce_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    int value = *(int *)param;
+
+    if (value < 0) {
+        DOCA_LOG_ERR("Bounce buffer size must not be negative");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->service.bounce = value > 0;
+    if (value > 0) cfg->service.bounce_size = (size_t)value << 10;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct co_config *cfg = (struct co_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Create and register a single ARGP parameter
+ *
+ * @short_name [in]: Short option name, NULL for none
+ * @long_name [in]: Long option name
+ * @description [in]: Help text
+ * @callback [in]: Parameter callback
+ * @type [in]: Parameter type
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_co_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("s", "sizes", "Comma separated copy sizes in KiB (host only)", sizes_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("i", "iterations", "Copies per size and mode (host only)", iterations_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("q", "depth", "Copies in flight in the pipelined mode (host only)", depth_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("S", "sleep-wait", "Sleep between polls while waiting for completions (host only)",
+                            sleep_callback, DOCA_ARGP_TYPE_BOOLEAN);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("b", "bounce", "Stage copies through DPU bounce buffers of this many KiB, 0 for direct "
+                            "host to host DMA (DPU only)", bounce_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise (host only)",
+                            output_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+
+    return DOCA_SUCCESS;
+}
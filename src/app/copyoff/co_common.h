@@ -0,0 +1,27 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "offload/copy_offload.h"
+
+struct co_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    std::vector<size_t> sizes = {4 << 10, 64 << 10, 1 << 20, 16 << 20}; /* Copy sizes to sweep, in bytes */
+    uint32_t iterations = 64;                                 /* Copies per size and mode */
+    uint32_t depth = 8;                                       /* Copies in flight in the pipelined mode */
+    bool sleep_wait = false;                                  /* Host blocking calls sleep between polls */
+    doca::copy_service_attr service;                          /* DPU side bounce buffers and job size */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_co_params(void);
@@ -0,0 +1,242 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "chan/comm_channel.h"
+#include "co_common.h"
+#include "dma/dma.h"
+#include "offload/copy_offload.h"
+#include "stats/clock.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(CO_CLIENT::MAIN);
+
+const char *server_name = "doca_copyoff_server";
+
+enum co_mode { CO_MEMCPY, CO_OFFLOAD, CO_PIPELINED, CO_MEMSET, CO_OFFLOAD_MEMSET, CO_FILL_PIPELINED };
+
+static const char *co_mode_name[] = {"memcpy", "offload_memcpy", "offload_pipelined",
+                                     "memset", "offload_memset", "fill_pipelined"};
+
+#define CO_FILL_BYTE 0xa5 /* Value the fill modes write */
+
+/* Source and destination regions, each depth slots of the largest copy size */
+struct co_regions {
+    doca::MemMap src;
+    doca::MemMap dst;
+    uint32_t src_id;
+    uint32_t dst_id;
+    size_t nb_slots;
+};
+
+/*
+ * Check the destination slots after a run
+ *
+ * @regions [in]: Registered regions
+ * @mode [in]: How the slots were written
+ * @len [in]: Bytes written from the start of the destination
+ * @return: true if they hold what the mode should have written
+ */
+static bool check_slots(co_regions &regions, co_mode mode, size_t len) {
+    const char *dst = regions.dst.Data();
+
+    if (mode < CO_MEMSET) return memcmp(dst, regions.src.Data(), len) == 0;
+    for (size_t i = 0; i < len; i++)
+        if ((uint8_t)dst[i] != CO_FILL_BYTE) return false;
+    return true;
+}
+
+/*
+ * Copy or fill size bytes iterations times in one mode, slot by slot, and check the destination slots afterwards
+ *
+ * @offload [in]: Copy service client
+ * @regions [in]: Registered regions
+ * @mode [in]: How the copies are made
+ * @size [in]: Bytes per copy
+ * @cfg [in]: Program configuration
+ * @report [in]: Result writer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_mode(doca::CopyOffload &offload, co_regions &regions, co_mode mode, size_t size,
+                             const struct co_config &cfg, doca::ReportWriter &report) {
+    using namespace doca;
+    std::deque<uint64_t> inflight;
+    uint64_t start_ns, wall_ns, cpu_ns, id, pattern = CO_FILL_BYTE * 0x0101010101010101ULL;
+    size_t slots = std::min<size_t>(regions.nb_slots, cfg.iterations), offset;
+    doca_error_t result = DOCA_SUCCESS;
+    double gbps, cpu_pct;
+
+    memset(regions.dst.Data(), 0, slots * size);
+
+    start_ns = NowNs();
+    cpu_ns = ThreadCpuNs();
+    for (uint32_t i = 0; i < cfg.iterations && result == DOCA_SUCCESS; i++) {
+        offset = (i % slots) * size;
+        switch (mode) {
+            case CO_MEMCPY:
+                memcpy(regions.dst.Data() + offset, regions.src.Data() + offset, size);
+                break;
+            case CO_OFFLOAD:
+                result = offload_memcpy(offload, regions.dst.Data() + offset, regions.src.Data() + offset, size);
+                break;
+            case CO_MEMSET:
+                memset(regions.dst.Data() + offset, CO_FILL_BYTE, size);
+                break;
+            case CO_OFFLOAD_MEMSET:
+                result = offload_memset(offload, regions.dst.Data() + offset, CO_FILL_BYTE, size);
+                break;
+            case CO_PIPELINED:
+            case CO_FILL_PIPELINED:
+                if (inflight.size() == cfg.depth) {
+                    result = offload.Wait(inflight.front());
+                    inflight.pop_front();
+                    if (result != DOCA_SUCCESS) break;
+                }
+                if (mode == CO_PIPELINED)
+                    result = offload.Post(regions.dst_id, offset, regions.src_id, offset, size, &id);
+                else
+                    result = offload.PostFill(regions.dst_id, offset, size, pattern, &id);
+                if (result == DOCA_SUCCESS) inflight.push_back(id);
+                break;
+        }
+    }
+    if (result == DOCA_SUCCESS && (mode == CO_PIPELINED || mode == CO_FILL_PIPELINED)) result = offload.WaitAll();
+    cpu_ns = ThreadCpuNs() - cpu_ns;
+    wall_ns = NowNs() - start_ns;
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("%s of %zu bytes failed: %s", co_mode_name[mode], size, doca_get_error_string(result));
+        return result;
+    }
+
+    if (!check_slots(regions, mode, slots * size)) {
+        DOCA_LOG_ERR("%s of %zu bytes left the destination with the wrong contents", co_mode_name[mode], size);
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    gbps = (double)size * cfg.iterations / wall_ns;
+    cpu_pct = 100.0 * cpu_ns / wall_ns;
+    DOCA_LOG_INFO("%-17s %8zu B: %9.2f us/op, %6.2f GB/s, host CPU %5.1f%%", co_mode_name[mode], size,
+                  wall_ns / 1e3 / cfg.iterations, gbps, cpu_pct);
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("mode", co_mode_name[mode])
+        .Add("size", (uint64_t)size)
+        .Add("iterations", (uint64_t)cfg.iterations)
+        .Add("depth", (uint64_t)(mode == CO_PIPELINED || mode == CO_FILL_PIPELINED ? cfg.depth : 1))
+        .Add("wait", cfg.sleep_wait ? "sleep" : "spin")
+        .Add("wall_ns", wall_ns)
+        .Add("us_per_op", wall_ns / 1e3 / cfg.iterations)
+        .Add("gb_per_sec", gbps)
+        .Add("host_cpu_pct", cpu_pct);
+    return report.EndRow();
+}
+
+/*
+ * Register the regions with the copy service and sweep the sizes in every copy and fill mode
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_benchmark(doca::CommChannel<doca::Host> &ch, const struct co_config &cfg) {
+    using namespace doca;
+    size_t max_size = *std::max_element(cfg.sizes.begin(), cfg.sizes.end());
+    ReportWriter report;
+    doca_error_t result, close_result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Host> dma;
+    co_regions regions;
+
+    regions.nb_slots = cfg.depth;
+    result = dma.Init(regions.src);
+    if (result != DOCA_SUCCESS) return result;
+    result = dma.Init(regions.dst);
+    if (result != DOCA_SUCCESS) return result;
+    result = regions.src.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, max_size * regions.nb_slots);
+    if (result != DOCA_SUCCESS) return result;
+    result = regions.dst.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, max_size * regions.nb_slots);
+    if (result != DOCA_SUCCESS) return result;
+    for (size_t i = 0; i < regions.src.Len(); i++) regions.src.Data()[i] = (char)(i * 131 + (i >> 12));
+
+    CopyOffload offload(dma, ch);
+
+    result = offload.Register(regions.src, &regions.src_id);
+    if (result != DOCA_SUCCESS) return result;
+    result = offload.Register(regions.dst, &regions.dst_id);
+    if (result != DOCA_SUCCESS) return result;
+
+    for (size_t size : cfg.sizes) {
+        for (co_mode mode : {CO_MEMCPY, CO_OFFLOAD, CO_PIPELINED, CO_MEMSET, CO_OFFLOAD_MEMSET, CO_FILL_PIPELINED}) {
+            result = run_mode(offload, regions, mode, size, cfg, report);
+            if (result != DOCA_SUCCESS) break;
+        }
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    close_result = offload.Close();
+    if (result != DOCA_SUCCESS) return result;
+    if (close_result != DOCA_SUCCESS) return close_result;
+
+    /* Service shut down */
+    return ch.WaitForSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct co_config cfg;
+    cc_ep_attr ep_attr;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_copyoff_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_co_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register copy offload client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    /* Sleeping between polls gives the host CPU back while copies run on the DPU */
+    ep_attr.wait = cfg.sleep_wait ? WAIT_SLEEP : WAIT_SPIN;
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr, ep_attr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_benchmark(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Copy offload benchmark failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
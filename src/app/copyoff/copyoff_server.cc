@@ -0,0 +1,98 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <cinttypes>
+
+#include "chan/comm_channel.h"
+#include "co_common.h"
+#include "dma/dma.h"
+#include "offload/copy_offload.h"
+
+DOCA_LOG_REGISTER(CO_SERVER::MAIN);
+
+const char *server_name = "doca_copyoff_server";
+
+/*
+ * Run the copy and fill service until the host closes it
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_service(doca::CommChannel<doca::Dpu> &ch, const struct co_config &cfg) {
+    using namespace doca;
+    copy_service_stats stats;
+    doca_error_t result;
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    /* Bounce buffers, if any, are the engine's only local memory */
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    CopyService service(dma, ch, cfg.service);
+
+    result = service.Run();
+    service.Snapshot(&stats);
+    DOCA_LOG_INFO("%s copies: %" PRIu64 " of %.1f MB; fills: %" PRIu64 " of %.1f MB; %" PRIu64 " failed; %" PRIu64
+                  " DMA jobs; %" PRIu64 " descriptor batches in, %" PRIu64 " completion batches out",
+                  cfg.service.bounce ? "Bounced" : "Direct", stats.copies, stats.bytes / 1e6, stats.fills,
+                  stats.fill_bytes / 1e6, stats.failed, stats.jobs, stats.cmd_msgs, stats.done_msgs);
+
+    dma.Finalize();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct co_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_copyoff_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_co_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register copy offload server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_service(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Copy service failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,315 @@
+#include "dd_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <stdlib.h>
+#include <string.h>
+
+DOCA_LOG_REGISTER(DD_COMMON);
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    const char *dev_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(dev_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_pci_addr, dev_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    const char *rep_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(rep_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device representor PCI address exceeding the maximum size of %d",
+                     DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_rep_pci_addr, rep_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle block count parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t blocks_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Block count must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->nb_blocks = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle block size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t block_size_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0 || value > (1 << 10)) {
+        DOCA_LOG_ERR("Block size must be between 1 and %d KiB", 1 << 10);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->fingerprint.block_size = (size_t)value << 10;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle duplicate share parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dup_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value < 0 || value > 100) {
+        DOCA_LOG_ERR("Duplicate share must be between 0 and 100 percent");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->dup_percent = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle iterations parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t iterations_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Iterations must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->iterations = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle chunk size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t chunk_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0 || value > (1 << 20)) {
+        DOCA_LOG_ERR("Chunk size must be between 1 and %d KiB", 1 << 20);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->fingerprint.chunk_size = (size_t)value << 10;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle buffer count parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t buffers_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Buffer count must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->fingerprint.nb_buffers = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle no verify parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t no_verify_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+
+    cfg->verify = !*(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle fingerprint table path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t file_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered fingerprint table path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->file_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct dd_config *cfg = (struct dd_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Create and register a single ARGP parameter
+ *
+ * @short_name [in]: Short option name, NULL for none
+ * @long_name [in]: Long option name
+ * @description [in]: Help text
+ * @callback [in]: Parameter callback
+ * @type [in]: Parameter type
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_dd_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("n", "blocks", "Blocks of the host region (host only)", blocks_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("b", "block-size", "Block size in KiB, the dedup unit (host only)", block_size_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("d", "dup", "Percent of blocks that copy an earlier block (host only)", dup_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("i", "iterations", "Fingerprinting passes (DPU only)", iterations_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("s", "chunk", "DMA chunk size in KiB, a multiple of the block size (DPU only)",
+                            chunk_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("q", "buffers", "DPU buffers in flight or being hashed (DPU only)", buffers_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("N", "no-verify", "Count equal fingerprints as duplicates without comparing (DPU only)",
+                            no_verify_callback, DOCA_ARGP_TYPE_BOOLEAN);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("f", "file", "Fingerprint table file, the duplicate report goes to <file>.dups (DPU only)",
+                            file_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise (DPU only)",
+                            output_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+
+    return DOCA_SUCCESS;
+}
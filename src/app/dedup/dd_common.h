@@ -0,0 +1,40 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include "chan/comm_channel.h"
+#include "dedup/fingerprint.h"
+
+struct dd_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    uint64_t nb_blocks = 16384;                               /* Blocks of the host region */
+    uint32_t dup_percent = 25;                                /* Blocks that copy an earlier one */
+    uint32_t iterations = 3;                                  /* Fingerprinting passes */
+    bool verify = true;                                       /* Compare fingerprint matches byte for byte */
+    doca::fingerprint_attr fingerprint;                       /* Block size on the host, DPU chunks and buffers */
+    char file_path[MAX_ARG_SIZE] = "";                        /* Fingerprint table file, duplicates go to <file>.dups */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/* Sent by the host after the export: the region is len bytes of block_size blocks */
+struct dd_region_desc {
+    uint64_t len;
+    uint64_t block_size;
+};
+
+/* Sent by the DPU once it is done, the host checks it against the duplicates it planted */
+struct dd_result {
+    uint64_t blocks;
+    uint64_t duplicate_blocks;
+    uint64_t groups;
+    uint64_t collisions;
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_dd_params(void);
@@ -0,0 +1,145 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <random>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "dd_common.h"
+
+DOCA_LOG_REGISTER(DD_CLIENT::MAIN);
+
+const char *server_name = "doca_dedup_server";
+
+/*
+ * Fill the region with random blocks, dup_percent of them copies of an earlier block
+ *
+ * @data [out]: Region to fill
+ * @cfg [in]: Program configuration
+ * @return: Number of copies, the duplicate blocks the DPU has to find
+ */
+static uint64_t fill_blocks(char *data, const struct dd_config &cfg) {
+    size_t block_size = cfg.fingerprint.block_size;
+    std::mt19937_64 rng(42);
+    uint64_t copies = 0, word;
+
+    for (uint64_t i = 0; i < cfg.nb_blocks; i++) {
+        if (i > 0 && rng() % 100 < cfg.dup_percent) {
+            memcpy(data + i * block_size, data + rng() % i * block_size, block_size);
+            copies++;
+            continue;
+        }
+        for (size_t off = 0; off < block_size; off += sizeof(word)) {
+            word = rng();
+            memcpy(data + i * block_size + off, &word, std::min(sizeof(word), block_size - off));
+        }
+    }
+    return copies;
+}
+
+/*
+ * Fill an exported region, keep it in place while the DPU fingerprints it and check the duplicates it found
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_region(doca::CommChannel<doca::Host> &ch, const struct dd_config &cfg) {
+    using namespace doca;
+    dd_region_desc desc;
+    doca_error_t result;
+    uint64_t copies;
+    dd_result res;
+    size_t len;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_ONLY, cfg.nb_blocks * cfg.fingerprint.block_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    copies = fill_blocks(mmap.Data(), cfg);
+    DOCA_LOG_INFO("Region of %" PRIu64 " blocks of %zu bytes, %.1f MB, %" PRIu64 " of them copies", cfg.nb_blocks,
+                  cfg.fingerprint.block_size, mmap.Len() / 1e6, copies);
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    desc = {mmap.Len(), cfg.fingerprint.block_size};
+    result = ch.SendTo(&desc, sizeof(desc));
+    if (result != DOCA_SUCCESS) return result;
+
+    len = sizeof(res);
+    result = ch.RecvFrom(&res, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(res)) {
+        DOCA_LOG_ERR("Malformed dedup result");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (res.blocks != cfg.nb_blocks || res.duplicate_blocks != copies) {
+        DOCA_LOG_ERR("DPU found %" PRIu64 " duplicates in %" PRIu64 " blocks, expected %" PRIu64 " in %" PRIu64,
+                     res.duplicate_blocks, res.blocks, copies, cfg.nb_blocks);
+        ch.SendFailMsg();
+        return DOCA_ERROR_IO_FAILED;
+    }
+    DOCA_LOG_INFO("DPU result checked: %" PRIu64 " duplicate blocks in %" PRIu64 " groups, %" PRIu64 " collisions",
+                  res.duplicate_blocks, res.groups, res.collisions);
+    return ch.SendSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct dd_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_dedup_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_dd_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register dedup client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_region(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Region setup failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,212 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "dd_common.h"
+#include "dma/dma.h"
+#include "stats/report.h"
+#include "util/crc32c.h"
+
+DOCA_LOG_REGISTER(DD_SERVER::MAIN);
+
+const char *server_name = "doca_dedup_server";
+
+/*
+ * Write the fingerprint table as CSV and the duplicate groups next to it, one line per group
+ *
+ * @path [in]: Fingerprint table file, the groups go to <path>.dups
+ * @table [in]: Fingerprint table
+ * @report [in]: Duplicate report
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t write_files(const char *path, const std::vector<doca::block_fingerprint> &table,
+                                const doca::dedup_report &report) {
+    std::string dups_path = std::string(path) + ".dups";
+    FILE *out;
+
+    out = fopen(path, "w");
+    if (out == NULL) {
+        DOCA_LOG_ERR("Failed to open fingerprint table file %s", path);
+        return DOCA_ERROR_NOT_FOUND;
+    }
+    fprintf(out, "offset,len,fingerprint\n");
+    for (const doca::block_fingerprint &entry : table)
+        fprintf(out, "%" PRIu64 ",%u,%016" PRIx64 "\n", entry.offset, entry.len, entry.fp);
+    if (fclose(out) != 0) {
+        DOCA_LOG_ERR("Failed to write fingerprint table file %s", path);
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    /* Fingerprint, block length, then the offsets, the first one holding the original */
+    out = fopen(dups_path.c_str(), "w");
+    if (out == NULL) {
+        DOCA_LOG_ERR("Failed to open duplicate report file %s", dups_path.c_str());
+        return DOCA_ERROR_NOT_FOUND;
+    }
+    fprintf(out, "# %" PRIu64 " blocks, %" PRIu64 " duplicates, %" PRIu64 " bytes reclaimable, %" PRIu64
+                 " collisions\n",
+            report.blocks, report.duplicate_blocks, report.duplicate_bytes, report.collisions);
+    for (const doca::dedup_group &group : report.groups) {
+        fprintf(out, "%016" PRIx64 " %u", group.fp, group.len);
+        for (uint64_t offset : group.offsets) fprintf(out, " %" PRIu64, offset);
+        fprintf(out, "\n");
+    }
+    if (fclose(out) != 0) {
+        DOCA_LOG_ERR("Failed to write duplicate report file %s", dups_path.c_str());
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    DOCA_LOG_INFO("Fingerprint table in %s, duplicate report in %s", path, dups_path.c_str());
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Import the host's region, fingerprint it, find the duplicates and send the result for the host to check
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_dedup(doca::CommChannel<doca::Dpu> &ch, const struct dd_config &cfg) {
+    using namespace doca;
+    fingerprint_attr attr = cfg.fingerprint;
+    std::vector<block_fingerprint> table;
+    fingerprint_stats stats;
+    dedup_report dups;
+    ReportWriter report;
+    dd_region_desc region;
+    doca_error_t result;
+    dd_result res;
+    size_t len;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    /* The fingerprinter's chunk buffers are the only local memory */
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    len = sizeof(region);
+    result = ch.RecvFrom(&region, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(region) || region.block_size == 0 || region.len > remote_mmap.Len()) {
+        DOCA_LOG_ERR("Malformed region description");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    attr.block_size = region.block_size;
+
+    {
+        Fingerprinter fingerprinter(dma, remote_mmap, attr);
+
+        for (uint32_t i = 0; i < cfg.iterations && result == DOCA_SUCCESS; i++)
+            result = fingerprinter.Run(0, region.len, &table);
+        if (result == DOCA_SUCCESS) result = fingerprinter.FindDuplicates(table, &dups, cfg.verify);
+        fingerprinter.Snapshot(&stats);
+    }
+    dma.Finalize();
+    if (result != DOCA_SUCCESS) return result;
+
+    DOCA_LOG_INFO("Fingerprinted %" PRIu64 " blocks of %zu bytes at %.2f GB/s, CRC32C (%s) alone %.2f GB/s",
+                  dups.blocks, attr.block_size, stats.GBps(), Crc32cImplName(), stats.HashGBps());
+    DOCA_LOG_INFO("%" PRIu64 " duplicate blocks in %zu groups, %.1f MB reclaimable; %" PRIu64 " matches compared in "
+                  "%.1f ms, %" PRIu64 " collisions",
+                  dups.duplicate_blocks, dups.groups.size(), dups.duplicate_bytes / 1e6, stats.verified,
+                  stats.verify_ns / 1e6, dups.collisions);
+
+    if (cfg.file_path[0] != '\0') {
+        result = write_files(cfg.file_path, table, dups);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    if (report.IsOpen()) {
+        report.Add("blocks", dups.blocks)
+            .Add("block_size", (uint64_t)attr.block_size)
+            .Add("chunk_size", (uint64_t)attr.chunk_size)
+            .Add("buffers", (uint64_t)attr.nb_buffers)
+            .Add("iterations", (uint64_t)cfg.iterations)
+            .Add("busy_ns", stats.busy_ns)
+            .Add("hash_ns", stats.hash_ns)
+            .Add("gbps", stats.GBps())
+            .Add("hash_gbps", stats.HashGBps())
+            .Add("crc32c", Crc32cImplName())
+            .Add("again", stats.again)
+            .Add("duplicate_blocks", dups.duplicate_blocks)
+            .Add("groups", (uint64_t)dups.groups.size())
+            .Add("duplicate_bytes", dups.duplicate_bytes)
+            .Add("verified", stats.verified)
+            .Add("verify_ns", stats.verify_ns)
+            .Add("collisions", dups.collisions);
+        result = report.EndRow();
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    res = {dups.blocks, dups.duplicate_blocks, dups.groups.size(), dups.collisions};
+    result = ch.SendTo(&res, sizeof(res));
+    if (result != DOCA_SUCCESS) return result;
+
+    /* The host's verdict */
+    return ch.WaitForSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct dd_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_dedup_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_dd_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register dedup server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_dedup(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Dedup failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
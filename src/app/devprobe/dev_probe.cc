@@ -0,0 +1,205 @@
+#include <doca_argp.h>
+#include <doca_dev.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include "chan/comm_channel.h"
+#include "dev/registry.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(DEV_PROBE::MAIN);
+
+struct probe_config {
+    char pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE]; /* Probe only this device if set */
+    char output_path[MAX_ARG_SIZE];            /* Report file, none if empty */
+};
+
+/*
+ * ARGP Callback - Handle DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct probe_config *cfg = (struct probe_config *)config;
+    const char *pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->pci_addr, pci_addr, len + 1);
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle report file parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct probe_config *cfg = (struct probe_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Register the command line parameters for the probe tool
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_probe_params(void) {
+    struct doca_argp_param *pci_param, *output_param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&pci_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(pci_param, "p");
+    doca_argp_param_set_long_name(pci_param, "pci-addr");
+    doca_argp_param_set_description(pci_param, "Probe only the DOCA device at this PCI address");
+    doca_argp_param_set_callback(pci_param, pci_addr_callback);
+    doca_argp_param_set_type(pci_param, DOCA_ARGP_TYPE_STRING);
+    result = doca_argp_register_param(pci_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = doca_argp_param_create(&output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(output_param, "o");
+    doca_argp_param_set_long_name(output_param, "output");
+    doca_argp_param_set_description(output_param, "Report file, JSON if it ends in .json, CSV otherwise");
+    doca_argp_param_set_callback(output_param, output_callback);
+    doca_argp_param_set_type(output_param, DOCA_ARGP_TYPE_STRING);
+    result = doca_argp_register_param(output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Log one device profile and append it to the report
+ *
+ * @profile [in]: Probed device
+ * @report [in]: Result writer, skipped if not open
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t report_profile(const doca::device_profile &profile, doca::ReportWriter &report) {
+    DOCA_LOG_INFO("Device %s (%s)", profile.pci_addr, profile.ibdev_name[0] ? profile.ibdev_name : "unknown");
+    DOCA_LOG_INFO("  DMA memcpy:          %s, max buffer %" PRIu64 " bytes", profile.dma_memcpy ? "yes" : "no",
+                  profile.dma_max_buf_size);
+    DOCA_LOG_INFO("  Comm Channel:        max message %u bytes, send queue %u, receive queue %u",
+                  profile.cc_max_msg_size, profile.cc_max_send_queue_size, profile.cc_max_recv_queue_size);
+    DOCA_LOG_INFO("  NUMA node:           %d", profile.numa_node);
+    DOCA_LOG_INFO("  PCIe link:           x%d of x%d, %s", profile.link_width, profile.max_link_width,
+                  profile.link_speed[0] ? profile.link_speed : "unknown speed");
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("pci_addr", profile.pci_addr)
+        .Add("ibdev", profile.ibdev_name)
+        .Add("dma_memcpy", profile.dma_memcpy ? "yes" : "no")
+        .Add("dma_max_buf_size", profile.dma_max_buf_size)
+        .Add("cc_max_msg_size", (uint64_t)profile.cc_max_msg_size)
+        .Add("cc_max_send_queue_size", (uint64_t)profile.cc_max_send_queue_size)
+        .Add("cc_max_recv_queue_size", (uint64_t)profile.cc_max_recv_queue_size)
+        .Add("numa_node", (int64_t)profile.numa_node)
+        .Add("link_width", (int64_t)profile.link_width)
+        .Add("max_link_width", (int64_t)profile.max_link_width)
+        .Add("link_speed", profile.link_speed);
+    return report.EndRow();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+
+    struct probe_config cfg = {};
+    DeviceRegistry &registry = DeviceRegistry::Instance();
+    ReportWriter report;
+    doca_error_t result;
+    size_t probed = 0;
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create standard log backend");
+        return result;
+    }
+
+    result = doca_argp_init("doca_dev_probe", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = register_probe_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register probe parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse sample input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    if (cfg.output_path[0]) {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) {
+            doca_argp_destroy();
+            return result;
+        }
+    }
+
+    for (size_t i = 0; i < registry.NumDevices(); i++) {
+        const char *pci_addr = registry.PciAddr(i);
+        uint8_t is_addr_equal = 1;
+
+        if (cfg.pci_addr[0]) doca_devinfo_get_is_pci_addr_equal(registry.DevInfo(i), cfg.pci_addr, &is_addr_equal);
+        if (!is_addr_equal) continue;
+
+        std::shared_ptr<DOCADevice> dev = registry.GetByPci(pci_addr);
+        if (!dev) continue;
+
+        result = report_profile(dev->Profile(), report);
+        if (result != DOCA_SUCCESS) break;
+        probed++;
+    }
+
+    if (result == DOCA_SUCCESS && probed == 0) {
+        DOCA_LOG_ERR("No DOCA device matched");
+        result = DOCA_ERROR_NOT_FOUND;
+    }
+
+    report.Close();
+    doca_argp_destroy();
+
+    return result;
+}
@@ -2,19 +2,83 @@
 #include <doca_error.h>
 #include <doca_log.h>
 
+#include "chan/clock_sync.h"
 #include "chan/comm_channel.h"
 #include "dma/dma.h"
 #include "dma_common.h"
+#include "stats/clock.h"
+#include "stats/histogram.h"
 
 const char *server_name = "doca_dma_server";
 
 DOCA_LOG_REGISTER(DMA_CLIENT::MAIN);
 
+/*
+ * Sync clocks with the DPU, then watch the exported buffer for the header of every DMA write and measure, in the
+ * host timebase, how long after submission each write became visible and when the DPU saw it complete
+ *
+ * @ch [in]: Connected Comm Channel
+ * @mmap [in]: Exported buffer the DPU writes into
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_one_way(doca::CommChannel<doca::Host> &ch, doca::MemMap &mmap, const struct dma_copy_cfg &cfg) {
+    using namespace doca;
+    struct dma_oneway_hdr *hdr = (struct dma_oneway_hdr *)mmap.Data();
+    LatencyHistogram visible, complete;
+    ClockSync sync;
+    doca_error_t result;
+    uint64_t seq, last_seq = 0, prev_submit = 0, submit, prev_complete, now;
+    int dpu_iterations;
+    size_t len;
+    int64_t lat;
+
+    memset(mmap.Data(), 0, sizeof(struct dma_oneway_hdr));
+    result = sync.Sync(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Waiting for more copies than the DPU issues would never end */
+    len = sizeof(dpu_iterations);
+    result = ch.RecvFrom(&dpu_iterations, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(dpu_iterations) || dpu_iterations != cfg.iterations) {
+        DOCA_LOG_ERR("DPU issues %d copies, the host expects %d: pass the same -n to both sides", dpu_iterations,
+                     cfg.iterations);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* Copies overwritten before they were seen are skipped, only observed ones are sampled */
+    while (last_seq < (uint64_t)cfg.iterations) {
+        seq = __atomic_load_n(&hdr->seq_end, __ATOMIC_ACQUIRE);
+        if (seq == last_seq) continue;
+        now = NowNs();
+        submit = __atomic_load_n(&hdr->dpu_submit_ns, __ATOMIC_RELAXED);
+        prev_complete = __atomic_load_n(&hdr->dpu_prev_complete_ns, __ATOMIC_RELAXED);
+        /* The next copy is landing over this one, the timestamps may be mixed; wait for it instead */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&hdr->seq, __ATOMIC_RELAXED) != seq) continue;
+
+        lat = (int64_t)(now - sync.FromPeer(submit));
+        visible.Record(lat > 0 ? lat : 0);
+        if (seq == last_seq + 1 && prev_complete != 0) complete.Record(prev_complete - prev_submit);
+
+        prev_submit = submit;
+        last_seq = seq;
+    }
+
+    DOCA_LOG_INFO("DPU->host write visible: %" PRIu64 " samples, p50 %" PRIu64 " ns, p99 %" PRIu64 " ns, max %" PRIu64
+                  " ns (sync error <= %" PRIu64 " ns)",
+                  visible.Count(), visible.Percentile(50.0), visible.Percentile(99.0), visible.Max(),
+                  sync.LastRtt() / 2);
+    DOCA_LOG_INFO("DPU submit->completion: p50 %" PRIu64 " ns, p99 %" PRIu64 " ns, max %" PRIu64 " ns",
+                  complete.Percentile(50.0), complete.Percentile(99.0), complete.Max());
+    return DOCA_SUCCESS;
+}
+
 int main(int argc, char *argv[]) {
     using namespace doca;
     doca_error_t result;
     struct dma_copy_cfg dma_cfg;
-    doca_app_mode mode = DOCA_MODE_HOST;
 
     /* Register a logger backend */
     result = doca_log_create_standard_backend();
@@ -34,10 +98,11 @@ int main(int argc, char *argv[]) {
     result = doca_argp_start(argc, argv);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
         return result;
     }
 
-    CommChannel ch(mode, dma_cfg.cc_dev_pci_addr, dma_cfg.cc_dev_rep_pci_addr);
+    CommChannel<Host> ch(dma_cfg.cc_dev_pci_addr);
 
     result = ch.Connect(server_name);
     if (result != DOCA_SUCCESS) {
@@ -50,7 +115,7 @@ int main(int argc, char *argv[]) {
         return result;
     }
 
-    DOCADma dma(mode);
+    DOCADma<Host> dma;
     MemMap mmap;
 
     dma.Init(mmap);
@@ -59,6 +124,11 @@ int main(int argc, char *argv[]) {
     dma.ExportDesc(mmap, ch);  // -->
     mmap.SendAddrAndOffset(ch);  // -->
 
+    if (dma_cfg.one_way) {
+        result = run_one_way(ch, mmap, dma_cfg);
+        if (result != DOCA_SUCCESS) goto argp_cleanup;
+    }
+
     ch.WaitForSuccessfulMsg();
     DOCA_LOG_INFO("Final status message was successfully received");
 
@@ -66,9 +66,78 @@ doca_error_t msg_size_callback(void *param, void *config) {
     return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle DMA copy iterations parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t iterations_callback(void *param, void *config) {
+    struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
+    int iterations = *(int *)param;
+
+    if (iterations <= 0) {
+        DOCA_LOG_ERR("Iterations must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->iterations = iterations;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle one-way latency mode parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t one_way_callback(void *param, void *config) {
+    struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
+
+    cfg->one_way = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle CPU performance counters parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t perf_callback(void *param, void *config) {
+    struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
+
+    cfg->perf = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Validation - Check flags against each other once all are parsed
+ *
+ * @config [in]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dma_validate(void *config) {
+    struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
+
+    /* The timestamps of every copy travel at the start of the chunk */
+    if (cfg->one_way && cfg->chunk_size < sizeof(struct dma_oneway_hdr)) {
+        DOCA_LOG_ERR("One-way mode needs chunks of at least %zu bytes", sizeof(struct dma_oneway_hdr));
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
 doca_error_t register_dma_copy_params(void) {
     doca_error_t result;
     struct doca_argp_param *chunk_size_param, *dev_pci_addr_param, *rep_pci_addr_param;
+    struct doca_argp_param *iterations_param, *one_way_param, *perf_param;
 
     /* Create and register Comm Channel DOCA device PCI address */
     result = doca_argp_param_create(&dev_pci_addr_param);
@@ -123,5 +192,60 @@ doca_error_t register_dma_copy_params(void) {
         return result;
     }
 
+    /* Create and register DMA copy iterations */
+    result = doca_argp_param_create(&iterations_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(iterations_param, "n");
+    doca_argp_param_set_long_name(iterations_param, "iterations");
+    doca_argp_param_set_description(iterations_param, "Number of DMA copies (default 10)");
+    doca_argp_param_set_callback(iterations_param, iterations_callback);
+    doca_argp_param_set_type(iterations_param, DOCA_ARGP_TYPE_INT);
+    result = doca_argp_register_param(iterations_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register one-way latency mode */
+    result = doca_argp_param_create(&one_way_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_long_name(one_way_param, "one-way");
+    doca_argp_param_set_description(one_way_param,
+                                    "Sync clocks and measure DPU->host DMA write latency on the host (both sides)");
+    doca_argp_param_set_callback(one_way_param, one_way_callback);
+    doca_argp_param_set_type(one_way_param, DOCA_ARGP_TYPE_BOOLEAN);
+    result = doca_argp_register_param(one_way_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    /* Create and register CPU performance counters */
+    result = doca_argp_param_create(&perf_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_long_name(perf_param, "perf");
+    doca_argp_param_set_description(perf_param, "Report per-copy CPU counters of the copy loop (DPU only)");
+    doca_argp_param_set_callback(perf_param, perf_callback);
+    doca_argp_param_set_type(perf_param, DOCA_ARGP_TYPE_BOOLEAN);
+    result = doca_argp_register_param(perf_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = doca_argp_register_validation_callback(dma_validate);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register validation callback: %s", doca_get_error_string(result));
+        return result;
+    }
+
     return DOCA_SUCCESS;
 }
@@ -1,11 +1,29 @@
 #pragma once
 
 #include <doca_dev.h>
+#include <stdint.h>
 
 struct dma_copy_cfg {
     char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
     char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
     uint32_t chunk_size;                                      /* Chunk size in bytes */
+    int iterations = 10;                                      /* DMA copies issued by the server */
+    bool one_way = false;                                     /* Measure DPU->host write visibility on the host */
+    bool perf = false;                                        /* CPU counters around the copy loop */
+};
+
+/*
+ * Written by the server at the start of every chunk in one-way mode. The host
+ * watches seq_end change and converts the DPU timestamps into its own
+ * timebase. The copy lands in address order, seq first and seq_end last: the
+ * host reads seq_end, then the timestamps, then seq, and takes the timestamps
+ * only if both sequence numbers agree, like a seqlock reader.
+ */
+struct dma_oneway_hdr {
+    uint64_t seq;                  /* 1-based copy number */
+    uint64_t dpu_submit_ns;        /* DPU clock, just before this copy was submitted */
+    uint64_t dpu_prev_complete_ns; /* DPU clock, completion of the previous copy, 0 for the first */
+    uint64_t seq_end;              /* Copy of seq, the last field written */
 };
 
 /*
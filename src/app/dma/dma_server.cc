@@ -4,23 +4,80 @@
 
 #include <chrono>
 
+#include "chan/clock_sync.h"
 #include "chan/comm_channel.h"
 #include "dma/dma.h"
 #include "dma_common.h"
+#include "stats/clock.h"
+#include "stats/perf_counters.h"
 
 const char *server_name = "doca_dma_server";
-const int iteration = 10;
 
 DOCA_LOG_REGISTER(DMA_SERVER::MAIN);
 
-int main(int argc, char *argv[]) {
+/* Timed copy loop of the DPU, reports throughput, CPU counters and job stats once the host was told it is done */
+static doca_error_t run_copies(doca::DOCADma<doca::Dpu> &dma, doca::MemMap &local_mmap, doca::MemMap &remote_mmap,
+                               doca::CommChannel<doca::Dpu> &ch, struct dma_copy_cfg &dma_cfg) {
     using namespace doca;
     using namespace std::chrono;
 
+    doca_error_t result = DOCA_SUCCESS;
+    int64_t duration;
+
+    struct dma_oneway_hdr *hdr = (struct dma_oneway_hdr *)local_mmap.Data();
+    uint64_t prev_complete = 0;
+    PerfCounters perf;
+    perf_sample counters;
+
+    /* Without any counter the copies still run, only the counter line is dropped */
+    if (dma_cfg.perf) perf.Open();
+    perf.Start();
+
+    auto start = high_resolution_clock::now();
+    decltype(start) end;
+
+    for (int i = 0; i < dma_cfg.iterations; i++) {
+        if (dma_cfg.one_way) {
+            hdr->seq = i + 1;
+            hdr->dpu_prev_complete_ns = prev_complete;
+            hdr->dpu_submit_ns = NowNs();
+            hdr->seq_end = i + 1;
+        }
+        result = dma.DmaCopy(local_mmap, remote_mmap, dma_cfg.chunk_size);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to do copy on %d: %s", i, doca_get_error_string(result));
+        }
+        if (dma_cfg.one_way) prev_complete = NowNs();
+    }
+
+    end = high_resolution_clock::now();
+    if (perf.IsOpen()) perf.Stop(&counters);
+
+    ch.SendSuccessfulMsg();
+
+    duration = duration_cast<microseconds>(end - start).count();
+    DOCA_LOG_INFO("Throughput: %f MB/s", static_cast<double>(dma_cfg.chunk_size) * dma_cfg.iterations / duration);
+    if (perf.IsOpen()) {
+        char line[256];
+        counters.Format(dma_cfg.iterations, line, sizeof(line));
+        DOCA_LOG_INFO("Per copy: %s", line);
+    }
+
+    dma_stats stats;
+    dma.Snapshot(&stats);
+    DOCA_LOG_INFO("Jobs: %" PRIu64 " completed, %" PRIu64 " failed, %" PRIu64 " bytes; latency p50 %" PRIu64
+                  " ns, p99 %" PRIu64 " ns, max %" PRIu64 " ns",
+                  stats.completed, stats.failures, stats.bytes, stats.latency.Percentile(50),
+                  stats.latency.Percentile(99), stats.latency.Max());
+
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+
     doca_error_t result;
     struct dma_copy_cfg dma_cfg;
-    doca_app_mode mode = DOCA_MODE_DPU;
-    int64_t duration;
 
     /* Register a logger backend */
     result = doca_log_create_standard_backend();
@@ -40,10 +97,11 @@ int main(int argc, char *argv[]) {
     result = doca_argp_start(argc, argv);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
         return result;
     }
 
-    CommChannel ch(mode, dma_cfg.cc_dev_pci_addr, dma_cfg.cc_dev_rep_pci_addr);
+    CommChannel<Dpu> ch(dma_cfg.cc_dev_pci_addr, dma_cfg.cc_dev_rep_pci_addr);
 
     result = ch.Listen(server_name);
     if (result != DOCA_SUCCESS) {
@@ -56,8 +114,15 @@ int main(int argc, char *argv[]) {
         return result;
     }
 
-    DOCADma dma(mode);
+    DOCADma<Dpu> dma;
     MemMap local_mmap;
+
+    if (dma_cfg.chunk_size > dma.MaxBufSize()) {
+        DOCA_LOG_ERR("Chunk size %u exceeds the device DMA limit of %" PRIu64 " bytes", dma_cfg.chunk_size,
+                     dma.MaxBufSize());
+        doca_argp_destroy();
+        return DOCA_ERROR_INVALID_VALUE;
+    }
     
     dma.Init(local_mmap);
     local_mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, dma_cfg.chunk_size);
@@ -78,26 +143,22 @@ int main(int argc, char *argv[]) {
 		return result;
     }
     
-    auto start = high_resolution_clock::now();
-    decltype(start) end;
-
-    for (int i = 0; i < iteration; i++) {
-        result = dma.DmaCopy(local_mmap, remote_mmap, dma_cfg.chunk_size);
-        if (result != DOCA_SUCCESS) {
-            DOCA_LOG_ERR("Failed to do copy on %d: %s", i, doca_get_error_string(result));
-        }
+    if (dma_cfg.one_way) {
+        /* Host is the sync initiator, it owns the latency measurement */
+        result = ClockSync::Serve(ch);
+        if (result != DOCA_SUCCESS) goto dma_cleanup;
+        /* The host waits for this many copies, it has to agree on -n */
+        result = ch.SendTo(&dma_cfg.iterations, sizeof(dma_cfg.iterations));
+        if (result != DOCA_SUCCESS) goto dma_cleanup;
     }
 
-    end = high_resolution_clock::now();
-
-    ch.SendSuccessfulMsg();
-
-    duration = duration_cast<microseconds>(end - start).count();
-    DOCA_LOG_INFO("Throughput: %f MB/s", static_cast<double>(dma_cfg.chunk_size * iteration) / duration);
+    result = run_copies(dma, local_mmap, remote_mmap, ch, dma_cfg);
 
+dma_cleanup:
     dma.RmBuffer(local_mmap);
     dma.RmBuffer(remote_mmap);
     dma.Finalize();
-    
+    doca_argp_destroy();
+
     return result;
 }
@@ -5,6 +5,7 @@
 #include <chrono>
 
 #include "chan/comm_channel.h"
+#include "dev/registry.h"
 #include "dma/dma.h"
 #include "dma_common.h"
 
@@ -23,7 +24,6 @@ int main(int argc, char *argv[]) {
 
     doca_error_t result;
     struct dma_copy_cfg dma_cfg;
-    doca_app_mode mode = DOCA_MODE_DPU;
     int64_t duration;
 
     struct doca_dma *dma_ctx;
@@ -54,7 +54,7 @@ int main(int argc, char *argv[]) {
         return result;
     }
 
-    CommChannel ch(mode, dma_cfg.cc_dev_pci_addr, dma_cfg.cc_dev_rep_pci_addr);
+    CommChannel<Dpu> ch(dma_cfg.cc_dev_pci_addr, dma_cfg.cc_dev_rep_pci_addr);
 
     result = ch.Listen(server_name);
     if (result != DOCA_SUCCESS) {
@@ -68,13 +68,10 @@ int main(int argc, char *argv[]) {
     }
 
     size_t num_elements = 2;
-    auto dev = std::make_shared<DOCADevice>();
-
-    dev = std::make_shared<DOCADevice>();
-    result = dev->OpenWithCap(check_dev_dma_capable_1);
-    if (result != DOCA_SUCCESS) {
+    auto dev = DeviceRegistry::Instance().GetByCap(check_dev_dma_capable_1);
+    if (!dev) {
         DOCA_LOG_ERR("Failed to open DOCA DMA capable device");
-        return result;
+        return DOCA_ERROR_NOT_FOUND;
     }
 
     result = doca_mmap_create(nullptr, &local_mmap);
@@ -0,0 +1,98 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "fm_common.h"
+
+DOCA_LOG_REGISTER(FM_CLIENT::MAIN);
+
+const char *server_name = "doca_farmem_server";
+
+/*
+ * Export the dataset to the DPU and wait until its lookups are done
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_dataset(doca::CommChannel<doca::Host> &ch, const struct fm_config &cfg) {
+    using namespace doca;
+    doca_error_t result;
+    uint64_t *words;
+    size_t nb_words = cfg.data_size / sizeof(uint64_t), bad = 0;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, cfg.data_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    words = (uint64_t *)mmap.Data();
+    for (size_t i = 0; i < nb_words; i++) words[i] = fm_word(i * sizeof(uint64_t));
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    /* DPU writes store the original values, written back pages must leave the dataset unchanged */
+    for (size_t i = 0; i < nb_words; i++)
+        if (words[i] != fm_word(i * sizeof(uint64_t))) bad++;
+    if (bad > 0) {
+        DOCA_LOG_ERR("Dataset corrupted after the DPU run: %zu of %zu words differ", bad, nb_words);
+        return DOCA_ERROR_IO_FAILED;
+    }
+    DOCA_LOG_INFO("Dataset of %zu bytes intact after the DPU run", cfg.data_size);
+
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct fm_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_farmem_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_fm_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register far memory client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    result = run_dataset(ch, cfg);
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
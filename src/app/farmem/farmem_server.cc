@@ -0,0 +1,379 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <thread>
+#include <vector>
+
+#include "cache/page_cache.h"
+#include "cache/prefetcher.h"
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "fm_common.h"
+#include "stats/clock.h"
+#include "stats/histogram.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(FM_SERVER::MAIN);
+
+const char *server_name = "doca_farmem_server";
+
+/* Results of one lookup thread */
+struct fm_worker {
+    doca::LatencyHistogram latency;
+    uint64_t mismatches = 0;
+    doca_error_t result = DOCA_SUCCESS;
+};
+
+/*
+ * Count the words of a record that do not hold their dataset value
+ *
+ * @buf [in]: Record contents
+ * @offset [in]: Byte offset of the record in the dataset
+ * @len [in]: Record size
+ * @return: Number of mismatching words
+ */
+static uint64_t check_record(const uint64_t *buf, size_t offset, size_t len) {
+    uint64_t bad = 0;
+
+    for (size_t i = 0; i < len / sizeof(uint64_t); i++)
+        if (buf[i] != fm_word(offset + i * sizeof(uint64_t))) bad++;
+    return bad;
+}
+
+/*
+ * Fill a record with its dataset value, so writes leave the dataset unchanged
+ *
+ * @buf [out]: Record contents
+ * @offset [in]: Byte offset of the record in the dataset
+ * @len [in]: Record size
+ */
+static void fill_record(uint64_t *buf, size_t offset, size_t len) {
+    for (size_t i = 0; i < len / sizeof(uint64_t); i++) buf[i] = fm_word(offset + i * sizeof(uint64_t));
+}
+
+/*
+ * Baseline: every lookup is one DMA job to or from host memory, waited for before the next
+ *
+ * @dma [in]: DMA engine
+ * @local [in]: Local record buffer
+ * @remote [in]: Host dataset
+ * @cfg [in]: Program configuration
+ * @worker [out]: Lookup results
+ */
+static void run_uncached(doca::DOCADma<doca::Dpu> &dma, doca::MemMap &local, doca::MemMap &remote,
+                         const struct fm_config &cfg, struct fm_worker &worker) {
+    AccessGen gen(cfg, remote.Len(), 0);
+    uint64_t *buf = (uint64_t *)local.Data();
+    uint64_t start;
+    uint32_t stream;
+    size_t offset;
+    bool write;
+    void *user_data;
+
+    for (int i = 0; i < cfg.iterations; i++) {
+        offset = gen.Next(&stream, &write);
+
+        start = doca::NowNs();
+        if (write) {
+            fill_record(buf, offset, cfg.record_size);
+            worker.result = dma.Submit(local, 0, remote, offset, cfg.record_size, nullptr);
+        } else {
+            worker.result = dma.Submit(remote, offset, local, 0, cfg.record_size, nullptr);
+        }
+        if (worker.result != DOCA_SUCCESS) return;
+        while ((worker.result = dma.Poll(&user_data)) == DOCA_ERROR_AGAIN)
+            ;
+        if (worker.result != DOCA_SUCCESS) return;
+        worker.latency.Record(doca::NowNs() - start);
+
+        if (!write) worker.mismatches += check_record(buf, offset, cfg.record_size);
+    }
+}
+
+/*
+ * Lookups through the page cache, run by every thread
+ *
+ * @cache [in]: Page cache over the host dataset
+ * @data_size [in]: Size of the host dataset
+ * @cfg [in]: Program configuration
+ * @seed [in]: Seed of this thread's access sequence
+ * @worker [out]: Lookup results
+ */
+static void run_cached(doca::PageCache &cache, size_t data_size, const struct fm_config &cfg, uint64_t seed,
+                       struct fm_worker &worker) {
+    AccessGen gen(cfg, data_size, seed);
+    std::vector<uint64_t> buf(cfg.record_size / sizeof(uint64_t));
+    uint64_t start;
+    uint32_t stream;
+    size_t offset;
+    bool write;
+
+    for (int i = 0; i < cfg.iterations; i++) {
+        offset = gen.Next(&stream, &write);
+
+        start = doca::NowNs();
+        if (write) {
+            fill_record(buf.data(), offset, cfg.record_size);
+            worker.result = cache.Write(offset, buf.data(), cfg.record_size);
+        } else {
+            worker.result = cache.Read(offset, buf.data(), cfg.record_size);
+        }
+        if (worker.result != DOCA_SUCCESS) return;
+        worker.latency.Record(doca::NowNs() - start);
+
+        if (!write) worker.mismatches += check_record(buf.data(), offset, cfg.record_size);
+    }
+}
+
+/*
+ * Scans through the prefetcher, single threaded and read only
+ *
+ * @prefetcher [in]: Prefetcher over the host dataset
+ * @data_size [in]: Size of the host dataset
+ * @cfg [in]: Program configuration
+ * @worker [out]: Lookup results
+ */
+static void run_prefetched(doca::Prefetcher &prefetcher, size_t data_size, const struct fm_config &cfg,
+                           struct fm_worker &worker) {
+    AccessGen gen(cfg, data_size, 0);
+    std::vector<uint64_t> buf(cfg.record_size / sizeof(uint64_t));
+    uint64_t start;
+    uint32_t stream;
+    size_t offset;
+    bool write;
+
+    for (int i = 0; i < cfg.iterations; i++) {
+        offset = gen.Next(&stream, &write);
+
+        start = doca::NowNs();
+        worker.result = prefetcher.Read(stream, offset, buf.data(), cfg.record_size);
+        if (worker.result != DOCA_SUCCESS) return;
+        worker.latency.Record(doca::NowNs() - start);
+
+        worker.mismatches += check_record(buf.data(), offset, cfg.record_size);
+    }
+}
+
+/*
+ * Log one phase and append it to the report if it is open
+ *
+ * @report [in]: Result writer
+ * @cfg [in]: Program configuration
+ * @phase [in]: Phase name
+ * @threads [in]: Threads that ran the phase
+ * @elapsed_ns [in]: Wall time of the phase
+ * @latency [in]: Per-lookup latency of all threads
+ * @stats [in]: Cache counters of the phase, NULL if the phase bypassed the cache
+ * @pf_stats [in]: Prefetcher counters of the phase, NULL if the phase bypassed the prefetcher
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t report_phase(doca::ReportWriter &report, const struct fm_config &cfg, const char *phase,
+                                 int threads, uint64_t elapsed_ns, const doca::LatencyHistogram &latency,
+                                 const doca::page_cache_stats *stats, const doca::prefetch_stats *pf_stats) {
+    static const char *patterns[] = {"random", "seq", "stride"};
+    double ops_per_sec = elapsed_ns ? latency.Count() * 1e9 / elapsed_ns : 0.0;
+
+    DOCA_LOG_INFO("%s: %d threads, %.0f lookups/s, p50 %" PRIu64 " ns, p99 %" PRIu64 " ns, max %" PRIu64 " ns",
+                  phase, threads, ops_per_sec, latency.Percentile(50.0), latency.Percentile(99.0), latency.Max());
+    if (stats)
+        DOCA_LOG_INFO("Cache: hit rate %.2f%%, %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions, %" PRIu64
+                      " write-backs, %" PRIu64 " fetch batches, %.1f MB fetched, %.1f MB written",
+                      stats->HitRate() * 100.0, stats->hits, stats->misses, stats->evictions, stats->writebacks,
+                      stats->fetch_batches, stats->fetched_bytes / 1e6, stats->written_bytes / 1e6);
+    if (pf_stats)
+        DOCA_LOG_INFO("Prefetch: accuracy %.2f%%, coverage %.2f%%, %" PRIu64 " issued, %" PRIu64 " hits (%" PRIu64
+                      " late), %" PRIu64 " demand misses, %" PRIu64 " wasted",
+                      pf_stats->Accuracy() * 100.0, pf_stats->Coverage() * 100.0, pf_stats->issued,
+                      pf_stats->prefetch_hits, pf_stats->late_hits, pf_stats->demand_misses, pf_stats->wasted);
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("phase", phase)
+        .Add("threads", (uint64_t)threads)
+        .Add("pattern", patterns[cfg.pattern])
+        .Add("record_size", (uint64_t)cfg.record_size)
+        .Add("page_size", (uint64_t)cfg.cache.page_size)
+        .Add("cache_pages", (uint64_t)cfg.cache.nb_pages)
+        .Add("policy", cfg.cache.policy == doca::CACHE_LRU ? "lru" : "clock")
+        .Add("write_back", (uint64_t)cfg.cache.write_back)
+        .Add("skew", (uint64_t)cfg.skew)
+        .Add("write_pct", (uint64_t)cfg.write_pct)
+        .Add("ops_per_sec", ops_per_sec)
+        .AddHistogram("lat_", latency);
+    /* Same columns on every row for the CSV header, left empty where they do not apply */
+    if (stats)
+        report.Add("hit_rate", stats->HitRate())
+            .Add("evictions", stats->evictions)
+            .Add("writebacks", stats->writebacks)
+            .Add("fetch_batches", stats->fetch_batches)
+            .Add("fetched_bytes", stats->fetched_bytes);
+    else
+        report.Add("hit_rate", "")
+            .Add("evictions", "")
+            .Add("writebacks", "")
+            .Add("fetch_batches", "")
+            .Add("fetched_bytes", "");
+    if (pf_stats)
+        report.Add("pf_accuracy", pf_stats->Accuracy())
+            .Add("pf_coverage", pf_stats->Coverage())
+            .Add("pf_late_hits", pf_stats->late_hits)
+            .Add("pf_wasted", pf_stats->wasted);
+    else
+        report.Add("pf_accuracy", "").Add("pf_coverage", "").Add("pf_late_hits", "").Add("pf_wasted", "");
+    return report.EndRow();
+}
+
+/*
+ * Run the uncached baseline, then the same lookups through the page cache, or
+ * through the prefetcher for the scan patterns
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_lookups(doca::CommChannel<doca::Dpu> &ch, const struct fm_config &cfg) {
+    using namespace doca;
+    ReportWriter report;
+    LatencyHistogram latency;
+    page_cache_stats stats;
+    prefetch_stats pf_stats;
+    uint64_t start, elapsed, mismatches;
+    doca_error_t result;
+
+    if (cfg.pattern != FM_PATTERN_RANDOM && (cfg.threads != 1 || cfg.write_pct != 0)) {
+        DOCA_LOG_ERR("Scan patterns are single threaded and read only");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = local_mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, cfg.record_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+    if (remote_mmap.Len() < cfg.record_size * cfg.prefetch.nb_streams) {
+        DOCA_LOG_ERR("Host dataset of %zu bytes is smaller than one record per stream", remote_mmap.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    struct fm_worker baseline;
+
+    start = NowNs();
+    run_uncached(dma, local_mmap, remote_mmap, cfg, baseline);
+    elapsed = NowNs() - start;
+    if (baseline.result != DOCA_SUCCESS) return baseline.result;
+    result = report_phase(report, cfg, "uncached", 1, elapsed, baseline.latency, nullptr, nullptr);
+    if (result != DOCA_SUCCESS) return result;
+    mismatches = baseline.mismatches;
+
+    if (cfg.pattern != FM_PATTERN_RANDOM) {
+        prefetch_attr attr = cfg.prefetch;
+        struct fm_worker worker;
+
+        attr.slot_size = cfg.record_size;
+        Prefetcher prefetcher(dma, remote_mmap, attr);
+
+        start = NowNs();
+        run_prefetched(prefetcher, remote_mmap.Len(), cfg, worker);
+        elapsed = NowNs() - start;
+        if (worker.result != DOCA_SUCCESS) return worker.result;
+        mismatches += worker.mismatches;
+
+        prefetcher.Snapshot(&pf_stats);
+        result = report_phase(report, cfg, "prefetched", 1, elapsed, worker.latency, nullptr, &pf_stats);
+        if (result != DOCA_SUCCESS) return result;
+    } else {
+        PageCache cache(dma, remote_mmap, cfg.cache);
+        std::vector<struct fm_worker> workers(cfg.threads);
+        std::vector<std::thread> threads;
+
+        start = NowNs();
+        for (int t = 0; t < cfg.threads; t++)
+            threads.emplace_back(run_cached, std::ref(cache), remote_mmap.Len(), std::cref(cfg), t + 1,
+                                 std::ref(workers[t]));
+        for (auto &thread : threads) thread.join();
+        elapsed = NowNs() - start;
+
+        for (auto &w : workers) {
+            if (w.result != DOCA_SUCCESS) return w.result;
+            latency.Merge(w.latency);
+            mismatches += w.mismatches;
+        }
+        cache.Snapshot(&stats);
+        result = report_phase(report, cfg, "cached", cfg.threads, elapsed, latency, &stats, nullptr);
+        if (result != DOCA_SUCCESS) return result;
+
+        result = cache.Flush();
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    if (mismatches > 0) {
+        DOCA_LOG_ERR("%" PRIu64 " words read back with a wrong value", mismatches);
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    dma.Finalize();
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct fm_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_farmem_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_fm_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register far memory server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_lookups(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Far memory run failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
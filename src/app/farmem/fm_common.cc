@@ -0,0 +1,478 @@
+#include "fm_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+
+DOCA_LOG_REGISTER(FM_COMMON);
+
+AccessGen::AccessGen(const struct fm_config &cfg, size_t data_size, uint64_t seed)
+    : cfg(cfg), nb_records(data_size / cfg.record_size), rng(seed) {
+    region = nb_records / cfg.prefetch.nb_streams;
+    cursors.assign(cfg.prefetch.nb_streams, 0);
+}
+
+size_t AccessGen::Next(uint32_t *stream, bool *write) {
+    size_t hot = std::max<size_t>(1, nb_records / 10);
+    size_t record;
+
+    if (cfg.pattern == FM_PATTERN_RANDOM) {
+        record = (int)(rng() % 100) < cfg.skew ? rng() % hot : rng() % nb_records;
+        *write = (int)(rng() % 100) < cfg.write_pct;
+        *stream = 0;
+        return record * cfg.record_size;
+    }
+
+    *stream = turn;
+    *write = false;
+    record = turn * region + cursors[turn];
+    cursors[turn] = (cursors[turn] + (cfg.pattern == FM_PATTERN_SEQ ? 1 : cfg.stride)) % region;
+    turn = (turn + 1) % cursors.size();
+    return record * cfg.record_size;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    const char *dev_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(dev_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_pci_addr, dev_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    const char *rep_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(rep_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device representor PCI address exceeding the maximum size of %d",
+                     DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_rep_pci_addr, rep_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle dataset size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t size_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int size = *(int *)param;
+
+    if (size <= 0) {
+        DOCA_LOG_ERR("Dataset size must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->data_size = (size_t)size << 20;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle lookup record size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t record_size_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int size = *(int *)param;
+
+    if (size <= 0 || size % sizeof(uint64_t) != 0) {
+        DOCA_LOG_ERR("Record size must be a positive multiple of %zu bytes", sizeof(uint64_t));
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->record_size = size;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle cache page size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t page_size_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int size = *(int *)param;
+
+    if (size <= 0) {
+        DOCA_LOG_ERR("Page size must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->cache.page_size = size;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle cache capacity parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t cache_pages_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int pages = *(int *)param;
+
+    if (pages <= 0) {
+        DOCA_LOG_ERR("Cache capacity must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->cache.nb_pages = pages;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle eviction policy parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t policy_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    const char *policy = (char *)param;
+
+    if (strcmp(policy, "clock") == 0)
+        cfg->cache.policy = doca::CACHE_CLOCK;
+    else if (strcmp(policy, "lru") == 0)
+        cfg->cache.policy = doca::CACHE_LRU;
+    else {
+        DOCA_LOG_ERR("Unknown eviction policy %s, expected clock or lru", policy);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle write-back parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t write_back_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+
+    cfg->cache.write_back = *(bool *)param;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle lookups per thread parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t iterations_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int iterations = *(int *)param;
+
+    if (iterations <= 0) {
+        DOCA_LOG_ERR("Iterations must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->iterations = iterations;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle thread count parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t threads_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int threads = *(int *)param;
+
+    if (threads <= 0) {
+        DOCA_LOG_ERR("Thread count must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->threads = threads;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle access skew parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t skew_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int skew = *(int *)param;
+
+    if (skew < 0 || skew > 100) {
+        DOCA_LOG_ERR("Skew must be a percentage");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->skew = skew;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle write percentage parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t write_pct_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int write_pct = *(int *)param;
+
+    if (write_pct < 0 || write_pct > 100) {
+        DOCA_LOG_ERR("Write share must be a percentage");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->write_pct = write_pct;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle access pattern parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pattern_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    const char *pattern = (char *)param;
+
+    if (strcmp(pattern, "random") == 0)
+        cfg->pattern = FM_PATTERN_RANDOM;
+    else if (strcmp(pattern, "seq") == 0)
+        cfg->pattern = FM_PATTERN_SEQ;
+    else if (strcmp(pattern, "stride") == 0)
+        cfg->pattern = FM_PATTERN_STRIDE;
+    else {
+        DOCA_LOG_ERR("Unknown access pattern %s, expected random, seq or stride", pattern);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle scan stride parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t stride_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int stride = *(int *)param;
+
+    if (stride <= 0) {
+        DOCA_LOG_ERR("Stride must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->stride = stride;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle scan streams parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t streams_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int streams = *(int *)param;
+
+    if (streams <= 0) {
+        DOCA_LOG_ERR("Stream count must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->prefetch.nb_streams = streams;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle readahead window limit parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t max_window_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    int window = *(int *)param;
+
+    if (window < (int)cfg->prefetch.min_window) {
+        DOCA_LOG_ERR("Readahead window limit must be at least %u", cfg->prefetch.min_window);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->prefetch.max_window = window;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct fm_config *cfg = (struct fm_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Create and register a single ARGP parameter
+ *
+ * @short_name [in]: Short option name, NULL for none
+ * @long_name [in]: Long option name
+ * @description [in]: Help text
+ * @callback [in]: Parameter callback
+ * @type [in]: Parameter type
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_fm_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("s", "size", "Host dataset size in MiB (host only)", size_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("k", "record-size", "Bytes per lookup, a multiple of 8", record_size_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("P", "page-size", "Cache page size in bytes", page_size_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("n", "cache-pages", "Cache capacity in pages", cache_pages_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("e", "policy", "Eviction policy: clock (default) or lru", policy_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("b", "write-back", "Keep written pages dirty in the cache until evicted or flushed",
+                            write_back_callback, DOCA_ARGP_TYPE_BOOLEAN);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("i", "iterations", "Lookups per thread", iterations_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("t", "threads", "DPU threads sharing the cache", threads_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("z", "skew", "Percent of lookups going to the hottest 10% of the dataset", skew_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("w", "write-pct", "Percent of lookups that are writes", write_pct_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("a", "pattern", "Access pattern: random (default, page cache), seq or stride (prefetcher)",
+                            pattern_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param(NULL, "stride", "Records between accesses of a strided scan", stride_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param(NULL, "streams", "Interleaved scan streams", streams_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param(NULL, "max-window", "Largest readahead window of a scan stream, in reads",
+                            max_window_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise", output_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+
+    return DOCA_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "cache/page_cache.h"
+#include "cache/prefetcher.h"
+
+enum fm_pattern {
+    FM_PATTERN_RANDOM, /* Skewed random lookups, served through the page cache */
+    FM_PATTERN_SEQ,    /* Sequential scans, served through the prefetcher */
+    FM_PATTERN_STRIDE, /* Strided scans, served through the prefetcher */
+};
+
+struct fm_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    size_t data_size = 64UL << 20;                            /* Host dataset exported to the DPU */
+    size_t record_size = 64;                                  /* Bytes read or written by one lookup */
+    enum fm_pattern pattern = FM_PATTERN_RANDOM;              /* Access pattern of the lookups */
+    int stride = 4;                                           /* Records between accesses of a strided scan */
+    doca::page_cache_attr cache;                              /* DPU page cache geometry and policy */
+    doca::prefetch_attr prefetch;                             /* Scan streams and readahead window */
+    int iterations = 100000;                                  /* Lookups per thread */
+    int threads = 1;                                          /* DPU threads sharing the cache */
+    int skew = 90;                                            /* Percent of lookups going to the hottest 10% */
+    int write_pct = 0;                                        /* Percent of lookups that are writes */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/*
+ * Value of the 64-bit word at a byte offset of the dataset. The host fills the
+ * dataset with it, DPU lookups check it and writes store it back unchanged.
+ */
+static inline uint64_t fm_word(size_t offset) {
+    return (uint64_t)offset * 0x9e3779b97f4a7c15ULL;
+}
+
+/*
+ * Offsets of one thread's accesses. Random lookups send skew percent of them
+ * into the first tenth of the dataset; scans split the dataset into one region
+ * per stream and advance the stream cursors round-robin, wrapping at the end
+ * of their region.
+ */
+class AccessGen {
+   public:
+    AccessGen(const struct fm_config &cfg, size_t data_size, uint64_t seed);
+
+    /* Byte offset of the next access, *stream is the scan cursor it belongs to */
+    size_t Next(uint32_t *stream, bool *write);
+
+   protected:
+    const struct fm_config &cfg;
+    size_t nb_records;
+    size_t region; /* Records per scan stream */
+    std::vector<size_t> cursors;
+    uint32_t turn = 0;
+    std::mt19937_64 rng;
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_fm_params(void);
@@ -0,0 +1,345 @@
+#include "lg_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <stdlib.h>
+#include <string.h>
+
+DOCA_LOG_REGISTER(LG_COMMON);
+
+ArrivalSchedule::ArrivalSchedule(enum lg_arrival arrival, uint64_t rate, uint64_t start_ns)
+    : arrival(arrival), mean_gap_ns(1e9 / rate), next(start_ns), next_ns(start_ns), rng(start_ns), exp_gap(1.0) {}
+
+uint64_t ArrivalSchedule::Next() {
+    uint64_t current = next_ns;
+
+    if (arrival == LG_ARRIVAL_POISSON)
+        next += exp_gap(rng) * mean_gap_ns;
+    else
+        next += mean_gap_ns;
+    next_ns = (uint64_t)next;
+
+    return current;
+}
+
+doca_error_t lg_report_rate(doca::ReportWriter &report, const struct lg_config &cfg, uint64_t rate, uint64_t completed,
+                            uint64_t elapsed_ns, const doca::LatencyHistogram &latency) {
+    double achieved = elapsed_ns ? completed * 1e9 / elapsed_ns : 0.0;
+
+    DOCA_LOG_INFO("Offered %" PRIu64 " req/s, achieved %.0f req/s: p50 %" PRIu64 " ns, p99 %" PRIu64
+                  " ns, p99.9 %" PRIu64 " ns, max %" PRIu64 " ns",
+                  rate, achieved, latency.Percentile(50.0), latency.Percentile(99.0), latency.Percentile(99.9),
+                  latency.Max());
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("target", cfg.target == LG_TARGET_DMA ? "dma" : "chan")
+        .Add("arrival", cfg.arrival == LG_ARRIVAL_POISSON ? "poisson" : "constant")
+        .Add("size", (uint64_t)cfg.msg_size)
+        .Add("offered_rps", rate)
+        .Add("achieved_rps", achieved)
+        .AddHistogram("lat_", latency);
+    return report.EndRow();
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *dev_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(dev_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_pci_addr, dev_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *rep_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(rep_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device representor PCI address exceeding the maximum size of %d",
+                     DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_rep_pci_addr, rep_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle target path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t target_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *target = (char *)param;
+
+    if (strcmp(target, "chan") == 0)
+        cfg->target = LG_TARGET_CHAN;
+    else if (strcmp(target, "dma") == 0)
+        cfg->target = LG_TARGET_DMA;
+    else {
+        DOCA_LOG_ERR("Unknown target %s, expected chan or dma", target);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle arrival process parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t arrival_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *arrival = (char *)param;
+
+    if (strcmp(arrival, "poisson") == 0)
+        cfg->arrival = LG_ARRIVAL_POISSON;
+    else if (strcmp(arrival, "constant") == 0)
+        cfg->arrival = LG_ARRIVAL_CONSTANT;
+    else {
+        DOCA_LOG_ERR("Unknown arrival process %s, expected poisson or constant", arrival);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle request size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t size_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    int size = *(int *)param;
+
+    if (size < (int)sizeof(struct lg_msg_hdr)) {
+        DOCA_LOG_ERR("Request size must be at least %zu bytes", sizeof(struct lg_msg_hdr));
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->msg_size = size;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle comma separated list of offered rates
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rates_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *str = (char *)param;
+    char *end;
+
+    cfg->rates.clear();
+    while (*str != '\0') {
+        unsigned long long rate = strtoull(str, &end, 10);
+        if (end == str || rate == 0 || (*end != ',' && *end != '\0')) {
+            DOCA_LOG_ERR("Invalid rate list %s, expected positive integers separated by commas", (char *)param);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        cfg->rates.push_back(rate);
+        str = *end == ',' ? end + 1 : end;
+    }
+
+    if (cfg->rates.empty()) {
+        DOCA_LOG_ERR("Rate list is empty");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle measured duration parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t duration_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    int duration = *(int *)param;
+
+    if (duration <= 0) {
+        DOCA_LOG_ERR("Duration must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->duration_ms = duration;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle warmup duration parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t warmup_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    int warmup = *(int *)param;
+
+    if (warmup < 0) {
+        DOCA_LOG_ERR("Warmup must not be negative");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->warmup_ms = warmup;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Validation - Check flags against each other once all are parsed
+ *
+ * @config [in]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t lg_validate(void *config) {
+    struct lg_config *cfg = (struct lg_config *)config;
+
+    /* A DMA job may be larger, a Comm Channel request has to fit one message */
+    if (cfg->target == LG_TARGET_CHAN && cfg->msg_size > CC_MAX_MSG_SIZE) {
+        DOCA_LOG_ERR("Comm Channel request size must be at most %d bytes", CC_MAX_MSG_SIZE);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Create and register a single ARGP parameter
+ *
+ * @short_name [in]: Short option name, NULL for none
+ * @long_name [in]: Long option name
+ * @description [in]: Help text
+ * @callback [in]: Parameter callback
+ * @type [in]: Parameter type
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_lg_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("t", "target", "Path under load: chan (default) or dma", target_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("a", "arrival", "Arrival process: poisson (default) or constant", arrival_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("s", "size", "Comm Channel message or DMA job size in bytes", size_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("R", "rates", "Comma separated offered loads in requests per second", rates_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("d", "duration", "Measured milliseconds per rate", duration_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("w", "warmup", "Unmeasured milliseconds at the start of every rate", warmup_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise", output_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = doca_argp_register_validation_callback(lg_validate);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register validation callback: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "stats/histogram.h"
+#include "stats/report.h"
+
+#define LG_SEQ_STOP UINT64_MAX /* Sequence number of the message ending a Comm Channel run */
+
+enum lg_target {
+    LG_TARGET_CHAN, /* Host sends requests, DPU echoes them over Comm Channel */
+    LG_TARGET_DMA,  /* DPU issues DMA writes into exported host memory */
+};
+
+enum lg_arrival {
+    LG_ARRIVAL_CONSTANT, /* Fixed inter-arrival gap of 1 / rate */
+    LG_ARRIVAL_POISSON,  /* Exponentially distributed gaps with mean 1 / rate */
+};
+
+struct lg_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    enum lg_target target = LG_TARGET_CHAN;                   /* Path under load */
+    enum lg_arrival arrival = LG_ARRIVAL_POISSON;             /* Arrival process */
+    size_t msg_size = 64;                                     /* Comm Channel message or DMA job size */
+    std::vector<uint64_t> rates = {10000};                    /* Offered loads to sweep, requests per second */
+    int duration_ms = 1000;                                   /* Measured time per rate */
+    int warmup_ms = 100;                                      /* Unmeasured time at the start of every rate */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/* Header at the start of every Comm Channel request, echoed back unchanged */
+struct lg_msg_hdr {
+    uint64_t seq;         /* Request number, LG_SEQ_STOP ends the run */
+    uint64_t intended_ns; /* Time the request was scheduled to be sent */
+};
+
+/*
+ * Generates intended send times. Latency is measured from these times rather
+ * than from the actual send, so a stalled sender is charged for the requests
+ * it failed to issue on time instead of hiding them (coordinated omission).
+ */
+class ArrivalSchedule {
+   public:
+    ArrivalSchedule(enum lg_arrival arrival, uint64_t rate, uint64_t start_ns);
+
+    uint64_t Peek() const { return next_ns; }
+    uint64_t Next();
+
+   protected:
+    enum lg_arrival arrival;
+    double mean_gap_ns;
+    double next;
+    uint64_t next_ns;
+    std::mt19937_64 rng;
+    std::exponential_distribution<double> exp_gap;
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_lg_params(void);
+
+/*
+ * Log one point of the throughput-latency curve and append it to the report if it is open
+ *
+ * @report [in]: Result writer
+ * @cfg [in]: Program configuration
+ * @rate [in]: Offered load in requests per second
+ * @completed [in]: Measured requests that completed
+ * @elapsed_ns [in]: Time from the start of the measured window to the last measured completion
+ * @latency [in]: Latency of measured requests, taken from their intended send time
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t lg_report_rate(doca::ReportWriter &report, const struct lg_config &cfg, uint64_t rate, uint64_t completed,
+                            uint64_t elapsed_ns, const doca::LatencyHistogram &latency);
@@ -0,0 +1,181 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "lg_common.h"
+#include "stats/clock.h"
+
+DOCA_LOG_REGISTER(LG_CLIENT::MAIN);
+
+const char *server_name = "doca_loadgen_server";
+
+/*
+ * Drive one offered rate open loop against the DPU echo server. Requests are sent at their scheduled time
+ * whenever the send queue allows it and responses are polled in between, so a slow server shows up as
+ * latency instead of throttling the sender.
+ *
+ * @ch [in]: Connected Comm Channel
+ * @send_buf [in]: Request buffer, msg_size long
+ * @recv_buf [in]: Response buffer, msg_size long
+ * @cfg [in]: Program configuration
+ * @rate [in]: Offered load in requests per second
+ * @report [in]: Result writer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_chan_rate(doca::CommEndpoint &ch, char *send_buf, char *recv_buf, const struct lg_config &cfg,
+                                  uint64_t rate, doca::ReportWriter &report) {
+    doca::LatencyHistogram latency;
+    doca_error_t result;
+    uint64_t start = doca::NowNs();
+    uint64_t measure_start = start + (uint64_t)cfg.warmup_ms * 1000000;
+    uint64_t measure_end = measure_start + (uint64_t)cfg.duration_ms * 1000000;
+    uint64_t seq = 0, outstanding = 0, completed = 0, last_completion = measure_end, now;
+    struct lg_msg_hdr *req = (struct lg_msg_hdr *)send_buf;
+    struct lg_msg_hdr *resp = (struct lg_msg_hdr *)recv_buf;
+    ArrivalSchedule schedule(cfg.arrival, rate, start);
+    size_t msg_len;
+
+    while (schedule.Peek() < measure_end || outstanding > 0) {
+        now = doca::NowNs();
+        if (schedule.Peek() < measure_end && now >= schedule.Peek()) {
+            req->seq = seq;
+            req->intended_ns = schedule.Peek();
+            result = ch.TrySendTo(send_buf, cfg.msg_size);
+            if (result == DOCA_SUCCESS) {
+                schedule.Next();
+                seq++;
+                outstanding++;
+            } else if (result != DOCA_ERROR_AGAIN) {
+                DOCA_LOG_ERR("Failed to send request: %s", doca_get_error_string(result));
+                return result;
+            }
+        }
+
+        msg_len = cfg.msg_size;
+        result = ch.TryRecvFrom(recv_buf, &msg_len);
+        if (result == DOCA_ERROR_AGAIN) continue;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive response: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        now = doca::NowNs();
+        outstanding--;
+        if (resp->intended_ns < measure_start) continue;
+        latency.Record(now - resp->intended_ns);
+        completed++;
+        if (now > last_completion) last_completion = now;
+    }
+
+    return lg_report_rate(report, cfg, rate, completed, last_completion - measure_start, latency);
+}
+
+/*
+ * Sweep all configured rates over Comm Channel, then stop the echo server
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_chan(doca::CommEndpoint &ch, const struct lg_config &cfg) {
+    doca::ReportWriter report;
+    doca_error_t result = DOCA_SUCCESS;
+    char *send_buf, *recv_buf;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    send_buf = new char[cfg.msg_size];
+    recv_buf = new char[cfg.msg_size];
+    memset(send_buf, 0, cfg.msg_size);
+
+    for (uint64_t rate : cfg.rates) {
+        result = run_chan_rate(ch, send_buf, recv_buf, cfg, rate, report);
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    ((struct lg_msg_hdr *)send_buf)->seq = LG_SEQ_STOP;
+    if (result == DOCA_SUCCESS) result = ch.SendTo(send_buf, cfg.msg_size);
+    if (result == DOCA_SUCCESS) result = ch.WaitForSuccessfulMsg();
+
+    delete[] send_buf;
+    delete[] recv_buf;
+    return result;
+}
+
+/*
+ * Export a host buffer for the DPU DMA generator and wait until it is done
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_dma(doca::CommChannel<doca::Host> &ch, const struct lg_config &cfg) {
+    using namespace doca;
+    doca_error_t result;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, cfg.msg_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    return ch.WaitForSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct lg_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_loadgen_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_lg_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register load generator client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    if (cfg.target == LG_TARGET_DMA)
+        result = run_dma(ch, cfg);
+    else
+        result = run_chan(ch, cfg);
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
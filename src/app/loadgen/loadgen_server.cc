@@ -0,0 +1,180 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "lg_common.h"
+#include "stats/clock.h"
+
+DOCA_LOG_REGISTER(LG_SERVER::MAIN);
+
+const char *server_name = "doca_loadgen_server";
+
+/*
+ * Echo Comm Channel requests back to the host until the stop message arrives
+ *
+ * @ch [in]: Connected Comm Channel
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_chan(doca::CommEndpoint &ch) {
+    doca_error_t result;
+    char *buf = new char[CC_MAX_MSG_SIZE];
+    size_t msg_len;
+
+    for (;;) {
+        msg_len = CC_MAX_MSG_SIZE;
+        result = ch.RecvFrom(buf, &msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive request: %s", doca_get_error_string(result));
+            break;
+        }
+        if (((struct lg_msg_hdr *)buf)->seq == LG_SEQ_STOP) {
+            result = ch.SendSuccessfulMsg();
+            break;
+        }
+
+        result = ch.SendTo(buf, msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send response: %s", doca_get_error_string(result));
+            break;
+        }
+    }
+
+    delete[] buf;
+    return result;
+}
+
+/*
+ * Drive one offered rate open loop against host memory. A job that cannot be submitted because the work
+ * queue is full stays due and is charged for the wait, since latency is taken from its intended time.
+ *
+ * @dma [in]: Started DMA context
+ * @local [in]: Local source buffer
+ * @remote [in]: Host destination buffer
+ * @cfg [in]: Program configuration
+ * @rate [in]: Offered load in jobs per second
+ * @report [in]: Result writer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_dma_rate(doca::DOCADma<doca::Dpu> &dma, doca::MemMap &local, doca::MemMap &remote,
+                                 const struct lg_config &cfg, uint64_t rate, doca::ReportWriter &report) {
+    doca::LatencyHistogram latency;
+    doca_error_t result;
+    uint64_t start = doca::NowNs();
+    uint64_t measure_start = start + (uint64_t)cfg.warmup_ms * 1000000;
+    uint64_t measure_end = measure_start + (uint64_t)cfg.duration_ms * 1000000;
+    uint64_t completed = 0, last_completion = measure_end, now, intended;
+    ArrivalSchedule schedule(cfg.arrival, rate, start);
+    void *user_data;
+
+    while (schedule.Peek() < measure_end || dma.Inflight() > 0) {
+        now = doca::NowNs();
+        while (schedule.Peek() < measure_end && now >= schedule.Peek()) {
+            result = dma.Submit(local, 0, remote, 0, cfg.msg_size, (void *)(uintptr_t)schedule.Peek());
+            if (result == DOCA_ERROR_AGAIN) break;
+            if (result != DOCA_SUCCESS) return result;
+            schedule.Next();
+        }
+
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) continue;
+        if (result != DOCA_SUCCESS) return result;
+
+        now = doca::NowNs();
+        intended = (uint64_t)(uintptr_t)user_data;
+        if (intended < measure_start) continue;
+        latency.Record(now - intended);
+        completed++;
+        if (now > last_completion) last_completion = now;
+    }
+
+    return lg_report_rate(report, cfg, rate, completed, last_completion - measure_start, latency);
+}
+
+/*
+ * Map the exported host buffer and sweep all configured rates with DMA writes into it
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_dma(doca::CommChannel<doca::Dpu> &ch, const struct lg_config &cfg) {
+    using namespace doca;
+    ReportWriter report;
+    doca_error_t result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = local_mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, cfg.msg_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    for (uint64_t rate : cfg.rates) {
+        result = run_dma_rate(dma, local_mmap, remote_mmap, cfg, rate, report);
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+    dma.Finalize();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct lg_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_loadgen_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_lg_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register load generator server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    if (cfg.target == LG_TARGET_DMA)
+        result = run_dma(ch, cfg);
+    else
+        result = run_chan(ch);
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,169 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "ms_common.h"
+#include "stats/clock.h"
+
+DOCA_LOG_REGISTER(MS_CLIENT::MAIN);
+
+const char *server_name = "doca_memsync_server";
+
+/*
+ * Write one round's values into clusters of random pages, dirty_pct percent of the region in total
+ *
+ * @region [in]: Exported host region
+ * @tracker [in]: Dirty page tracker of the region
+ * @cfg [in]: Program configuration
+ * @round [in]: Round number, part of the values written
+ * @rng [in]: Random generator picking the clusters
+ * @return: Pages written, counting pages hit by more than one cluster once per hit
+ */
+static size_t dirty_round(doca::MemMap &region, doca::DirtyTracker &tracker, const struct ms_config &cfg, int round,
+                          std::mt19937_64 &rng) {
+    size_t nb_pages = (region.Len() + cfg.page_size - 1) / cfg.page_size;
+    size_t target = nb_pages * cfg.dirty_pct / 100, written = 0;
+    uint64_t *words = (uint64_t *)region.Data();
+    size_t first, last, start, end;
+
+    while (written < target) {
+        first = rng() % nb_pages;
+        last = std::min(first + cfg.cluster, nb_pages);
+        start = first * cfg.page_size;
+        end = std::min(last * cfg.page_size, region.Len());
+
+        for (size_t off = start; off < end; off += sizeof(uint64_t)) words[off / sizeof(uint64_t)] = ms_word(off, round);
+        /* Soft-dirty tracking finds the pages on its own */
+        if (cfg.mode == doca::DIRTY_TRACK_EXPLICIT) tracker.MarkDirty(start, end - start);
+        written += last - first;
+    }
+    return written;
+}
+
+/*
+ * Export the region, then dirty part of it and sync it to the DPU mirror every round
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_region(doca::CommChannel<doca::Host> &ch, const struct ms_config &cfg) {
+    using namespace doca;
+    std::mt19937_64 rng(0);
+    dirty_sync_stats stats;
+    doca_error_t result;
+    uint64_t *words, start, elapsed, checksum;
+    size_t pages;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, cfg.region_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    words = (uint64_t *)mmap.Data();
+    for (size_t i = 0; i < cfg.region_size / sizeof(uint64_t); i++) words[i] = ms_word(i * sizeof(uint64_t), 0);
+
+    /* Before the export, an unavailable tracking mode is reported to the DPU instead of the descriptor */
+    std::unique_ptr<DirtyTracker> tracker_owner;
+    try {
+        tracker_owner.reset(new DirtyTracker(mmap, cfg.page_size, cfg.mode));
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Dirty tracking setup failed: %s", e.what());
+        ch.SendFailMsg();
+        return DOCA_ERROR_NOT_SUPPORTED;
+    }
+    DirtyTracker &tracker = *tracker_owner;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    for (int round = 0; round <= cfg.rounds; round++) {
+        /* Round 0 is the initial full copy, every page starts dirty */
+        pages = round == 0 ? tracker.DirtyPages() : dirty_round(mmap, tracker, cfg, round, rng);
+
+        start = NowNs();
+        result = tracker.Sync(ch);
+        if (result != DOCA_SUCCESS) return result;
+        elapsed = NowNs() - start;
+
+        checksum = ms_checksum(mmap.Data(), mmap.Len());
+        result = ch.SendTo(&checksum, sizeof(checksum));
+        if (result != DOCA_SUCCESS) return result;
+        result = ch.WaitForSuccessfulMsg();
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("DPU mirror differs from the region after round %d", round);
+            return result;
+        }
+        DOCA_LOG_INFO("Round %d: %zu pages written, synced in %.1f us", round, pages, elapsed / 1e3);
+    }
+
+    result = tracker.Close(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    tracker.Snapshot(&stats);
+    DOCA_LOG_INFO("%" PRIu64 " syncs of %" PRIu64 " dirty pages, %" PRIu64 " bitmap messages of %" PRIu64
+                  " bytes in total, mirror verified after every sync",
+                  stats.syncs, stats.dirty_pages, stats.messages, stats.wire_bytes);
+    return DOCA_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct ms_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_memsync_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_ms_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register memory sync client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_region(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Memory sync run failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
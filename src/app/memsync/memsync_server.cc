@@ -0,0 +1,161 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "ms_common.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(MS_SERVER::MAIN);
+
+const char *server_name = "doca_memsync_server";
+
+/*
+ * Log one sync and append it to the report if it is open
+ *
+ * @report [in]: Result writer
+ * @cfg [in]: Program configuration
+ * @round [in]: Round number, 0 for the initial full copy
+ * @stats [in]: Mirror counters of the sync
+ * @region_size [in]: Size of the mirrored region
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t report_round(doca::ReportWriter &report, const struct ms_config &cfg, int round,
+                                 const doca::dirty_sync_stats &stats, size_t region_size) {
+    double copied_pct = region_size ? stats.copied_bytes * 100.0 / region_size : 0.0;
+    double mb_per_sec = stats.busy_ns ? stats.copied_bytes * 1e3 / stats.busy_ns : 0.0;
+
+    DOCA_LOG_INFO("Round %d: %" PRIu64 " dirty pages in %" PRIu64 " DMA jobs, %.1f MB copied (%.1f%% of the region), "
+                  "%" PRIu64 " bitmap bytes in %" PRIu64 " messages, %.1f us, %.0f MB/s",
+                  round, stats.dirty_pages, stats.dma_jobs, stats.copied_bytes / 1e6, copied_pct, stats.wire_bytes,
+                  stats.messages, stats.busy_ns / 1e3, mb_per_sec);
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("round", (uint64_t)round)
+        .Add("merge_gap", (uint64_t)cfg.mirror.merge_gap)
+        .Add("dirty_pages", stats.dirty_pages)
+        .Add("messages", stats.messages)
+        .Add("wire_bytes", stats.wire_bytes)
+        .Add("dma_jobs", stats.dma_jobs)
+        .Add("copied_bytes", stats.copied_bytes)
+        .Add("copied_pct", copied_pct)
+        .Add("sync_ns", stats.busy_ns)
+        .Add("mb_per_sec", mb_per_sec);
+    return report.EndRow();
+}
+
+/*
+ * Mirror the host region and apply its syncs until the host closes, checking the mirror after each
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_mirror(doca::CommChannel<doca::Dpu> &ch, const struct ms_config &cfg) {
+    using namespace doca;
+    ReportWriter report;
+    dirty_sync_stats stats;
+    uint64_t checksum;
+    size_t msg_len;
+    bool closed = false;
+    doca_error_t result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap mirror_mmap;
+
+    result = dma.Init(mirror_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    /* The host reports whether its tracking mode works before it sends the descriptor */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Host could not set up dirty tracking");
+        return result;
+    }
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mirror_mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, remote_mmap.Len());
+    if (result != DOCA_SUCCESS) return result;
+
+    DirtyMirror mirror(dma, remote_mmap, mirror_mmap, cfg.mirror);
+
+    for (int round = 0;; round++) {
+        result = mirror.ServeSync(ch, &closed);
+        if (result != DOCA_SUCCESS || closed) break;
+        mirror.Snapshot(&stats);
+        mirror.ResetStats();
+
+        msg_len = sizeof(checksum);
+        result = ch.RecvFrom(&checksum, &msg_len);
+        if (result != DOCA_SUCCESS) break;
+        if (checksum != ms_checksum(mirror_mmap.Data(), remote_mmap.Len())) {
+            DOCA_LOG_ERR("Mirror checksum mismatch after round %d", round);
+            ch.SendFailMsg();
+            result = DOCA_ERROR_IO_FAILED;
+            break;
+        }
+        result = ch.SendSuccessfulMsg();
+        if (result != DOCA_SUCCESS) break;
+
+        result = report_round(report, cfg, round, stats, remote_mmap.Len());
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    dma.Finalize();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct ms_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_memsync_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_ms_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register memory sync server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_mirror(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Memory sync run failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,303 @@
+#include "ms_common.h"
+
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+DOCA_LOG_REGISTER(MS_COMMON);
+
+uint64_t ms_checksum(const char *data, size_t len) {
+    const uint64_t *words = (const uint64_t *)data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < len / sizeof(uint64_t); i++) hash = (hash ^ words[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pci_addr_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    const char *dev_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(dev_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device PCI address exceeding the maximum size of %d", DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_pci_addr, dev_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle Comm Channel DOCA device representor PCI address parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rep_pci_addr_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    const char *rep_pci_addr = (char *)param;
+    int len;
+
+    len = strnlen(rep_pci_addr, DOCA_DEVINFO_PCI_ADDR_SIZE);
+    /* Check using >= to make static code analysis satisfied */
+    if (len >= DOCA_DEVINFO_PCI_ADDR_SIZE) {
+        DOCA_LOG_ERR("Entered device representor PCI address exceeding the maximum size of %d",
+                     DOCA_DEVINFO_PCI_ADDR_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* The string will be '\0' terminated due to the strnlen check above */
+    strncpy(cfg->cc_dev_rep_pci_addr, rep_pci_addr, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle region size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t size_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Region size must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->region_size = (size_t)value << 20;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle dirty page size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t page_size_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0 || value % sizeof(uint64_t) != 0) {
+        DOCA_LOG_ERR("Page size must be a positive multiple of 8 bytes");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->page_size = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle sync rounds parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rounds_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value < 0) {
+        DOCA_LOG_ERR("Round count must not be negative");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->rounds = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle dirty percentage parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dirty_pct_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value < 0 || value > 100) {
+        DOCA_LOG_ERR("Dirty percentage must be within [0, 100]");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->dirty_pct = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle dirty cluster parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t cluster_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value <= 0) {
+        DOCA_LOG_ERR("Cluster size must be positive");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->cluster = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle dirty tracking mode parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t mode_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    const char *mode = (char *)param;
+
+    if (strcmp(mode, "explicit") == 0)
+        cfg->mode = doca::DIRTY_TRACK_EXPLICIT;
+    else if (strcmp(mode, "soft-dirty") == 0)
+        cfg->mode = doca::DIRTY_TRACK_SOFT_DIRTY;
+    else {
+        DOCA_LOG_ERR("Unknown tracking mode %s, expected explicit or soft-dirty", mode);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle merge gap parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t merge_gap_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    int value = *(int *)param;
+
+    if (value < 0) {
+        DOCA_LOG_ERR("Merge gap must not be negative");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    cfg->mirror.merge_gap = value;
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle result file path parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    struct ms_config *cfg = (struct ms_config *)config;
+    const char *path = (char *)param;
+    int len;
+
+    len = strnlen(path, MAX_ARG_SIZE);
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered output path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    strncpy(cfg->output_path, path, len + 1);
+
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Create and register a single ARGP parameter
+ *
+ * @short_name [in]: Short option name, NULL for none
+ * @long_name [in]: Long option name
+ * @description [in]: Help text
+ * @callback [in]: Parameter callback
+ * @type [in]: Parameter type
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_param(const char *short_name, const char *long_name, const char *description,
+                                   callback_func callback, enum doca_argp_type type) {
+    struct doca_argp_param *param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (short_name) doca_argp_param_set_short_name(param, short_name);
+    doca_argp_param_set_long_name(param, long_name);
+    doca_argp_param_set_description(param, description);
+    doca_argp_param_set_callback(param, callback);
+    doca_argp_param_set_type(param, type);
+    result = doca_argp_register_param(param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t register_ms_params(void) {
+    doca_error_t result;
+
+    result = register_param("p", "pci-addr", "DOCA Comm Channel device PCI address", pci_addr_callback,
+                            DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("r", "rep-pci", "DOCA Comm Channel device representor PCI address (needed only on DPU)",
+                            rep_pci_addr_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("s", "size", "Host region size in MiB (host only)", size_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("P", "page-size", "Dirty tracking page size in bytes (host only)", page_size_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("i", "rounds", "Incremental syncs after the initial full copy (host only)",
+                            rounds_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("d", "dirty-pct", "Percent of the pages written per round (host only)",
+                            dirty_pct_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("c", "cluster", "Consecutive pages written together (host only)", cluster_callback,
+                            DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("m", "mode", "Dirty tracking: explicit (default) or soft-dirty (host only)",
+                            mode_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("g", "merge-gap", "Clean pages one DMA job may span to join two dirty runs (DPU only)",
+                            merge_gap_callback, DOCA_ARGP_TYPE_INT);
+    if (result != DOCA_SUCCESS) return result;
+    result = register_param("o", "output", "Result file, JSON if it ends in .json, CSV otherwise (DPU only)",
+                            output_callback, DOCA_ARGP_TYPE_STRING);
+    if (result != DOCA_SUCCESS) return result;
+
+    return DOCA_SUCCESS;
+}
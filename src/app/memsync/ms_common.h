@@ -0,0 +1,44 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include "chan/comm_channel.h"
+#include "sync/dirty_sync.h"
+
+struct ms_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    size_t region_size = 64UL << 20;                          /* Host region mirrored to the DPU */
+    size_t page_size = 4096;                                  /* Dirty tracking granularity */
+    int rounds = 10;                                          /* Incremental syncs after the initial full one */
+    int dirty_pct = 5;                                        /* Percent of the pages written per round */
+    int cluster = 8;                                          /* Consecutive pages written together */
+    doca::dirty_track_mode mode = doca::DIRTY_TRACK_EXPLICIT; /* How the host finds dirty pages */
+    doca::dirty_mirror_attr mirror;                           /* DPU copy merging */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/*
+ * Value of the 64-bit word at a byte offset of the region after a round. The
+ * host writes it into the pages it dirties, round 0 fills the whole region.
+ */
+static inline uint64_t ms_word(size_t offset, int round) {
+    return ((uint64_t)offset + ((uint64_t)round << 48)) * 0x9e3779b97f4a7c15ULL;
+}
+
+/*
+ * Checksum of a region, compared between the host and its DPU mirror after every sync
+ *
+ * @data [in]: Region contents
+ * @len [in]: Region size, a multiple of 8
+ * @return: 64-bit checksum
+ */
+uint64_t ms_checksum(const char *data, size_t len);
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_ms_params(void);
@@ -0,0 +1,335 @@
+#include <benchmark/benchmark.h>
+#include <doca_buf.h>
+#include <doca_buf_inventory.h>
+#include <doca_ctx.h>
+#include <doca_dma.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <doca_mmap.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "dev/registry.h"
+#include "dma/dma.h"
+#include "mem/mem.h"
+
+/*
+ * Per-call cost of the DOCA primitives under the doca-harness wrappers, and of
+ * the wrappers themselves. Runs in one process on the DPU side: every mmap is
+ * local, so DMA jobs copy between two local buffers. DMA benchmarks are timed
+ * on the wall clock, as the device (or emulation thread) does the copy. Sizes
+ * are bytes; all Google Benchmark flags (--benchmark_filter,
+ * --benchmark_format=json, ...) apply.
+ */
+
+DOCA_LOG_REGISTER(MICROBENCH);
+
+using namespace doca;
+
+#define BUF_SIZE_MAX (1 << 20) /* Largest job and buffer size */
+
+/* DMA context, work queue and two started local mmaps, built with the raw DOCA calls of dma_server_flat */
+class RawDma {
+   public:
+    std::shared_ptr<DOCADevice> dev;
+    struct doca_dma *dma_ctx = nullptr;
+    struct doca_ctx *ctx = nullptr;
+    struct doca_workq *workq = nullptr;
+    struct doca_buf_inventory *buf_inv = nullptr;
+    struct doca_mmap *mmaps[2] = {};
+    std::vector<char> buffers[2];
+
+    RawDma() {
+        try {
+            Setup();
+        } catch (const std::runtime_error &) {
+            /* No destructor runs for a partly constructed fixture */
+            Teardown();
+            throw;
+        }
+    }
+
+    ~RawDma() { Teardown(); }
+
+    /* Source and destination buffers of size bytes for a memcpy job */
+    void GetBufs(size_t size, struct doca_buf **src, struct doca_buf **dst) {
+        Check(doca_buf_inventory_buf_by_addr(buf_inv, mmaps[0], buffers[0].data(), size, src), "get source buf");
+        Check(doca_buf_inventory_buf_by_addr(buf_inv, mmaps[1], buffers[1].data(), size, dst), "get dest buf");
+        Check(doca_buf_set_data(*src, buffers[0].data(), size), "set source data");
+    }
+
+    static void Check(doca_error_t result, const char *what) {
+        if (result == DOCA_SUCCESS) return;
+        DOCA_LOG_ERR("Failed to %s: %s", what, doca_get_error_string(result));
+        throw std::runtime_error(what);
+    }
+
+   private:
+    /* Setup steps reached, Teardown undoes exactly those */
+    bool dev_added = false;
+    bool ctx_started = false;
+    bool workq_added = false;
+
+    void Setup() {
+        dev = DeviceRegistry::Instance().GetByCap(check_dev_dma_capable);
+        if (!dev) throw std::runtime_error("Failed to open DOCA DMA capable device");
+
+        Check(doca_buf_inventory_create(NULL, 2 + 2 * WORKQ_DEPTH, DOCA_BUF_EXTENSION_NONE, &buf_inv),
+              "create buffer inventory");
+        Check(doca_buf_inventory_start(buf_inv), "start buffer inventory");
+        Check(doca_dma_create(&dma_ctx), "create DMA engine");
+        ctx = doca_dma_as_ctx(dma_ctx);
+        Check(doca_workq_create(WORKQ_DEPTH, &workq), "create work queue");
+        Check(doca_ctx_dev_add(ctx, dev->dev), "add device to DMA context");
+        dev_added = true;
+        Check(doca_ctx_start(ctx), "start DMA context");
+        ctx_started = true;
+        Check(doca_ctx_workq_add(ctx, workq), "add work queue to DMA context");
+        workq_added = true;
+
+        for (int i = 0; i < 2; i++) {
+            buffers[i].resize(BUF_SIZE_MAX);
+            Check(doca_mmap_create(nullptr, &mmaps[i]), "create mmap");
+            Check(doca_mmap_dev_add(mmaps[i], dev->dev), "add device to mmap");
+            Check(doca_mmap_set_permissions(mmaps[i], DOCA_ACCESS_LOCAL_READ_WRITE), "set mmap permissions");
+            Check(doca_mmap_set_memrange(mmaps[i], buffers[i].data(), BUF_SIZE_MAX), "set mmap memrange");
+            Check(doca_mmap_start(mmaps[i]), "start mmap");
+        }
+    }
+
+    void Teardown() {
+        for (int i = 0; i < 2; i++)
+            if (mmaps[i]) doca_mmap_destroy(mmaps[i]);
+        if (workq_added) doca_ctx_workq_rm(ctx, workq);
+        if (ctx_started) doca_ctx_stop(ctx);
+        if (dev_added) doca_ctx_dev_rm(ctx, dev->dev);
+        if (workq) doca_workq_destroy(workq);
+        if (dma_ctx) doca_dma_destroy(dma_ctx);
+        if (buf_inv) doca_buf_inventory_destroy(buf_inv);
+    }
+};
+
+/* Fixture construction fails without a device; report it as a skipped benchmark */
+#define MICROBENCH_SETUP(state, decl)        \
+    std::unique_ptr<decl> fixture;           \
+    try {                                    \
+        fixture = std::make_unique<decl>();  \
+    } catch (const std::runtime_error &e) {  \
+        state.SkipWithError(e.what());       \
+        return;                              \
+    }
+
+/* Take and release a buffer over a region of the given size */
+static void BM_BufInventoryBufByAddr(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    size_t size = state.range(0);
+    struct doca_buf *buf;
+
+    for (auto _ : state) {
+        doca_buf_inventory_buf_by_addr(fixture->buf_inv, fixture->mmaps[0], fixture->buffers[0].data(), size, &buf);
+        doca_buf_refcount_rm(buf, NULL);
+    }
+}
+BENCHMARK(BM_BufInventoryBufByAddr)->RangeMultiplier(16)->Range(64, BUF_SIZE_MAX);
+
+/* Data pointer round trip, done for every DmaCopy */
+static void BM_BufGetSetData(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    struct doca_buf *buf;
+    void *data;
+
+    RawDma::Check(doca_buf_inventory_buf_by_addr(fixture->buf_inv, fixture->mmaps[0], fixture->buffers[0].data(),
+                                                 BUF_SIZE_MAX, &buf),
+                  "get buf");
+    for (auto _ : state) {
+        doca_buf_get_data(buf, &data);
+        doca_buf_set_data(buf, data, 4096);
+        benchmark::DoNotOptimize(data);
+    }
+    doca_buf_refcount_rm(buf, NULL);
+}
+BENCHMARK(BM_BufGetSetData);
+
+/* Submission alone: the queue is drained with the timer paused every WORKQ_DEPTH jobs */
+static void BM_WorkqSubmit(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    size_t size = state.range(0);
+    struct doca_dma_job_memcpy job = {};
+    struct doca_buf *src, *dst;
+    struct doca_event event;
+    uint32_t inflight = 0;
+
+    fixture->GetBufs(size, &src, &dst);
+    job.base.type = DOCA_DMA_JOB_MEMCPY;
+    job.base.flags = DOCA_JOB_FLAGS_NONE;
+    job.base.ctx = fixture->ctx;
+    job.src_buff = src;
+    job.dst_buff = dst;
+
+    for (auto _ : state) {
+        if (doca_workq_submit(fixture->workq, &job.base) != DOCA_SUCCESS) {
+            state.SkipWithError("Failed to submit DMA job");
+            break;
+        }
+        if (++inflight < WORKQ_DEPTH) continue;
+        state.PauseTiming();
+        for (; inflight > 0; inflight--)
+            while (doca_workq_progress_retrieve(fixture->workq, &event, DOCA_WORKQ_RETRIEVE_FLAGS_NONE) ==
+                   DOCA_ERROR_AGAIN)
+                ;
+        state.ResumeTiming();
+    }
+    for (; inflight > 0; inflight--)
+        while (doca_workq_progress_retrieve(fixture->workq, &event, DOCA_WORKQ_RETRIEVE_FLAGS_NONE) == DOCA_ERROR_AGAIN)
+            ;
+    doca_buf_refcount_rm(src, NULL);
+    doca_buf_refcount_rm(dst, NULL);
+}
+BENCHMARK(BM_WorkqSubmit)->RangeMultiplier(16)->Range(64, BUF_SIZE_MAX)->UseRealTime();
+
+/* Registration of an already allocated region: memrange and start, create and destroy untimed */
+static void BM_MmapStart(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    std::vector<char> region(state.range(0));
+    struct doca_mmap *mmap;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        doca_mmap_create(nullptr, &mmap);
+        doca_mmap_dev_add(mmap, fixture->dev->dev);
+        doca_mmap_set_permissions(mmap, DOCA_ACCESS_LOCAL_READ_WRITE);
+        state.ResumeTiming();
+
+        doca_mmap_set_memrange(mmap, region.data(), region.size());
+        doca_mmap_start(mmap);
+
+        state.PauseTiming();
+        doca_mmap_destroy(mmap);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_MmapStart)->RangeMultiplier(16)->Range(4096, 64 << 20);
+
+/* Whole raw mmap lifecycle over an already allocated region, the baseline of BM_MemMapConstruct */
+static void BM_MmapLifecycleRaw(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    std::vector<char> region(state.range(0));
+    struct doca_mmap *mmap;
+
+    for (auto _ : state) {
+        doca_mmap_create(nullptr, &mmap);
+        doca_mmap_dev_add(mmap, fixture->dev->dev);
+        doca_mmap_set_permissions(mmap, DOCA_ACCESS_LOCAL_READ_WRITE);
+        doca_mmap_set_memrange(mmap, region.data(), region.size());
+        doca_mmap_start(mmap);
+        doca_mmap_destroy(mmap);
+    }
+}
+BENCHMARK(BM_MmapLifecycleRaw)->RangeMultiplier(16)->Range(4096, 64 << 20);
+
+/* MemMap over the same preallocated region: construct, add the device, populate, destroy */
+static void BM_MemMapConstruct(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    std::vector<char> region(state.range(0));
+
+    for (auto _ : state) {
+        MemMap mmap;
+        fixture->dev->AddMMap(mmap);
+        mmap.Populate(DOCA_ACCESS_LOCAL_READ_WRITE, region.data(), region.size());
+    }
+}
+BENCHMARK(BM_MemMapConstruct)->RangeMultiplier(16)->Range(4096, 64 << 20);
+
+/* Synchronous copy with the raw calls of dma_server_flat, spinning on completion */
+static void BM_DmaCopyRaw(benchmark::State &state) {
+    MICROBENCH_SETUP(state, RawDma);
+    size_t size = state.range(0);
+    struct doca_dma_job_memcpy job = {};
+    struct doca_buf *src, *dst;
+    struct doca_event event;
+    doca_error_t result;
+    void *data;
+
+    fixture->GetBufs(size, &src, &dst);
+    job.base.type = DOCA_DMA_JOB_MEMCPY;
+    job.base.flags = DOCA_JOB_FLAGS_NONE;
+    job.base.ctx = fixture->ctx;
+
+    for (auto _ : state) {
+        doca_buf_get_data(src, &data);
+        doca_buf_set_data(src, data, size);
+        job.src_buff = src;
+        job.dst_buff = dst;
+        result = doca_workq_submit(fixture->workq, &job.base);
+        if (result == DOCA_SUCCESS) {
+            while ((result = doca_workq_progress_retrieve(fixture->workq, &event, DOCA_WORKQ_RETRIEVE_FLAGS_NONE)) ==
+                   DOCA_ERROR_AGAIN)
+                ;
+        }
+        if (result != DOCA_SUCCESS) {
+            state.SkipWithError("DMA copy failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+    doca_buf_refcount_rm(src, NULL);
+    doca_buf_refcount_rm(dst, NULL);
+}
+BENCHMARK(BM_DmaCopyRaw)->RangeMultiplier(16)->Range(64, BUF_SIZE_MAX)->UseRealTime();
+
+/* Two local MemMaps on one DOCADma, the dma_server path */
+class WrappedDma {
+   public:
+    DOCADma<Dpu> dma;
+    MemMap src;
+    MemMap dst;
+
+    /* DOCADma opens the device itself and throws without one */
+    WrappedDma() {
+        dma.SetWaitPolicy(WAIT_SPIN);
+        RawDma::Check(dma.Init(src), "init DMA");
+        RawDma::Check(src.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, BUF_SIZE_MAX), "populate source");
+        RawDma::Check(dma.AddMMap(dst), "add device to destination");
+        RawDma::Check(dst.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, BUF_SIZE_MAX), "populate destination");
+        RawDma::Check(dma.AddBuffer(src), "add source buffer");
+        RawDma::Check(dma.AddBuffer(dst), "add destination buffer");
+    }
+
+    ~WrappedDma() {
+        dma.RmBuffer(src);
+        dma.RmBuffer(dst);
+        dma.Finalize();
+    }
+};
+
+/* Synchronous copy through DOCADma::DmaCopy, spinning on completion like BM_DmaCopyRaw */
+static void BM_DmaCopyWrapper(benchmark::State &state) {
+    MICROBENCH_SETUP(state, WrappedDma);
+    size_t size = state.range(0);
+
+    for (auto _ : state) {
+        if (fixture->dma.DmaCopy(fixture->src, fixture->dst, size) != DOCA_SUCCESS) {
+            state.SkipWithError("DMA copy failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_DmaCopyWrapper)->RangeMultiplier(16)->Range(64, BUF_SIZE_MAX)->UseRealTime();
+
+int main(int argc, char *argv[]) {
+    doca_error_t result;
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+    /* Setup of every benchmark run logs at INFO level */
+    doca_log_global_level_set(DOCA_LOG_LEVEL_WARNING);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "chan/comm_channel.h"
+
+struct pc_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    uint64_t nb_keys = 1 << 20;                               /* Keys in the host hash table */
+    uint32_t chain_len = 4;                                   /* Average keys per bucket */
+    uint64_t lookups = 1 << 16;                               /* Lookups per concurrency level */
+    std::vector<uint32_t> concurrency = {1, 8, 32, 64};       /* Traversals in flight to sweep */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/* Chained hash table node in host memory, nodes are scattered over the region */
+struct pc_node {
+    uint64_t key;
+    uint64_t value;
+    uint64_t next; /* Host address of the next node in the bucket, 0 at the end */
+    uint64_t pad;
+};
+
+/* Sent by the host after the export: where the table is */
+struct pc_table_desc {
+    uint64_t buckets;    /* Host address of the bucket array, one head pointer each */
+    uint64_t nb_buckets;
+    uint64_t nb_keys;
+};
+
+/* The table holds the odd keys below 2 * nb_keys */
+static inline uint64_t pc_key(uint64_t i) { return 2 * i + 1; }
+
+static inline uint64_t pc_value(uint64_t key) { return (key * 0x9e3779b97f4a7c15ULL) | 1; }
+
+static inline uint64_t pc_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_pc_params(void);
@@ -0,0 +1,122 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "pc_common.h"
+
+DOCA_LOG_REGISTER(PC_CLIENT::MAIN);
+
+const char *server_name = "doca_ptrchase_server";
+
+/*
+ * Build the chained hash table in an exported region and keep it in place while the DPU looks keys up
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_table(doca::CommChannel<doca::Host> &ch, const struct pc_config &cfg) {
+    using namespace doca;
+    uint64_t nb_buckets = std::max<uint64_t>(1, cfg.nb_keys / cfg.chain_len), key, bucket;
+    std::vector<uint64_t> placement(cfg.nb_keys);
+    std::mt19937_64 rng(42);
+    pc_table_desc desc;
+    doca_error_t result;
+    uint64_t *buckets;
+    pc_node *nodes;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE,
+                                   nb_buckets * sizeof(uint64_t) + cfg.nb_keys * sizeof(pc_node));
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Scatter the nodes so that no two hops of a chain share a cache line or page by construction */
+    buckets = (uint64_t *)mmap.Data();
+    nodes = (pc_node *)(buckets + nb_buckets);
+    memset(buckets, 0, nb_buckets * sizeof(uint64_t));
+    std::iota(placement.begin(), placement.end(), 0);
+    std::shuffle(placement.begin(), placement.end(), rng);
+    for (uint64_t i = 0; i < cfg.nb_keys; i++) {
+        pc_node &node = nodes[placement[i]];
+
+        key = pc_key(i);
+        bucket = pc_hash(key) % nb_buckets;
+        node = {key, pc_value(key), buckets[bucket], 0};
+        buckets[bucket] = (uint64_t)(uintptr_t)&node;
+    }
+    DOCA_LOG_INFO("Hash table of %" PRIu64 " keys in %" PRIu64 " buckets, %.1f MB", cfg.nb_keys, nb_buckets,
+                  mmap.Len() / 1e6);
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    desc = {(uint64_t)(uintptr_t)buckets, nb_buckets, cfg.nb_keys};
+    result = ch.SendTo(&desc, sizeof(desc));
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Lookups done */
+    return ch.WaitForSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct pc_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_ptrchase_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_pc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register pointer chasing client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_table(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Hash table setup failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
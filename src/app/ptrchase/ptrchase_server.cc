@@ -0,0 +1,219 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <cinttypes>
+#include <random>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "pc_common.h"
+#include "stats/report.h"
+#include "traverse/traversal.h"
+
+DOCA_LOG_REGISTER(PC_SERVER::MAIN);
+
+const char *server_name = "doca_ptrchase_server";
+
+/*
+ * Hash chain lookup, one call per fetched node: the bucket head on the first hop, chain nodes after it
+ *
+ * @ctx [in]: Unused
+ * @t [in/out]: Lookup, result is the value or 0 for a miss
+ * @node [in]: Fetched bytes
+ * @len [in]: Number of fetched bytes
+ * @next [out]: Host address of the next node
+ * @return: TRAVERSAL_NEXT to go on, TRAVERSAL_DONE once the lookup is decided
+ */
+static doca::traversal_step pc_visit(void *ctx, doca::traversal *t, const char *node, size_t len, uint64_t *next) {
+    pc_node n;
+
+    (void)ctx;
+    if (t->hops == 1) {
+        memcpy(next, node, sizeof(*next));
+        t->result = 0;
+        return *next ? doca::TRAVERSAL_NEXT : doca::TRAVERSAL_DONE;
+    }
+
+    if (len < sizeof(n)) return doca::TRAVERSAL_DONE;
+    memcpy(&n, node, sizeof(n));
+    if (n.key == t->key) {
+        t->result = n.value;
+        return doca::TRAVERSAL_DONE;
+    }
+    *next = n.next;
+    return n.next ? doca::TRAVERSAL_NEXT : doca::TRAVERSAL_DONE;
+}
+
+/*
+ * Look the keys up with a number of traversals in flight, check the results and report the rates
+ *
+ * @dma [in]: DMA engine
+ * @remote [in]: Host region holding the table
+ * @table [in]: Table location
+ * @keys [in]: Keys to look up
+ * @concurrency [in]: Traversals in flight
+ * @report [in]: Result writer
+ * @serial_rate [in/out]: Lookups per second of the first level, the base of the speedup
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_level(doca::DOCADma<doca::Dpu> &dma, doca::MemMap &remote, const pc_table_desc &table,
+                              const std::vector<uint64_t> &keys, uint32_t concurrency, doca::ReportWriter &report,
+                              double *serial_rate) {
+    using namespace doca;
+    std::vector<traversal> ts(keys.size());
+    traversal_attr attr;
+    traversal_stats stats;
+    doca_error_t result;
+    uint64_t wrong = 0, found = 0, expected;
+    double rate;
+
+    attr.node_size = sizeof(pc_node);
+    attr.concurrency = concurrency;
+    TraversalEngine engine(dma, remote, attr);
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        ts[i].key = keys[i];
+        ts[i].start = table.buckets + pc_hash(keys[i]) % table.nb_buckets * sizeof(uint64_t);
+    }
+
+    result = engine.Run(ts.data(), ts.size(), pc_visit, nullptr);
+    if (result != DOCA_SUCCESS) return result;
+    engine.Snapshot(&stats);
+
+    for (const traversal &t : ts) {
+        expected = (t.key & 1) && t.key < 2 * table.nb_keys ? pc_value(t.key) : 0;
+        if (t.status != DOCA_SUCCESS || t.result != expected) wrong++;
+        if (t.result) found++;
+    }
+    if (wrong > 0) {
+        DOCA_LOG_ERR("%" PRIu64 " of %zu lookups went wrong with %u in flight", wrong, keys.size(), concurrency);
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    rate = keys.size() * 1e9 / stats.busy_ns;
+    if (*serial_rate == 0) *serial_rate = rate;
+    DOCA_LOG_INFO("%4u in flight: %9.0f lookups/s, %9.0f hops/s, %.2f hops per lookup, %" PRIu64
+                  " found, %.1fx the first level; %" PRIu64 " fetches waited for the work queue",
+                  concurrency, rate, stats.HopsPerSec(), (double)stats.hops / keys.size(), found,
+                  rate / *serial_rate, stats.again);
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("concurrency", (uint64_t)concurrency)
+        .Add("lookups", (uint64_t)keys.size())
+        .Add("found", found)
+        .Add("hops", stats.hops)
+        .Add("busy_ns", stats.busy_ns)
+        .Add("lookups_per_sec", rate)
+        .Add("hops_per_sec", stats.HopsPerSec())
+        .Add("speedup", rate / *serial_rate)
+        .Add("again", stats.again);
+    return report.EndRow();
+}
+
+/*
+ * Import the host's table and sweep the concurrency levels over the same lookups
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_lookups(doca::CommChannel<doca::Dpu> &ch, const struct pc_config &cfg) {
+    using namespace doca;
+    std::vector<uint64_t> keys(cfg.lookups);
+    std::mt19937_64 rng(7);
+    double serial_rate = 0;
+    ReportWriter report;
+    pc_table_desc table;
+    doca_error_t result;
+    size_t len;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    /* The engines' node buffers are the only local memory */
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    len = sizeof(table);
+    result = ch.RecvFrom(&table, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(table) || table.nb_buckets == 0) {
+        DOCA_LOG_ERR("Malformed table description");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* Every other lookup misses: even keys are never in the table */
+    for (uint64_t i = 0; i < cfg.lookups; i++) keys[i] = pc_key(rng() % table.nb_keys) + (i & 1);
+
+    for (uint32_t concurrency : cfg.concurrency) {
+        result = run_level(dma, remote_mmap, table, keys, concurrency, report, &serial_rate);
+        if (result != DOCA_SUCCESS) break;
+    }
+
+    dma.Finalize();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct pc_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_ptrchase_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_pc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register pointer chasing server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_lookups(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Lookups failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
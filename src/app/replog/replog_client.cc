@@ -0,0 +1,143 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <cinttypes>
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "rl_common.h"
+#include "stats/clock.h"
+#include "stats/report.h"
+#include "wal/replicated_log.h"
+
+DOCA_LOG_REGISTER(RL_CLIENT::MAIN);
+
+const char *server_name = "doca_replog_server";
+
+/*
+ * Append the records to a replicated log, close it, and report throughput and commit latency
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_writer(doca::CommChannel<doca::Host> &ch, const struct rl_config &cfg) {
+    using namespace doca;
+    std::vector<uint64_t> record((cfg.record_len + sizeof(uint64_t) - 1) / sizeof(uint64_t) + 1);
+    log_writer_stats stats;
+    ReportWriter report;
+    uint64_t start_ns, wall_ns, lsn;
+    doca_error_t result;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE, LOG_CTRL_SIZE + cfg.ring_size);
+    if (result != DOCA_SUCCESS) return result;
+
+    /* Resets the committed offset, before the DPU gets to read it */
+    LogWriter writer(mmap, ch, cfg.writer);
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    start_ns = NowNs();
+    for (uint64_t i = 0; i < cfg.records; i++) {
+        for (size_t w = 0; w < record.size(); w++) record[w] = i * 0x9e3779b97f4a7c15ULL + w;
+        result = writer.Append(record.data(), cfg.record_len, &lsn);
+        if (result != DOCA_SUCCESS) return result;
+        result = writer.Poll();
+        if (result != DOCA_SUCCESS) return result;
+    }
+    result = writer.Close();
+    if (result != DOCA_SUCCESS) return result;
+    wall_ns = NowNs() - start_ns;
+
+    writer.Snapshot(&stats);
+    DOCA_LOG_INFO("%" PRIu64 " records of %zu bytes durable in %.1f ms: %.0f records/s, %.1f MB/s; %" PRIu64
+                  " commits, %.1f records each, %" PRIu64 " appends waited for ring space",
+                  stats.records, cfg.record_len, wall_ns / 1e6, stats.records * 1e9 / wall_ns,
+                  stats.bytes * 1e3 / wall_ns, stats.commits, (double)stats.records / stats.commits,
+                  stats.full_waits);
+    DOCA_LOG_INFO("Commit latency: mean %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us",
+                  stats.commit_latency.Mean() / 1e3, stats.commit_latency.Percentile(50.0) / 1e3,
+                  stats.commit_latency.Percentile(99.0) / 1e3, stats.commit_latency.Max() / 1e3);
+
+    /* Replica shut down cleanly */
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) return result;
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("records", stats.records)
+        .Add("record_len", (uint64_t)cfg.record_len)
+        .Add("ring_size", (uint64_t)cfg.ring_size)
+        .Add("group_bytes", (uint64_t)cfg.writer.group_bytes)
+        .Add("group_ns", cfg.writer.group_ns)
+        .Add("wall_ns", wall_ns)
+        .Add("records_per_sec", stats.records * 1e9 / wall_ns)
+        .Add("mb_per_sec", stats.bytes * 1e3 / wall_ns)
+        .Add("commits", stats.commits)
+        .Add("full_waits", stats.full_waits)
+        .AddHistogram("commit_", stats.commit_latency);
+    return report.EndRow();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct rl_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_replog_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_rl_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register log writer parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_writer(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Log writer failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
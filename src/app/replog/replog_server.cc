@@ -0,0 +1,104 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <cinttypes>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "rl_common.h"
+#include "wal/replicated_log.h"
+
+DOCA_LOG_REGISTER(RL_SERVER::MAIN);
+
+const char *server_name = "doca_replog_server";
+
+/*
+ * Replicate the host's log into local memory, and the log file if there is one, until the host closes it
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_replica(doca::CommChannel<doca::Dpu> &ch, const struct rl_config &cfg) {
+    using namespace doca;
+    log_replica_attr attr = cfg.replica;
+    log_replica_stats stats;
+    doca_error_t result;
+
+    DOCADma<Dpu> dma;
+    MemMap replica_mmap;
+
+    result = dma.Init(replica_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = replica_mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, remote_mmap.Len());
+    if (result != DOCA_SUCCESS) return result;
+
+    attr.path = cfg.file_path;
+    LogReplica replica(dma, remote_mmap, replica_mmap, attr);
+
+    result = replica.Serve(ch);
+    replica.Snapshot(&stats);
+    DOCA_LOG_INFO("Replicated %.1f MB in %" PRIu64 " groups (%" PRIu64 " records verified), %" PRIu64
+                  " DMA reads, %" PRIu64 " committed offset reads; pull %.1f ms, verify %.1f ms, file %.1f ms",
+                  stats.bytes / 1e6, stats.groups, stats.records, stats.dma_jobs, stats.ctrl_reads,
+                  stats.pull_ns / 1e6, stats.verify_ns / 1e6, stats.sync_ns / 1e6);
+
+    dma.Finalize();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct rl_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_replog_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_rl_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register log replica parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_replica(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Log replica failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+        ch.SendFailMsg();
+    }
+
+    /* Serve reported a failure to the host itself */
+    if (result == DOCA_SUCCESS) ch.SendSuccessfulMsg();
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include "chan/comm_channel.h"
+#include "wal/replicated_log.h"
+
+struct rl_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    size_t ring_size = 16UL << 20;                            /* Host log ring */
+    uint64_t records = 1 << 20;                               /* Records to append */
+    size_t record_len = 256;                                  /* Payload bytes per record */
+    doca::log_writer_attr writer;                             /* Group commit policy */
+    doca::log_replica_attr replica;                           /* Read size, polling, verification */
+    char file_path[MAX_ARG_SIZE] = "";                        /* DPU-local log file, empty for none */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_rl_params(void);
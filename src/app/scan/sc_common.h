@@ -0,0 +1,45 @@
+#pragma once
+
+#include <doca_dev.h>
+#include <stdint.h>
+
+#include "chan/comm_channel.h"
+#include "scan/scan.h"
+
+#define SC_VALUE_BITS 20 /* Column values are uniform in [-2^20, 2^20) */
+
+struct sc_config {
+    char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];         /* Comm Channel DOCA device PCI address */
+    char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
+    uint64_t nb_rows = 16 << 20;                              /* Rows of the host column */
+    doca::scan_predicate pred = {0, (1 << 17) - 1};           /* Filter, about 6% of the rows match by default */
+    uint32_t iterations = 5;                                  /* Passes per mode */
+    bool bitmap = false;                                      /* Write the match bitmap back to the host */
+    doca::scan_attr scan;                                     /* DPU chunk size and buffers */
+    char output_path[MAX_ARG_SIZE] = "";                      /* CSV/JSON result file, empty for none */
+};
+
+/* Sent by the host after the export: the column starts the region, the bitmap area follows it */
+struct sc_column_desc {
+    uint64_t nb_rows;
+    uint64_t bitmap_offset;
+};
+
+/* Sent by the DPU once it is done, the host checks it against its own scan */
+struct sc_result {
+    int32_t lo;
+    int32_t hi;
+    uint64_t count;
+    int64_t sum;
+    int32_t min;
+    int32_t max;
+    uint32_t bitmap; /* Non-zero if the bitmap area holds the match bitmap */
+    uint32_t reserved;
+};
+
+/*
+ * Register application arguments
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t register_sc_params(void);
@@ -0,0 +1,167 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <random>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "sc_common.h"
+
+DOCA_LOG_REGISTER(SC_CLIENT::MAIN);
+
+const char *server_name = "doca_scan_server";
+
+/*
+ * Check the DPU's result against a plain scan of the column on the host
+ *
+ * @column [in]: Host column
+ * @nb_rows [in]: Rows of the column
+ * @bitmap [in]: Bitmap area of the region
+ * @res [in]: DPU result
+ * @return: DOCA_SUCCESS if it matches and DOCA_ERROR otherwise
+ */
+static doca_error_t check_result(const int32_t *column, uint64_t nb_rows, const uint64_t *bitmap,
+                                 const sc_result &res) {
+    doca::scan_agg expected;
+    uint64_t bad_words = 0, word;
+
+    for (uint64_t i = 0; i < nb_rows; i += 64) {
+        word = 0;
+        for (uint64_t j = i; j < nb_rows && j < i + 64; j++) {
+            if (column[j] < res.lo || column[j] > res.hi) continue;
+            word |= 1ull << (j - i);
+            expected.count++;
+            expected.sum += column[j];
+            expected.min = std::min(expected.min, column[j]);
+            expected.max = std::max(expected.max, column[j]);
+        }
+        if (res.bitmap && bitmap[i / 64] != word) bad_words++;
+    }
+
+    if (res.count != expected.count || res.sum != expected.sum || res.min != expected.min ||
+        res.max != expected.max) {
+        DOCA_LOG_ERR("DPU aggregates are off: count %" PRIu64 " sum %" PRId64 " min %d max %d, expected count %" PRIu64
+                     " sum %" PRId64 " min %d max %d",
+                     res.count, res.sum, res.min, res.max, expected.count, expected.sum, expected.min, expected.max);
+        return DOCA_ERROR_IO_FAILED;
+    }
+    if (bad_words > 0) {
+        DOCA_LOG_ERR("%" PRIu64 " of %" PRIu64 " bitmap words are off", bad_words, (nb_rows + 63) / 64);
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    DOCA_LOG_INFO("DPU result checked: %" PRIu64 " of %" PRIu64 " rows in [%d, %d], sum %" PRId64
+                  ", min %d, max %d%s",
+                  res.count, nb_rows, res.lo, res.hi, res.sum, res.min, res.max,
+                  res.bitmap ? ", bitmap matches" : "");
+    return DOCA_SUCCESS;
+}
+
+/*
+ * Fill the column in an exported region, keep it in place while the DPU scans it and check the outcome
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_column(doca::CommChannel<doca::Host> &ch, const struct sc_config &cfg) {
+    using namespace doca;
+    uint64_t bitmap_offset = (cfg.nb_rows * sizeof(int32_t) + 7) / 8 * 8;
+    std::mt19937 rng(42);
+    sc_column_desc desc;
+    doca_error_t result;
+    sc_result res;
+    int32_t *column;
+    size_t len;
+
+    DOCADma<Host> dma;
+    MemMap mmap;
+
+    result = dma.Init(mmap);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.AllocAndPopulate(DOCA_ACCESS_DPU_READ_WRITE,
+                                   bitmap_offset + (cfg.nb_rows + 63) / 64 * sizeof(uint64_t));
+    if (result != DOCA_SUCCESS) return result;
+
+    column = (int32_t *)mmap.Data();
+    for (uint64_t i = 0; i < cfg.nb_rows; i++)
+        column[i] = (int32_t)(rng() & ((2u << SC_VALUE_BITS) - 1)) - (1 << SC_VALUE_BITS);
+    memset(mmap.Data() + bitmap_offset, 0, mmap.Len() - bitmap_offset);
+    DOCA_LOG_INFO("Column of %" PRIu64 " rows, %.1f MB", cfg.nb_rows, cfg.nb_rows * sizeof(int32_t) / 1e6);
+
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    desc = {cfg.nb_rows, bitmap_offset};
+    result = ch.SendTo(&desc, sizeof(desc));
+    if (result != DOCA_SUCCESS) return result;
+
+    len = sizeof(res);
+    result = ch.RecvFrom(&res, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(res)) {
+        DOCA_LOG_ERR("Malformed scan result");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    result = check_result(column, cfg.nb_rows, (const uint64_t *)(mmap.Data() + bitmap_offset), res);
+    if (result == DOCA_SUCCESS)
+        ch.SendSuccessfulMsg();
+    else
+        ch.SendFailMsg();
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct sc_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_scan_client", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_sc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register scan client parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Host> ch(cfg.cc_dev_pci_addr);
+
+    result = ch.Connect(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.SendSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_column(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Column setup failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+    ch.DisConnect();
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
@@ -0,0 +1,193 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <cinttypes>
+
+#include "chan/comm_channel.h"
+#include "dma/dma.h"
+#include "sc_common.h"
+#include "stats/report.h"
+
+DOCA_LOG_REGISTER(SC_SERVER::MAIN);
+
+const char *server_name = "doca_scan_server";
+
+/* Passes of one mode over the column */
+enum sc_mode {
+    SC_MODE_DMA,    /* Stream the column without looking at it, the baseline */
+    SC_MODE_SCAN,   /* Filter and aggregate */
+    SC_MODE_BITMAP, /* Filter and aggregate, write the match bitmap back */
+};
+
+static const char *sc_mode_names[] = {"dma", "scan", "scan_bitmap"};
+
+/*
+ * Run the passes of a mode and report their throughput
+ *
+ * @op [in]: Scan operator over the host region
+ * @remote [in]: Host region, for the bitmap
+ * @column [in]: Column location
+ * @cfg [in]: Program configuration
+ * @mode [in]: What a pass does
+ * @report [in]: Result writer
+ * @dma_gbps [in/out]: Throughput of the DMA mode, the base of the others' ratio
+ * @agg [out]: Aggregates of the last pass, untouched in the DMA mode
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_mode(doca::ScanOperator &op, doca::MemMap &remote, const sc_column_desc &column,
+                             const struct sc_config &cfg, sc_mode mode, doca::ReportWriter &report, double *dma_gbps,
+                             doca::scan_agg *agg) {
+    using namespace doca;
+    scan_stats stats;
+    doca_error_t result;
+    double gbps;
+
+    op.ResetStats();
+    for (uint32_t i = 0; i < cfg.iterations; i++) {
+        if (mode == SC_MODE_DMA) {
+            result = op.Stream(0, column.nb_rows * sizeof(int32_t));
+        } else {
+            *agg = scan_agg();
+            result = op.Scan(0, column.nb_rows, cfg.pred, agg, mode == SC_MODE_BITMAP ? &remote : nullptr,
+                             column.bitmap_offset);
+        }
+        if (result != DOCA_SUCCESS) return result;
+    }
+    op.Snapshot(&stats);
+
+    gbps = stats.GBps();
+    if (mode == SC_MODE_DMA) {
+        *dma_gbps = gbps;
+        DOCA_LOG_INFO("%-11s %6.2f GB/s", sc_mode_names[mode], gbps);
+    } else {
+        DOCA_LOG_INFO("%-11s %6.2f GB/s, %.0f%% of DMA; %s kernel alone %.2f GB/s; %" PRIu64 " matches per pass",
+                      sc_mode_names[mode], gbps, *dma_gbps > 0 ? 100 * gbps / *dma_gbps : 0.0, ScanKernelName(),
+                      stats.KernelGBps(), stats.matches / cfg.iterations);
+    }
+
+    if (!report.IsOpen()) return DOCA_SUCCESS;
+    report.Add("mode", sc_mode_names[mode])
+        .Add("kernel", mode == SC_MODE_DMA ? "none" : ScanKernelName())
+        .Add("rows", column.nb_rows)
+        .Add("chunk_size", (uint64_t)cfg.scan.chunk_size)
+        .Add("buffers", (uint64_t)cfg.scan.nb_buffers)
+        .Add("iterations", (uint64_t)cfg.iterations)
+        .Add("matches", stats.matches / cfg.iterations)
+        .Add("bitmap_bytes", stats.bitmap_bytes)
+        .Add("busy_ns", stats.busy_ns)
+        .Add("kernel_ns", stats.kernel_ns)
+        .Add("gbps", gbps)
+        .Add("kernel_gbps", stats.KernelGBps())
+        .Add("dma_ratio", *dma_gbps > 0 ? gbps / *dma_gbps : 0.0)
+        .Add("again", stats.again);
+    return report.EndRow();
+}
+
+/*
+ * Import the host's column, scan it in every mode and send the result for the host to check
+ *
+ * @ch [in]: Connected Comm Channel
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t run_scans(doca::CommChannel<doca::Dpu> &ch, const struct sc_config &cfg) {
+    using namespace doca;
+    sc_column_desc column;
+    ReportWriter report;
+    doca_error_t result;
+    double dma_gbps = 0;
+    scan_agg agg;
+    sc_result res;
+    size_t len;
+
+    if (cfg.output_path[0] != '\0') {
+        result = report.Open(cfg.output_path);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    DOCADma<Dpu> dma;
+    MemMap local_mmap;
+
+    /* The operator's chunk buffers are the only local memory */
+    result = dma.Init(local_mmap);
+    if (result != DOCA_SUCCESS) return result;
+
+    MemMap remote_mmap(dma, ch);
+    result = remote_mmap.RecvAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    len = sizeof(column);
+    result = ch.RecvFrom(&column, &len);
+    if (result != DOCA_SUCCESS) return result;
+    if (len != sizeof(column) || column.nb_rows == 0) {
+        DOCA_LOG_ERR("Malformed column description");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    {
+        ScanOperator op(dma, remote_mmap, cfg.scan);
+
+        for (int mode = SC_MODE_DMA; mode <= SC_MODE_BITMAP && result == DOCA_SUCCESS; mode++) {
+            if (mode == SC_MODE_BITMAP && !cfg.bitmap) break;
+            result = run_mode(op, remote_mmap, column, cfg, (sc_mode)mode, report, &dma_gbps, &agg);
+        }
+    }
+    dma.Finalize();
+    if (result != DOCA_SUCCESS) return result;
+
+    res = {cfg.pred.lo, cfg.pred.hi, agg.count, agg.sum, agg.min, agg.max, cfg.bitmap, 0};
+    result = ch.SendTo(&res, sizeof(res));
+    if (result != DOCA_SUCCESS) return result;
+
+    /* The host's verdict */
+    return ch.WaitForSuccessfulMsg();
+}
+
+int main(int argc, char *argv[]) {
+    using namespace doca;
+    doca_error_t result;
+    struct sc_config cfg;
+
+    /* Register a logger backend */
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("doca_scan_server", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_sc_params();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register scan server parameters: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    CommChannel<Dpu> ch(cfg.cc_dev_pci_addr, cfg.cc_dev_rep_pci_addr);
+
+    result = ch.Listen(server_name);
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+    result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) goto argp_cleanup;
+
+    try {
+        result = run_scans(ch, cfg);
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Scan failed: %s", e.what());
+        result = DOCA_ERROR_INITIALIZATION;
+    }
+
+argp_cleanup:
+    doca_argp_destroy();
+
+    return result;
+}
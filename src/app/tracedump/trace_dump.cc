@@ -0,0 +1,276 @@
+#include <doca_argp.h>
+#include <doca_error.h>
+#include <doca_log.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "chan/comm_channel.h"
+#include "trace/trace.h"
+
+DOCA_LOG_REGISTER(TRACE_DUMP::MAIN);
+
+struct dump_config {
+    char input_path[MAX_ARG_SIZE];  /* Binary trace written by a traced run */
+    char output_path[MAX_ARG_SIZE]; /* Chrome trace JSON */
+};
+
+/* Cycle counter to microseconds on the CLOCK_MONOTONIC time line of the traced process */
+struct tsc_clock {
+    uint64_t tsc_start;
+    uint64_t ns_start;
+    long double ns_per_tick;
+
+    double Us(uint64_t tsc) const { return (ns_start + ((long double)tsc - tsc_start) * ns_per_tick) / 1000.0; }
+};
+
+/*
+ * ARGP Callback - Handle a path parameter
+ *
+ * @param [in]: Input parameter
+ * @dst [out]: Destination buffer, MAX_ARG_SIZE long
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t copy_path(const char *param, char *dst) {
+    int len = strnlen(param, MAX_ARG_SIZE);
+
+    if (len >= MAX_ARG_SIZE) {
+        DOCA_LOG_ERR("Entered path exceeding the maximum size of %d", MAX_ARG_SIZE - 1);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    strncpy(dst, param, len + 1);
+    return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle trace file parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t input_callback(void *param, void *config) {
+    return copy_path((const char *)param, ((struct dump_config *)config)->input_path);
+}
+
+/*
+ * ARGP Callback - Handle JSON output parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t output_callback(void *param, void *config) {
+    return copy_path((const char *)param, ((struct dump_config *)config)->output_path);
+}
+
+/*
+ * Register the command line parameters for the dump tool
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t register_dump_params(void) {
+    struct doca_argp_param *input_param, *output_param;
+    doca_error_t result;
+
+    result = doca_argp_param_create(&input_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(input_param, "i");
+    doca_argp_param_set_long_name(input_param, "input");
+    doca_argp_param_set_description(input_param, "Binary trace file written by a run built with DOCA_HARNESS_TRACE");
+    doca_argp_param_set_callback(input_param, input_callback);
+    doca_argp_param_set_type(input_param, DOCA_ARGP_TYPE_STRING);
+    doca_argp_param_set_mandatory(input_param);
+    result = doca_argp_register_param(input_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    result = doca_argp_param_create(&output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_get_error_string(result));
+        return result;
+    }
+    doca_argp_param_set_short_name(output_param, "o");
+    doca_argp_param_set_long_name(output_param, "output");
+    doca_argp_param_set_description(output_param, "Chrome trace / Perfetto JSON file to write");
+    doca_argp_param_set_callback(output_param, output_callback);
+    doca_argp_param_set_type(output_param, DOCA_ARGP_TYPE_STRING);
+    doca_argp_param_set_mandatory(output_param);
+    result = doca_argp_register_param(output_param);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to register program param: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+/* Poll misses and send retries come in bursts and are folded into one slice per burst */
+static bool is_burst_event(uint32_t event) {
+    return event == TRACE_DMA_POLL_MISS || event == TRACE_CC_RECV_MISS || event == TRACE_CC_SEND_RETRY;
+}
+
+/*
+ * Write the events of one thread. DMA jobs become async slices keyed by thread and job slot, from submit
+ * to completion with the doorbell as an instant on the slice; other events are thread instants.
+ *
+ * @out [in]: JSON output
+ * @clock [in]: Timestamp conversion
+ * @pid [in]: Traced process
+ * @tid [in]: Traced thread
+ * @records [in]: Thread records, oldest first
+ * @first [in/out]: Whether no event has been written yet, to place commas
+ */
+static void write_thread(FILE *out, const tsc_clock &clock, uint32_t pid, uint64_t tid,
+                         const std::vector<trace_record> &records, bool *first) {
+    const char *sep;
+
+    fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%" PRIu64 ",\"args\":{\"name\":\"thread %" PRIu64 "\"}}",
+            *first ? "" : ",", pid, tid, tid);
+    *first = false;
+    sep = ",";
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const trace_record &r = records[i];
+        const char *name = doca::TraceEventName(r.event);
+        double ts = clock.Us(r.tsc);
+
+        switch (r.event) {
+            case TRACE_DMA_SUBMIT:
+            case TRACE_DMA_DOORBELL:
+            case TRACE_DMA_COMPLETE:
+                fprintf(out,
+                        "%s\n{\"name\":\"dma_job\",\"cat\":\"dma\",\"ph\":\"%s\",\"id\":\"%" PRIu64 ".%u\",\"pid\":%u,"
+                        "\"tid\":%" PRIu64 ",\"ts\":%.3f,\"args\":{\"%s\":%" PRIu64 "}}",
+                        sep, r.event == TRACE_DMA_SUBMIT ? "b" : (r.event == TRACE_DMA_COMPLETE ? "e" : "n"), tid,
+                        r.id, pid, tid, ts, r.event == TRACE_DMA_COMPLETE ? "result" : "size", r.value);
+                break;
+            default:
+                if (is_burst_event(r.event)) {
+                    size_t last = i;
+                    while (last + 1 < records.size() && records[last + 1].event == r.event) last++;
+                    fprintf(out,
+                            "%s\n{\"name\":\"%s\",\"cat\":\"poll\",\"ph\":\"X\",\"pid\":%u,\"tid\":%" PRIu64
+                            ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"count\":%zu}}",
+                            sep, name, pid, tid, ts, clock.Us(records[last].tsc) - ts, last - i + 1);
+                    i = last;
+                } else {
+                    fprintf(out,
+                            "%s\n{\"name\":\"%s\",\"cat\":\"chan\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%" PRIu64
+                            ",\"ts\":%.3f,\"args\":{\"%s\":%" PRIu64 "}}",
+                            sep, name, pid, tid, ts,
+                            r.event == TRACE_CC_SEND_FAIL || r.event == TRACE_CC_RECV_FAIL ? "result" : "len", r.value);
+                }
+        }
+    }
+}
+
+/*
+ * Convert a binary trace file to Chrome trace JSON
+ *
+ * @cfg [in]: Program configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dump_trace(const struct dump_config &cfg) {
+    struct trace_file_hdr hdr;
+    std::vector<trace_record> records;
+    doca_error_t result = DOCA_SUCCESS;
+    uint64_t total = 0, dropped = 0;
+    bool first = true;
+    tsc_clock clock;
+    FILE *in, *out;
+
+    in = fopen(cfg.input_path, "rb");
+    if (in == NULL) {
+        DOCA_LOG_ERR("Failed to open trace file %s", cfg.input_path);
+        return DOCA_ERROR_NOT_FOUND;
+    }
+    if (fread(&hdr, sizeof(hdr), 1, in) != 1 || hdr.magic != TRACE_FILE_MAGIC) {
+        DOCA_LOG_ERR("%s is not a trace file", cfg.input_path);
+        fclose(in);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    out = fopen(cfg.output_path, "w");
+    if (out == NULL) {
+        DOCA_LOG_ERR("Failed to open output file %s", cfg.output_path);
+        fclose(in);
+        return DOCA_ERROR_NOT_FOUND;
+    }
+
+    clock.tsc_start = hdr.tsc_start;
+    clock.ns_start = hdr.ns_start;
+    clock.ns_per_tick = hdr.tsc_end > hdr.tsc_start ? (long double)(hdr.ns_end - hdr.ns_start) /
+                                                          (hdr.tsc_end - hdr.tsc_start)
+                                                    : 1.0;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    fprintf(out, "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"pid %u\"}}", hdr.pid,
+            hdr.pid);
+    first = false;
+
+    for (uint32_t t = 0; t < hdr.nb_threads; t++) {
+        struct trace_thread_hdr thread;
+
+        if (fread(&thread, sizeof(thread), 1, in) != 1) {
+            DOCA_LOG_ERR("Truncated trace file, thread %u of %u", t, hdr.nb_threads);
+            result = DOCA_ERROR_IO_FAILED;
+            break;
+        }
+        records.resize(thread.nb_records);
+        if (fread(records.data(), sizeof(trace_record), thread.nb_records, in) != thread.nb_records) {
+            DOCA_LOG_ERR("Truncated trace file, records of thread %" PRIu64, thread.tid);
+            result = DOCA_ERROR_IO_FAILED;
+            break;
+        }
+        if (thread.dropped)
+            DOCA_LOG_WARN("Thread %" PRIu64 ": %" PRIu64 " oldest events were overwritten, raise DOCA_TRACE_EVENTS",
+                          thread.tid, thread.dropped);
+        write_thread(out, clock, hdr.pid, thread.tid, records, &first);
+        total += thread.nb_records;
+        dropped += thread.dropped;
+    }
+
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    fclose(in);
+
+    DOCA_LOG_INFO("Converted %" PRIu64 " events of %u threads (%" PRIu64 " dropped) to %s", total, hdr.nb_threads,
+                  dropped, cfg.output_path);
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    doca_error_t result;
+    struct dump_config cfg = {};
+
+    result = doca_log_create_standard_backend();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = doca_argp_init("trace_dump", &cfg);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to init ARGP resources: %s", doca_get_error_string(result));
+        return result;
+    }
+    result = register_dump_params();
+    if (result != DOCA_SUCCESS) {
+        doca_argp_destroy();
+        return result;
+    }
+    result = doca_argp_start(argc, argv);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to parse application input: %s", doca_get_error_string(result));
+        doca_argp_destroy();
+        return result;
+    }
+
+    result = dump_trace(cfg);
+    doca_argp_destroy();
+    return result;
+}
@@ -0,0 +1,394 @@
+#include "page_cache.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(PAGE_CACHE);
+
+void page_cache_stats::Merge(const page_cache_stats &other) {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    writebacks += other.writebacks;
+    fetch_batches += other.fetch_batches;
+    fetched_bytes += other.fetched_bytes;
+    written_bytes += other.written_bytes;
+}
+
+PageCache::PageCache(DOCADma<Dpu> &dma, MemMap &remote, const page_cache_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.page_size == 0 || attr.nb_pages == 0 || attr.nb_shards == 0 || attr.nb_pages > UINT32_MAX) {
+        DOCA_LOG_ERR("Invalid page cache geometry: %zu pages of %zu bytes, %u shards", attr.nb_pages,
+                     attr.page_size, attr.nb_shards);
+        throw std::runtime_error("Invalid page cache geometry");
+    }
+    if (attr.page_size > dma.MaxBufSize()) {
+        DOCA_LOG_ERR("Page size %zu exceeds the device DMA limit of %" PRIu64 " bytes", attr.page_size,
+                     dma.MaxBufSize());
+        throw std::runtime_error("Page size exceeds the device DMA limit");
+    }
+
+    result = dma.AddMMap(pool);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to page pool");
+    result = pool.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.page_size * attr.nb_pages);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate page pool");
+
+    frames.reset(new cache_frame[attr.nb_pages]);
+    shards.reset(new cache_shard[attr.nb_shards]);
+    for (size_t i = 0; i < attr.nb_pages; i++) {
+        frames[i].page = CACHE_NO_PAGE;
+        frames[i].dirty = false;
+        frames[i].referenced = false;
+        free_frames.push_back(attr.nb_pages - 1 - i);
+    }
+
+    DOCA_LOG_INFO("Page cache of %zu pages of %zu bytes over %zu remote bytes, %s eviction, write-%s",
+                  attr.nb_pages, attr.page_size, remote.Len(), attr.policy == CACHE_LRU ? "LRU" : "CLOCK",
+                  attr.write_back ? "back" : "through");
+}
+
+PageCache::~PageCache() {
+    size_t dirty = 0;
+
+    for (size_t i = 0; i < attr.nb_pages; i++)
+        if (frames[i].page != CACHE_NO_PAGE && frames[i].dirty) dirty++;
+    if (dirty > 0) DOCA_LOG_WARN("Page cache destroyed with %zu dirty pages, their updates are lost", dirty);
+}
+
+size_t PageCache::PageLen(uint64_t page) const {
+    size_t start = page * attr.page_size;
+
+    return std::min(attr.page_size, remote.Len() - start);
+}
+
+doca_error_t PageCache::Read(size_t offset, void *dst, size_t len) {
+    return Access(offset, (char *)dst, len, false);
+}
+
+doca_error_t PageCache::Write(size_t offset, const void *src, size_t len) {
+    /* Segments of a write are only ever copied from */
+    return Access(offset, (char *)src, len, true);
+}
+
+doca_error_t PageCache::Access(size_t offset, char *buf, size_t len, bool write) {
+    cache_segment segs[CACHE_MAX_BATCH];
+    size_t window = std::min<size_t>(CACHE_MAX_BATCH, attr.nb_pages);
+    size_t nb_segs, n;
+    doca_error_t result;
+
+    if (offset > remote.Len() || len > remote.Len() - offset) {
+        DOCA_LOG_ERR("Cache access out of range: %zu bytes at offset %zu (len %zu)", len, offset, remote.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* Windows of at most one fetch batch, and never more pages than the pool holds */
+    while (len > 0) {
+        for (nb_segs = 0; len > 0 && nb_segs < window; nb_segs++) {
+            n = std::min(len, attr.page_size - offset % attr.page_size);
+            segs[nb_segs] = {offset / attr.page_size, offset % attr.page_size, n, buf};
+            offset += n;
+            buf += n;
+            len -= n;
+        }
+        result = AccessWindow(segs, nb_segs, write);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t PageCache::AccessWindow(const cache_segment *segs, size_t nb_segs, bool write) {
+    bool through = write && !attr.write_back;
+    size_t missing[CACHE_MAX_BATCH];
+    uint64_t pages[CACHE_MAX_BATCH];
+    bool need_data[CACHE_MAX_BATCH];
+    uint32_t loaded[CACHE_MAX_BATCH];
+    cache_job jobs[CACHE_MAX_BATCH];
+    size_t nb_missing = 0, nb_fetch = 0, nb_jobs = 0, hits = 0;
+    doca_error_t result;
+    uint32_t frame;
+    char *data;
+
+    /* Hits only need their shard; a write-through has to reach the host, so it always takes io_lock */
+    for (size_t i = 0; i < nb_segs; i++) {
+        if (!through && CopyResident(segs[i], write, &frame))
+            hits++;
+        else
+            missing[nb_missing++] = i;
+    }
+    if (nb_missing == 0) {
+        counters.hits.fetch_add(hits, std::memory_order_relaxed);
+        return DOCA_SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> guard(io_lock);
+
+    /* Another thread may have loaded some of the pages meanwhile */
+    for (size_t i = 0; i < nb_missing; i++) {
+        const cache_segment &seg = segs[missing[i]];
+
+        if (CopyResident(seg, write, &frame)) {
+            hits++;
+            if (through) jobs[nb_jobs++] = {frame, seg.page, seg.page_offset, seg.len, true};
+            continue;
+        }
+        missing[nb_fetch] = missing[i];
+        pages[nb_fetch] = seg.page;
+        /* A write covering the whole page does not need its old contents */
+        need_data[nb_fetch] = !write || seg.len < PageLen(seg.page);
+        nb_fetch++;
+    }
+    counters.hits.fetch_add(hits, std::memory_order_relaxed);
+
+    /* Write the hits through before loading the misses can evict their frames */
+    if (nb_jobs > 0) {
+        result = RunJobs(jobs, nb_jobs);
+        if (result != DOCA_SUCCESS) return result;
+        nb_jobs = 0;
+    }
+    if (nb_fetch == 0) return DOCA_SUCCESS;
+
+    result = LoadPages(pages, need_data, nb_fetch, loaded);
+    if (result != DOCA_SUCCESS) return result;
+    counters.misses.fetch_add(nb_fetch, std::memory_order_relaxed);
+
+    /* Fill the frames before they become visible to hits */
+    for (size_t i = 0; i < nb_fetch; i++) {
+        const cache_segment &seg = segs[missing[i]];
+
+        data = FrameData(loaded[i]) + seg.page_offset;
+        if (write)
+            memcpy(data, seg.buf, seg.len);
+        else
+            memcpy(seg.buf, data, seg.len);
+        Insert(seg.page, loaded[i], write && attr.write_back);
+        if (through) jobs[nb_jobs++] = {loaded[i], seg.page, seg.page_offset, seg.len, true};
+    }
+
+    return nb_jobs > 0 ? RunJobs(jobs, nb_jobs) : DOCA_SUCCESS;
+}
+
+bool PageCache::CopyResident(const cache_segment &seg, bool write, uint32_t *frame) {
+    cache_shard &shard = ShardOf(seg.page);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    char *data;
+
+    auto it = shard.index.find(seg.page);
+    if (it == shard.index.end()) return false;
+    *frame = it->second;
+
+    data = FrameData(*frame) + seg.page_offset;
+    if (write) {
+        memcpy(data, seg.buf, seg.len);
+        if (attr.write_back) frames[*frame].dirty = true;
+    } else {
+        memcpy(seg.buf, data, seg.len);
+    }
+
+    if (attr.policy == CACHE_LRU)
+        frames[*frame].last_use.store(NowNs(), std::memory_order_relaxed);
+    else
+        frames[*frame].referenced = true;
+    return true;
+}
+
+void PageCache::Insert(uint64_t page, uint32_t frame, bool dirty) {
+    cache_shard &shard = ShardOf(page);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    cache_frame &f = frames[frame];
+
+    f.page = page;
+    f.dirty = dirty;
+    f.referenced = true;
+    f.last_use.store(NowNs(), std::memory_order_relaxed);
+    shard.index[page] = frame;
+}
+
+doca_error_t PageCache::LoadPages(const uint64_t *pages, const bool *need_data, size_t nb_pages, uint32_t *out) {
+    cache_job jobs[CACHE_MAX_BATCH];
+    size_t nb_jobs = 0;
+    doca_error_t result;
+
+    if (nb_pages > free_frames.size()) {
+        result = Evict(nb_pages - free_frames.size());
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    for (size_t i = 0; i < nb_pages; i++) {
+        out[i] = free_frames.back();
+        free_frames.pop_back();
+        if (need_data[i]) jobs[nb_jobs++] = {out[i], pages[i], 0, PageLen(pages[i]), false};
+    }
+    if (nb_jobs == 0) return DOCA_SUCCESS;
+
+    counters.fetch_batches.fetch_add(1, std::memory_order_relaxed);
+    result = RunJobs(jobs, nb_jobs);
+    if (result != DOCA_SUCCESS) free_frames.insert(free_frames.end(), out, out + nb_pages);
+    return result;
+}
+
+doca_error_t PageCache::Evict(size_t nb_victims) {
+    doca_error_t result;
+
+    writeback.clear();
+    PickVictims(nb_victims);
+    counters.evictions.fetch_add(nb_victims, std::memory_order_relaxed);
+    if (writeback.empty()) return DOCA_SUCCESS;
+
+    result = RunJobs(writeback.data(), writeback.size());
+    if (result != DOCA_SUCCESS) {
+        /* Keep the dirty pages resident rather than drop their updates */
+        for (const cache_job &job : writeback) Insert(job.page, job.frame, true);
+        return result;
+    }
+
+    counters.writebacks.fetch_add(writeback.size(), std::memory_order_relaxed);
+    for (const cache_job &job : writeback) free_frames.push_back(job.frame);
+    return DOCA_SUCCESS;
+}
+
+void PageCache::PickVictims(size_t nb_victims) {
+    size_t picked = 0;
+
+    if (attr.policy == CACHE_LRU) {
+        lru_scan.clear();
+        for (size_t i = 0; i < attr.nb_pages; i++)
+            if (frames[i].page != CACHE_NO_PAGE)
+                lru_scan.emplace_back(frames[i].last_use.load(std::memory_order_relaxed), i);
+        std::nth_element(lru_scan.begin(), lru_scan.begin() + (nb_victims - 1), lru_scan.end());
+        for (size_t i = 0; i < nb_victims; i++) Unindex(lru_scan[i].second, false);
+        return;
+    }
+
+    /* Only free frames carry no page, and the caller asks for no more victims than there are resident pages */
+    while (picked < nb_victims) {
+        uint32_t frame = hand;
+
+        hand = (hand + 1) % attr.nb_pages;
+        if (frames[frame].page == CACHE_NO_PAGE) continue;
+        if (Unindex(frame, true)) picked++;
+    }
+}
+
+bool PageCache::Unindex(uint32_t frame, bool second_chance) {
+    cache_frame &f = frames[frame];
+    cache_shard &shard = ShardOf(f.page);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    if (second_chance && f.referenced) {
+        f.referenced = false;
+        return false;
+    }
+
+    shard.index.erase(f.page);
+    if (f.dirty)
+        writeback.push_back({frame, f.page, 0, PageLen(f.page), true});
+    else
+        free_frames.push_back(frame);
+    f.page = CACHE_NO_PAGE;
+    f.dirty = false;
+    return true;
+}
+
+doca_error_t PageCache::Flush() {
+    std::lock_guard<std::mutex> guard(io_lock);
+    doca_error_t result;
+
+    writeback.clear();
+    for (size_t i = 0; i < attr.nb_pages; i++) {
+        cache_frame &f = frames[i];
+
+        if (f.page == CACHE_NO_PAGE) continue;
+        cache_shard &shard = ShardOf(f.page);
+        std::lock_guard<std::mutex> shard_guard(shard.lock);
+        /* Cleared before the copy, a write landing meanwhile dirties the page again */
+        if (f.dirty) {
+            f.dirty = false;
+            writeback.push_back({(uint32_t)i, f.page, 0, PageLen(f.page), true});
+        }
+    }
+    if (writeback.empty()) return DOCA_SUCCESS;
+
+    result = RunJobs(writeback.data(), writeback.size());
+    if (result != DOCA_SUCCESS) {
+        for (const cache_job &job : writeback) {
+            cache_shard &shard = ShardOf(job.page);
+            std::lock_guard<std::mutex> shard_guard(shard.lock);
+            frames[job.frame].dirty = true;
+        }
+        return result;
+    }
+
+    counters.writebacks.fetch_add(writeback.size(), std::memory_order_relaxed);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t PageCache::RunJobs(const cache_job *jobs, size_t nb_jobs) {
+    doca_error_t result, failure = DOCA_SUCCESS;
+    size_t submitted = 0, completed = 0;
+    void *user_data;
+
+    /* Once a job fails nothing new is submitted, but the jobs in flight are still reaped */
+    while (completed < submitted || (submitted < nb_jobs && failure == DOCA_SUCCESS)) {
+        while (submitted < nb_jobs && failure == DOCA_SUCCESS) {
+            const cache_job &job = jobs[submitted];
+            size_t local = (size_t)job.frame * attr.page_size + job.page_offset;
+            size_t host = job.page * attr.page_size + job.page_offset;
+
+            if (job.to_remote)
+                result = dma.Submit(pool, local, remote, host, job.len, nullptr);
+            else
+                result = dma.Submit(remote, host, pool, local, job.len, nullptr);
+            if (result == DOCA_ERROR_AGAIN) break;
+            if (result != DOCA_SUCCESS) {
+                failure = result;
+                break;
+            }
+            (job.to_remote ? counters.written_bytes : counters.fetched_bytes)
+                .fetch_add(job.len, std::memory_order_relaxed);
+            submitted++;
+        }
+        if (completed == submitted) continue;
+
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) continue;
+        completed++;
+        if (result != DOCA_SUCCESS && failure == DOCA_SUCCESS) failure = result;
+    }
+
+    if (failure != DOCA_SUCCESS)
+        DOCA_LOG_ERR("Page cache DMA failed: %s", doca_get_error_string(failure));
+    return failure;
+}
+
+void PageCache::Snapshot(page_cache_stats *stats) const {
+    stats->hits = counters.hits.load(std::memory_order_relaxed);
+    stats->misses = counters.misses.load(std::memory_order_relaxed);
+    stats->evictions = counters.evictions.load(std::memory_order_relaxed);
+    stats->writebacks = counters.writebacks.load(std::memory_order_relaxed);
+    stats->fetch_batches = counters.fetch_batches.load(std::memory_order_relaxed);
+    stats->fetched_bytes = counters.fetched_bytes.load(std::memory_order_relaxed);
+    stats->written_bytes = counters.written_bytes.load(std::memory_order_relaxed);
+}
+
+void PageCache::ResetStats() {
+    counters.hits.store(0, std::memory_order_relaxed);
+    counters.misses.store(0, std::memory_order_relaxed);
+    counters.evictions.store(0, std::memory_order_relaxed);
+    counters.writebacks.store(0, std::memory_order_relaxed);
+    counters.fetch_batches.store(0, std::memory_order_relaxed);
+    counters.fetched_bytes.store(0, std::memory_order_relaxed);
+    counters.written_bytes.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace doca
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+#define CACHE_MAX_BATCH 64        /* Pages fetched by one batch of DMA jobs */
+#define CACHE_NO_PAGE UINT64_MAX  /* Page of a free frame */
+
+namespace doca {
+
+enum cache_policy {
+    CACHE_CLOCK, /* Second chance sweep, hits only set a reference bit */
+    CACHE_LRU,   /* Exact LRU on access timestamps, victim selection scans the pool */
+};
+
+/* Construction time settings of a PageCache */
+struct page_cache_attr {
+    size_t page_size = 4096;            /* Bytes per page, offsets in the remote mmap are split on this */
+    size_t nb_pages = 1024;             /* Frames in the DPU-local pool */
+    enum cache_policy policy = CACHE_CLOCK;
+    bool write_back = false;            /* Keep written pages dirty until evicted or flushed, else write through */
+    uint32_t nb_shards = 64;            /* Index partitions, each with its own lock */
+};
+
+/* Point-in-time copy of a PageCache's counters, see PageCache::Snapshot */
+struct page_cache_stats {
+    uint64_t hits = 0;          /* Page accesses served from the pool */
+    uint64_t misses = 0;        /* Page accesses that had to fetch or allocate the page */
+    uint64_t evictions = 0;     /* Resident pages dropped to make room */
+    uint64_t writebacks = 0;    /* Dirty pages written to the host, on eviction or Flush */
+    uint64_t fetch_batches = 0; /* Batches of miss fetches, each pipelined on the work queue */
+    uint64_t fetched_bytes = 0; /* Bytes read from the host */
+    uint64_t written_bytes = 0; /* Bytes written to the host */
+
+    double HitRate() const { return hits + misses ? (double)hits / (hits + misses) : 0.0; }
+    void Merge(const page_cache_stats &other);
+};
+
+/*
+ * DPU-side cache of a remote (host) mmap. Pages live in a local pool and are
+ * found through a sharded hash index, so hits from any number of threads only
+ * take the lock of one shard and never touch the DMA engine. Misses are
+ * serialized: they fetch all missing pages of an access as one batch of
+ * asynchronous DMA jobs, evicting with the configured policy.
+ *
+ * The cache drives dma itself, it must not have jobs in flight from anyone
+ * else while the cache is in use.
+ */
+class PageCache {
+   public:
+    PageCache(DOCADma<Dpu> &dma, MemMap &remote, const page_cache_attr &attr = page_cache_attr());
+    ~PageCache();
+    PageCache(const PageCache &) = delete;
+    PageCache &operator=(const PageCache &) = delete;
+
+    /* Copy len bytes at offset of the remote mmap, through the cache */
+    doca_error_t Read(size_t offset, void *dst, size_t len);
+    /* Update len bytes at offset of the remote mmap, written through or marked dirty per attr.write_back */
+    doca_error_t Write(size_t offset, const void *src, size_t len);
+    /* Write every dirty page back to the host */
+    doca_error_t Flush();
+
+    size_t PageSize() const { return attr.page_size; }
+    size_t Capacity() const { return attr.nb_pages; }
+
+    void Snapshot(page_cache_stats *stats) const;
+    void ResetStats();
+
+   protected:
+    /*
+     * Frame metadata is guarded by the lock of the shard the frame's page hashes to.
+     * page only changes with io_lock held as well, so io_lock holders may read it bare.
+     */
+    struct cache_frame {
+        uint64_t page;
+        bool dirty;
+        bool referenced;
+        std::atomic<uint64_t> last_use{0}; /* Read without a lock by the LRU victim scan */
+    };
+
+    struct alignas(64) cache_shard {
+        std::mutex lock;
+        std::unordered_map<uint64_t, uint32_t> index; /* Page number to frame */
+    };
+
+    /* Part of an access falling into one page */
+    struct cache_segment {
+        uint64_t page;
+        size_t page_offset;
+        size_t len;
+        char *buf;
+    };
+
+    /* One DMA job between a frame and its page */
+    struct cache_job {
+        uint32_t frame;
+        uint64_t page;
+        size_t page_offset;
+        size_t len;
+        bool to_remote;
+    };
+
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    page_cache_attr attr;
+    MemMap pool;
+
+    std::unique_ptr<cache_frame[]> frames;
+    std::unique_ptr<cache_shard[]> shards;
+
+    /* Taken by misses, write-through and Flush: owns dma, the frame lists and the CLOCK hand */
+    std::mutex io_lock;
+    std::vector<uint32_t> free_frames;
+    std::vector<cache_job> writeback;
+    std::vector<std::pair<uint64_t, uint32_t>> lru_scan;
+    uint32_t hand = 0;
+
+    struct {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> evictions{0};
+        std::atomic<uint64_t> writebacks{0};
+        std::atomic<uint64_t> fetch_batches{0};
+        std::atomic<uint64_t> fetched_bytes{0};
+        std::atomic<uint64_t> written_bytes{0};
+    } counters;
+
+    doca_error_t Access(size_t offset, char *buf, size_t len, bool write);
+    doca_error_t AccessWindow(const cache_segment *segs, size_t nb_segs, bool write);
+    /* Copy a segment in or out of its frame if the page is resident, returns the frame in *frame */
+    bool CopyResident(const cache_segment &seg, bool write, uint32_t *frame);
+    /*
+     * Take frames for pages that are not resident and fetch the ones marked in need_data. The
+     * frames are not indexed yet, the caller fills them and calls Insert; caller holds io_lock.
+     */
+    doca_error_t LoadPages(const uint64_t *pages, const bool *need_data, size_t nb_pages, uint32_t *out);
+    /* Free nb_victims frames into free_frames, writing dirty victims back; caller holds io_lock */
+    doca_error_t Evict(size_t nb_victims);
+    /* Unindex victims, clean ones go to free_frames and dirty ones to writeback */
+    void PickVictims(size_t nb_victims);
+    /* Unindex one resident frame, unless second_chance is set and the page was referenced since */
+    bool Unindex(uint32_t frame, bool second_chance);
+    void Insert(uint64_t page, uint32_t frame, bool dirty);
+    /* Run jobs pipelined on the work queue, at most WORKQ_DEPTH in flight; caller holds io_lock */
+    doca_error_t RunJobs(const cache_job *jobs, size_t nb_jobs);
+
+    cache_shard &ShardOf(uint64_t page) { return shards[page % attr.nb_shards]; }
+    char *FrameData(uint32_t frame) const { return pool.Data() + (size_t)frame * attr.page_size; }
+    /* Bytes of the page present in the remote mmap, the last page may be short */
+    size_t PageLen(uint64_t page) const;
+};
+
+}  // namespace doca
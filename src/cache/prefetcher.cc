@@ -0,0 +1,270 @@
+#include "prefetcher.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(PREFETCHER);
+
+void prefetch_stats::Merge(const prefetch_stats &other) {
+    demand_reads += other.demand_reads;
+    prefetch_hits += other.prefetch_hits;
+    late_hits += other.late_hits;
+    demand_misses += other.demand_misses;
+    issued += other.issued;
+    wasted += other.wasted;
+}
+
+Prefetcher::Prefetcher(DOCADma<Dpu> &dma, MemMap &remote, const prefetch_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.slot_size == 0 || attr.nb_slots == 0 || attr.nb_streams == 0 || attr.min_window == 0 ||
+        attr.min_window > attr.max_window) {
+        DOCA_LOG_ERR("Invalid prefetcher settings: %zu slots of %zu bytes, %u streams, window %u-%u",
+                     attr.nb_slots, attr.slot_size, attr.nb_streams, attr.min_window, attr.max_window);
+        throw std::runtime_error("Invalid prefetcher settings");
+    }
+    if (attr.slot_size > dma.MaxBufSize()) {
+        DOCA_LOG_ERR("Slot size %zu exceeds the device DMA limit of %" PRIu64 " bytes", attr.slot_size,
+                     dma.MaxBufSize());
+        throw std::runtime_error("Slot size exceeds the device DMA limit");
+    }
+
+    result = dma.AddMMap(pool);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to staging pool");
+    result = pool.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.slot_size * (attr.nb_slots + 1));
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate staging pool");
+
+    slots.resize(attr.nb_slots + 1);
+    for (size_t i = 0; i < attr.nb_slots; i++) free_slots.push_back(attr.nb_slots - 1 - i);
+    streams.resize(attr.nb_streams);
+    for (stream_state &st : streams) st.window = attr.min_window;
+}
+
+Prefetcher::~Prefetcher() {
+    while (inflight > 0) {
+        doca_error_t result = PollOne();
+        if (result != DOCA_SUCCESS && result != DOCA_ERROR_AGAIN) break;
+    }
+}
+
+doca_error_t Prefetcher::Read(uint32_t stream, size_t offset, void *dst, size_t len) {
+    doca_error_t result;
+    uint32_t slot, owner;
+    bool late;
+
+    if (stream >= attr.nb_streams || len == 0 || len > attr.slot_size || offset > remote.Len() ||
+        len > remote.Len() - offset) {
+        DOCA_LOG_ERR("Invalid read of stream %u: %zu bytes at offset %zu (len %zu, slots of %zu bytes)", stream, len,
+                     offset, remote.Len(), attr.slot_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    counters.demand_reads++;
+
+    /* Retire whatever finished meanwhile, it frees work queue entries for new readahead */
+    while (inflight > 0 && PollOne() == DOCA_SUCCESS)
+        ;
+
+    auto it = index.find(offset);
+    if (it != index.end() && slots[it->second].len < len) {
+        /* Staged for a shorter read of the same offset, it would otherwise hold its slot for good */
+        slot = it->second;
+        Unstage(slot);
+        Discard(slot);
+        counters.wasted++;
+        it = index.end();
+    }
+    if (it != index.end()) {
+        slot = it->second;
+        owner = slots[slot].stream;
+        late = slots[slot].state == SLOT_INFLIGHT;
+        /* Claimed before training, a pattern break of the stream must not drop it */
+        Unstage(slot);
+        /* Keep the stream ahead of demand while waiting */
+        Train(stream, offset);
+        Issue(stream, len);
+        result = WaitFor(slot);
+        if (result == DOCA_SUCCESS) {
+            memcpy(dst, SlotData(slot), len);
+            Release(slot);
+            counters.prefetch_hits++;
+            if (late) {
+                counters.late_hits++;
+                streams[owner].window = std::min(streams[owner].window * 2, attr.max_window);
+            }
+            return DOCA_SUCCESS;
+        }
+        /* The readahead failed and was dropped, fall back to a demand read */
+        result = Submit(DemandSlot(), offset, len);
+        if (result != DOCA_SUCCESS) return result;
+    } else {
+        /* Demand first, the readahead queues up behind it */
+        result = Submit(DemandSlot(), offset, len);
+        if (result != DOCA_SUCCESS) return result;
+        Train(stream, offset);
+        Issue(stream, len);
+    }
+
+    result = WaitFor(DemandSlot());
+    if (result != DOCA_SUCCESS) return result;
+    memcpy(dst, SlotData(DemandSlot()), len);
+    slots[DemandSlot()].state = SLOT_FREE;
+    counters.demand_misses++;
+
+    return DOCA_SUCCESS;
+}
+
+void Prefetcher::EndStream(uint32_t stream) {
+    DropReadahead(stream);
+    streams[stream].has_last = false;
+    streams[stream].trained = false;
+}
+
+void Prefetcher::DropReadahead(uint32_t stream) {
+    stream_state &st = streams[stream];
+    uint64_t dropped = 0;
+
+    for (uint32_t i = 0; i < attr.nb_slots && st.outstanding > 0; i++) {
+        staging_slot &s = slots[i];
+
+        if (s.state == SLOT_FREE || s.stream != stream || !Unstage(i)) continue;
+        dropped++;
+        Discard(i);
+    }
+
+    counters.wasted += dropped;
+    if (dropped > 0) st.window = std::max(st.window / 2, attr.min_window);
+}
+
+void Prefetcher::Train(uint32_t stream, size_t offset) {
+    stream_state &st = streams[stream];
+    int64_t delta = (int64_t)offset - (int64_t)st.last_offset;
+
+    if (st.has_last && delta != 0 && delta == st.delta) {
+        if (!st.trained) st.next = (int64_t)offset + delta;
+        st.trained = true;
+    } else {
+        if (st.trained) DropReadahead(stream);
+        st.trained = false;
+        st.delta = st.has_last ? delta : 0;
+    }
+    st.has_last = true;
+    st.last_offset = offset;
+}
+
+void Prefetcher::Issue(uint32_t stream, size_t len) {
+    stream_state &st = streams[stream];
+    int64_t last = (int64_t)st.last_offset;
+    uint32_t slot;
+
+    if (!st.trained) return;
+    /* Demand overtook the readahead, restart it right after the current read */
+    if ((st.next - last) / st.delta <= 0) st.next = last + st.delta;
+
+    while ((st.next - last) / st.delta <= (int64_t)st.window && !free_slots.empty()) {
+        if (st.next < 0 || (size_t)st.next > remote.Len() - len) break;
+        if (index.count(st.next) == 0) {
+            slot = free_slots.back();
+            if (Submit(slot, st.next, len) != DOCA_SUCCESS) break;
+            free_slots.pop_back();
+            slots[slot].stream = stream;
+            index[st.next] = slot;
+            st.outstanding++;
+            counters.issued++;
+        }
+        st.next += st.delta;
+    }
+}
+
+doca_error_t Prefetcher::Submit(uint32_t slot, size_t offset, size_t len) {
+    doca_error_t result;
+
+    result = dma.Submit(remote, offset, pool, (size_t)slot * attr.slot_size, len, (void *)(uintptr_t)slot);
+    /* Demand reads wait for a free work queue entry, readahead is simply not issued */
+    while (result == DOCA_ERROR_AGAIN && slot == DemandSlot()) {
+        result = PollOne();
+        if (result != DOCA_SUCCESS && result != DOCA_ERROR_AGAIN) return result;
+        result = dma.Submit(remote, offset, pool, (size_t)slot * attr.slot_size, len, (void *)(uintptr_t)slot);
+    }
+    if (result != DOCA_SUCCESS) return result;
+
+    slots[slot].state = SLOT_INFLIGHT;
+    slots[slot].orphan = false;
+    slots[slot].offset = offset;
+    slots[slot].len = len;
+    inflight++;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Prefetcher::PollOne() {
+    doca_error_t result;
+    void *user_data;
+    uint32_t slot;
+
+    result = dma.Poll(&user_data);
+    if (result == DOCA_ERROR_AGAIN) return result;
+
+    slot = (uint32_t)(uintptr_t)user_data;
+    staging_slot &s = slots[slot];
+    inflight--;
+
+    if (slot == DemandSlot()) {
+        /* A failed demand read is retried by the caller of WaitFor, which gets the error */
+        s.state = result == DOCA_SUCCESS ? SLOT_READY : SLOT_FREE;
+        return result;
+    }
+    if (s.orphan) {
+        s.orphan = false;
+        Release(slot);
+        return DOCA_SUCCESS;
+    }
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_WARN("Readahead of %zu bytes at offset %zu failed: %s", s.len, s.offset,
+                      doca_get_error_string(result));
+        Unstage(slot);
+        Release(slot);
+        return DOCA_SUCCESS;
+    }
+    s.state = SLOT_READY;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Prefetcher::WaitFor(uint32_t slot) {
+    doca_error_t result;
+
+    while (slots[slot].state == SLOT_INFLIGHT) {
+        result = PollOne();
+        if (result != DOCA_SUCCESS && result != DOCA_ERROR_AGAIN) return result;
+    }
+    return slots[slot].state == SLOT_READY ? DOCA_SUCCESS : DOCA_ERROR_IO_FAILED;
+}
+
+bool Prefetcher::Unstage(uint32_t slot) {
+    auto it = index.find(slots[slot].offset);
+
+    if (it == index.end() || it->second != slot) return false;
+    index.erase(it);
+    streams[slots[slot].stream].outstanding--;
+    return true;
+}
+
+void Prefetcher::Release(uint32_t slot) {
+    slots[slot].state = SLOT_FREE;
+    slots[slot].orphan = false;
+    free_slots.push_back(slot);
+}
+
+void Prefetcher::Discard(uint32_t slot) {
+    if (slots[slot].state == SLOT_INFLIGHT)
+        slots[slot].orphan = true;
+    else
+        Release(slot);
+}
+
+}  // namespace doca
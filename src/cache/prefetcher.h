@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+namespace doca {
+
+/* Construction time settings of a Prefetcher */
+struct prefetch_attr {
+    size_t slot_size = 4096;   /* Staging buffer size, the largest read the prefetcher serves */
+    size_t nb_slots = 64;      /* Staging buffers shared by all streams */
+    uint32_t nb_streams = 1;   /* Independent access streams, each trained on its own */
+    uint32_t min_window = 2;   /* Reads kept in flight ahead of a trained stream, adapted in [min, max] */
+    uint32_t max_window = 16;
+};
+
+/* Point-in-time copy of a Prefetcher's counters, see Prefetcher::Snapshot */
+struct prefetch_stats {
+    uint64_t demand_reads = 0;  /* Reads asked for by the caller */
+    uint64_t prefetch_hits = 0; /* Reads served from a staging buffer */
+    uint64_t late_hits = 0;     /* Prefetch hits that still had to wait for their DMA job */
+    uint64_t demand_misses = 0; /* Reads fetched on demand */
+    uint64_t issued = 0;        /* Readahead DMA jobs submitted */
+    uint64_t wasted = 0;        /* Readahead dropped unused, its stream changed pattern or read more */
+
+    /* Share of the readahead that was used */
+    double Accuracy() const { return issued ? (double)prefetch_hits / issued : 0.0; }
+    /* Share of the demand reads that readahead served */
+    double Coverage() const { return demand_reads ? (double)prefetch_hits / demand_reads : 0.0; }
+    void Merge(const prefetch_stats &other);
+};
+
+/*
+ * Readahead on the remote-read path. Every stream keeps the delta between its
+ * last reads; once the same delta repeats, covering sequential (delta equal to
+ * the read size) and strided walks alike, the next window reads of the stream
+ * are issued as asynchronous DMA jobs into staging buffers. The window doubles
+ * when demand catches up with a job still in flight and halves when the
+ * stream breaks pattern with readahead outstanding.
+ *
+ * Single threaded: the prefetcher owns dma, which must not be used by anyone
+ * else while the prefetcher exists.
+ */
+class Prefetcher {
+   public:
+    Prefetcher(DOCADma<Dpu> &dma, MemMap &remote, const prefetch_attr &attr = prefetch_attr());
+    /* Waits for the readahead still in flight, the staging buffers are its destination */
+    ~Prefetcher();
+    Prefetcher(const Prefetcher &) = delete;
+    Prefetcher &operator=(const Prefetcher &) = delete;
+
+    /* Copy len bytes at offset of the remote mmap, len at most attr.slot_size */
+    doca_error_t Read(uint32_t stream, size_t offset, void *dst, size_t len);
+    /* Forget a stream's pattern and drop its readahead, e.g. when a scan is done */
+    void EndStream(uint32_t stream);
+
+    void Snapshot(prefetch_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = prefetch_stats(); }
+
+   protected:
+    enum slot_state { SLOT_FREE, SLOT_INFLIGHT, SLOT_READY };
+
+    struct staging_slot {
+        slot_state state = SLOT_FREE;
+        bool orphan = false; /* In flight but dropped, freed on completion */
+        uint32_t stream = 0;
+        size_t offset = 0;
+        size_t len = 0;
+    };
+
+    struct stream_state {
+        bool has_last = false;
+        bool trained = false;
+        size_t last_offset = 0;
+        int64_t delta = 0;
+        int64_t next = 0;         /* Offset of the next readahead */
+        uint32_t window;
+        uint32_t outstanding = 0; /* Readahead issued and not consumed yet */
+    };
+
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    prefetch_attr attr;
+    MemMap pool;
+
+    std::vector<staging_slot> slots; /* The last one serves demand misses */
+    std::vector<uint32_t> free_slots;
+    std::unordered_map<size_t, uint32_t> index; /* Remote offset to the readahead staged for it */
+    std::vector<stream_state> streams;
+    size_t inflight = 0;
+
+    prefetch_stats counters;
+
+    /* Retire one completion, DOCA_ERROR_AGAIN if none is ready */
+    doca_error_t PollOne();
+    doca_error_t WaitFor(uint32_t slot);
+    doca_error_t Submit(uint32_t slot, size_t offset, size_t len);
+    /* A slot is readahead of its stream while indexed; false if it was already unstaged */
+    bool Unstage(uint32_t slot);
+    void Release(uint32_t slot);
+    /* Free an unstaged slot now, or on completion if its job is still in flight */
+    void Discard(uint32_t slot);
+    /* Drop a stream's outstanding readahead, shrinking its window if there was any */
+    void DropReadahead(uint32_t stream);
+    void Train(uint32_t stream, size_t offset);
+    void Issue(uint32_t stream, size_t len);
+
+    uint32_t DemandSlot() const { return attr.nb_slots; }
+    char *SlotData(uint32_t slot) const { return pool.Data() + (size_t)slot * attr.slot_size; }
+};
+
+}  // namespace doca
@@ -0,0 +1,122 @@
+#include "clock_sync.h"
+
+#include <limits>
+
+#include "stats/clock.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(CLOCK_SYNC);
+
+doca_error_t ClockSync::Sync(CommEndpoint &ch, int rounds) {
+    struct clock_sync_msg msg;
+    struct clock_sync_point best = {0, 0, std::numeric_limits<uint64_t>::max()};
+    doca_error_t result;
+    uint64_t t4, rtt;
+    size_t msg_len;
+
+    for (int i = 0; i < rounds; i++) {
+        msg.type = CLOCK_SYNC_PROBE;
+        msg.t1 = NowNs();
+        result = ch.SendTo(&msg, sizeof(msg));
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send clock probe: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        msg_len = sizeof(msg);
+        result = ch.RecvFrom(&msg, &msg_len);
+        t4 = NowNs();
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive clock probe reply: %s", doca_get_error_string(result));
+            return result;
+        }
+
+        rtt = (t4 - msg.t1) - (msg.t3 - msg.t2);
+        if (rtt < best.rtt_ns) {
+            best.rtt_ns = rtt;
+            best.local_ns = msg.t1 + (t4 - msg.t1) / 2;
+            best.offset_ns = ((int64_t)(msg.t2 - msg.t1) + (int64_t)(msg.t3 - t4)) / 2;
+        }
+    }
+
+    msg.type = CLOCK_SYNC_DONE;
+    result = ch.SendTo(&msg, sizeof(msg));
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to finish clock sync: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    points.push_back(best);
+    if (points.size() > CLOCK_SYNC_MAX_POINTS) points.erase(points.begin());
+    Fit();
+
+    DOCA_LOG_INFO("Clock offset %" PRId64 " ns (probe RTT %" PRIu64 " ns), drift %.3f ppm", best.offset_ns,
+                  best.rtt_ns, DriftPpm());
+    return DOCA_SUCCESS;
+}
+
+doca_error_t ClockSync::Serve(CommEndpoint &ch) {
+    struct clock_sync_msg msg;
+    doca_error_t result;
+    size_t msg_len;
+
+    for (;;) {
+        msg_len = sizeof(msg);
+        result = ch.RecvFrom(&msg, &msg_len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive clock probe: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (msg.type == CLOCK_SYNC_DONE) return DOCA_SUCCESS;
+
+        msg.t2 = NowNs();
+        msg.t3 = NowNs();
+        result = ch.SendTo(&msg, sizeof(msg));
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to reply to clock probe: %s", doca_get_error_string(result));
+            return result;
+        }
+    }
+}
+
+void ClockSync::Fit() {
+    double n = points.size(), mean_t = 0, mean_o = 0, cov = 0, var = 0;
+
+    skew = 0.0;
+    fit_local_ns = points.back().local_ns;
+    fit_offset = points.back().offset_ns;
+    if (points.size() < 2) return;
+
+    /* Least squares over times relative to the first point to keep the doubles precise */
+    for (auto &p : points) {
+        mean_t += (double)(p.local_ns - points.front().local_ns) / n;
+        mean_o += (double)p.offset_ns / n;
+    }
+    for (auto &p : points) {
+        double dt = (double)(p.local_ns - points.front().local_ns) - mean_t;
+        cov += dt * ((double)p.offset_ns - mean_o);
+        var += dt * dt;
+    }
+    if (var <= 0) return;
+
+    skew = cov / var;
+    fit_local_ns = points.front().local_ns + (uint64_t)mean_t;
+    fit_offset = mean_o;
+}
+
+int64_t ClockSync::Offset(uint64_t local_ns) const {
+    if (points.empty()) return 0;
+
+    return (int64_t)(fit_offset + skew * (double)(int64_t)(local_ns - fit_local_ns));
+}
+
+uint64_t ClockSync::FromPeer(uint64_t peer_ns) const {
+    if (points.empty()) return peer_ns;
+
+    /* Offset changes slowly, so evaluating it at the approximate local time is exact enough */
+    uint64_t approx_local = peer_ns - (int64_t)fit_offset;
+    return peer_ns - Offset(approx_local);
+}
+
+}  // namespace doca
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "comm_channel.h"
+
+#define CLOCK_SYNC_ROUNDS 64      /* Probes exchanged per Sync call */
+#define CLOCK_SYNC_MAX_POINTS 16  /* Sync results kept for drift estimation */
+
+namespace doca {
+
+enum clock_sync_msg_type { CLOCK_SYNC_PROBE, CLOCK_SYNC_DONE };
+
+struct clock_sync_msg {
+    uint64_t type;
+    uint64_t t1; /* Initiator send time, initiator clock */
+    uint64_t t2; /* Responder receive time, responder clock */
+    uint64_t t3; /* Responder send time, responder clock */
+};
+
+/* Offset of the peer clock relative to the local clock, observed at local_ns */
+struct clock_sync_point {
+    uint64_t local_ns;
+    int64_t offset_ns;
+    uint64_t rtt_ns;
+};
+
+/*
+ * NTP-style estimation of the offset between the local and the peer's
+ * monotonic clock. Each Sync exchanges a burst of probes and keeps only the
+ * one with the smallest round trip, which bounds its error by half that RTT.
+ * The results of consecutive Sync calls are fitted linearly to track drift.
+ * Both sides must call Sync / Serve in lockstep with no other traffic on the
+ * channel in between.
+ */
+class ClockSync {
+   public:
+    ClockSync() = default;
+
+    doca_error_t Sync(CommEndpoint &ch, int rounds = CLOCK_SYNC_ROUNDS);
+    static doca_error_t Serve(CommEndpoint &ch);
+
+    bool Synced() const { return !points.empty(); }
+    /* peer clock - local clock, at local time local_ns */
+    int64_t Offset(uint64_t local_ns) const;
+    uint64_t ToPeer(uint64_t local_ns) const { return local_ns + Offset(local_ns); }
+    uint64_t FromPeer(uint64_t peer_ns) const;
+    /* Relative drift of the peer clock in parts per million */
+    double DriftPpm() const { return skew * 1e6; }
+    /* Round trip of the probe behind the latest estimate, twice its worst case error */
+    uint64_t LastRtt() const { return points.empty() ? 0 : points.back().rtt_ns; }
+
+   protected:
+    std::vector<clock_sync_point> points;
+    double skew = 0.0;
+    /* Fitted line: offset is fit_offset at fit_local_ns, changing by skew per local ns */
+    uint64_t fit_local_ns = 0;
+    double fit_offset = 0.0;
+
+    void Fit();
+};
+
+}  // namespace doca
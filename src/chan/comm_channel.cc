@@ -3,72 +3,87 @@
 #include <doca_ctx.h>
 #include <doca_dev.h>
 
+#include <string.h>
+
+#include <algorithm>
 #include <stdexcept>
 
-#define SLEEP_IN_NANOS (10 * 1000) /* Sample the job every 10 microseconds  */
+#include "../dev/registry.h"
+#include "../trace/trace.h"
+
+#define SLEEP_IN_NANOS (10 * 1000) /* Sleep between polls of blocking calls under WAIT_SLEEP */
 
 namespace doca {
 
 DOCA_LOG_REGISTER(COMM_CHANNEL);
 
-CommChannel::CommChannel(doca_app_mode mode, const char *dev_pci_addr, const char *dev_rep_pci_addr)
-    : mode(mode), connected(false) {
+CommEndpoint::CommEndpoint(const char *dev_pci_addr, const cc_ep_attr &attr) : connected(false), attr(attr) {
     doca_error_t result;
 
-    result = doca_comm_channel_ep_create(&ep);
-    if (result != DOCA_SUCCESS) {
-        DOCA_LOG_ERR("Failed to create Comm Channel endpoint: %s", doca_get_error_string(result));
-        throw std::runtime_error("Failed to create Comm Channel endpoint");
+    dev = DeviceRegistry::Instance().GetByPci(dev_pci_addr);
+    if (!dev) {
+        DOCA_LOG_ERR("Failed to open Comm Channel DOCA device based on PCI address");
+        throw std::runtime_error("Failed to open Comm Channel DOCA device based on PCI address");
     }
 
-    dev = std::make_shared<DOCADevice>();
-    result = dev->OpenWithPci(dev_pci_addr);
+    result = resolve_attr();
     if (result != DOCA_SUCCESS) {
-        DOCA_LOG_ERR("Failed to open Comm Channel DOCA device based on PCI address");
         dev.reset();
-        throw std::runtime_error("Failed to open Comm Channel DOCA device based on PCI address");
+        throw std::runtime_error("Invalid Comm Channel attributes");
     }
 
-    /* Open DOCA device representor on DPU side */
-    if (mode == DOCA_MODE_DPU) {
-        dev_rep = std::make_shared<DOCADeviceRep>();
-        result = dev_rep->OpenWithPci(*dev, DOCA_DEV_REP_FILTER_NET, dev_rep_pci_addr);
-        if (result != DOCA_SUCCESS) {
-            DOCA_LOG_ERR("Failed to open Comm Channel DOCA device representor based on PCI address");
-            doca_comm_channel_ep_destroy(ep);
-            dev.reset();
-            throw std::runtime_error("Failed to open Comm Channel DOCA device representor based on PCI address");
-        }
+    if (this->attr.flow_control) {
+        tx_buf.resize(this->attr.max_msg_size);
+        stash.resize(this->attr.recv_pool_size);
     }
+    pool.resize((size_t)this->attr.recv_pool_size * this->attr.max_msg_size);
+    pool_len.resize(this->attr.recv_pool_size);
+    lent.assign(this->attr.recv_pool_size, false);
+    free_pool.reserve(this->attr.recv_pool_size);
+    for (uint32_t slot = this->attr.recv_pool_size; slot > 0; slot--) free_pool.push_back(slot - 1);
 
-    result = set_cc_properties(mode);
+    result = doca_comm_channel_ep_create(&ep);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to create Comm Channel endpoint: %s", doca_get_error_string(result));
+        ep = nullptr;
+        dev.reset();
+        throw std::runtime_error("Failed to create Comm Channel endpoint");
+    }
+
+    result = set_cc_properties();
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to set Comm Channel properties");
         doca_comm_channel_ep_destroy(ep);
-        if (mode == DOCA_MODE_DPU) dev_rep.reset();
+        ep = nullptr;
         dev.reset();
         throw std::runtime_error("Failed to set Comm Channel properties");
     }
 }
 
-CommChannel::~CommChannel() {
+CommEndpoint::~CommEndpoint() {
+    Destroy();
+    dev.reset();
+}
+
+void CommEndpoint::Destroy() {
     doca_error_t result;
+
+    if (ep == nullptr) return;
     DisConnect();
 
     result = doca_comm_channel_ep_destroy(ep);
     if (result != DOCA_SUCCESS)
         DOCA_LOG_ERR("Failed to destroy Comm Channel endpoint: %s", doca_get_error_string(result));
-
-    dev_rep.reset();
-    dev.reset();
+    ep = nullptr;
 }
 
-doca_error_t CommChannel::Connect(const char *name) {
+CommChannel<Host>::CommChannel(const char *dev_pci_addr, const cc_ep_attr &attr) : CommEndpoint(dev_pci_addr, attr) {}
+
+doca_error_t CommChannel<Host>::Connect(const char *name) {
     struct timespec ts = {
         .tv_nsec = SLEEP_IN_NANOS,
     };
     doca_error_t result;
-    size_t msg_len;
 
     result = doca_comm_channel_ep_connect(ep, name, &peer_addr);
     if (result != DOCA_SUCCESS) {
@@ -86,10 +101,55 @@ doca_error_t CommChannel::Connect(const char *name) {
 
     connected = true;
     DOCA_LOG_INFO("Connection to DPU was established successfully");
+
+    /* Grant our window first, the server answers with its own once it knows our address */
+    if (attr.flow_control) {
+        hello_sent = true;
+        result = SendCtrl(CC_FC_FLAG_HELLO);
+    }
+    return result;
+}
+
+doca_error_t CommChannel<Host>::ConnectRetry(const char *name) {
+    struct timespec ts = {
+        .tv_nsec = CC_CONNECT_RETRY_NANOS,
+    };
+    doca_error_t result = DOCA_ERROR_NOT_CONNECTED;
+
+    for (int i = 0; i < CC_CONNECT_RETRIES; i++) {
+        result = Connect(name);
+        if (result == DOCA_SUCCESS) break;
+        nanosleep(&ts, NULL);
+    }
+
     return result;
 }
 
-doca_error_t CommChannel::DisConnect() {
+CommChannel<Dpu>::CommChannel(const char *dev_pci_addr, const char *dev_rep_pci_addr, const cc_ep_attr &attr)
+    : CommEndpoint(dev_pci_addr, attr) {
+    doca_error_t result;
+
+    dev_rep = std::make_shared<DOCADeviceRep>();
+    result = dev_rep->OpenWithPci(*dev, DOCA_DEV_REP_FILTER_NET, dev_rep_pci_addr);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to open Comm Channel DOCA device representor based on PCI address");
+        throw std::runtime_error("Failed to open Comm Channel DOCA device representor based on PCI address");
+    }
+
+    result = doca_comm_channel_ep_set_device_rep(ep, dev_rep->dev_rep);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to set DOCA device representor property");
+        throw std::runtime_error("Failed to set Comm Channel properties");
+    }
+}
+
+CommChannel<Dpu>::~CommChannel() {
+    /* The endpoint goes first, it was set up on the representor */
+    Destroy();
+    dev_rep.reset();
+}
+
+doca_error_t CommEndpoint::DisConnect() {
     if (!connected) return DOCA_SUCCESS;
     doca_error_t result;
     if (peer_addr) {
@@ -103,46 +163,317 @@ doca_error_t CommChannel::DisConnect() {
     return result;
 }
 
-doca_error_t CommChannel::Listen(const char *name) {
+doca_error_t CommChannel<Dpu>::Listen(const char *name) {
     doca_error_t result;
     result = doca_comm_channel_ep_listen(ep, name);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Comm Channel server couldn't start listening: %s", doca_get_error_string(result));
         return result;
     }
-
     DOCA_LOG_INFO("Server started Listening, waiting for new connections");
     return result;
 }
 
-doca_error_t CommChannel::SendTo(const void *msg, size_t len) {
-    struct timespec ts = {
-        .tv_nsec = SLEEP_IN_NANOS,
-    };
+doca_error_t CommEndpoint::SendTo(const void *msg, size_t len) {
+    if (attr.flow_control) return FcSendTo(msg, len, true);
+
     doca_error_t result;
-    while ((result = doca_comm_channel_ep_sendto(ep, msg, len, DOCA_CC_MSG_FLAG_NONE, peer_addr)) == DOCA_ERROR_AGAIN)
-        ;// nanosleep(&ts, &ts);
+    while ((result = doca_comm_channel_ep_sendto(ep, msg, len, DOCA_CC_MSG_FLAG_NONE, peer_addr)) == DOCA_ERROR_AGAIN) {
+        TRACE_EVENT(TRACE_CC_SEND_RETRY, 0, len);
+        Backoff();
+    }
+    if (result == DOCA_SUCCESS)
+        TRACE_EVENT(TRACE_CC_SEND, 0, len);
+    else
+        TRACE_EVENT(TRACE_CC_SEND_FAIL, 0, result);
 
     return result;
 }
 
-doca_error CommChannel::RecvFrom(void *msg, size_t *len) {
+doca_error CommEndpoint::RecvFrom(void *msg, size_t *len) {
+    if (attr.flow_control) return FcRecvFrom(msg, len, true);
+
     size_t msg_len = *len;
-    struct timespec ts = {
-        .tv_nsec = SLEEP_IN_NANOS,
-    };
     doca_error_t result;
     while ((result = doca_comm_channel_ep_recvfrom(ep, msg, &msg_len, DOCA_CC_MSG_FLAG_NONE, &peer_addr)) ==
            DOCA_ERROR_AGAIN) {
-        ;// nanosleep(&ts, &ts);
+        TRACE_EVENT(TRACE_CC_RECV_MISS, 0, 0);
+        Backoff();
         msg_len = *len;
     }
+    if (result == DOCA_SUCCESS)
+        TRACE_EVENT(TRACE_CC_RECV, 0, msg_len);
+    else
+        TRACE_EVENT(TRACE_CC_RECV_FAIL, 0, result);
 
     *len = msg_len;
     return result;
 }
 
-doca_error_t CommChannel::SendStatusMsg(bool is_success) {
+doca_error_t CommEndpoint::TrySendTo(const void *msg, size_t len) {
+    if (attr.flow_control) return FcSendTo(msg, len, false);
+
+    doca_error_t result = doca_comm_channel_ep_sendto(ep, msg, len, DOCA_CC_MSG_FLAG_NONE, peer_addr);
+    if (result == DOCA_SUCCESS)
+        TRACE_EVENT(TRACE_CC_SEND, 0, len);
+    else if (result == DOCA_ERROR_AGAIN)
+        TRACE_EVENT(TRACE_CC_SEND_RETRY, 0, len);
+    else
+        TRACE_EVENT(TRACE_CC_SEND_FAIL, 0, result);
+    return result;
+}
+
+doca_error_t CommEndpoint::TryRecvFrom(void *msg, size_t *len) {
+    if (attr.flow_control) return FcRecvFrom(msg, len, false);
+
+    doca_error_t result = doca_comm_channel_ep_recvfrom(ep, msg, len, DOCA_CC_MSG_FLAG_NONE, &peer_addr);
+    if (result == DOCA_SUCCESS)
+        TRACE_EVENT(TRACE_CC_RECV, 0, *len);
+    else if (result == DOCA_ERROR_AGAIN)
+        TRACE_EVENT(TRACE_CC_RECV_MISS, 0, 0);
+    else
+        TRACE_EVENT(TRACE_CC_RECV_FAIL, 0, result);
+    return result;
+}
+
+/* Fill in attributes left to the device and clamp the rest to what the device supports */
+doca_error_t CommEndpoint::resolve_attr() {
+    const device_profile &profile = dev->Profile();
+    uint32_t max_msg_size = profile.cc_max_msg_size ? std::min<uint32_t>(profile.cc_max_msg_size, UINT16_MAX)
+                                                    : CC_MAX_MSG_SIZE;
+
+    if (attr.max_msg_size == 0) attr.max_msg_size = max_msg_size;
+    if (attr.max_msg_size > max_msg_size) {
+        DOCA_LOG_WARN("Message size %u exceeds the device limit, using %u", attr.max_msg_size, max_msg_size);
+        attr.max_msg_size = max_msg_size;
+    }
+    if (profile.cc_max_send_queue_size && attr.send_queue_size > profile.cc_max_send_queue_size) {
+        DOCA_LOG_WARN("Send queue size %u exceeds the device limit, using %u", attr.send_queue_size,
+                      profile.cc_max_send_queue_size);
+        attr.send_queue_size = profile.cc_max_send_queue_size;
+    }
+    if (profile.cc_max_recv_queue_size && attr.recv_queue_size > profile.cc_max_recv_queue_size) {
+        DOCA_LOG_WARN("Receive queue size %u exceeds the device limit, using %u", attr.recv_queue_size,
+                      profile.cc_max_recv_queue_size);
+        attr.recv_queue_size = profile.cc_max_recv_queue_size;
+    }
+    if (attr.recv_pool_size == 0) attr.recv_pool_size = std::min<uint32_t>(2 * attr.recv_queue_size, UINT16_MAX);
+
+    if (attr.flow_control) {
+        if (attr.recv_queue_size <= CC_FC_CTRL_SLOTS || attr.max_msg_size <= sizeof(cc_fc_hdr)) {
+            DOCA_LOG_ERR("Flow control needs a receive queue larger than %d", CC_FC_CTRL_SLOTS);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        /* A full window may have to be stashed while waiting for credits */
+        if (attr.recv_pool_size <= GrantSize()) {
+            DOCA_LOG_WARN("Receive pool of %u buffers cannot hold the %u message window, using %u",
+                          attr.recv_pool_size, GrantSize(), GrantSize() + 1);
+            attr.recv_pool_size = GrantSize() + 1;
+        }
+    }
+
+    return DOCA_SUCCESS;
+}
+
+void CommEndpoint::Backoff() const {
+    struct timespec ts = {
+        .tv_nsec = SLEEP_IN_NANOS,
+    };
+
+    if (attr.wait == WAIT_SLEEP) nanosleep(&ts, NULL);
+}
+
+uint32_t CommEndpoint::GrantSize() const { return attr.recv_queue_size - CC_FC_CTRL_SLOTS; }
+
+doca_error_t CommEndpoint::SendCtrl(uint16_t flags) {
+    struct cc_fc_hdr hdr;
+    doca_error_t result;
+
+    hdr.flags = flags;
+    hdr.credits = (flags & CC_FC_FLAG_HELLO) ? GrantSize() : return_credits;
+    while ((result = doca_comm_channel_ep_sendto(ep, &hdr, sizeof(hdr), DOCA_CC_MSG_FLAG_NONE, peer_addr)) ==
+           DOCA_ERROR_AGAIN)
+        Backoff();
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to send credit update: %s", doca_get_error_string(result));
+        return result;
+    }
+
+    if (!(flags & CC_FC_FLAG_HELLO)) return_credits = 0;
+    return DOCA_SUCCESS;
+}
+
+/*
+ * One endpoint receive attempt into a free pool slot. With flow control, credits are absorbed from every
+ * message and credit only messages leave the slot free and are reported as DOCA_ERROR_AGAIN. On success the
+ * slot holds a data message and is owned by the caller.
+ */
+doca_error_t CommEndpoint::RecvSlot(uint32_t *slot) {
+    struct cc_fc_hdr *hdr;
+    size_t msg_len = attr.max_msg_size;
+    doca_error_t result;
+    uint32_t id;
+
+    if (free_pool.empty()) return DOCA_ERROR_NO_MEMORY;
+    id = free_pool.back();
+    hdr = (struct cc_fc_hdr *)SlotData(id);
+
+    result = doca_comm_channel_ep_recvfrom(ep, SlotData(id), &msg_len, DOCA_CC_MSG_FLAG_NONE, &peer_addr);
+    if (result != DOCA_SUCCESS) {
+        if (result == DOCA_ERROR_AGAIN)
+            TRACE_EVENT(TRACE_CC_RECV_MISS, 0, 0);
+        else
+            TRACE_EVENT(TRACE_CC_RECV_FAIL, 0, result);
+        return result;
+    }
+    TRACE_EVENT(TRACE_CC_RECV, 0, msg_len);
+
+    if (attr.flow_control) {
+        if (msg_len < sizeof(*hdr)) {
+            DOCA_LOG_ERR("Received message without flow control header, is flow control enabled on the peer?");
+            return DOCA_ERROR_UNEXPECTED;
+        }
+
+        send_credits += hdr->credits;
+        if ((hdr->flags & CC_FC_FLAG_HELLO) && !hello_sent) {
+            hello_sent = true;
+            result = SendCtrl(CC_FC_FLAG_HELLO);
+            if (result != DOCA_SUCCESS) return result;
+        }
+        if (hdr->flags != CC_FC_FLAG_DATA) return DOCA_ERROR_AGAIN;
+    }
+
+    free_pool.pop_back();
+    pool_len[id] = msg_len - PayloadOffset();
+    *slot = id;
+    return DOCA_SUCCESS;
+}
+
+/* Next data message, taken from the stash before the endpoint */
+doca_error_t CommEndpoint::NextSlot(uint32_t *slot, bool block) {
+    doca_error_t result;
+
+    if (stash_count > 0) {
+        *slot = stash[stash_head];
+        stash_head = (stash_head + 1) % stash.size();
+        stash_count--;
+        return DOCA_SUCCESS;
+    }
+
+    while ((result = RecvSlot(slot)) == DOCA_ERROR_AGAIN && block) Backoff();
+
+    return result;
+}
+
+doca_error_t CommEndpoint::ReleaseSlot(uint32_t slot) {
+    free_pool.push_back(slot);
+    if (!attr.flow_control) return DOCA_SUCCESS;
+
+    /* Hand the slot back once half the window is due, unless a data message carries it first */
+    if (++return_credits >= (GrantSize() + 1) / 2) return SendCtrl(CC_FC_FLAG_CREDIT);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CommEndpoint::FcSendTo(const void *msg, size_t len, bool block) {
+    struct cc_fc_hdr *hdr = (struct cc_fc_hdr *)tx_buf.data();
+    doca_error_t result;
+
+    if (len > MaxPayload()) {
+        DOCA_LOG_ERR("Message of %zu bytes exceeds the %zu byte flow controlled payload", len, MaxPayload());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    /* Out of credits: keep draining incoming messages until the peer returns some */
+    while (send_credits == 0) {
+        uint32_t slot;
+
+        result = RecvSlot(&slot);
+        if (result == DOCA_SUCCESS) {
+            stash[(stash_head + stash_count++) % stash.size()] = slot;
+        } else if (result == DOCA_ERROR_NO_MEMORY) {
+            DOCA_LOG_ERR("Receive pool exhausted while waiting for credits, release borrowed messages");
+            return result;
+        } else if (result != DOCA_ERROR_AGAIN) {
+            return result;
+        }
+        if (send_credits > 0) break;
+        TRACE_EVENT(TRACE_CC_SEND_RETRY, 0, len);
+        if (!block) return DOCA_ERROR_AGAIN;
+        Backoff();
+    }
+
+    hdr->credits = return_credits;
+    hdr->flags = CC_FC_FLAG_DATA;
+    memcpy(tx_buf.data() + sizeof(*hdr), msg, len);
+
+    while ((result = doca_comm_channel_ep_sendto(ep, tx_buf.data(), len + sizeof(*hdr), DOCA_CC_MSG_FLAG_NONE,
+                                                 peer_addr)) == DOCA_ERROR_AGAIN) {
+        TRACE_EVENT(TRACE_CC_SEND_RETRY, 0, len);
+        if (!block) break;
+        Backoff();
+    }
+    if (result != DOCA_SUCCESS) {
+        if (result != DOCA_ERROR_AGAIN) TRACE_EVENT(TRACE_CC_SEND_FAIL, 0, result);
+        return result;
+    }
+    TRACE_EVENT(TRACE_CC_SEND, 0, len);
+
+    return_credits -= hdr->credits;
+    send_credits--;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CommEndpoint::FcRecvFrom(void *msg, size_t *len, bool block) {
+    doca_error_t result;
+    uint32_t slot;
+
+    result = NextSlot(&slot, block);
+    if (result != DOCA_SUCCESS) return result;
+
+    if (pool_len[slot] > *len) {
+        DOCA_LOG_ERR("Message of %u bytes does not fit the %zu byte receive buffer", pool_len[slot], *len);
+        ReleaseSlot(slot);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    memcpy(msg, SlotData(slot) + PayloadOffset(), pool_len[slot]);
+    *len = pool_len[slot];
+
+    return ReleaseSlot(slot);
+}
+
+doca_error_t CommEndpoint::BorrowSlot(cc_recv_lease *lease, bool block) {
+    doca_error_t result;
+    uint32_t slot;
+
+    result = NextSlot(&slot, block);
+    if (result != DOCA_SUCCESS) return result;
+
+    lease->data = SlotData(slot) + PayloadOffset();
+    lease->len = pool_len[slot];
+    lease->token = slot;
+    lent[slot] = true;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CommEndpoint::RecvBorrow(cc_recv_lease *lease) { return BorrowSlot(lease, true); }
+
+doca_error_t CommEndpoint::TryRecvBorrow(cc_recv_lease *lease) { return BorrowSlot(lease, false); }
+
+doca_error_t CommEndpoint::Release(const cc_recv_lease &lease) {
+    if (lease.token >= attr.recv_pool_size) {
+        DOCA_LOG_ERR("Invalid receive lease token %u", lease.token);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    /* Freeing a slot twice would hand it to two receives and credit the peer twice */
+    if (!lent[lease.token]) {
+        DOCA_LOG_ERR("Receive lease %u is not outstanding, it was already released", lease.token);
+        return DOCA_ERROR_BAD_STATE;
+    }
+    lent[lease.token] = false;
+    return ReleaseSlot(lease.token);
+}
+
+doca_error_t CommEndpoint::SendStatusMsg(bool is_success) {
     doca_error_t result;
     struct cc_msg_status msg_status;
     size_t msg_len = sizeof(struct cc_msg_status);
@@ -157,7 +488,7 @@ doca_error_t CommChannel::SendStatusMsg(bool is_success) {
     return DOCA_SUCCESS;
 }
 
-doca_error_t CommChannel::WaitForSuccessfulMsg() {
+doca_error_t CommEndpoint::WaitForSuccessfulMsg() {
     struct cc_msg_status msg_status;
     doca_error_t result;
     size_t msg_len = sizeof(struct cc_msg_status);
@@ -176,7 +507,7 @@ doca_error_t CommChannel::WaitForSuccessfulMsg() {
     return DOCA_SUCCESS;
 }
 
-doca_error_t CommChannel::set_cc_properties(doca_app_mode mode) {
+doca_error_t CommEndpoint::set_cc_properties() {
     doca_error_t result;
 
     result = doca_comm_channel_ep_set_device(ep, dev->dev);
@@ -185,29 +516,24 @@ doca_error_t CommChannel::set_cc_properties(doca_app_mode mode) {
         return result;
     }
 
-    result = doca_comm_channel_ep_set_max_msg_size(ep, CC_MAX_MSG_SIZE);
+    result = doca_comm_channel_ep_set_max_msg_size(ep, attr.max_msg_size);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to set max_msg_size property");
         return result;
     }
 
-    result = doca_comm_channel_ep_set_send_queue_size(ep, CC_MAX_QUEUE_SIZE);
+    result = doca_comm_channel_ep_set_send_queue_size(ep, attr.send_queue_size);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to set snd_queue_size property");
         return result;
     }
 
-    result = doca_comm_channel_ep_set_recv_queue_size(ep, CC_MAX_QUEUE_SIZE);
+    result = doca_comm_channel_ep_set_recv_queue_size(ep, attr.recv_queue_size);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to set rcv_queue_size property");
         return result;
     }
 
-    if (mode == DOCA_MODE_DPU) {
-        result = doca_comm_channel_ep_set_device_rep(ep, dev_rep->dev_rep);
-        if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to set DOCA device representor property");
-    }
-
     return result;
 }
 
@@ -5,6 +5,7 @@
 #include <doca_log.h>
 
 #include <memory>
+#include <vector>
 
 #include "../common.h"
 #include "../dev/device.h"
@@ -13,6 +14,10 @@
 #define MAX_DMA_BUF_SIZE (1024 * 1024) /* DMA buffer maximum size */
 #define CC_MAX_MSG_SIZE 4080           /* Comm Channel message maximum size */
 #define CC_MAX_QUEUE_SIZE 10           /* Max number of messages on Comm Channel queue */
+#define CC_FC_CTRL_SLOTS 2             /* Receive queue slots kept free of data for credit updates */
+
+#define CC_CONNECT_RETRIES 100                 /* ConnectRetry attempts on a service that is not listening yet */
+#define CC_CONNECT_RETRY_NANOS (100 * 1000000) /* Delay between connection attempts */
 
 namespace doca {
 
@@ -20,30 +25,155 @@ struct cc_msg_status {
     bool is_success;
 };
 
-class CommChannel {
+/*
+ * Endpoint attributes, fixed at creation. Flow control must match on both sides.
+ * Sizes are clamped to the device limits; 0 leaves the choice to the device profile.
+ */
+struct cc_ep_attr {
+    uint16_t max_msg_size = 0;                    /* Largest message on the wire, flow control header included */
+    uint16_t send_queue_size = CC_MAX_QUEUE_SIZE; /* Endpoint send queue depth */
+    uint16_t recv_queue_size = CC_MAX_QUEUE_SIZE; /* Endpoint receive queue depth */
+    uint16_t recv_pool_size = 0;                  /* Receive buffers for lending, twice the receive queue if 0 */
+    bool flow_control = false;                    /* Credit-based flow control */
+    wait_policy wait = WAIT_SPIN;                 /* How blocking calls poll the endpoint */
+};
+
+/*
+ * A received message lent out of the endpoint's receive pool. data stays
+ * valid, and may be modified in place, until the lease is handed back with
+ * Release(); no other receive reuses the buffer in the meantime.
+ */
+struct cc_recv_lease {
+    char *data;
+    size_t len;
+    uint32_t token; /* Pool slot, identifies the lease to Release() */
+};
+
+enum cc_fc_flags {
+    CC_FC_FLAG_DATA = 0,         /* Payload follows the header */
+    CC_FC_FLAG_CREDIT = 1 << 0,  /* Credit update only, no payload */
+    CC_FC_FLAG_HELLO = 1 << 1,   /* Initial grant, answered by the peer with its own */
+};
+
+/*
+ * Prepended to every message when flow control is on. credits returns
+ * receive slots the sender has freed since its last update; they ride on
+ * data messages and are only sent on their own once half the window is due.
+ */
+struct cc_fc_hdr {
+    uint16_t credits;
+    uint16_t flags;
+};
+
+/*
+ * Mode independent part of a Comm Channel endpoint: the data path, flow
+ * control and the receive pool. Endpoints are created as CommChannel<Host>,
+ * which connects, or CommChannel<Dpu>, which listens through the device
+ * representor; code that only exchanges messages takes a CommEndpoint.
+ */
+class CommEndpoint {
    public:
-    CommChannel(doca_app_mode mode, const char *dev_pci_addr, const char *dev_rep_pci_addr);
-    ~CommChannel();
+    CommEndpoint(const CommEndpoint &) = delete;
+    CommEndpoint &operator=(const CommEndpoint &) = delete;
 
-    doca_error_t Connect(const char *name);
     doca_error_t DisConnect();
-    doca_error_t Listen(const char *name);
     doca_error_t SendTo(const void *msg, size_t len);
     doca_error RecvFrom(void *msg, size_t *len);
+    /* Single attempt variants, return DOCA_ERROR_AGAIN instead of spinning */
+    doca_error_t TrySendTo(const void *msg, size_t len);
+    doca_error_t TryRecvFrom(void *msg, size_t *len);
+    /*
+     * Zero-copy receive: the message lands in a pool buffer that is lent to
+     * the caller instead of being copied out. DOCA_ERROR_NO_MEMORY means every
+     * pool buffer is still lent. With flow control the slot is credited back
+     * to the peer on Release(), so held leases throttle the sender.
+     */
+    doca_error_t RecvBorrow(cc_recv_lease *lease);
+    doca_error_t TryRecvBorrow(cc_recv_lease *lease);
+    doca_error_t Release(const cc_recv_lease &lease);
     doca_error_t SendStatusMsg(bool is_success);
     doca_error_t SendSuccessfulMsg() { return SendStatusMsg(true); }
     doca_error_t SendFailMsg() { return SendStatusMsg(false); }
     doca_error_t WaitForSuccessfulMsg();
 
+    /* Attributes in effect, after device defaults and limits were applied */
+    const cc_ep_attr &Attr() const { return attr; }
+    /* Largest payload SendTo accepts */
+    size_t MaxPayload() const { return attr.max_msg_size - (attr.flow_control ? sizeof(cc_fc_hdr) : 0); }
+    /* Data messages that may be sent before the peer returns credits */
+    uint32_t SendCredits() const { return send_credits; }
+    /* Pool buffers not currently lent or holding stashed messages */
+    size_t FreeRecvBuffers() const { return free_pool.size(); }
+
    protected:
-    struct doca_comm_channel_ep_t *ep;
-    struct doca_comm_channel_addr_t *peer_addr;
+    /* Only through CommChannel<Host> and CommChannel<Dpu> */
+    CommEndpoint(const char *dev_pci_addr, const cc_ep_attr &attr);
+    ~CommEndpoint();
+
+    struct doca_comm_channel_ep_t *ep = nullptr;
+    struct doca_comm_channel_addr_t *peer_addr = nullptr;
     std::shared_ptr<DOCADevice> dev;
-    std::shared_ptr<DOCADeviceRep> dev_rep;
-    doca_app_mode mode;
     bool connected;
+    cc_ep_attr attr;
+
+    /* Flow control state */
+    uint32_t send_credits = 0;   /* Data messages the peer can still take */
+    uint32_t return_credits = 0; /* Messages consumed locally and not yet credited back */
+    bool hello_sent = false;
+    std::vector<char> tx_buf;
 
-    doca_error_t set_cc_properties(doca_app_mode mode);
+    /* Receive pool, recv_pool_size buffers of max_msg_size allocated once at creation */
+    std::vector<char> pool;
+    std::vector<uint32_t> pool_len;  /* Payload length of each slot */
+    std::vector<uint32_t> free_pool; /* Slots available for the next receive */
+    std::vector<bool> lent;          /* Slots out on a lease, a second Release of one is refused */
+    std::vector<uint32_t> stash;     /* Ring of slots received while waiting for credits */
+    size_t stash_head = 0;
+    size_t stash_count = 0;
+
+    /* Disconnect and destroy the endpoint, before the device handles it uses are released */
+    void Destroy();
+    doca_error_t set_cc_properties();
+    doca_error_t resolve_attr();
+    /* Pause between polls of a blocking call, according to attr.wait */
+    void Backoff() const;
+    uint32_t GrantSize() const;
+    size_t PayloadOffset() const { return attr.flow_control ? sizeof(cc_fc_hdr) : 0; }
+    char *SlotData(uint32_t slot) { return pool.data() + (size_t)slot * attr.max_msg_size; }
+    doca_error_t SendCtrl(uint16_t flags);
+    doca_error_t RecvSlot(uint32_t *slot);
+    doca_error_t NextSlot(uint32_t *slot, bool block);
+    doca_error_t ReleaseSlot(uint32_t slot);
+    doca_error_t FcSendTo(const void *msg, size_t len, bool block);
+    doca_error_t FcRecvFrom(void *msg, size_t *len, bool block);
+    doca_error_t BorrowSlot(cc_recv_lease *lease, bool block);
+};
+
+template <typename Mode>
+class CommChannel;
+
+/* Host side endpoint, connects to a service the DPU listens on */
+template <>
+class CommChannel<Host> : public CommEndpoint {
+   public:
+    CommChannel(const char *dev_pci_addr, const cc_ep_attr &attr = cc_ep_attr());
+
+    doca_error_t Connect(const char *name);
+    /* Connect, retrying while the DPU side is not listening yet, for services it brings up on demand */
+    doca_error_t ConnectRetry(const char *name);
+};
+
+/* DPU side endpoint, listens on a service through the device representor of the host */
+template <>
+class CommChannel<Dpu> : public CommEndpoint {
+   public:
+    CommChannel(const char *dev_pci_addr, const char *dev_rep_pci_addr, const cc_ep_attr &attr = cc_ep_attr());
+    ~CommChannel();
+
+    doca_error_t Listen(const char *name);
+
+   protected:
+    std::shared_ptr<DOCADeviceRep> dev_rep;
 };
 
 }  // namespace doca
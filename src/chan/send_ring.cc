@@ -0,0 +1,80 @@
+#include "send_ring.h"
+
+#include <string.h>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(SEND_RING);
+
+SendRing::SendRing(CommEndpoint &ch, size_t capacity, size_t slot_size)
+    : ch(ch), slot_size(slot_size), head(0), tail(0) {
+    size_t size = 1;
+
+    while (size < capacity) size <<= 1;
+    mask = size - 1;
+
+    slots.reset(new send_ring_slot[size]);
+    for (size_t i = 0; i < size; i++) slots[i].seq.store(i, std::memory_order_relaxed);
+    data.resize(size * slot_size);
+}
+
+doca_error_t SendRing::Enqueue(const void *msg, size_t len) {
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    send_ring_slot *slot;
+    int64_t diff;
+
+    if (len > slot_size) {
+        DOCA_LOG_ERR("Message of %zu bytes exceeds the %zu byte ring slot", len, slot_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    for (;;) {
+        slot = &slots[pos & mask];
+        diff = (int64_t)(slot->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            /* Slot still holds the message from one lap ago */
+            return DOCA_ERROR_AGAIN;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(&data[(pos & mask) * slot_size], msg, len);
+    slot->len = len;
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t SendRing::Drain(size_t max_batch, size_t *sent) {
+    send_ring_slot *slot;
+    doca_error_t result;
+    size_t n = 0;
+
+    while (n < max_batch) {
+        slot = &slots[tail & mask];
+        if (slot->seq.load(std::memory_order_acquire) != tail + 1) break;
+
+        result = ch.TrySendTo(&data[(tail & mask) * slot_size], slot->len);
+        if (result == DOCA_ERROR_AGAIN) break;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send queued message: %s", doca_get_error_string(result));
+            *sent = n;
+            return result;
+        }
+
+        slot->seq.store(tail + mask + 1, std::memory_order_release);
+        tail++;
+        n++;
+    }
+
+    *sent = n;
+    return DOCA_SUCCESS;
+}
+
+bool SendRing::Empty() const {
+    return slots[tail & mask].seq.load(std::memory_order_acquire) != tail + 1;
+}
+
+}  // namespace doca
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "comm_channel.h"
+
+#define CACHE_LINE_SIZE 64
+
+namespace doca {
+
+struct alignas(CACHE_LINE_SIZE) send_ring_slot {
+    std::atomic<uint64_t> seq; /* Ring position the slot is free for, or that position + 1 once filled */
+    uint32_t len;
+};
+
+/*
+ * Bounded lock-free multi-producer single-consumer queue in front of a
+ * CommChannel endpoint. Any thread may Enqueue; the message is copied into
+ * a preallocated slot and Enqueue never blocks. A single owner thread calls
+ * Drain to hand queued messages to the endpoint in batches, so the endpoint
+ * itself is only ever touched by that thread.
+ */
+class SendRing {
+   public:
+    /* capacity is rounded up to a power of two, slot_size bounds the message length */
+    SendRing(CommEndpoint &ch, size_t capacity, size_t slot_size = CC_MAX_MSG_SIZE);
+
+    /* Any thread. DOCA_ERROR_AGAIN if the ring is full, DOCA_ERROR_INVALID_VALUE if len exceeds the slot size */
+    doca_error_t Enqueue(const void *msg, size_t len);
+    /*
+     * Owner thread only. Sends up to max_batch messages in enqueue order and stores the count in *sent.
+     * Stops early without error when the ring is empty or the endpoint send queue is full.
+     */
+    doca_error_t Drain(size_t max_batch, size_t *sent);
+    /* Owner thread only */
+    bool Empty() const;
+
+    size_t Capacity() const { return mask + 1; }
+    size_t SlotSize() const { return slot_size; }
+
+   protected:
+    CommEndpoint &ch;
+    size_t mask;
+    size_t slot_size;
+    std::unique_ptr<send_ring_slot[]> slots;
+    std::vector<char> data;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head; /* Next position producers claim */
+    alignas(CACHE_LINE_SIZE) uint64_t tail;              /* Next position the owner sends */
+};
+
+}  // namespace doca
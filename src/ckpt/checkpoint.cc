@@ -0,0 +1,421 @@
+#include "checkpoint.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+
+#include "../stats/clock.h"
+#include "../util/crc32c.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(CHECKPOINT);
+
+namespace {
+
+/*
+ * Buffers moving between the DMA stage on the calling thread and the file
+ * stage on its own thread. Either stage stops both by setting error.
+ */
+struct ckpt_ring {
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<uint32_t> free_bufs;
+    std::deque<std::pair<uint32_t, size_t>> ready; /* Buffer and the chunk it holds */
+    bool done = false;                             /* Save only: no more ready buffers will come */
+    doca_error_t error = DOCA_SUCCESS;
+
+    void Fail(doca_error_t result) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (error == DOCA_SUCCESS) error = result;
+        cv.notify_all();
+    }
+};
+
+}  // namespace
+
+Checkpointer::Checkpointer(DOCADma<Dpu> &dma, MemMap &remote, const ckpt_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.chunk_size == 0 || attr.chunk_size % CKPT_IO_ALIGN != 0 || attr.chunk_size > UINT32_MAX ||
+        attr.nb_buffers == 0 || remote.Len() == 0) {
+        DOCA_LOG_ERR("Invalid checkpoint settings: %zu buffers of %zu bytes over %zu remote bytes", attr.nb_buffers,
+                     attr.chunk_size, remote.Len());
+        throw std::runtime_error("Invalid checkpoint settings");
+    }
+    if (attr.chunk_size > dma.MaxBufSize()) {
+        DOCA_LOG_ERR("Chunk size %zu exceeds the device DMA limit of %" PRIu64 " bytes", attr.chunk_size,
+                     dma.MaxBufSize());
+        throw std::runtime_error("Chunk size exceeds the device DMA limit");
+    }
+
+    result = dma.AddMMap(pool);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to checkpoint buffers");
+    /* Room to align the first buffer for O_DIRECT */
+    result = pool.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.chunk_size * attr.nb_buffers + CKPT_IO_ALIGN);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate checkpoint buffers");
+
+    pool_base = (CKPT_IO_ALIGN - (uintptr_t)pool.Data() % CKPT_IO_ALIGN) % CKPT_IO_ALIGN;
+    nb_chunks = (remote.Len() + attr.chunk_size - 1) / attr.chunk_size;
+}
+
+size_t Checkpointer::ChunkLen(size_t chunk) const {
+    return std::min(attr.chunk_size, remote.Len() - chunk * attr.chunk_size);
+}
+
+size_t Checkpointer::IoLen(size_t chunk) const {
+    return (ChunkLen(chunk) + CKPT_IO_ALIGN - 1) / CKPT_IO_ALIGN * CKPT_IO_ALIGN;
+}
+
+doca_error_t Checkpointer::Save(const char *path) {
+    std::vector<uint32_t> crcs(nb_chunks);
+    std::vector<size_t> buf_chunk(attr.nb_buffers);
+    doca_error_t result = DOCA_SUCCESS, drained;
+    std::string manifest;
+    uint64_t start, loop_end, t, wait_ns = 0, io_ns = 0;
+    size_t next = 0, completed = 0, chunk;
+    void *user_data;
+    uint32_t buf;
+    ckpt_ring ring;
+    int fd;
+
+    counters = ckpt_stats();
+    /* An old manifest would vouch for the data while it is being overwritten */
+    manifest = std::string(path) + ".manifest";
+    if (unlink(manifest.c_str()) != 0 && errno != ENOENT) {
+        DOCA_LOG_ERR("Failed to remove stale manifest %s: %s", manifest.c_str(), strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+    fd = OpenFile(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) return DOCA_ERROR_IO_FAILED;
+    for (uint32_t i = 0; i < attr.nb_buffers; i++) ring.free_bufs.push_back(i);
+
+    start = NowNs();
+    std::thread writer([&] {
+        std::unique_lock<std::mutex> guard(ring.lock);
+        uint64_t begin;
+        ssize_t n;
+
+        for (;;) {
+            ring.cv.wait(guard, [&] { return !ring.ready.empty() || ring.done || ring.error != DOCA_SUCCESS; });
+            if (ring.error != DOCA_SUCCESS || ring.ready.empty()) return;
+            auto [wbuf, wchunk] = ring.ready.front();
+            ring.ready.pop_front();
+            guard.unlock();
+
+            begin = NowNs();
+            n = pwrite(fd, BufData(wbuf), IoLen(wchunk), wchunk * attr.chunk_size);
+            io_ns += NowNs() - begin;
+
+            guard.lock();
+            if (n != (ssize_t)IoLen(wchunk)) {
+                DOCA_LOG_ERR("Failed to write chunk %zu of %s: %s", wchunk, path, n < 0 ? strerror(errno) : "short write");
+                if (ring.error == DOCA_SUCCESS) ring.error = DOCA_ERROR_IO_FAILED;
+                ring.cv.notify_all();
+                return;
+            }
+            ring.free_bufs.push_back(wbuf);
+            ring.cv.notify_all();
+        }
+    });
+
+    while (completed < nb_chunks && result == DOCA_SUCCESS) {
+        /* Every free buffer becomes a DMA read of the next chunk */
+        while (next < nb_chunks) {
+            {
+                std::lock_guard<std::mutex> guard(ring.lock);
+                if (ring.error != DOCA_SUCCESS || ring.free_bufs.empty()) break;
+                buf = ring.free_bufs.front();
+                ring.free_bufs.pop_front();
+            }
+            result = dma.Submit(remote, next * attr.chunk_size, pool, BufOffset(buf), ChunkLen(next),
+                                (void *)(uintptr_t)buf);
+            if (result != DOCA_SUCCESS) {
+                std::lock_guard<std::mutex> guard(ring.lock);
+                ring.free_bufs.push_front(buf);
+                break;
+            }
+            buf_chunk[buf] = next++;
+        }
+        if (result == DOCA_ERROR_AGAIN) result = DOCA_SUCCESS;
+        if (result != DOCA_SUCCESS) break;
+
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) {
+            std::unique_lock<std::mutex> guard(ring.lock);
+
+            result = ring.error;
+            if (dma.Inflight() == 0 && result == DOCA_SUCCESS) {
+                /* Every buffer waits for the writer */
+                t = NowNs();
+                ring.cv.wait(guard, [&] { return !ring.free_bufs.empty() || ring.error != DOCA_SUCCESS; });
+                wait_ns += NowNs() - t;
+                result = ring.error;
+            }
+            continue;
+        }
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("DMA read of a chunk failed: %s", doca_get_error_string(result));
+            break;
+        }
+
+        buf = (uint32_t)(uintptr_t)user_data;
+        chunk = buf_chunk[buf];
+        t = NowNs();
+        crcs[chunk] = Crc32c(BufData(buf), ChunkLen(chunk));
+        counters.crc_ns += NowNs() - t;
+
+        std::lock_guard<std::mutex> guard(ring.lock);
+        ring.ready.emplace_back(buf, chunk);
+        ring.cv.notify_all();
+        completed++;
+    }
+    loop_end = NowNs();
+
+    if (result != DOCA_SUCCESS) ring.Fail(result);
+    {
+        std::lock_guard<std::mutex> guard(ring.lock);
+        ring.done = true;
+        ring.cv.notify_all();
+    }
+    writer.join();
+    drained = dma.Drain();
+    if (result == DOCA_SUCCESS) result = ring.error;
+    if (result == DOCA_SUCCESS) result = drained;
+
+    /* The data must be durable before the manifest declares the checkpoint complete */
+    if (result == DOCA_SUCCESS && (ftruncate(fd, remote.Len()) != 0 || fdatasync(fd) != 0)) {
+        DOCA_LOG_ERR("Failed to flush %s: %s", path, strerror(errno));
+        result = DOCA_ERROR_IO_FAILED;
+    }
+    close(fd);
+    if (result == DOCA_SUCCESS) result = WriteManifest(manifest, crcs);
+    if (result != DOCA_SUCCESS) return result;
+
+    counters.total_ns = NowNs() - start;
+    counters.dma_ns = loop_end - start - wait_ns - counters.crc_ns;
+    counters.io_ns = io_ns;
+    counters.bytes = remote.Len();
+    counters.chunks = nb_chunks;
+    DOCA_LOG_INFO("Checkpoint of %zu bytes in %zu chunks saved to %s", remote.Len(), nb_chunks, path);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Checkpointer::Restore(const char *path) {
+    std::vector<uint32_t> crcs;
+    doca_error_t result, drained;
+    uint64_t start, loop_end, t, wait_ns = 0, io_ns = 0;
+    size_t completed = 0, chunk;
+    void *user_data;
+    uint32_t buf;
+    ckpt_ring ring;
+    int fd;
+
+    counters = ckpt_stats();
+    result = ReadManifest(std::string(path) + ".manifest", &crcs);
+    if (result != DOCA_SUCCESS) return result;
+    fd = OpenFile(path, O_RDONLY);
+    if (fd < 0) return DOCA_ERROR_IO_FAILED;
+    for (uint32_t i = 0; i < attr.nb_buffers; i++) ring.free_bufs.push_back(i);
+
+    start = NowNs();
+    std::thread reader([&] {
+        std::unique_lock<std::mutex> guard(ring.lock);
+        uint64_t begin;
+        uint32_t rbuf;
+        ssize_t n;
+
+        for (size_t rchunk = 0; rchunk < nb_chunks; rchunk++) {
+            ring.cv.wait(guard, [&] { return !ring.free_bufs.empty() || ring.error != DOCA_SUCCESS; });
+            if (ring.error != DOCA_SUCCESS) return;
+            rbuf = ring.free_bufs.front();
+            ring.free_bufs.pop_front();
+            guard.unlock();
+
+            /* The file was truncated to the region size, the last read may come back short */
+            begin = NowNs();
+            n = pread(fd, BufData(rbuf), IoLen(rchunk), rchunk * attr.chunk_size);
+            io_ns += NowNs() - begin;
+
+            guard.lock();
+            if (n < (ssize_t)ChunkLen(rchunk)) {
+                DOCA_LOG_ERR("Failed to read chunk %zu of %s: %s", rchunk, path, n < 0 ? strerror(errno) : "short read");
+                if (ring.error == DOCA_SUCCESS) ring.error = DOCA_ERROR_IO_FAILED;
+                ring.cv.notify_all();
+                return;
+            }
+            ring.ready.emplace_back(rbuf, rchunk);
+            ring.cv.notify_all();
+        }
+    });
+
+    while (completed < nb_chunks && result == DOCA_SUCCESS) {
+        /* Every chunk read so far is verified and DMAed to the host */
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> guard(ring.lock);
+                if (ring.error != DOCA_SUCCESS || ring.ready.empty()) break;
+                std::tie(buf, chunk) = ring.ready.front();
+                ring.ready.pop_front();
+            }
+            t = NowNs();
+            if (Crc32c(BufData(buf), ChunkLen(chunk)) != crcs[chunk]) {
+                DOCA_LOG_ERR("Chunk %zu of %s does not match its checksum", chunk, path);
+                result = DOCA_ERROR_IO_FAILED;
+            }
+            counters.crc_ns += NowNs() - t;
+            if (result != DOCA_SUCCESS) break;
+
+            result = dma.Submit(pool, BufOffset(buf), remote, chunk * attr.chunk_size, ChunkLen(chunk),
+                                (void *)(uintptr_t)buf);
+            if (result != DOCA_SUCCESS) {
+                std::lock_guard<std::mutex> guard(ring.lock);
+                ring.ready.emplace_front(buf, chunk);
+                break;
+            }
+        }
+        if (result == DOCA_ERROR_AGAIN) result = DOCA_SUCCESS;
+        if (result != DOCA_SUCCESS) break;
+
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) {
+            std::unique_lock<std::mutex> guard(ring.lock);
+
+            result = ring.error;
+            if (dma.Inflight() == 0 && result == DOCA_SUCCESS) {
+                /* Nothing to DMA until the reader delivers */
+                t = NowNs();
+                ring.cv.wait(guard, [&] { return !ring.ready.empty() || ring.error != DOCA_SUCCESS; });
+                wait_ns += NowNs() - t;
+                result = ring.error;
+            }
+            continue;
+        }
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("DMA write of a chunk failed: %s", doca_get_error_string(result));
+            break;
+        }
+
+        std::lock_guard<std::mutex> guard(ring.lock);
+        ring.free_bufs.push_back((uint32_t)(uintptr_t)user_data);
+        ring.cv.notify_all();
+        completed++;
+    }
+    loop_end = NowNs();
+
+    if (result != DOCA_SUCCESS) ring.Fail(result);
+    reader.join();
+    drained = dma.Drain();
+    close(fd);
+    if (result == DOCA_SUCCESS) result = ring.error;
+    if (result == DOCA_SUCCESS) result = drained;
+    if (result != DOCA_SUCCESS) return result;
+
+    counters.total_ns = NowNs() - start;
+    counters.dma_ns = loop_end - start - wait_ns - counters.crc_ns;
+    counters.io_ns = io_ns;
+    counters.bytes = remote.Len();
+    counters.chunks = nb_chunks;
+    DOCA_LOG_INFO("Checkpoint of %zu bytes in %zu chunks restored from %s", remote.Len(), nb_chunks, path);
+    return DOCA_SUCCESS;
+}
+
+int Checkpointer::OpenFile(const char *path, int flags) {
+    int fd;
+
+    counters.direct_io = false;
+    if (attr.direct_io) {
+        fd = open(path, flags | O_DIRECT, 0644);
+        if (fd >= 0) {
+            counters.direct_io = true;
+            return fd;
+        }
+        /* tmpfs and some others refuse O_DIRECT */
+        if (errno != EINVAL) {
+            DOCA_LOG_ERR("Failed to open %s: %s", path, strerror(errno));
+            return -1;
+        }
+        DOCA_LOG_WARN("O_DIRECT not supported for %s, using buffered I/O", path);
+    }
+
+    fd = open(path, flags, 0644);
+    if (fd < 0) DOCA_LOG_ERR("Failed to open %s: %s", path, strerror(errno));
+    return fd;
+}
+
+doca_error_t Checkpointer::WriteManifest(const std::string &path, const std::vector<uint32_t> &crcs) {
+    std::string tmp = path + ".tmp";
+    ckpt_manifest_hdr hdr = {};
+    size_t len = crcs.size() * sizeof(uint32_t);
+    bool ok;
+    int fd;
+
+    memcpy(hdr.magic, CKPT_MAGIC, sizeof(hdr.magic));
+    hdr.version = CKPT_VERSION;
+    hdr.chunk_size = attr.chunk_size;
+    hdr.region_size = remote.Len();
+    hdr.nb_chunks = crcs.size();
+
+    /* Written aside and renamed, a crash never leaves a manifest that is half there */
+    fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        DOCA_LOG_ERR("Failed to create %s: %s", tmp.c_str(), strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+    ok = write(fd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) && write(fd, crcs.data(), len) == (ssize_t)len &&
+         fdatasync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        DOCA_LOG_ERR("Failed to write manifest %s: %s", path.c_str(), strerror(errno));
+        unlink(tmp.c_str());
+        return DOCA_ERROR_IO_FAILED;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Checkpointer::ReadManifest(const std::string &path, std::vector<uint32_t> *crcs) {
+    ckpt_manifest_hdr hdr;
+    size_t len;
+    bool ok;
+    int fd;
+
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        DOCA_LOG_ERR("Failed to open manifest %s: %s", path.c_str(), strerror(errno));
+        return DOCA_ERROR_NOT_FOUND;
+    }
+    ok = read(fd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) && memcmp(hdr.magic, CKPT_MAGIC, sizeof(hdr.magic)) == 0 &&
+         hdr.version == CKPT_VERSION;
+    if (ok && (hdr.region_size != remote.Len() || hdr.chunk_size != attr.chunk_size || hdr.nb_chunks != nb_chunks)) {
+        DOCA_LOG_ERR("Checkpoint of %" PRIu64 " bytes in chunks of %u bytes does not fit a region of %zu bytes in "
+                     "chunks of %zu bytes",
+                     hdr.region_size, hdr.chunk_size, remote.Len(), attr.chunk_size);
+        close(fd);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (ok) {
+        crcs->resize(nb_chunks);
+        len = nb_chunks * sizeof(uint32_t);
+        ok = read(fd, crcs->data(), len) == (ssize_t)len;
+    }
+    close(fd);
+    if (!ok) {
+        DOCA_LOG_ERR("Manifest %s is not a valid checkpoint manifest", path.c_str());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    return DOCA_SUCCESS;
+}
+
+}  // namespace doca
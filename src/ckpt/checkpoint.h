@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+#define CKPT_MAGIC "DOCACKPT"
+#define CKPT_VERSION 1
+#define CKPT_IO_ALIGN 4096 /* O_DIRECT buffer, offset and length alignment */
+
+namespace doca {
+
+/* Construction time settings of a Checkpointer */
+struct ckpt_attr {
+    size_t chunk_size = 1 << 20; /* Unit of DMA, checksum and file I/O, a multiple of CKPT_IO_ALIGN */
+    size_t nb_buffers = 8;       /* DPU buffers in the ring between the DMA and file stages */
+    bool direct_io = true;       /* O_DIRECT file I/O, buffered if the file system refuses it */
+};
+
+/*
+ * Header of the manifest stored next to a checkpoint, at <path>.manifest. It
+ * is followed by the CRC32C of every chunk; the manifest is written once the
+ * data is on disk, so a checkpoint without one is incomplete.
+ */
+struct ckpt_manifest_hdr {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunk_size;
+    uint64_t region_size;
+    uint64_t nb_chunks;
+};
+
+/*
+ * Counters of the last Save or Restore. The stages overlap, each one's time is
+ * what it spent working rather than waiting for the other, so bytes over a
+ * stage's time is the throughput it could sustain on its own.
+ */
+struct ckpt_stats {
+    uint64_t bytes = 0;
+    uint64_t chunks = 0;
+    uint64_t total_ns = 0;
+    uint64_t dma_ns = 0; /* DMA stage busy: jobs in flight or buffers to hand out */
+    uint64_t crc_ns = 0; /* Chunk checksums, computed on save and verified on restore */
+    uint64_t io_ns = 0;  /* File writes on save, reads on restore */
+    bool direct_io = false;
+
+    /* MB/s of the run, or of a stage given its time */
+    double Throughput() const { return Throughput(total_ns); }
+    double Throughput(uint64_t ns) const { return ns ? bytes * 1e3 / ns : 0.0; }
+};
+
+/*
+ * Snapshot of an exported host region to a DPU-local file and back, without
+ * host CPU. Save pipelines DMA reads of chunks into a ring of DPU buffers with
+ * a writer thread draining them to the file; Restore runs the other way,
+ * verifying every chunk against the manifest before it is DMAed to the host.
+ *
+ * The calling thread drives dma, which must not be used by anyone else during
+ * a Save or Restore.
+ */
+class Checkpointer {
+   public:
+    Checkpointer(DOCADma<Dpu> &dma, MemMap &remote, const ckpt_attr &attr = ckpt_attr());
+    Checkpointer(const Checkpointer &) = delete;
+    Checkpointer &operator=(const Checkpointer &) = delete;
+
+    doca_error_t Save(const char *path);
+    doca_error_t Restore(const char *path);
+
+    void Snapshot(ckpt_stats *stats) const { *stats = counters; }
+
+   protected:
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    ckpt_attr attr;
+    MemMap pool;
+    size_t pool_base; /* Offset of the first aligned buffer in pool */
+    size_t nb_chunks;
+
+    ckpt_stats counters;
+
+    size_t ChunkLen(size_t chunk) const;
+    /* File I/O length of a chunk, padded to the O_DIRECT alignment */
+    size_t IoLen(size_t chunk) const;
+    size_t BufOffset(uint32_t buf) const { return pool_base + (size_t)buf * attr.chunk_size; }
+    char *BufData(uint32_t buf) const { return pool.Data() + BufOffset(buf); }
+
+    int OpenFile(const char *path, int flags);
+    doca_error_t WriteManifest(const std::string &path, const std::vector<uint32_t> &crcs);
+    doca_error_t ReadManifest(const std::string &path, std::vector<uint32_t> *crcs);
+};
+
+}  // namespace doca
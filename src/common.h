@@ -4,4 +4,14 @@ namespace doca {
 
 enum doca_app_mode { DOCA_MODE_HOST, DOCA_MODE_DPU };
 
+/*
+ * Side of the link a wrapper is built for, as a template argument: CommChannel<Host>,
+ * DOCADma<Dpu>. Each specialization only has the state and operations of its side.
+ */
+struct Host {};
+struct Dpu {};
+
+/* How blocking calls wait on the device: busy polling, or sleeping briefly between polls */
+enum wait_policy { WAIT_SPIN, WAIT_SLEEP };
+
 }  // namespace doca
@@ -0,0 +1,231 @@
+#include "fingerprint.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+#include "../util/crc32c.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(FINGERPRINT);
+
+Fingerprinter::Fingerprinter(DOCADma<Dpu> &dma, MemMap &remote, const fingerprint_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.block_size == 0 || attr.block_size % 2 != 0 || attr.chunk_size % attr.block_size != 0 ||
+        attr.chunk_size < 2 * attr.block_size || attr.chunk_size > dma.MaxBufSize() || attr.nb_buffers == 0) {
+        DOCA_LOG_ERR("Invalid fingerprint settings: %zu byte blocks, %u buffers of %zu bytes", attr.block_size,
+                     attr.nb_buffers, attr.chunk_size);
+        throw std::runtime_error("Invalid fingerprint settings");
+    }
+
+    result = dma.AddMMap(pool);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to the fingerprint buffers");
+    result = pool.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.nb_buffers * attr.chunk_size);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate the fingerprint buffers");
+
+    buf_job.resize(attr.nb_buffers);
+    buf_reads.resize(attr.nb_buffers);
+}
+
+doca_error_t Fingerprinter::Run(size_t offset, size_t len, std::vector<block_fingerprint> *table) {
+    size_t nb_chunks = (len + attr.chunk_size - 1) / attr.chunk_size, next = 0, done = 0, chunk_off, chunk_len;
+    size_t block, half;
+    uint64_t start = NowNs(), hash_start;
+    doca_error_t result = DOCA_SUCCESS;
+    const char *data;
+    void *user_data;
+    uint32_t buf;
+
+    if (offset > remote.Len() || len > remote.Len() - offset) {
+        DOCA_LOG_ERR("Fingerprinting %zu bytes at offset %zu is outside the %zu byte remote region", len, offset,
+                     remote.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    table->resize((len + attr.block_size - 1) / attr.block_size);
+    free_bufs.clear();
+    for (uint32_t i = attr.nb_buffers; i > 0; i--) free_bufs.push_back(i - 1);
+
+    while (done < nb_chunks) {
+        while (next < nb_chunks && !free_bufs.empty()) {
+            buf = free_bufs.back();
+            chunk_off = next * attr.chunk_size;
+            chunk_len = std::min(attr.chunk_size, len - chunk_off);
+            result = dma.Submit(remote, offset + chunk_off, pool, buf * attr.chunk_size, chunk_len,
+                                (void *)(uintptr_t)(buf + 1));
+            if (result == DOCA_ERROR_AGAIN) {
+                counters.again++;
+                break;
+            }
+            if (result != DOCA_SUCCESS) {
+                DOCA_LOG_ERR("Fingerprinting stopped after %zu of %zu chunks: %s", done, nb_chunks,
+                             doca_get_error_string(result));
+                Drain();
+                return result;
+            }
+            free_bufs.pop_back();
+            buf_job[buf] = next++;
+        }
+
+        user_data = nullptr;
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) continue;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Fingerprinting stopped after %zu of %zu chunks: %s", done, nb_chunks,
+                         doca_get_error_string(result));
+            Drain();
+            return result;
+        }
+
+        /* Hash the chunk while the reads of the following ones are in flight */
+        buf = (uint32_t)(uintptr_t)user_data - 1;
+        chunk_off = buf_job[buf] * attr.chunk_size;
+        chunk_len = std::min(attr.chunk_size, len - chunk_off);
+        data = pool.Data() + buf * attr.chunk_size;
+        hash_start = NowNs();
+        for (size_t b = 0; b < chunk_len; b += attr.block_size) {
+            block_fingerprint &entry = (*table)[(chunk_off + b) / attr.block_size];
+
+            block = std::min(attr.block_size, chunk_len - b);
+            half = block / 2;
+            entry.offset = offset + chunk_off + b;
+            entry.len = block;
+            entry.reserved = 0;
+            entry.fp = (uint64_t)Crc32c(data + b, half) << 32 | Crc32c(data + b + half, block - half);
+        }
+        counters.hash_ns += NowNs() - hash_start;
+        counters.blocks += (chunk_len + attr.block_size - 1) / attr.block_size;
+        counters.bytes += chunk_len;
+        counters.chunks++;
+        free_bufs.push_back(buf);
+        done++;
+    }
+
+    counters.busy_ns += NowNs() - start;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Fingerprinter::FindDuplicates(const std::vector<block_fingerprint> &table, dedup_report *report,
+                                           bool verify) {
+    std::vector<std::pair<size_t, size_t>> pairs;
+    std::vector<size_t> order(table.size());
+    uint64_t start = NowNs();
+    doca_error_t result;
+    std::vector<bool> same;
+    size_t first, end, p;
+
+    *report = dedup_report();
+    report->blocks = table.size();
+
+    /* Equal fingerprints and lengths end up next to each other, ascending offsets within */
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&table](size_t a, size_t b) {
+        if (table[a].fp != table[b].fp) return table[a].fp < table[b].fp;
+        if (table[a].len != table[b].len) return table[a].len < table[b].len;
+        return table[a].offset < table[b].offset;
+    });
+
+    for (first = 0; first < order.size(); first = end) {
+        for (end = first + 1; end < order.size() && table[order[end]].fp == table[order[first]].fp &&
+                              table[order[end]].len == table[order[first]].len;
+             end++)
+            pairs.push_back({order[first], order[end]});
+    }
+
+    same.assign(pairs.size(), true);
+    if (verify && !pairs.empty()) {
+        result = Compare(table, pairs, &same);
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    for (p = 0; p < pairs.size();) {
+        dedup_group group = {table[pairs[p].first].fp, table[pairs[p].first].len, {table[pairs[p].first].offset}};
+
+        for (first = pairs[p].first; p < pairs.size() && pairs[p].first == first; p++) {
+            if (!same[p]) {
+                report->collisions++;
+                continue;
+            }
+            group.offsets.push_back(table[pairs[p].second].offset);
+        }
+        if (group.offsets.size() < 2) continue;
+        report->duplicate_blocks += group.offsets.size() - 1;
+        report->duplicate_bytes += (group.offsets.size() - 1) * group.len;
+        report->groups.push_back(std::move(group));
+    }
+
+    counters.verify_ns += NowNs() - start;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t Fingerprinter::Compare(const std::vector<block_fingerprint> &table,
+                                    const std::vector<std::pair<size_t, size_t>> &pairs, std::vector<bool> *same) {
+    size_t next = 0, done = 0, base;
+    bool half_in = false; /* The work queue took only the first read of pair next, into buffer filling */
+    doca_error_t result;
+    void *user_data;
+    uint32_t buf, filling = 0;
+
+    /* Both blocks of a pair land in one buffer, the first at its start and the second right after it */
+    free_bufs.clear();
+    for (uint32_t i = attr.nb_buffers; i > 0; i--) free_bufs.push_back(i - 1);
+
+    while (done < pairs.size()) {
+        while (next < pairs.size()) {
+            if (!half_in) {
+                if (free_bufs.empty()) break;
+                filling = free_bufs.back();
+                result = dma.Submit(remote, table[pairs[next].first].offset, pool, filling * attr.chunk_size,
+                                    table[pairs[next].first].len, (void *)(uintptr_t)(filling + 1));
+                if (result == DOCA_ERROR_AGAIN) break;
+                if (result != DOCA_SUCCESS) goto failed;
+                free_bufs.pop_back();
+                buf_job[filling] = next;
+                half_in = true;
+            }
+            result = dma.Submit(remote, table[pairs[next].second].offset, pool,
+                                filling * attr.chunk_size + attr.block_size, table[pairs[next].second].len,
+                                (void *)(uintptr_t)(filling + 1));
+            if (result == DOCA_ERROR_AGAIN) break;
+            if (result != DOCA_SUCCESS) goto failed;
+            half_in = false;
+            next++;
+        }
+
+        user_data = nullptr;
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) continue;
+        if (result != DOCA_SUCCESS) goto failed;
+
+        buf = (uint32_t)(uintptr_t)user_data - 1;
+        if (++buf_reads[buf] < 2) continue;
+        buf_reads[buf] = 0;
+        base = buf * attr.chunk_size;
+        (*same)[buf_job[buf]] = memcmp(pool.Data() + base, pool.Data() + base + attr.block_size,
+                                       table[pairs[buf_job[buf]].first].len) == 0;
+        counters.verified++;
+        free_bufs.push_back(buf);
+        done++;
+    }
+    return DOCA_SUCCESS;
+
+failed:
+    DOCA_LOG_ERR("Duplicate verification stopped after %zu of %zu comparisons: %s", done, pairs.size(),
+                 doca_get_error_string(result));
+    Drain();
+    return result;
+}
+
+void Fingerprinter::Drain() {
+    dma.Drain();
+    std::fill(buf_reads.begin(), buf_reads.end(), 0);
+}
+
+}  // namespace doca
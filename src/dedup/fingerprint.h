@@ -0,0 +1,107 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+namespace doca {
+
+/* Fingerprint table entry of one block of the remote region */
+struct block_fingerprint {
+    uint64_t offset; /* Remote offset of the block */
+    uint32_t len;    /* block_size, less for a last partial block */
+    uint32_t reserved;
+    uint64_t fp; /* CRC32C of the first half of the block in the upper 32 bits, of the second half in the lower */
+};
+
+/* Blocks with identical contents; offsets are ascending, the first is the one the others duplicate */
+struct dedup_group {
+    uint64_t fp;
+    uint32_t len;
+    std::vector<uint64_t> offsets;
+};
+
+/* Outcome of FindDuplicates */
+struct dedup_report {
+    uint64_t blocks = 0;
+    uint64_t duplicate_blocks = 0; /* Blocks whose contents appear at a lower offset */
+    uint64_t duplicate_bytes = 0;
+    uint64_t collisions = 0; /* Blocks sharing a fingerprint with different contents, found by verify */
+    std::vector<dedup_group> groups;
+};
+
+/* Construction time settings of a Fingerprinter */
+struct fingerprint_attr {
+    size_t block_size = 4096;      /* Dedup unit, even */
+    size_t chunk_size = 256 << 10; /* Bytes per DMA read, a multiple of block_size and at least two blocks */
+    uint32_t nb_buffers = 8;       /* Chunks in flight or being hashed at once */
+};
+
+/* Counters of a Fingerprinter */
+struct fingerprint_stats {
+    uint64_t blocks = 0;
+    uint64_t bytes = 0; /* Bytes read and hashed */
+    uint64_t chunks = 0;
+    uint64_t again = 0;     /* Reads held back by a full work queue */
+    uint64_t busy_ns = 0;   /* Time spent in Run */
+    uint64_t hash_ns = 0;   /* Time spent hashing */
+    uint64_t verified = 0;  /* Fingerprint matches compared byte for byte */
+    uint64_t verify_ns = 0; /* Time spent in FindDuplicates */
+
+    double GBps() const { return busy_ns ? (double)bytes / busy_ns : 0.0; }
+    double HashGBps() const { return hash_ns ? (double)bytes / hash_ns : 0.0; }
+};
+
+/*
+ * Content fingerprinting of host memory from the DPU, for dedup and integrity
+ * checks. Run streams the region in chunks through a ring of DPU buffers and
+ * hashes every block of a chunk as soon as it arrived, while the reads of the
+ * next chunks are in flight. The hash is CRC32C, taken over the two halves of
+ * a block for a 64-bit fingerprint; Crc32c uses the CRC instructions when the
+ * CPU has them, Crc32cImplName tells which implementation ran. FindDuplicates
+ * groups the table by fingerprint and can compare every match byte for byte
+ * before calling it a duplicate.
+ *
+ * Single threaded: the fingerprinter owns dma, which must not be used by
+ * anyone else during Run or FindDuplicates.
+ */
+class Fingerprinter {
+   public:
+    Fingerprinter(DOCADma<Dpu> &dma, MemMap &remote, const fingerprint_attr &attr = fingerprint_attr());
+    Fingerprinter(const Fingerprinter &) = delete;
+    Fingerprinter &operator=(const Fingerprinter &) = delete;
+
+    /* Fingerprint the blocks of len bytes from remote offset; table gets one entry per block, by offset */
+    doca_error_t Run(size_t offset, size_t len, std::vector<block_fingerprint> *table);
+    /*
+     * Group the blocks of a table with equal fingerprints. With verify, every block is read back and
+     * compared with the first of its group, pipelined like Run; blocks that differ count as collisions
+     * and stay out of the group. Without it, equal fingerprints are taken as equal contents.
+     */
+    doca_error_t FindDuplicates(const std::vector<block_fingerprint> &table, dedup_report *report, bool verify = true);
+
+    void Snapshot(fingerprint_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = fingerprint_stats(); }
+
+   protected:
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    fingerprint_attr attr;
+    MemMap pool; /* nb_buffers chunks */
+
+    std::vector<size_t> buf_job;     /* Chunk or comparison each buffer holds */
+    std::vector<uint32_t> buf_reads; /* Reads of a comparison completed */
+    std::vector<uint32_t> free_bufs;
+
+    fingerprint_stats counters;
+
+    /* Compare the blocks of each pair, same[i] tells whether pair i matched */
+    doca_error_t Compare(const std::vector<block_fingerprint> &table,
+                         const std::vector<std::pair<size_t, size_t>> &pairs, std::vector<bool> *same);
+    /* Wait for the jobs in flight after a failure, unless a failed retrieve shows they never complete */
+    void Drain();
+};
+
+}  // namespace doca
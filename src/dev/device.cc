@@ -1,7 +1,12 @@
 #include "device.h"
 
+#include <doca_comm_channel.h>
+#include <doca_dma.h>
 #include <doca_error.h>
 #include <doca_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../mem/mem.h"
 
@@ -9,6 +14,38 @@ namespace doca {
 
 DOCA_LOG_REGISTER(DEVICE);
 
+/* Read the first line of a sysfs attribute of a PCI function, false if it does not exist */
+static bool read_pci_attr(const char* pci_addr, const char* attr, char* value, size_t len) {
+    char path[128];
+    FILE* f;
+
+    snprintf(path, sizeof(path), "/sys/bus/pci/devices/%s/%s", pci_addr, attr);
+    f = fopen(path, "r");
+    if (f == NULL) return false;
+    if (fgets(value, len, f) == NULL) {
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    value[strcspn(value, "\n")] = '\0';
+    return true;
+}
+
+static int read_pci_attr_int(const char* pci_addr, const char* attr) {
+    char value[32];
+
+    if (!read_pci_attr(pci_addr, attr, value, sizeof(value))) return -1;
+    return atoi(value);
+}
+
+doca_error_t DOCADevice::Open(struct doca_devinfo* devinfo) {
+    doca_error_t res;
+
+    res = doca_dev_open(devinfo, &dev);
+    if (res != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to open DOCA device: %s", doca_get_error_string(res));
+    return res;
+}
+
 doca_error_t DOCADevice::OpenWithPci(const char* pci_addr) {
     struct doca_devinfo** dev_list;
     uint32_t nb_devs;
@@ -81,6 +118,49 @@ doca_error_t DOCADevice::AddMMap(MemMap& mmap) {
     return result;
 }
 
+doca_error_t DOCADevice::Probe(device_profile* profile) {
+    struct doca_devinfo* devinfo;
+    doca_error_t result;
+
+    if (dev == nullptr) return DOCA_ERROR_BAD_STATE;
+    devinfo = doca_dev_as_devinfo(dev);
+    memset(profile, 0, sizeof(*profile));
+
+    result = doca_devinfo_get_pci_addr_str(devinfo, profile->pci_addr);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to get device PCI address: %s", doca_get_error_string(result));
+        return result;
+    }
+    if (doca_devinfo_get_ibdev_name(devinfo, profile->ibdev_name, sizeof(profile->ibdev_name)) != DOCA_SUCCESS)
+        profile->ibdev_name[0] = '\0';
+
+    /* Limits of unsupported features stay 0 */
+    profile->dma_memcpy = doca_dma_job_get_supported(devinfo, DOCA_DMA_JOB_MEMCPY) == DOCA_SUCCESS;
+    if (profile->dma_memcpy && doca_dma_get_max_buf_size(devinfo, &profile->dma_max_buf_size) != DOCA_SUCCESS)
+        profile->dma_max_buf_size = 0;
+    if (doca_comm_channel_get_max_message_size(devinfo, &profile->cc_max_msg_size) != DOCA_SUCCESS)
+        profile->cc_max_msg_size = 0;
+    if (doca_comm_channel_get_max_send_queue_size(devinfo, &profile->cc_max_send_queue_size) != DOCA_SUCCESS)
+        profile->cc_max_send_queue_size = 0;
+    if (doca_comm_channel_get_max_recv_queue_size(devinfo, &profile->cc_max_recv_queue_size) != DOCA_SUCCESS)
+        profile->cc_max_recv_queue_size = 0;
+
+    profile->numa_node = read_pci_attr_int(profile->pci_addr, "numa_node");
+    profile->link_width = read_pci_attr_int(profile->pci_addr, "current_link_width");
+    profile->max_link_width = read_pci_attr_int(profile->pci_addr, "max_link_width");
+    if (!read_pci_attr(profile->pci_addr, "current_link_speed", profile->link_speed, sizeof(profile->link_speed)))
+        profile->link_speed[0] = '\0';
+
+    return DOCA_SUCCESS;
+}
+
+const device_profile& DOCADevice::Profile() {
+    std::call_once(probe_once, [this] {
+        if (Probe(&profile) != DOCA_SUCCESS) DOCA_LOG_WARN("Device probe failed, falling back to built-in limits");
+    });
+    return profile;
+}
+
 DOCADevice::~DOCADevice() {
     doca_error_t res;
     if (dev) {
@@ -1,34 +1,69 @@
 #pragma once
 
 #include <doca_dev.h>
+#include <stdint.h>
+
+#include <mutex>
 
 namespace doca {
 
 using jobs_check = doca_error_t (*)(struct doca_devinfo *);
 
+/*
+ * Limits and placement of an opened device. Limits the device does not
+ * report are 0, sysfs values that are not available are -1.
+ */
+struct device_profile {
+    char pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];
+    char ibdev_name[DOCA_DEVINFO_IBDEV_NAME_SIZE];
+    bool dma_memcpy;           /* DOCA_DMA_JOB_MEMCPY supported */
+    uint64_t dma_max_buf_size; /* Largest single DMA job */
+    uint32_t cc_max_msg_size;  /* Comm Channel limits */
+    uint32_t cc_max_send_queue_size;
+    uint32_t cc_max_recv_queue_size;
+    int numa_node;
+    int link_width; /* Negotiated PCIe lanes */
+    int max_link_width;
+    char link_speed[32]; /* Negotiated PCIe speed as sysfs reports it, empty if unknown */
+};
+
+class CommEndpoint;
+template <typename Mode>
 class CommChannel;
 class DOCADeviceRep;
 class MemMap;
+template <typename Mode>
 class DOCADma;
 
 class DOCADevice {
     friend class DOCADeviceRep;
-    friend class CommChannel;
+    friend class CommEndpoint;
     friend class MemMap;
+    template <typename Mode>
     friend class DOCADma;
 
    public:
     DOCADevice() = default;
+    doca_error_t Open(struct doca_devinfo *devinfo);
     doca_error_t OpenWithPci(const char *pci_addr);
     doca_error_t OpenWithCap(jobs_check func);
     doca_error_t AddMMap(MemMap &mmap);
+    /* Query limits and topology of the opened device */
+    doca_error_t Probe(device_profile *profile);
+    /* Probe once and keep the result, devices are shared through DeviceRegistry */
+    const device_profile &Profile();
     ~DOCADevice();
 
    public:
-    struct doca_dev *dev;
+    struct doca_dev *dev = nullptr;
+
+   protected:
+    device_profile profile = {};
+    std::once_flag probe_once;
 };
 
 class DOCADeviceRep {
+    template <typename Mode>
     friend class CommChannel;
 
    public:
@@ -37,7 +72,7 @@ class DOCADeviceRep {
     ~DOCADeviceRep();
 
    protected:
-    struct doca_dev_rep *dev_rep;
+    struct doca_dev_rep *dev_rep = nullptr;
 };
 
 }  // namespace doca
@@ -0,0 +1,131 @@
+#include "registry.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(DEVICE_REGISTRY);
+
+DeviceRegistry &DeviceRegistry::Instance() {
+    static DeviceRegistry registry;
+    return registry;
+}
+
+DeviceRegistry::~DeviceRegistry() {
+    if (dev_list) doca_devinfo_list_destroy(dev_list);
+}
+
+/* Called with lock held */
+doca_error_t DeviceRegistry::Enumerate() {
+    uint32_t nb_devs;
+    doca_error_t result;
+
+    if (enumerated) return DOCA_SUCCESS;
+
+    result = doca_devinfo_list_create(&dev_list, &nb_devs);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to load doca devices list. Doca_error value: %d", result);
+        return result;
+    }
+
+    entries.resize(nb_devs);
+    for (uint32_t i = 0; i < nb_devs; i++) {
+        entries[i].devinfo = dev_list[i];
+        entries[i].pci_addr[0] = '\0';
+        result = doca_devinfo_get_pci_addr_str(dev_list[i], entries[i].pci_addr);
+        if (result != DOCA_SUCCESS) DOCA_LOG_WARN("Failed to get PCI address of device %u", i);
+    }
+
+    enumerated = true;
+    return DOCA_SUCCESS;
+}
+
+/* Called with lock held */
+bool DeviceRegistry::HasCap(size_t idx, jobs_check func) {
+    auto it = cap_cache.find(func);
+
+    if (it == cap_cache.end()) {
+        std::vector<bool> caps(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) caps[i] = func(entries[i].devinfo) == DOCA_SUCCESS;
+        it = cap_cache.emplace(func, std::move(caps)).first;
+    }
+    return it->second[idx];
+}
+
+/* Called with lock held */
+std::shared_ptr<DOCADevice> DeviceRegistry::Acquire(size_t idx) {
+    std::shared_ptr<DOCADevice> dev = entries[idx].dev.lock();
+
+    if (dev) return dev;
+
+    dev = std::make_shared<DOCADevice>();
+    if (dev->Open(entries[idx].devinfo) != DOCA_SUCCESS) return nullptr;
+
+    entries[idx].dev = dev;
+    return dev;
+}
+
+std::shared_ptr<DOCADevice> DeviceRegistry::GetByPci(const char *pci_addr) {
+    std::lock_guard<std::mutex> guard(lock);
+    uint8_t is_addr_equal = 0;
+    doca_error_t result;
+
+    if (Enumerate() != DOCA_SUCCESS) return nullptr;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        result = doca_devinfo_get_is_pci_addr_equal(entries[i].devinfo, pci_addr, &is_addr_equal);
+        if (result != DOCA_SUCCESS || !is_addr_equal) continue;
+
+        std::shared_ptr<DOCADevice> dev = Acquire(i);
+        if (dev) return dev;
+    }
+
+    DOCA_LOG_WARN("Matching device not found");
+    return nullptr;
+}
+
+std::shared_ptr<DOCADevice> DeviceRegistry::GetByCap(jobs_check func) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (Enumerate() != DOCA_SUCCESS) return nullptr;
+
+    /* Reuse a device some other object already holds before opening a new one */
+    for (size_t i = 0; i < entries.size(); i++) {
+        std::shared_ptr<DOCADevice> dev = entries[i].dev.lock();
+        if (dev && HasCap(i, func)) return dev;
+    }
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!HasCap(i, func)) continue;
+
+        std::shared_ptr<DOCADevice> dev = Acquire(i);
+        if (dev) return dev;
+    }
+
+    DOCA_LOG_WARN("Matching device not found");
+    return nullptr;
+}
+
+size_t DeviceRegistry::NumDevices() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (Enumerate() != DOCA_SUCCESS) return 0;
+    return entries.size();
+}
+
+const char *DeviceRegistry::PciAddr(size_t idx) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (Enumerate() != DOCA_SUCCESS || idx >= entries.size()) return nullptr;
+    return entries[idx].pci_addr;
+}
+
+struct doca_devinfo *DeviceRegistry::DevInfo(size_t idx) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (Enumerate() != DOCA_SUCCESS || idx >= entries.size()) return nullptr;
+    return entries[idx].devinfo;
+}
+
+}  // namespace doca
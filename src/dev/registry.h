@@ -0,0 +1,59 @@
+#pragma once
+
+#include <doca_dev.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "device.h"
+
+namespace doca {
+
+/* A device found at enumeration, with what has been learnt about it so far */
+struct dev_entry {
+    struct doca_devinfo *devinfo;
+    char pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];
+    std::weak_ptr<DOCADevice> dev; /* Open handle, shared by every user until the last one drops it */
+};
+
+/*
+ * Process-wide device registry. The devinfo list is created once on first
+ * use and kept for the life of the process, capability checks are cached
+ * per device, and every lookup of the same function returns the same open
+ * doca_dev so that mmaps and contexts can be shared between objects. The
+ * device is closed when the last handle is released.
+ */
+class DeviceRegistry {
+   public:
+    static DeviceRegistry &Instance();
+
+    /* Shared handle to the device at pci_addr, nullptr if none matches or it fails to open */
+    std::shared_ptr<DOCADevice> GetByPci(const char *pci_addr);
+    /* Shared handle to a device passing func, preferring one that is already open */
+    std::shared_ptr<DOCADevice> GetByCap(jobs_check func);
+
+    size_t NumDevices();
+    const char *PciAddr(size_t idx);
+    struct doca_devinfo *DevInfo(size_t idx);
+
+    DeviceRegistry(const DeviceRegistry &) = delete;
+    DeviceRegistry &operator=(const DeviceRegistry &) = delete;
+
+   protected:
+    DeviceRegistry() = default;
+    ~DeviceRegistry();
+
+    std::mutex lock;
+    bool enumerated = false;
+    struct doca_devinfo **dev_list = nullptr;
+    std::vector<dev_entry> entries;
+    std::map<jobs_check, std::vector<bool>> cap_cache; /* Capability check result per device */
+
+    doca_error_t Enumerate();
+    bool HasCap(size_t idx, jobs_check func);
+    std::shared_ptr<DOCADevice> Acquire(size_t idx);
+};
+
+}  // namespace doca
@@ -3,8 +3,14 @@
 #include <doca_error.h>
 #include <doca_log.h>
 
+#include <algorithm>
 #include <stdexcept>
 
+#include "../dev/registry.h"
+#include "../stats/clock.h"
+#include "../stats/counter.h"
+#include "../trace/trace.h"
+
 namespace doca {
 
 DOCA_LOG_REGISTER(DOCA_DMA);
@@ -13,18 +19,44 @@ doca_error_t check_dev_dma_capable(struct doca_devinfo *devinfo) {
     return doca_dma_job_get_supported(devinfo, DOCA_DMA_JOB_MEMCPY);
 }
 
-DOCADma::DOCADma(doca_app_mode mode) : mode(mode) {
+DOCADma<Host>::DOCADma() {
+    dev = DeviceRegistry::Instance().GetByCap(check_dev_dma_capable);
+    if (!dev) {
+        DOCA_LOG_ERR("Failed to open DOCA DMA capable device");
+        throw std::runtime_error("Failed to open DOCA DMA capable device");
+    }
+}
+
+doca_error_t DOCADma<Host>::Init(MemMap &mmap) {
     doca_error_t result;
-    size_t num_elements = 2;
 
-    dev = std::make_shared<DOCADevice>();
-    result = dev->OpenWithCap(check_dev_dma_capable);
-    if (result != DOCA_SUCCESS) {
+    result = dev->AddMMap(mmap);
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Unable to add device to mmap: %s", doca_get_error_string(result));
+    return result;
+}
+
+doca_error_t DOCADma<Host>::ExportDesc(MemMap &mmap, CommChannel<Host> &ch) {
+    doca_error_t result;
+
+    result = mmap.ExportDPU(*dev);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendDesc(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    return result;
+}
+
+DOCADma<Dpu>::DOCADma() {
+    doca_error_t result;
+    /* Two buffers for DmaCopy plus a source and destination buffer per asynchronous job */
+    size_t num_elements = 2 + 2 * WORKQ_DEPTH;
+
+    dev = DeviceRegistry::Instance().GetByCap(check_dev_dma_capable);
+    if (!dev) {
         DOCA_LOG_ERR("Failed to open DOCA DMA capable device");
         throw std::runtime_error("Failed to open DOCA DMA capable device");
     }
-
-    if (mode == DOCA_MODE_HOST) return;
+    max_buf_size = dev->Profile().dma_max_buf_size ? dev->Profile().dma_max_buf_size : UINT64_MAX;
 
     result = doca_buf_inventory_create(NULL, num_elements, DOCA_BUF_EXTENSION_NONE, &buf_inv);
     if (result != DOCA_SUCCESS) {
@@ -45,30 +77,31 @@ DOCADma::DOCADma(doca_app_mode mode) : mode(mode) {
         DOCA_LOG_ERR("Unable to create work queue: %s", doca_get_error_string(result));
         throw std::runtime_error("Unable to create work queue");
     }
+
+    job_slots.resize(WORKQ_DEPTH);
+    for (uint32_t i = 0; i < WORKQ_DEPTH; i++) free_slots.push_back(WORKQ_DEPTH - 1 - i);
 }
 
-DOCADma::~DOCADma() {
+DOCADma<Dpu>::~DOCADma() {
     doca_error_t result;
 
-    if (mode == DOCA_MODE_DPU) {
-        result = doca_workq_destroy(workq);
-        if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy work queue: %s", doca_get_error_string(result));
-        workq = NULL;
+    result = doca_workq_destroy(workq);
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy work queue: %s", doca_get_error_string(result));
+    workq = NULL;
 
-        result = doca_dma_destroy(dma_ctx);
-        if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy dma: %s", doca_get_error_string(result));
-        dma_ctx = NULL;
-        ctx = NULL;
+    result = doca_dma_destroy(dma_ctx);
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy dma: %s", doca_get_error_string(result));
+    dma_ctx = NULL;
+    ctx = NULL;
 
-        result = doca_buf_inventory_destroy(buf_inv);
-        if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy buf inventory: %s", doca_get_error_string(result));
-        buf_inv = NULL;
-    }
+    result = doca_buf_inventory_destroy(buf_inv);
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to destroy buf inventory: %s", doca_get_error_string(result));
+    buf_inv = NULL;
 
     dev.reset();
 }
 
-doca_error_t DOCADma::Init(MemMap &mmap) {
+doca_error_t DOCADma<Dpu>::Init(MemMap &mmap) {
     doca_error_t result;
 
     result = dev->AddMMap(mmap);
@@ -77,8 +110,6 @@ doca_error_t DOCADma::Init(MemMap &mmap) {
         return result;
     }
 
-    if (mode == DOCA_MODE_HOST) return DOCA_SUCCESS;
-
     result = doca_buf_inventory_start(buf_inv);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Unable to start buffer inventory: %s", doca_get_error_string(result));
@@ -106,7 +137,7 @@ doca_error_t DOCADma::Init(MemMap &mmap) {
     return result;
 }
 
-void DOCADma::Finalize() {
+void DOCADma<Dpu>::Finalize() {
     doca_error_t result;
 
     result = doca_ctx_workq_rm(ctx, workq);
@@ -119,23 +150,15 @@ void DOCADma::Finalize() {
     if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Failed to remove device from DMA ctx: %s", doca_get_error_string(result));
 }
 
-doca_error_t DOCADma::ExportDesc(MemMap &mmap, CommChannel &ch) {
-    if (mode == DOCA_MODE_DPU) {
-        DOCA_LOG_ERR("DPU should not export memory");
-        return DOCA_SUCCESS;
-    }
-
+doca_error_t DOCADma<Dpu>::AddMMap(MemMap &mmap) {
     doca_error_t result;
 
-    result = mmap.ExportDPU(*dev);
-    if (result != DOCA_SUCCESS) return result;
-    result = mmap.SendDesc(ch);
-    if (result != DOCA_SUCCESS) return result;
-
+    result = dev->AddMMap(mmap);
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("Unable to add device to mmap: %s", doca_get_error_string(result));
     return result;
 }
 
-doca_error_t DOCADma::AddBuffer(MemMap &mmap) {
+doca_error_t DOCADma<Dpu>::AddBuffer(MemMap &mmap) {
     doca_error_t result;
     /* Construct DOCA buffer for local (DPU) address range */
     result = doca_buf_inventory_buf_by_addr(buf_inv, mmap.mmap, mmap.buffer, mmap.len,
@@ -149,15 +172,16 @@ doca_error_t DOCADma::AddBuffer(MemMap &mmap) {
     return result;
 }
 
-void DOCADma::RmBuffer(MemMap &mmap) {
+void DOCADma<Dpu>::RmBuffer(MemMap &mmap) {
     doca_buf_refcount_rm(mmap.doca_buf, NULL);
 }
 
-doca_error_t DOCADma::DmaCopy(MemMap &from, MemMap &to, size_t size) {
+doca_error_t DOCADma<Dpu>::DmaCopy(MemMap &from, MemMap &to, size_t size) {
     doca_error_t result;
 
     struct doca_event event = {0};
     struct doca_dma_job_memcpy dma_job = {0};
+    uint64_t submit_ns;
     void *data;
 
     struct timespec ts = {
@@ -165,6 +189,11 @@ doca_error_t DOCADma::DmaCopy(MemMap &from, MemMap &to, size_t size) {
         .tv_nsec = 10 * 1000,
     };
 
+    if (size > max_buf_size) {
+        DOCA_LOG_ERR("DMA job of %zu bytes exceeds the device limit of %" PRIu64 " bytes", size, max_buf_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
     /* Construct DMA job */
     dma_job.base.type = DOCA_DMA_JOB_MEMCPY;
     dma_job.base.flags = DOCA_JOB_FLAGS_NONE;
@@ -186,16 +215,24 @@ doca_error_t DOCADma::DmaCopy(MemMap &from, MemMap &to, size_t size) {
     dma_job.dst_buff = to.doca_buf;
 
     /* Enqueue DMA job */
+    submit_ns = NowNs();
+    TRACE_EVENT(TRACE_DMA_SUBMIT, TRACE_DMA_SYNC_JOB, size);
     result = doca_workq_submit(workq, &dma_job.base);
     if (result != DOCA_SUCCESS) {
+        TRACE_EVENT(TRACE_DMA_COMPLETE, TRACE_DMA_SYNC_JOB, result);
         DOCA_LOG_ERR("Failed to submit DMA job: %s", doca_get_error_string(result));
+        CounterAdd(counters.failures, 1);
         return result;
     }
+    TRACE_EVENT(TRACE_DMA_DOORBELL, TRACE_DMA_SYNC_JOB, size);
+    CountSubmit(1);
 
     /* Wait for job completion */
     while ((result = doca_workq_progress_retrieve(workq, &event, DOCA_WORKQ_RETRIEVE_FLAGS_NONE)) == DOCA_ERROR_AGAIN) {
-        nanosleep(&ts, &ts);
+        TRACE_EVENT(TRACE_DMA_POLL_MISS, TRACE_DMA_SYNC_JOB, 0);
+        if (wait == WAIT_SLEEP) nanosleep(&ts, &ts);
     }
+    TRACE_EVENT(TRACE_DMA_COMPLETE, TRACE_DMA_SYNC_JOB, result);
 
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to retrieve DMA job: %s", doca_get_error_string(result));
@@ -203,6 +240,7 @@ doca_error_t DOCADma::DmaCopy(MemMap &from, MemMap &to, size_t size) {
             struct doca_dma_memcpy_result *memcpy_result = (struct doca_dma_memcpy_result *)&event.result.u64;
             DOCA_LOG_ERR("%d, %s", memcpy_result->result, doca_get_error_string(memcpy_result->result));
         }
+        CountCompletion(submit_ns, size, false);
         return result;
     }
 
@@ -210,10 +248,238 @@ doca_error_t DOCADma::DmaCopy(MemMap &from, MemMap &to, size_t size) {
     result = (doca_error_t)event.result.u64;
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("DMA job event returned unsuccessfully: %s", doca_get_error_string(result));
+        CountCompletion(submit_ns, size, false);
         return result;
     }
 
+    CountCompletion(submit_ns, size, true);
     return result;
 }
 
+doca_error_t DOCADma<Dpu>::Submit(MemMap &from, size_t from_offset, MemMap &to, size_t to_offset, size_t size,
+                             void *user_data) {
+    doca_error_t result;
+    struct doca_dma_job_memcpy dma_job = {0};
+    uint32_t slot_id;
+
+    if (from_offset + size > from.len || to_offset + size > to.len) {
+        DOCA_LOG_ERR("DMA job out of range: %zu bytes from offset %zu (len %zu) to offset %zu (len %zu)", size,
+                     from_offset, from.len, to_offset, to.len);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (size > max_buf_size) {
+        DOCA_LOG_ERR("DMA job of %zu bytes exceeds the device limit of %" PRIu64 " bytes", size, max_buf_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (free_slots.empty()) {
+        CounterAdd(counters.again, 1);
+        return DOCA_ERROR_AGAIN;
+    }
+    slot_id = free_slots.back();
+    dma_job_slot &slot = job_slots[slot_id];
+
+    result = doca_buf_inventory_buf_by_addr(buf_inv, from.mmap, from.buffer + from_offset, size, &slot.src);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Unable to acquire DOCA source buffer: %s", doca_get_error_string(result));
+        CounterAdd(counters.failures, 1);
+        return result;
+    }
+
+    result = doca_buf_inventory_buf_by_addr(buf_inv, to.mmap, to.buffer + to_offset, size, &slot.dst);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Unable to acquire DOCA destination buffer: %s", doca_get_error_string(result));
+        doca_buf_refcount_rm(slot.src, NULL);
+        CounterAdd(counters.failures, 1);
+        return result;
+    }
+
+    result = doca_buf_set_data(slot.src, from.buffer + from_offset, size);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to set data for DOCA buffer: %s", doca_get_error_string(result));
+        goto release_bufs;
+    }
+
+    dma_job.base.type = DOCA_DMA_JOB_MEMCPY;
+    dma_job.base.flags = DOCA_JOB_FLAGS_NONE;
+    dma_job.base.ctx = ctx;
+    dma_job.base.user_data.u64 = slot_id;
+    dma_job.src_buff = slot.src;
+    dma_job.dst_buff = slot.dst;
+
+    slot.submit_ns = NowNs();
+    TRACE_EVENT(TRACE_DMA_SUBMIT, slot_id, size);
+    result = doca_workq_submit(workq, &dma_job.base);
+    if (result != DOCA_SUCCESS) {
+        /* Close the slice the SUBMIT opened, a refused job never completes */
+        TRACE_EVENT(TRACE_DMA_COMPLETE, slot_id, result);
+        if (result != DOCA_ERROR_AGAIN)
+            DOCA_LOG_ERR("Failed to submit DMA job: %s", doca_get_error_string(result));
+        goto release_bufs;
+    }
+
+    slot.user_data = user_data;
+    slot.size = size;
+    free_slots.pop_back();
+    TRACE_EVENT(TRACE_DMA_DOORBELL, slot_id, size);
+    CountSubmit(Inflight());
+    return DOCA_SUCCESS;
+
+release_bufs:
+    doca_buf_refcount_rm(slot.dst, NULL);
+    doca_buf_refcount_rm(slot.src, NULL);
+    CounterAdd(result == DOCA_ERROR_AGAIN ? counters.again : counters.failures, 1);
+    return result;
+}
+
+doca_error_t DOCADma<Dpu>::Poll(void **user_data) {
+    doca_error_t result;
+    struct doca_event event = {0};
+    uint32_t slot_id;
+
+    result = doca_workq_progress_retrieve(workq, &event, DOCA_WORKQ_RETRIEVE_FLAGS_NONE);
+    if (result == DOCA_ERROR_AGAIN) {
+        TRACE_EVENT(TRACE_DMA_POLL_MISS, 0, Inflight());
+        return result;
+    }
+
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to retrieve DMA job: %s", doca_get_error_string(result));
+        if (result != DOCA_ERROR_IO_FAILED) return result;
+    }
+
+    slot_id = (uint32_t)event.user_data.u64;
+    dma_job_slot &slot = job_slots[slot_id];
+    TRACE_EVENT(TRACE_DMA_COMPLETE, slot_id, result);
+    doca_buf_refcount_rm(slot.dst, NULL);
+    doca_buf_refcount_rm(slot.src, NULL);
+    free_slots.push_back(slot_id);
+    if (user_data) *user_data = slot.user_data;
+
+    if (result == DOCA_ERROR_IO_FAILED) {
+        struct doca_dma_memcpy_result *memcpy_result = (struct doca_dma_memcpy_result *)&event.result.u64;
+        DOCA_LOG_ERR("%d, %s", memcpy_result->result, doca_get_error_string(memcpy_result->result));
+        CountCompletion(slot.submit_ns, slot.size, false);
+        return result;
+    }
+
+    /* event result is valid */
+    result = (doca_error_t)event.result.u64;
+    if (result != DOCA_SUCCESS) DOCA_LOG_ERR("DMA job event returned unsuccessfully: %s", doca_get_error_string(result));
+    CountCompletion(slot.submit_ns, slot.size, result == DOCA_SUCCESS);
+
+    return result;
+}
+
+doca_error_t DOCADma<Dpu>::Fill(MemMap &pattern, MemMap &to, size_t to_offset, size_t size) {
+    doca_error_t result = DOCA_SUCCESS, job_result;
+    size_t chunk = std::min<size_t>(pattern.len, max_buf_size), offset = 0, len, inflight;
+
+    struct timespec ts = {
+        .tv_sec = 0,
+        .tv_nsec = 10 * 1000,
+    };
+
+    if (Inflight() > 0) {
+        DOCA_LOG_ERR("Fill needs an idle work queue, %zu jobs are in flight", Inflight());
+        return DOCA_ERROR_BAD_STATE;
+    }
+    if (chunk == 0 || to_offset > to.len || size > to.len - to_offset) {
+        DOCA_LOG_ERR("Fill of %zu bytes at offset %zu (len %zu) from a %zu byte pattern is out of range", size,
+                     to_offset, to.len, pattern.len);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    while ((offset < size && result == DOCA_SUCCESS) || Inflight() > 0) {
+        /* Keep the work queue full, chunks all start at the beginning of the pattern */
+        while (offset < size && result == DOCA_SUCCESS) {
+            len = std::min(chunk, size - offset);
+            job_result = Submit(pattern, 0, to, to_offset + offset, len, nullptr);
+            if (job_result == DOCA_ERROR_AGAIN) break;
+            if (job_result != DOCA_SUCCESS) result = job_result;
+            offset += len;
+        }
+
+        inflight = Inflight();
+        job_result = Poll(nullptr);
+        if (job_result == DOCA_ERROR_AGAIN) {
+            if (wait == WAIT_SLEEP) nanosleep(&ts, &ts);
+            continue;
+        }
+        if (job_result != DOCA_SUCCESS && result == DOCA_SUCCESS) result = job_result;
+        /* The retrieve itself failed and no job came back, waiting for the rest would never end */
+        if (job_result != DOCA_SUCCESS && Inflight() == inflight) return result;
+    }
+
+    return result;
+}
+
+doca_error_t DOCADma<Dpu>::Drain() {
+    doca_error_t result = DOCA_SUCCESS, job_result;
+    size_t inflight;
+
+    while ((inflight = Inflight()) > 0) {
+        job_result = Poll(nullptr);
+        if (job_result == DOCA_ERROR_AGAIN || job_result == DOCA_SUCCESS) continue;
+        if (result == DOCA_SUCCESS) result = job_result;
+        if (Inflight() == inflight) break;
+    }
+
+    return result;
+}
+
+void DOCADma<Dpu>::CountSubmit(size_t depth) {
+    CounterAdd(counters.submitted, 1);
+    CounterAdd(counters.depth_samples, 1);
+    CounterAdd(counters.depth_sum, depth);
+    if (depth > counters.depth_max.load(std::memory_order_relaxed))
+        counters.depth_max.store(depth, std::memory_order_relaxed);
+}
+
+void DOCADma<Dpu>::CountCompletion(uint64_t submit_ns, size_t size, bool success) {
+    latency.Record(NowNs() - submit_ns);
+    if (success) {
+        CounterAdd(counters.completed, 1);
+        CounterAdd(counters.bytes, size);
+    } else {
+        CounterAdd(counters.failures, 1);
+    }
+}
+
+void DOCADma<Dpu>::Snapshot(dma_stats *stats) const {
+    stats->submitted = counters.submitted.load(std::memory_order_relaxed);
+    stats->completed = counters.completed.load(std::memory_order_relaxed);
+    stats->bytes = counters.bytes.load(std::memory_order_relaxed);
+    stats->again = counters.again.load(std::memory_order_relaxed);
+    stats->failures = counters.failures.load(std::memory_order_relaxed);
+    stats->depth_samples = counters.depth_samples.load(std::memory_order_relaxed);
+    stats->depth_sum = counters.depth_sum.load(std::memory_order_relaxed);
+    stats->depth_max = counters.depth_max.load(std::memory_order_relaxed);
+    latency.Snapshot(&stats->latency);
+}
+
+void DOCADma<Dpu>::ResetStats() {
+    counters.submitted.store(0, std::memory_order_relaxed);
+    counters.completed.store(0, std::memory_order_relaxed);
+    counters.bytes.store(0, std::memory_order_relaxed);
+    counters.again.store(0, std::memory_order_relaxed);
+    counters.failures.store(0, std::memory_order_relaxed);
+    counters.depth_samples.store(0, std::memory_order_relaxed);
+    counters.depth_sum.store(0, std::memory_order_relaxed);
+    counters.depth_max.store(0, std::memory_order_relaxed);
+    latency.Reset();
+}
+
+void dma_stats::Merge(const dma_stats &other) {
+    submitted += other.submitted;
+    completed += other.completed;
+    bytes += other.bytes;
+    again += other.again;
+    failures += other.failures;
+    depth_samples += other.depth_samples;
+    depth_sum += other.depth_sum;
+    depth_max = std::max(depth_max, other.depth_max);
+    latency.Merge(other.latency);
+}
+
 }  // namespace doca
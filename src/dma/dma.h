@@ -4,37 +4,143 @@
 #include <doca_dma.h>
 
 #include <memory>
+#include <vector>
 
 #include "../chan/comm_channel.h"
 #include "../common.h"
 #include "../mem/mem.h"
+#include "../stats/histogram.h"
 
 #define WORKQ_DEPTH 32 /* Work queue depth */
 
 namespace doca {
 
-class DOCADma {
+/* Buffers held by an in-flight asynchronous DMA job */
+struct dma_job_slot {
+    struct doca_buf *src;
+    struct doca_buf *dst;
+    void *user_data;
+    uint64_t submit_ns;
+    size_t size;
+};
+
+/* Point-in-time copy of a DOCADma's instrumentation, see DOCADma::Snapshot */
+struct dma_stats {
+    uint64_t submitted = 0;     /* Jobs accepted by the work queue */
+    uint64_t completed = 0;     /* Jobs that finished successfully */
+    uint64_t bytes = 0;         /* Bytes moved by completed jobs */
+    uint64_t again = 0;         /* Submissions refused with DOCA_ERROR_AGAIN, work queue full */
+    uint64_t failures = 0;      /* Jobs that failed to submit or completed with an error */
+    uint64_t depth_samples = 0; /* Jobs in flight, sampled at every submission */
+    uint64_t depth_sum = 0;
+    uint64_t depth_max = 0;
+    LatencyHistogram latency;   /* Submit to completion of every finished job, in nanoseconds */
+
+    double MeanDepth() const { return depth_samples ? (double)depth_sum / depth_samples : 0.0; }
+    /* Accumulate the stats of another engine, e.g. to total up worker threads */
+    void Merge(const dma_stats &other);
+};
+
+/* Device capability check of DeviceRegistry::GetByCap, memcpy DMA jobs */
+doca_error_t check_dev_dma_capable(struct doca_devinfo *devinfo);
+
+template <typename Mode>
+class DOCADma;
+
+/* Host side: registers local memory with the device and exports it, the copies run on the DPU */
+template <>
+class DOCADma<Host> {
+   public:
+    DOCADma();
+
+    doca_error_t Init(MemMap &mmap);
+    doca_error_t ExportDesc(MemMap &mmap, CommChannel<Host> &ch);
+
+   protected:
+    std::shared_ptr<DOCADevice> dev;
+};
+
+/* DPU side: DMA context, work queue and buffer inventory, copies to and from exported host memory */
+template <>
+class DOCADma<Dpu> {
     friend class MemMap;
    public:
-    DOCADma(doca_app_mode mode);
+    DOCADma();
     ~DOCADma();
 
     doca_error_t Init(MemMap &mmap);
     void Finalize();
-    doca_error_t ExportDesc(MemMap &mmap, CommChannel &ch);
+    /* Register a further local mmap with the device of an initialized engine, before populating it */
+    doca_error_t AddMMap(MemMap &mmap);
     doca_error_t AddBuffer(MemMap &mmap);
     void RmBuffer(MemMap &mmap);
     doca_error_t DmaCopy(MemMap &from, MemMap &to, size_t size);
 
+    /*
+     * Asynchronous copy of size bytes between arbitrary offsets of two mmaps. At most WORKQ_DEPTH jobs
+     * can be in flight; DOCA_ERROR_AGAIN is returned when the work queue is full. Completions are reaped
+     * with Poll, which returns DOCA_ERROR_AGAIN if no job has finished yet. Do not mix with DmaCopy while
+     * asynchronous jobs are in flight.
+     */
+    doca_error_t Submit(MemMap &from, size_t from_offset, MemMap &to, size_t to_offset, size_t size,
+                        void *user_data);
+    doca_error_t Poll(void **user_data);
+    /*
+     * Fill size bytes of to from to_offset with the contents of pattern, a local mmap populated with
+     * whole periods of the pattern, repeated as often as needed. Chunks of up to the pattern length
+     * are pipelined through the work queue; returns once all of them completed. Needs the work queue
+     * to itself, like DmaCopy.
+     */
+    doca_error_t Fill(MemMap &pattern, MemMap &to, size_t to_offset, size_t size);
+    /*
+     * Reap every asynchronous job still in flight, discarding their user data, e.g. on an error path.
+     * Returns the first error; gives up early when a failed retrieve hands back no job, as the rest
+     * would never complete.
+     */
+    doca_error_t Drain();
+    size_t Inflight() const { return job_slots.size() - free_slots.size(); }
+    /* DmaCopy sleeps between completion polls by default */
+    void SetWaitPolicy(wait_policy policy) { wait = policy; }
+    /* Largest single job the device accepts, from its probed profile */
+    uint64_t MaxBufSize() const { return max_buf_size; }
+
+    /*
+     * Copy of the job counters and latency histogram. Cheap and safe to call from
+     * a monitoring thread while the owning thread keeps submitting; the copy may
+     * lag jobs completing concurrently. ResetStats is for the owning thread only.
+     */
+    void Snapshot(dma_stats *stats) const;
+    void ResetStats();
+
    protected:
-    struct doca_dma *dma_ctx;
-    struct doca_ctx *ctx;
-    struct doca_workq *workq;
-    struct doca_buf_inventory *buf_inv;
+    struct doca_dma *dma_ctx = nullptr;
+    struct doca_ctx *ctx = nullptr;
+    struct doca_workq *workq = nullptr;
+    struct doca_buf_inventory *buf_inv = nullptr;
 
     std::shared_ptr<DOCADevice> dev;
+    uint64_t max_buf_size;
+
+    std::vector<dma_job_slot> job_slots;
+    std::vector<uint32_t> free_slots;
+
+    wait_policy wait = WAIT_SLEEP;
+
+    /* Instrumentation, only the owning thread writes, Snapshot reads from any thread */
+    struct {
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> again{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> depth_samples{0};
+        std::atomic<uint64_t> depth_sum{0};
+        std::atomic<uint64_t> depth_max{0};
+    } counters;
+    ConcurrentHistogram latency;
 
-    doca_app_mode mode;
+    void CountSubmit(size_t depth);
+    void CountCompletion(uint64_t submit_ns, size_t size, bool success);
 };
 
 }  // namespace doca
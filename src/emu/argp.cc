@@ -0,0 +1,185 @@
+#include <doca_argp.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+DOCA_LOG_REGISTER(EMU_ARGP);
+
+struct doca_argp_param {
+    std::string short_name;
+    std::string long_name;
+    std::string arguments;
+    std::string description;
+    callback_func callback = nullptr;
+    doca_argp_type type = DOCA_ARGP_TYPE_UNKNOWN;
+    bool mandatory = false;
+    bool seen = false;
+};
+
+static std::string program;
+static void *program_config;
+static std::vector<doca_argp_param *> params;
+static validation_callback validator;
+
+/* Option ids of the built-in flags, past the range of registered params */
+enum { ARGP_HELP = 0x1000, ARGP_LOG_LEVEL, ARGP_VERSION };
+
+static void usage() {
+    printf("Usage: %s [DOCA Flags] [Program Flags]\n\n", program.c_str());
+    printf("DOCA Flags:\n");
+    printf("  -h, --help                        Print a help synopsis\n");
+    printf("  -v, --version                     Print program version information\n");
+    printf("  -l, --log-level                   Set the log level (30=ERROR, 40=WARNING, 50=INFO, 60=DEBUG)\n");
+    printf("\nProgram Flags:\n");
+    for (doca_argp_param *param : params) {
+        std::string flags = param->short_name.empty() ? "    " : "  -" + param->short_name + ",";
+        flags += " --" + param->long_name;
+        if (!param->arguments.empty()) flags += " " + param->arguments;
+        printf("%-36s%s%s\n", flags.c_str(), param->description.c_str(), param->mandatory ? " (mandatory)" : "");
+    }
+}
+
+doca_error_t doca_argp_init(const char *program_name, void *config) {
+    program = program_name;
+    program_config = config;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_argp_param_create(struct doca_argp_param **param) {
+    if (param == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *param = new doca_argp_param();
+    return DOCA_SUCCESS;
+}
+
+void doca_argp_param_set_short_name(struct doca_argp_param *param, const char *name) { param->short_name = name; }
+
+void doca_argp_param_set_long_name(struct doca_argp_param *param, const char *name) { param->long_name = name; }
+
+void doca_argp_param_set_arguments(struct doca_argp_param *param, const char *arguments) {
+    param->arguments = arguments;
+}
+
+void doca_argp_param_set_description(struct doca_argp_param *param, const char *description) {
+    param->description = description;
+}
+
+void doca_argp_param_set_callback(struct doca_argp_param *param, callback_func callback) { param->callback = callback; }
+
+void doca_argp_param_set_type(struct doca_argp_param *param, enum doca_argp_type type) { param->type = type; }
+
+void doca_argp_param_set_mandatory(struct doca_argp_param *param) { param->mandatory = true; }
+
+void doca_argp_param_set_multiplicity(struct doca_argp_param *param) { (void)param; }
+
+doca_error_t doca_argp_register_param(struct doca_argp_param *input_param) {
+    if (input_param == NULL || input_param->long_name.empty() || input_param->callback == NULL ||
+        input_param->type == DOCA_ARGP_TYPE_UNKNOWN || input_param->type == DOCA_ARGP_TYPE_JSON_OBJ) {
+        DOCA_LOG_ERR("Invalid program flag, a long name, callback and non-JSON type are required");
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (input_param->short_name.size() > 1) {
+        DOCA_LOG_ERR("Short name of --%s must be a single character", input_param->long_name.c_str());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    params.push_back(input_param);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_argp_register_validation_callback(validation_callback callback) {
+    if (callback == NULL) return DOCA_ERROR_INVALID_VALUE;
+    validator = callback;
+    return DOCA_SUCCESS;
+}
+
+static doca_error_t run_callback(doca_argp_param *param, const char *arg) {
+    bool flag = true;
+    long value;
+    char *end;
+    int int_value;
+
+    param->seen = true;
+    switch (param->type) {
+        case DOCA_ARGP_TYPE_STRING:
+            return param->callback((void *)arg, program_config);
+        case DOCA_ARGP_TYPE_INT:
+            errno = 0;
+            value = strtol(arg, &end, 0);
+            if (errno != 0 || *end != '\0' || value < INT32_MIN || value > INT32_MAX) {
+                DOCA_LOG_ERR("Flag --%s expects an integer, got \"%s\"", param->long_name.c_str(), arg);
+                return DOCA_ERROR_INVALID_VALUE;
+            }
+            int_value = (int)value;
+            return param->callback(&int_value, program_config);
+        case DOCA_ARGP_TYPE_BOOLEAN:
+            return param->callback(&flag, program_config);
+        default:
+            return DOCA_ERROR_NOT_SUPPORTED;
+    }
+}
+
+doca_error_t doca_argp_start(int argc, char **argv) {
+    std::vector<struct option> options;
+    std::string short_opts = "hvl:";
+    doca_error_t result;
+    int opt, index;
+
+    for (size_t i = 0; i < params.size(); i++) {
+        int has_arg = params[i]->type == DOCA_ARGP_TYPE_BOOLEAN ? no_argument : required_argument;
+        options.push_back({params[i]->long_name.c_str(), has_arg, NULL, (int)i});
+        if (!params[i]->short_name.empty()) short_opts += params[i]->short_name + (has_arg ? ":" : "");
+    }
+    options.push_back({"help", no_argument, NULL, ARGP_HELP});
+    options.push_back({"version", no_argument, NULL, ARGP_VERSION});
+    options.push_back({"log-level", required_argument, NULL, ARGP_LOG_LEVEL});
+    options.push_back({NULL, 0, NULL, 0});
+
+    optind = 1;
+    while ((opt = getopt_long(argc, argv, short_opts.c_str(), options.data(), &index)) != -1) {
+        if (opt >= 0 && opt < (int)params.size()) {
+            result = run_callback(params[opt], optarg);
+        } else if (opt == 'h' || opt == ARGP_HELP) {
+            usage();
+            exit(EXIT_SUCCESS);
+        } else if (opt == 'v' || opt == ARGP_VERSION) {
+            printf("%s (DOCA software emulation)\n", program.c_str());
+            exit(EXIT_SUCCESS);
+        } else if (opt == 'l' || opt == ARGP_LOG_LEVEL) {
+            doca_log_global_level_set(atoi(optarg));
+            result = DOCA_SUCCESS;
+        } else {
+            result = DOCA_ERROR_INVALID_VALUE;
+            for (doca_argp_param *param : params) {
+                if (!param->short_name.empty() && param->short_name[0] == opt) {
+                    result = run_callback(param, optarg);
+                    break;
+                }
+            }
+            if (result == DOCA_ERROR_INVALID_VALUE && opt == '?') usage();
+        }
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    for (doca_argp_param *param : params) {
+        if (param->mandatory && !param->seen) {
+            DOCA_LOG_ERR("Missing mandatory flag --%s", param->long_name.c_str());
+            usage();
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+    }
+
+    /* Checks across flags, once all of them are in */
+    if (validator != nullptr) return validator(program_config);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_argp_destroy(void) {
+    for (doca_argp_param *param : params) delete param;
+    params.clear();
+    validator = nullptr;
+    return DOCA_SUCCESS;
+}
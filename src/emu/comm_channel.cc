@@ -0,0 +1,506 @@
+#include <doca_comm_channel.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "emu.h"
+
+DOCA_LOG_REGISTER(EMU_COMM_CHANNEL);
+
+using namespace doca::emu;
+
+/*
+ * A listening endpoint publishes a segment named after its service with a
+ * table of connection slots. A client claims a free slot and creates a
+ * per-connection segment holding one single-producer ring per direction, each
+ * as deep as the receiving endpoint's receive queue. Only the listener
+ * unlinks connection segments, when it retires their slot.
+ *
+ * Messages are stamped with the time they become visible to the receiver:
+ * the sender's ring is modeled as a link of DOCA_EMU_CC_BW_MBPS (unlimited if
+ * 0) followed by DOCA_EMU_CC_LATENCY_NS of one-way latency.
+ */
+
+#define CC_SHM_PREFIX "/doca_emu_cc_"
+#define CC_MAGIC 0x646f6361636331ULL /* "docacc1" */
+
+enum cc_slot_state : uint32_t {
+    CC_SLOT_FREE,
+    CC_SLOT_CLAIMED,   /* Client is setting up the connection segment */
+    CC_SLOT_CONNECTED,
+    CC_SLOT_CLOSED,    /* Client disconnected, listener drains and retires the slot */
+};
+
+struct cc_listen_hdr {
+    std::atomic<uint64_t> magic; /* Set last, once the rest of the header is valid */
+    pid_t pid;
+    uint32_t max_msg_size;
+    uint32_t recv_queue_size;
+    std::atomic<uint32_t> slot_state[EMU_CC_MAX_CONNS];
+};
+
+struct cc_entry {
+    uint64_t ready_ns;
+    uint32_t len;
+    uint32_t reserved;
+    /* entry_size bytes of payload follow */
+};
+
+struct cc_ring {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) uint64_t link_free_ns; /* Producer only */
+    uint32_t capacity;
+    uint32_t entry_size;
+};
+
+struct cc_conn_hdr {
+    std::atomic<uint32_t> server_closed;
+    uint64_t ring_off[2];
+};
+static_assert(sizeof(cc_conn_hdr) <= 64, "connection header must fit before the first ring");
+
+enum cc_dir { CC_C2S, CC_S2C };
+
+struct doca_comm_channel_addr_t {
+    struct doca_comm_channel_ep_t *ep;
+    int slot = -1;
+    cc_conn_hdr *conn = nullptr;
+    size_t conn_size = 0;
+};
+
+struct doca_comm_channel_ep_t {
+    struct doca_dev *dev = nullptr;
+    struct doca_dev_rep *dev_rep = nullptr;
+    uint32_t max_msg_size = 0;
+    uint32_t send_queue_size = 0;
+    uint32_t recv_queue_size = 0;
+    std::string name;
+    bool listening = false;
+    cc_listen_hdr *hdr = nullptr;
+    doca_comm_channel_addr_t *client = nullptr;
+    doca_comm_channel_addr_t peers[EMU_CC_MAX_CONNS];
+    uint32_t next_peer = 0;
+};
+
+static uint64_t cc_latency_ns() {
+    static uint64_t latency_ns = EnvU64("DOCA_EMU_CC_LATENCY_NS", 0);
+    return latency_ns;
+}
+
+static uint64_t cc_bw_mbps() {
+    static uint64_t bw_mbps = EnvU64("DOCA_EMU_CC_BW_MBPS", 0);
+    return bw_mbps;
+}
+
+static std::string shm_name(const std::string &service, int slot) {
+    std::string name = CC_SHM_PREFIX + service;
+
+    std::replace(name.begin() + 1, name.end(), '/', '_');
+    if (slot >= 0) name += "." + std::to_string(slot);
+    return name;
+}
+
+static void *shm_map(const std::string &name, size_t size, bool create) {
+    void *addr;
+    int fd;
+
+    if (create) {
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    } else {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0) return NULL;
+
+    if (create && ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return NULL;
+    }
+    if (!create) {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < size) {
+            close(fd);
+            return NULL;
+        }
+        size = st.st_size;
+    }
+
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return addr == MAP_FAILED ? NULL : addr;
+}
+
+/* Entries are 8 byte aligned, rings cache line aligned */
+static size_t entry_stride(uint32_t entry_size) { return (sizeof(cc_entry) + entry_size + 7) & ~7UL; }
+
+static size_t ring_size(uint32_t capacity, uint32_t entry_size) {
+    return (sizeof(cc_ring) + capacity * entry_stride(entry_size) + 63) & ~63UL;
+}
+
+static cc_ring *conn_ring(cc_conn_hdr *conn, cc_dir dir) { return (cc_ring *)((char *)conn + conn->ring_off[dir]); }
+
+static cc_entry *ring_entry(cc_ring *ring, uint64_t pos) {
+    return (cc_entry *)((char *)(ring + 1) + (pos % ring->capacity) * entry_stride(ring->entry_size));
+}
+
+static doca_error_t ring_push(cc_ring *ring, const void *msg, size_t len) {
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t now, start;
+    cc_entry *entry;
+
+    if (len > ring->entry_size) return DOCA_ERROR_INVALID_VALUE;
+    if (tail - ring->head.load(std::memory_order_acquire) == ring->capacity) {
+        PollMiss();
+        return DOCA_ERROR_AGAIN;
+    }
+
+    now = NowNs();
+    start = now;
+    if (cc_bw_mbps() != 0) {
+        start = std::max(now, ring->link_free_ns);
+        ring->link_free_ns = start + (uint64_t)len * 1000 / cc_bw_mbps();
+        start = ring->link_free_ns;
+    }
+
+    entry = ring_entry(ring, tail);
+    memcpy(entry + 1, msg, len);
+    entry->len = len;
+    entry->ready_ns = start + cc_latency_ns();
+    ring->tail.store(tail + 1, std::memory_order_release);
+    return DOCA_SUCCESS;
+}
+
+static doca_error_t ring_pop(cc_ring *ring, void *msg, size_t *len) {
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    cc_entry *entry;
+
+    if (head == ring->tail.load(std::memory_order_acquire)) return DOCA_ERROR_AGAIN;
+    entry = ring_entry(ring, head);
+    if (entry->ready_ns > NowNs()) return DOCA_ERROR_AGAIN;
+    if (entry->len > *len) return DOCA_ERROR_INVALID_VALUE;
+
+    memcpy(msg, entry + 1, entry->len);
+    *len = entry->len;
+    ring->head.store(head + 1, std::memory_order_release);
+    return DOCA_SUCCESS;
+}
+
+static void unmap_conn(doca_comm_channel_addr_t *addr) {
+    if (addr->conn) munmap(addr->conn, addr->conn_size);
+    addr->conn = nullptr;
+    addr->conn_size = 0;
+}
+
+/*
+ * Listener side: drop a connection. A slot the client already left is freed
+ * for the next client; otherwise the client frees it when it disconnects, so
+ * that a late disconnect never lands on a slot that has been reused.
+ */
+static void retire_peer(doca_comm_channel_ep_t *ep, int slot) {
+    doca_comm_channel_addr_t *peer = &ep->peers[slot];
+    uint32_t closed = CC_SLOT_CLOSED;
+
+    if (peer->conn) peer->conn->server_closed.store(1);
+    unmap_conn(peer);
+    shm_unlink(shm_name(ep->name, slot).c_str());
+    ep->hdr->slot_state[slot].compare_exchange_strong(closed, CC_SLOT_FREE);
+}
+
+/* Client side: claim a slot in the listener's table and lay out the connection segment */
+static doca_error_t try_connect(doca_comm_channel_addr_t *addr) {
+    doca_comm_channel_ep_t *ep = addr->ep;
+    uint32_t entry_size, c2s_cap, s2c_cap;
+    cc_conn_hdr *conn;
+    size_t size;
+
+    if (ep->hdr == nullptr) {
+        ep->hdr = (cc_listen_hdr *)shm_map(shm_name(ep->name, -1), sizeof(cc_listen_hdr), false);
+        if (ep->hdr == nullptr) return DOCA_ERROR_CONNECTION_INPROGRESS;
+    }
+    /* Not initialized yet, or left behind by a listener that is gone */
+    if (ep->hdr->magic.load(std::memory_order_acquire) != CC_MAGIC || kill(ep->hdr->pid, 0) != 0) {
+        munmap(ep->hdr, sizeof(cc_listen_hdr));
+        ep->hdr = nullptr;
+        return DOCA_ERROR_CONNECTION_INPROGRESS;
+    }
+
+    for (int i = 0; i < EMU_CC_MAX_CONNS && addr->slot < 0; i++) {
+        uint32_t expected = CC_SLOT_FREE;
+        if (ep->hdr->slot_state[i].compare_exchange_strong(expected, CC_SLOT_CLAIMED)) addr->slot = i;
+    }
+    if (addr->slot < 0) return DOCA_ERROR_CONNECTION_INPROGRESS;
+
+    entry_size = std::max(ep->max_msg_size, ep->hdr->max_msg_size);
+    c2s_cap = ep->hdr->recv_queue_size;
+    s2c_cap = ep->recv_queue_size;
+    /* Rings follow the connection header, which fits in the first cache line */
+    size = 64 + ring_size(c2s_cap, entry_size) + ring_size(s2c_cap, entry_size);
+    conn = (cc_conn_hdr *)shm_map(shm_name(ep->name, addr->slot), size, true);
+    if (conn == nullptr) {
+        DOCA_LOG_ERR("Failed to create connection segment for %s: %s", ep->name.c_str(), strerror(errno));
+        ep->hdr->slot_state[addr->slot].store(CC_SLOT_FREE, std::memory_order_release);
+        addr->slot = -1;
+        return DOCA_ERROR_NO_MEMORY;
+    }
+
+    conn->ring_off[CC_C2S] = 64;
+    conn->ring_off[CC_S2C] = 64 + ring_size(c2s_cap, entry_size);
+    conn_ring(conn, CC_C2S)->capacity = c2s_cap;
+    conn_ring(conn, CC_C2S)->entry_size = entry_size;
+    conn_ring(conn, CC_S2C)->capacity = s2c_cap;
+    conn_ring(conn, CC_S2C)->entry_size = entry_size;
+    addr->conn = conn;
+    addr->conn_size = size;
+
+    ep->hdr->slot_state[addr->slot].store(CC_SLOT_CONNECTED, std::memory_order_release);
+    return DOCA_SUCCESS;
+}
+
+/* Listener side: map the connection segment of a slot a client has set up */
+static doca_comm_channel_addr_t *peer_of(doca_comm_channel_ep_t *ep, int slot) {
+    doca_comm_channel_addr_t *peer = &ep->peers[slot];
+    uint32_t state = ep->hdr->slot_state[slot].load(std::memory_order_acquire);
+    struct stat st;
+    int fd;
+
+    if (state != CC_SLOT_CONNECTED && state != CC_SLOT_CLOSED) return nullptr;
+    if (peer->conn) return peer;
+
+    fd = shm_open(shm_name(ep->name, slot).c_str(), O_RDWR, 0);
+    if (fd < 0) return nullptr;
+    if (fstat(fd, &st) == 0) {
+        void *addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            peer->conn = (cc_conn_hdr *)addr;
+            peer->conn_size = st.st_size;
+        }
+    }
+    close(fd);
+    return peer->conn ? peer : nullptr;
+}
+
+doca_error_t doca_comm_channel_ep_create(struct doca_comm_channel_ep_t **ep) {
+    if (ep == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *ep = new doca_comm_channel_ep_t();
+    for (doca_comm_channel_addr_t &peer : (*ep)->peers) peer.ep = *ep;
+    for (int i = 0; i < EMU_CC_MAX_CONNS; i++) (*ep)->peers[i].slot = i;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_destroy(struct doca_comm_channel_ep_t *ep) {
+    if (ep == NULL) return DOCA_ERROR_INVALID_VALUE;
+
+    if (ep->client) doca_comm_channel_ep_disconnect(ep, ep->client);
+    if (ep->listening) {
+        for (int i = 0; i < EMU_CC_MAX_CONNS; i++) {
+            if (ep->hdr->slot_state[i].load(std::memory_order_acquire) != CC_SLOT_FREE) retire_peer(ep, i);
+        }
+        shm_unlink(shm_name(ep->name, -1).c_str());
+    }
+    if (ep->hdr) munmap(ep->hdr, sizeof(cc_listen_hdr));
+    delete ep;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_set_device(struct doca_comm_channel_ep_t *ep, struct doca_dev *device) {
+    uint32_t max;
+
+    if (ep == NULL || device == NULL) return DOCA_ERROR_INVALID_VALUE;
+    ep->dev = device;
+    /* Device maximums until told otherwise */
+    doca_comm_channel_get_max_message_size(device->info, &max);
+    if (ep->max_msg_size == 0) ep->max_msg_size = max;
+    doca_comm_channel_get_max_send_queue_size(device->info, &max);
+    if (ep->send_queue_size == 0) ep->send_queue_size = max;
+    doca_comm_channel_get_max_recv_queue_size(device->info, &max);
+    if (ep->recv_queue_size == 0) ep->recv_queue_size = max;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_set_max_msg_size(struct doca_comm_channel_ep_t *ep, uint16_t max_msg_size) {
+    uint32_t max;
+
+    if (ep == NULL || ep->dev == NULL || max_msg_size == 0) return DOCA_ERROR_INVALID_VALUE;
+    doca_comm_channel_get_max_message_size(ep->dev->info, &max);
+    if (max_msg_size > max) return DOCA_ERROR_INVALID_VALUE;
+    ep->max_msg_size = max_msg_size;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_set_send_queue_size(struct doca_comm_channel_ep_t *ep, uint16_t send_queue_size) {
+    uint32_t max;
+
+    if (ep == NULL || ep->dev == NULL || send_queue_size == 0) return DOCA_ERROR_INVALID_VALUE;
+    doca_comm_channel_get_max_send_queue_size(ep->dev->info, &max);
+    if (send_queue_size > max) return DOCA_ERROR_INVALID_VALUE;
+    ep->send_queue_size = send_queue_size;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_set_recv_queue_size(struct doca_comm_channel_ep_t *ep, uint16_t recv_queue_size) {
+    uint32_t max;
+
+    if (ep == NULL || ep->dev == NULL || recv_queue_size == 0) return DOCA_ERROR_INVALID_VALUE;
+    doca_comm_channel_get_max_recv_queue_size(ep->dev->info, &max);
+    if (recv_queue_size > max) return DOCA_ERROR_INVALID_VALUE;
+    ep->recv_queue_size = recv_queue_size;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_set_device_rep(struct doca_comm_channel_ep_t *ep, struct doca_dev_rep *device_rep) {
+    if (ep == NULL || device_rep == NULL) return DOCA_ERROR_INVALID_VALUE;
+    ep->dev_rep = device_rep;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_listen(struct doca_comm_channel_ep_t *local_ep, const char *name) {
+    cc_listen_hdr *hdr;
+
+    if (local_ep == NULL || name == NULL || local_ep->dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (local_ep->listening || local_ep->client) return DOCA_ERROR_BAD_STATE;
+
+    local_ep->name = name;
+    hdr = (cc_listen_hdr *)shm_map(shm_name(local_ep->name, -1), sizeof(cc_listen_hdr), true);
+    if (hdr == NULL) {
+        DOCA_LOG_ERR("Failed to create service %s: %s", name, strerror(errno));
+        return DOCA_ERROR_OPERATING_SYSTEM;
+    }
+    /* Connection segments of a previous listener under this name are stale */
+    for (int i = 0; i < EMU_CC_MAX_CONNS; i++) shm_unlink(shm_name(local_ep->name, i).c_str());
+
+    hdr->pid = getpid();
+    hdr->max_msg_size = local_ep->max_msg_size;
+    hdr->recv_queue_size = local_ep->recv_queue_size;
+    hdr->magic.store(CC_MAGIC, std::memory_order_release);
+    local_ep->hdr = hdr;
+    local_ep->listening = true;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_ep_connect(struct doca_comm_channel_ep_t *local_ep, const char *name,
+                                          struct doca_comm_channel_addr_t **peer_addr) {
+    doca_error_t result;
+
+    if (local_ep == NULL || name == NULL || peer_addr == NULL || local_ep->dev == NULL)
+        return DOCA_ERROR_INVALID_VALUE;
+    if (local_ep->listening || local_ep->client) return DOCA_ERROR_BAD_STATE;
+
+    local_ep->name = name;
+    local_ep->client = new doca_comm_channel_addr_t();
+    local_ep->client->ep = local_ep;
+    /* The connection completes in peer_addr_update_info if the listener is not up yet */
+    result = try_connect(local_ep->client);
+    if (result != DOCA_SUCCESS && result != DOCA_ERROR_CONNECTION_INPROGRESS) {
+        delete local_ep->client;
+        local_ep->client = nullptr;
+        return result;
+    }
+    *peer_addr = local_ep->client;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_peer_addr_update_info(struct doca_comm_channel_addr_t *peer_addr) {
+    if (peer_addr == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (peer_addr->conn) return DOCA_SUCCESS;
+    if (peer_addr->ep->listening) return DOCA_ERROR_NOT_CONNECTED;
+    return try_connect(peer_addr);
+}
+
+doca_error_t doca_comm_channel_ep_sendto(struct doca_comm_channel_ep_t *local_ep, const void *msg, size_t len,
+                                         int flags, struct doca_comm_channel_addr_t *peer_addr) {
+    (void)flags;
+    if (local_ep == NULL || msg == NULL || peer_addr == NULL || peer_addr->ep != local_ep)
+        return DOCA_ERROR_INVALID_VALUE;
+    if (len > local_ep->max_msg_size) return DOCA_ERROR_INVALID_VALUE;
+    if (peer_addr->conn == nullptr) return DOCA_ERROR_NOT_CONNECTED;
+
+    if (local_ep->listening) {
+        /* Like a disconnect still in flight on hardware, messages to a departing client are dropped */
+        if (local_ep->hdr->slot_state[peer_addr->slot].load(std::memory_order_acquire) == CC_SLOT_CLOSED)
+            return DOCA_SUCCESS;
+        return ring_push(conn_ring(peer_addr->conn, CC_S2C), msg, len);
+    }
+    if (peer_addr->conn->server_closed.load(std::memory_order_acquire)) return DOCA_ERROR_CONNECTION_RESET;
+    return ring_push(conn_ring(peer_addr->conn, CC_C2S), msg, len);
+}
+
+doca_error_t doca_comm_channel_ep_recvfrom(struct doca_comm_channel_ep_t *local_ep, void *msg, size_t *len,
+                                           int flags, struct doca_comm_channel_addr_t **peer_addr) {
+    doca_comm_channel_addr_t *peer;
+    doca_error_t result;
+
+    (void)flags;
+    if (local_ep == NULL || msg == NULL || len == NULL || peer_addr == NULL) return DOCA_ERROR_INVALID_VALUE;
+
+    if (!local_ep->listening) {
+        peer = local_ep->client;
+        if (peer == nullptr || peer->conn == nullptr) return DOCA_ERROR_NOT_CONNECTED;
+        result = ring_pop(conn_ring(peer->conn, CC_S2C), msg, len);
+        if (result == DOCA_ERROR_AGAIN && peer->conn->server_closed.load(std::memory_order_acquire))
+            return DOCA_ERROR_CONNECTION_RESET;
+        if (result == DOCA_ERROR_AGAIN) PollMiss();
+        if (result == DOCA_SUCCESS) *peer_addr = peer;
+        return result;
+    }
+
+    /* Round robin over connected clients so a busy one cannot starve the others */
+    for (uint32_t n = 0; n < EMU_CC_MAX_CONNS; n++) {
+        int slot = (local_ep->next_peer + n) % EMU_CC_MAX_CONNS;
+
+        peer = peer_of(local_ep, slot);
+        if (peer == nullptr) continue;
+        result = ring_pop(conn_ring(peer->conn, CC_C2S), msg, len);
+        if (result == DOCA_SUCCESS) {
+            local_ep->next_peer = slot + 1;
+            *peer_addr = peer;
+            return result;
+        }
+        if (result != DOCA_ERROR_AGAIN) return result;
+        /* Everything the client sent before disconnecting has been read */
+        if (local_ep->hdr->slot_state[slot].load(std::memory_order_acquire) == CC_SLOT_CLOSED &&
+            conn_ring(peer->conn, CC_C2S)->head.load() == conn_ring(peer->conn, CC_C2S)->tail.load())
+            retire_peer(local_ep, slot);
+    }
+    PollMiss();
+    return DOCA_ERROR_AGAIN;
+}
+
+doca_error_t doca_comm_channel_ep_disconnect(struct doca_comm_channel_ep_t *local_ep,
+                                             struct doca_comm_channel_addr_t *peer_addr) {
+    if (local_ep == NULL || peer_addr == NULL || peer_addr->ep != local_ep) return DOCA_ERROR_INVALID_VALUE;
+
+    if (local_ep->listening) {
+        if (peer_addr->conn == nullptr) return DOCA_ERROR_NOT_CONNECTED;
+        retire_peer(local_ep, peer_addr->slot);
+        return DOCA_SUCCESS;
+    }
+
+    if (peer_addr->conn && local_ep->hdr) {
+        std::atomic<uint32_t> &state = local_ep->hdr->slot_state[peer_addr->slot];
+        uint32_t expected = CC_SLOT_CONNECTED;
+
+        /*
+         * The listener raises server_closed before it tries to free a CLOSED slot, the client closes the slot
+         * before it looks at server_closed: at least one of them sees the other, and the CAS lets only one free
+         * it. A listener retiring in between would otherwise find the slot still CONNECTED and leak it.
+         */
+        state.compare_exchange_strong(expected, CC_SLOT_CLOSED);
+        if (peer_addr->conn->server_closed.load()) {
+            expected = CC_SLOT_CLOSED;
+            state.compare_exchange_strong(expected, CC_SLOT_FREE);
+        }
+    }
+    unmap_conn(peer_addr);
+    local_ep->client = nullptr;
+    delete peer_addr;
+    return DOCA_SUCCESS;
+}
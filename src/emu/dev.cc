@@ -0,0 +1,173 @@
+#include <doca_comm_channel.h>
+#include <doca_dev.h>
+#include <doca_dma.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mutex>
+
+#include "emu.h"
+
+using namespace doca::emu;
+
+/*
+ * Devices and representors are fixed for the process lifetime and come from
+ * comma separated PCI address lists in DOCA_EMU_PCI and DOCA_EMU_REP_PCI.
+ */
+static doca_devinfo devinfos[EMU_MAX_DEVS];
+static uint32_t nb_devinfos;
+static doca_devinfo_rep devinfo_reps[EMU_MAX_DEVS];
+static uint32_t nb_devinfo_reps;
+static std::once_flag enumerated;
+
+static uint32_t parse_pci_list(const char *list, char (*out)[DOCA_DEVINFO_PCI_ADDR_SIZE], size_t stride) {
+    uint32_t n = 0;
+    const char *p = list;
+
+    while (*p != '\0' && n < EMU_MAX_DEVS) {
+        size_t len = strcspn(p, ",");
+        char *addr = (char *)out + n * stride;
+
+        if (len > 0 && len < DOCA_DEVINFO_PCI_ADDR_SIZE) {
+            memcpy(addr, p, len);
+            addr[len] = '\0';
+            n++;
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+    return n;
+}
+
+static void enumerate() {
+    nb_devinfos = parse_pci_list(EnvStr("DOCA_EMU_PCI", EMU_DEFAULT_PCI), &devinfos[0].pci_addr, sizeof(devinfos[0]));
+    for (uint32_t i = 0; i < nb_devinfos; i++)
+        snprintf(devinfos[i].ibdev_name, sizeof(devinfos[i].ibdev_name), "mlx5_emu%u", i);
+    nb_devinfo_reps = parse_pci_list(EnvStr("DOCA_EMU_REP_PCI", EMU_DEFAULT_REP_PCI), &devinfo_reps[0].pci_addr,
+                                     sizeof(devinfo_reps[0]));
+}
+
+doca_error_t doca_devinfo_list_create(struct doca_devinfo ***dev_list, uint32_t *nb_devs) {
+    if (dev_list == NULL || nb_devs == NULL) return DOCA_ERROR_INVALID_VALUE;
+    std::call_once(enumerated, enumerate);
+    if (nb_devinfos == 0) return DOCA_ERROR_NOT_FOUND;
+
+    *dev_list = new doca_devinfo *[nb_devinfos];
+    for (uint32_t i = 0; i < nb_devinfos; i++) (*dev_list)[i] = &devinfos[i];
+    *nb_devs = nb_devinfos;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_list_destroy(struct doca_devinfo **dev_list) {
+    delete[] dev_list;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_rep_list_create(struct doca_dev *dev, int filter, struct doca_devinfo_rep ***dev_list_rep,
+                                          uint32_t *nb_devs_rep) {
+    (void)filter;
+    if (dev == NULL || dev_list_rep == NULL || nb_devs_rep == NULL) return DOCA_ERROR_INVALID_VALUE;
+    std::call_once(enumerated, enumerate);
+    if (nb_devinfo_reps == 0) return DOCA_ERROR_NOT_FOUND;
+
+    *dev_list_rep = new doca_devinfo_rep *[nb_devinfo_reps];
+    for (uint32_t i = 0; i < nb_devinfo_reps; i++) (*dev_list_rep)[i] = &devinfo_reps[i];
+    *nb_devs_rep = nb_devinfo_reps;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_rep_list_destroy(struct doca_devinfo_rep **dev_list_rep) {
+    delete[] dev_list_rep;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_get_pci_addr_str(const struct doca_devinfo *devinfo, char *pci_addr_str) {
+    if (devinfo == NULL || pci_addr_str == NULL) return DOCA_ERROR_INVALID_VALUE;
+    strcpy(pci_addr_str, devinfo->pci_addr);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_get_is_pci_addr_equal(const struct doca_devinfo *devinfo, const char *pci_addr_str,
+                                                uint8_t *is_equal) {
+    if (devinfo == NULL || pci_addr_str == NULL || is_equal == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *is_equal = PciAddrEqual(devinfo->pci_addr, pci_addr_str);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_get_ibdev_name(const struct doca_devinfo *devinfo, char *ibdev_name, uint32_t size) {
+    if (devinfo == NULL || ibdev_name == NULL || size == 0) return DOCA_ERROR_INVALID_VALUE;
+    snprintf(ibdev_name, size, "%s", devinfo->ibdev_name);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_rep_get_pci_addr_str(const struct doca_devinfo_rep *devinfo_rep, char *pci_addr_str) {
+    if (devinfo_rep == NULL || pci_addr_str == NULL) return DOCA_ERROR_INVALID_VALUE;
+    strcpy(pci_addr_str, devinfo_rep->pci_addr);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_devinfo_rep_get_is_pci_addr_equal(const struct doca_devinfo_rep *devinfo_rep,
+                                                    const char *pci_addr_str, uint8_t *is_equal) {
+    if (devinfo_rep == NULL || pci_addr_str == NULL || is_equal == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *is_equal = PciAddrEqual(devinfo_rep->pci_addr, pci_addr_str);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_dev_open(struct doca_devinfo *devinfo, struct doca_dev **dev) {
+    if (devinfo == NULL || dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *dev = new doca_dev{devinfo};
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_dev_close(struct doca_dev *dev) {
+    if (dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    delete dev;
+    return DOCA_SUCCESS;
+}
+
+struct doca_devinfo *doca_dev_as_devinfo(const struct doca_dev *dev) {
+    return dev ? dev->info : NULL;
+}
+
+doca_error_t doca_dev_rep_open(struct doca_devinfo_rep *devinfo, struct doca_dev_rep **dev_rep) {
+    if (devinfo == NULL || dev_rep == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *dev_rep = new doca_dev_rep{devinfo};
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_dev_rep_close(struct doca_dev_rep *dev) {
+    if (dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    delete dev;
+    return DOCA_SUCCESS;
+}
+
+/* Capabilities, every emulated device supports DMA memcpy and comm channel */
+
+doca_error_t doca_dma_job_get_supported(struct doca_devinfo *devinfo, enum doca_dma_job_types job_type) {
+    if (devinfo == NULL) return DOCA_ERROR_INVALID_VALUE;
+    return job_type == DOCA_DMA_JOB_MEMCPY ? DOCA_SUCCESS : DOCA_ERROR_NOT_SUPPORTED;
+}
+
+doca_error_t doca_dma_get_max_buf_size(const struct doca_devinfo *devinfo, uint64_t *buf_size) {
+    if (devinfo == NULL || buf_size == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *buf_size = EnvU64("DOCA_EMU_DMA_MAX_BUF_SIZE", EMU_DMA_MAX_BUF_SIZE);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_get_max_message_size(struct doca_devinfo *devinfo, uint32_t *max_message_size) {
+    if (devinfo == NULL || max_message_size == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *max_message_size = (uint32_t)EnvU64("DOCA_EMU_CC_MAX_MSG_SIZE", EMU_CC_MAX_MSG_SIZE);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_get_max_send_queue_size(struct doca_devinfo *devinfo, uint32_t *max_send_queue_size) {
+    if (devinfo == NULL || max_send_queue_size == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *max_send_queue_size = (uint32_t)EnvU64("DOCA_EMU_CC_MAX_QUEUE_SIZE", EMU_CC_MAX_QUEUE_SIZE);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_comm_channel_get_max_recv_queue_size(struct doca_devinfo *devinfo, uint32_t *max_recv_queue_size) {
+    if (devinfo == NULL || max_recv_queue_size == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *max_recv_queue_size = (uint32_t)EnvU64("DOCA_EMU_CC_MAX_QUEUE_SIZE", EMU_CC_MAX_QUEUE_SIZE);
+    return DOCA_SUCCESS;
+}
@@ -0,0 +1,288 @@
+#include <doca_ctx.h>
+#include <doca_dma.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+#include "emu.h"
+
+DOCA_LOG_REGISTER(EMU_DMA);
+
+using namespace doca::emu;
+
+/*
+ * DMA memcpy jobs are executed by a process-wide pool of copy threads. Each
+ * job is also timed against a per-device link model: it starts once the link
+ * is free, occupies it for size / DOCA_EMU_DMA_BW_MBPS and completes
+ * DOCA_EMU_DMA_LATENCY_NS later. A completion becomes visible to
+ * progress_retrieve when both the copy and the modeled time are done.
+ */
+namespace {
+
+struct copy_job {
+    struct doca_workq *workq;
+    struct doca_event event;
+    struct doca_buf *src;
+    struct doca_buf *dst;
+    size_t len;
+    uint64_t done_ns; /* Completion time given by the link model */
+};
+
+class CopyEngine {
+   public:
+    static CopyEngine &Instance() {
+        /* Never destroyed: detached workers block on its queue until the process exits */
+        static CopyEngine *engine = new CopyEngine();
+        return *engine;
+    }
+
+    void Post(const copy_job &job) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (workers.empty()) Start();
+            jobs.push_back(job);
+        }
+        cond.notify_one();
+    }
+
+   private:
+    std::mutex lock;
+    std::condition_variable cond;
+    std::deque<copy_job> jobs;
+    std::vector<std::thread> workers;
+
+    CopyEngine() = default;
+
+    void Start() {
+        uint64_t nb_threads = std::max<uint64_t>(1, EnvU64("DOCA_EMU_DMA_THREADS", EMU_DMA_THREADS));
+
+        for (uint64_t i = 0; i < nb_threads; i++) {
+            workers.emplace_back(&CopyEngine::Worker, this);
+            workers.back().detach();
+        }
+    }
+
+    void Worker() {
+        for (;;) {
+            copy_job job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                cond.wait(guard, [this] { return !jobs.empty(); });
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            doca_error_t result = Copy(job);
+            uint64_t now = NowNs();
+            {
+                std::lock_guard<std::mutex> guard(job.workq->lock);
+                job.workq->done.push_back({job.event, result, std::max(now, job.done_ns)});
+            }
+            job.workq->running.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    static doca_error_t Copy(const copy_job &job) {
+        pid_t self = getpid();
+        pid_t src_pid = job.src->mmap->pid;
+        pid_t dst_pid = job.dst->mmap->pid;
+        struct iovec local, remote;
+        ssize_t n;
+
+        if (src_pid == self && dst_pid == self) {
+            memcpy(job.dst->data, job.src->data, job.len);
+            return DOCA_SUCCESS;
+        }
+        if (src_pid != self && dst_pid != self) {
+            /* Both ends in other processes, bounce through local memory */
+            std::vector<char> bounce(job.len);
+            local = {bounce.data(), job.len};
+            remote = {job.src->data, job.len};
+            if (process_vm_readv(src_pid, &local, 1, &remote, 1, 0) != (ssize_t)job.len) return Fail(src_pid);
+            remote = {job.dst->data, job.len};
+            if (process_vm_writev(dst_pid, &local, 1, &remote, 1, 0) != (ssize_t)job.len) return Fail(dst_pid);
+            return DOCA_SUCCESS;
+        }
+        if (src_pid != self) {
+            local = {job.dst->data, job.len};
+            remote = {job.src->data, job.len};
+            n = process_vm_readv(src_pid, &local, 1, &remote, 1, 0);
+            return n == (ssize_t)job.len ? DOCA_SUCCESS : Fail(src_pid);
+        }
+        local = {job.src->data, job.len};
+        remote = {job.dst->data, job.len};
+        n = process_vm_writev(dst_pid, &local, 1, &remote, 1, 0);
+        return n == (ssize_t)job.len ? DOCA_SUCCESS : Fail(dst_pid);
+    }
+
+    static doca_error_t Fail(pid_t pid) {
+        DOCA_LOG_ERR("Failed to access memory of process %d: %s", pid, strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+};
+
+/* Reserve the device link for len bytes, returns the job completion time */
+uint64_t model_completion(struct doca_devinfo *info, size_t len) {
+    static uint64_t latency_ns = EnvU64("DOCA_EMU_DMA_LATENCY_NS", 0);
+    static uint64_t bw_mbps = EnvU64("DOCA_EMU_DMA_BW_MBPS", 0);
+    uint64_t now = NowNs();
+    uint64_t start;
+
+    if (bw_mbps == 0) return now + latency_ns;
+
+    std::lock_guard<std::mutex> guard(info->link_lock);
+    start = std::max(now, info->link_free_ns);
+    info->link_free_ns = start + (uint64_t)len * 1000 / bw_mbps;
+    return info->link_free_ns + latency_ns;
+}
+
+}  // namespace
+
+doca_error_t doca_dma_create(struct doca_dma **dma) {
+    if (dma == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *dma = new doca_dma();
+    (*dma)->ctx.type = EMU_CTX_DMA;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_dma_destroy(struct doca_dma *dma) {
+    if (dma == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (dma->ctx.started) return DOCA_ERROR_IN_USE;
+    delete dma;
+    return DOCA_SUCCESS;
+}
+
+struct doca_ctx *doca_dma_as_ctx(struct doca_dma *dma) {
+    return dma ? &dma->ctx : NULL;
+}
+
+doca_error_t doca_ctx_dev_add(struct doca_ctx *ctx, struct doca_dev *dev) {
+    if (ctx == NULL || dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (ctx->dev != NULL) return DOCA_ERROR_IN_USE;
+    ctx->dev = dev;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_ctx_dev_rm(struct doca_ctx *ctx, struct doca_dev *dev) {
+    if (ctx == NULL || dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (ctx->dev != dev) return DOCA_ERROR_NOT_FOUND;
+    if (ctx->started) return DOCA_ERROR_BAD_STATE;
+    ctx->dev = NULL;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_ctx_start(struct doca_ctx *ctx) {
+    if (ctx == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (ctx->dev == NULL) return DOCA_ERROR_BAD_STATE;
+    ctx->started = true;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_ctx_stop(struct doca_ctx *ctx) {
+    if (ctx == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (!ctx->workqs.empty()) return DOCA_ERROR_IN_USE;
+    ctx->started = false;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_ctx_workq_add(struct doca_ctx *ctx, struct doca_workq *workq) {
+    if (ctx == NULL || workq == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (!ctx->started) return DOCA_ERROR_BAD_STATE;
+    if (workq->ctx != NULL) return DOCA_ERROR_IN_USE;
+    workq->ctx = ctx;
+    ctx->workqs.push_back(workq);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_ctx_workq_rm(struct doca_ctx *ctx, struct doca_workq *workq) {
+    if (ctx == NULL || workq == NULL) return DOCA_ERROR_INVALID_VALUE;
+    auto it = std::find(ctx->workqs.begin(), ctx->workqs.end(), workq);
+    if (it == ctx->workqs.end()) return DOCA_ERROR_NOT_FOUND;
+    /* Jobs still being copied reference the work queue */
+    while (workq->running.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    ctx->workqs.erase(it);
+    workq->ctx = NULL;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_workq_create(uint32_t depth, struct doca_workq **workq) {
+    if (depth == 0 || workq == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *workq = new doca_workq();
+    (*workq)->depth = depth;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_workq_destroy(struct doca_workq *workq) {
+    if (workq == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (workq->ctx != NULL) return DOCA_ERROR_IN_USE;
+    delete workq;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_workq_submit(struct doca_workq *workq, const struct doca_job *job) {
+    const struct doca_dma_job_memcpy *memcpy_job = (const struct doca_dma_job_memcpy *)job;
+    struct doca_buf *src, *dst;
+    copy_job copy = {};
+
+    if (workq == NULL || job == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (workq->ctx == NULL || job->ctx != workq->ctx || !job->ctx->started) return DOCA_ERROR_BAD_STATE;
+    if (job->type != DOCA_DMA_JOB_MEMCPY) return DOCA_ERROR_NOT_SUPPORTED;
+
+    src = memcpy_job->src_buff;
+    dst = memcpy_job->dst_buff;
+    if (src == NULL || dst == NULL) return DOCA_ERROR_INVALID_VALUE;
+    /* The copy lands at the destination data pointer and must fit before the end of the buffer */
+    if ((size_t)(dst->head + dst->len - dst->data) < src->data_len) return DOCA_ERROR_INVALID_VALUE;
+
+    {
+        std::lock_guard<std::mutex> guard(workq->lock);
+        if (workq->inflight == workq->depth) return DOCA_ERROR_AGAIN;
+        workq->inflight++;
+    }
+
+    copy.workq = workq;
+    copy.event.type = job->type;
+    copy.event.user_data = job->user_data;
+    copy.src = src;
+    copy.dst = dst;
+    copy.len = src->data_len;
+    copy.done_ns = model_completion(job->ctx->dev->info, copy.len);
+    dst->data_len = copy.len;
+
+    workq->running.fetch_add(1, std::memory_order_relaxed);
+    CopyEngine::Instance().Post(copy);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_workq_progress_retrieve(struct doca_workq *workq, struct doca_event *ev, int flags) {
+    uint64_t now;
+
+    (void)flags;
+    if (workq == NULL || ev == NULL) return DOCA_ERROR_INVALID_VALUE;
+
+    std::unique_lock<std::mutex> guard(workq->lock);
+    if (workq->done.empty()) {
+        guard.unlock();
+        PollMiss();
+        return DOCA_ERROR_AGAIN;
+    }
+
+    /* Copy threads may finish out of order, hand out any completion that is due */
+    now = NowNs();
+    for (auto it = workq->done.begin(); it != workq->done.end(); ++it) {
+        if (it->done_ns > now) continue;
+        *ev = it->event;
+        ev->result.u64 = it->result;
+        workq->done.erase(it);
+        workq->inflight--;
+        return ev->result.u64 == DOCA_SUCCESS ? DOCA_SUCCESS : DOCA_ERROR_IO_FAILED;
+    }
+    guard.unlock();
+    PollMiss();
+    return DOCA_ERROR_AGAIN;
+}
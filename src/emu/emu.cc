@@ -0,0 +1,147 @@
+#include "emu.h"
+
+#include <doca_error.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace doca::emu {
+
+uint64_t NowNs() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+uint64_t EnvU64(const char *name, uint64_t def) {
+    const char *value = getenv(name);
+    char *end;
+    uint64_t result;
+
+    if (value == NULL || *value == '\0') return def;
+    result = strtoull(value, &end, 0);
+    return *end == '\0' ? result : def;
+}
+
+const char *EnvStr(const char *name, const char *def) {
+    const char *value = getenv(name);
+
+    return (value == NULL || *value == '\0') ? def : value;
+}
+
+/* Skip the PCI domain, if any: "0000:03:00.0" -> "03:00.0" */
+static const char *strip_domain(const char *addr) {
+    const char *first = strchr(addr, ':');
+
+    if (first != NULL && strchr(first + 1, ':') != NULL) return first + 1;
+    return addr;
+}
+
+bool PciAddrEqual(const char *a, const char *b) { return strcasecmp(strip_domain(a), strip_domain(b)) == 0; }
+
+}  // namespace doca::emu
+
+const char *doca_get_error_string(doca_error_t error) {
+    switch (error) {
+        case DOCA_SUCCESS:
+            return "Success";
+        case DOCA_ERROR_UNKNOWN:
+            return "Unknown error";
+        case DOCA_ERROR_NOT_PERMITTED:
+            return "Operation not permitted";
+        case DOCA_ERROR_IN_USE:
+            return "Resource already in use";
+        case DOCA_ERROR_NOT_SUPPORTED:
+            return "Operation not supported";
+        case DOCA_ERROR_AGAIN:
+            return "Resource temporarily unavailable, try again";
+        case DOCA_ERROR_INVALID_VALUE:
+            return "Invalid input";
+        case DOCA_ERROR_NO_MEMORY:
+            return "Memory allocation failure";
+        case DOCA_ERROR_INITIALIZATION:
+            return "Resource initialization failure";
+        case DOCA_ERROR_TIME_OUT:
+            return "Timer expired waiting for resource";
+        case DOCA_ERROR_SHUTDOWN:
+            return "Shut down in process or completed";
+        case DOCA_ERROR_CONNECTION_RESET:
+            return "Connection reset by peer";
+        case DOCA_ERROR_CONNECTION_ABORTED:
+            return "Connection aborted";
+        case DOCA_ERROR_CONNECTION_INPROGRESS:
+            return "Connection in progress";
+        case DOCA_ERROR_NOT_CONNECTED:
+            return "Not connected";
+        case DOCA_ERROR_NO_LOCK:
+            return "Unable to acquire required lock";
+        case DOCA_ERROR_NOT_FOUND:
+            return "Resource not found";
+        case DOCA_ERROR_IO_FAILED:
+            return "Input/Output operation failed";
+        case DOCA_ERROR_BAD_STATE:
+            return "Bad state";
+        case DOCA_ERROR_UNSUPPORTED_VERSION:
+            return "Unsupported version";
+        case DOCA_ERROR_OPERATING_SYSTEM:
+            return "Operating system call failure";
+        case DOCA_ERROR_DRIVER:
+            return "DOCA driver call failure";
+        case DOCA_ERROR_UNEXPECTED:
+            return "Unexpected error";
+    }
+    return "Unrecognized error code";
+}
+
+const char *doca_get_error_name(doca_error_t error) {
+    switch (error) {
+        case DOCA_SUCCESS:
+            return "DOCA_SUCCESS";
+        case DOCA_ERROR_UNKNOWN:
+            return "DOCA_ERROR_UNKNOWN";
+        case DOCA_ERROR_NOT_PERMITTED:
+            return "DOCA_ERROR_NOT_PERMITTED";
+        case DOCA_ERROR_IN_USE:
+            return "DOCA_ERROR_IN_USE";
+        case DOCA_ERROR_NOT_SUPPORTED:
+            return "DOCA_ERROR_NOT_SUPPORTED";
+        case DOCA_ERROR_AGAIN:
+            return "DOCA_ERROR_AGAIN";
+        case DOCA_ERROR_INVALID_VALUE:
+            return "DOCA_ERROR_INVALID_VALUE";
+        case DOCA_ERROR_NO_MEMORY:
+            return "DOCA_ERROR_NO_MEMORY";
+        case DOCA_ERROR_INITIALIZATION:
+            return "DOCA_ERROR_INITIALIZATION";
+        case DOCA_ERROR_TIME_OUT:
+            return "DOCA_ERROR_TIME_OUT";
+        case DOCA_ERROR_SHUTDOWN:
+            return "DOCA_ERROR_SHUTDOWN";
+        case DOCA_ERROR_CONNECTION_RESET:
+            return "DOCA_ERROR_CONNECTION_RESET";
+        case DOCA_ERROR_CONNECTION_ABORTED:
+            return "DOCA_ERROR_CONNECTION_ABORTED";
+        case DOCA_ERROR_CONNECTION_INPROGRESS:
+            return "DOCA_ERROR_CONNECTION_INPROGRESS";
+        case DOCA_ERROR_NOT_CONNECTED:
+            return "DOCA_ERROR_NOT_CONNECTED";
+        case DOCA_ERROR_NO_LOCK:
+            return "DOCA_ERROR_NO_LOCK";
+        case DOCA_ERROR_NOT_FOUND:
+            return "DOCA_ERROR_NOT_FOUND";
+        case DOCA_ERROR_IO_FAILED:
+            return "DOCA_ERROR_IO_FAILED";
+        case DOCA_ERROR_BAD_STATE:
+            return "DOCA_ERROR_BAD_STATE";
+        case DOCA_ERROR_UNSUPPORTED_VERSION:
+            return "DOCA_ERROR_UNSUPPORTED_VERSION";
+        case DOCA_ERROR_OPERATING_SYSTEM:
+            return "DOCA_ERROR_OPERATING_SYSTEM";
+        case DOCA_ERROR_DRIVER:
+            return "DOCA_ERROR_DRIVER";
+        case DOCA_ERROR_UNEXPECTED:
+            return "DOCA_ERROR_UNEXPECTED";
+    }
+    return "DOCA_ERROR_UNRECOGNIZED";
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+ * Software emulation of the DOCA objects doca-harness uses, for runs on
+ * machines without a BlueField. Host and DPU are two local processes: comm
+ * channel endpoints meet in POSIX shared memory and DMA jobs are copies done
+ * by worker threads, with process_vm_readv/writev across the process
+ * boundary. Behaviour is tuned through DOCA_EMU_* environment variables.
+ */
+
+#include <doca_buf.h>
+#include <doca_buf_inventory.h>
+#include <doca_comm_channel.h>
+#include <doca_ctx.h>
+#include <doca_dev.h>
+#include <doca_dma.h>
+#include <doca_mmap.h>
+#include <sched.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define EMU_DEFAULT_PCI "0000:03:00.0"     /* Emulated device, DOCA_EMU_PCI */
+#define EMU_DEFAULT_REP_PCI "0000:3b:00.0" /* Emulated representor, DOCA_EMU_REP_PCI */
+#define EMU_MAX_DEVS 8
+#define EMU_CC_MAX_MSG_SIZE 4080      /* Device comm channel limit, DOCA_EMU_CC_MAX_MSG_SIZE */
+#define EMU_CC_MAX_QUEUE_SIZE 1024    /* Device comm channel queue limit, DOCA_EMU_CC_MAX_QUEUE_SIZE */
+#define EMU_CC_MAX_CONNS 16           /* Clients a listening endpoint accepts */
+#define EMU_DMA_MAX_BUF_SIZE (1UL << 30) /* Device DMA job limit, DOCA_EMU_DMA_MAX_BUF_SIZE */
+#define EMU_DMA_THREADS 2             /* Copy engine workers, DOCA_EMU_DMA_THREADS */
+
+namespace doca::emu {
+
+/* CLOCK_MONOTONIC in nanoseconds, comparable between processes */
+uint64_t NowNs();
+/* Numeric environment setting, def if unset or malformed */
+uint64_t EnvU64(const char *name, uint64_t def);
+const char *EnvStr(const char *name, const char *def);
+/*
+ * Called when a poll finds nothing to do. Hardware progresses on its own,
+ * emulated progress needs the peer process or copy threads to get CPU time.
+ */
+inline void PollMiss() { sched_yield(); }
+/* PCI address comparison that tolerates a missing domain ("03:00.0" == "0000:03:00.0") */
+bool PciAddrEqual(const char *a, const char *b);
+
+}  // namespace doca::emu
+
+struct doca_devinfo {
+    char pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];
+    char ibdev_name[DOCA_DEVINFO_IBDEV_NAME_SIZE];
+    /* DMA link model, shared by every context on the device */
+    std::mutex link_lock;
+    uint64_t link_free_ns = 0;
+};
+
+struct doca_devinfo_rep {
+    char pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE];
+};
+
+struct doca_dev {
+    struct doca_devinfo *info;
+};
+
+struct doca_dev_rep {
+    struct doca_devinfo_rep *info;
+};
+
+struct doca_mmap {
+    char *addr = nullptr;
+    size_t len = 0;
+    uint32_t access = DOCA_ACCESS_LOCAL_READ_WRITE;
+    bool started = false;
+    pid_t pid = 0; /* Owner of the memory range, another process for an imported mmap */
+    std::string desc;
+    std::vector<struct doca_dev *> devs;
+};
+
+struct doca_buf {
+    struct doca_mmap *mmap;
+    struct doca_buf_inventory *inv;
+    char *head;
+    size_t len;
+    char *data;
+    size_t data_len;
+    uint16_t refcount;
+};
+
+struct doca_buf_inventory {
+    std::vector<doca_buf> bufs;
+    std::vector<doca_buf *> free_bufs;
+    bool started = false;
+};
+
+enum emu_ctx_type { EMU_CTX_DMA };
+
+struct doca_ctx {
+    emu_ctx_type type;
+    struct doca_dev *dev = nullptr;
+    bool started = false;
+    std::vector<struct doca_workq *> workqs;
+};
+
+struct doca_dma {
+    struct doca_ctx ctx;
+};
+
+/* A finished job, visible to progress_retrieve once done_ns has passed */
+struct emu_completion {
+    struct doca_event event;
+    doca_error_t result;
+    uint64_t done_ns;
+};
+
+struct doca_workq {
+    uint32_t depth;
+    struct doca_ctx *ctx = nullptr;
+    std::mutex lock;
+    std::deque<emu_completion> done;
+    uint32_t inflight = 0; /* Submitted and not retrieved, under lock */
+    std::atomic<uint32_t> running{0}; /* Jobs still owned by the copy engine */
+};
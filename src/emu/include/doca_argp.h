@@ -0,0 +1,40 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum doca_argp_type {
+    DOCA_ARGP_TYPE_UNKNOWN = 0,
+    DOCA_ARGP_TYPE_STRING,
+    DOCA_ARGP_TYPE_INT,
+    DOCA_ARGP_TYPE_BOOLEAN,
+    DOCA_ARGP_TYPE_JSON_OBJ,
+};
+
+struct doca_argp_param;
+
+typedef doca_error_t (*callback_func)(void *, void *);
+typedef doca_error_t (*validation_callback)(void *);
+
+doca_error_t doca_argp_init(const char *program_name, void *program_config);
+doca_error_t doca_argp_param_create(struct doca_argp_param **param);
+void doca_argp_param_set_short_name(struct doca_argp_param *param, const char *name);
+void doca_argp_param_set_long_name(struct doca_argp_param *param, const char *name);
+void doca_argp_param_set_arguments(struct doca_argp_param *param, const char *arguments);
+void doca_argp_param_set_description(struct doca_argp_param *param, const char *description);
+void doca_argp_param_set_callback(struct doca_argp_param *param, callback_func callback);
+void doca_argp_param_set_type(struct doca_argp_param *param, enum doca_argp_type type);
+void doca_argp_param_set_mandatory(struct doca_argp_param *param);
+void doca_argp_param_set_multiplicity(struct doca_argp_param *param);
+doca_error_t doca_argp_register_param(struct doca_argp_param *input_param);
+doca_error_t doca_argp_register_validation_callback(validation_callback callback);
+doca_error_t doca_argp_start(int argc, char **argv);
+doca_error_t doca_argp_destroy(void);
+
+#ifdef __cplusplus
+}
+#endif
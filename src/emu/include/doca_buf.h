@@ -0,0 +1,25 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_error.h"
+#include "doca_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct doca_buf;
+
+doca_error_t doca_buf_refcount_add(struct doca_buf *buf, uint16_t *refcount);
+doca_error_t doca_buf_refcount_rm(struct doca_buf *buf, uint16_t *refcount);
+doca_error_t doca_buf_get_refcount(struct doca_buf *buf, uint16_t *refcount);
+doca_error_t doca_buf_get_len(struct doca_buf *buf, size_t *len);
+doca_error_t doca_buf_get_head(struct doca_buf *buf, void **head);
+doca_error_t doca_buf_get_data_len(struct doca_buf *buf, size_t *data_len);
+doca_error_t doca_buf_get_data(struct doca_buf *buf, void **data);
+doca_error_t doca_buf_set_data(struct doca_buf *buf, void *data, size_t data_len);
+doca_error_t doca_buf_reset_data_len(struct doca_buf *buf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,30 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_buf.h"
+#include "doca_mmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct doca_buf_inventory;
+
+enum doca_buf_extension {
+    DOCA_BUF_EXTENSION_NONE = 0,
+    DOCA_BUF_EXTENSION_LINKED_LIST = 1 << 0,
+};
+
+doca_error_t doca_buf_inventory_create(const union doca_data *user_data, size_t num_elements, uint32_t extensions,
+                                       struct doca_buf_inventory **buf_inventory);
+doca_error_t doca_buf_inventory_destroy(struct doca_buf_inventory *inventory);
+doca_error_t doca_buf_inventory_start(struct doca_buf_inventory *inventory);
+doca_error_t doca_buf_inventory_stop(struct doca_buf_inventory *inventory);
+doca_error_t doca_buf_inventory_get_num_free_elements(const struct doca_buf_inventory *inventory,
+                                                      uint32_t *num_of_free_elements);
+doca_error_t doca_buf_inventory_buf_by_addr(struct doca_buf_inventory *inventory, struct doca_mmap *mmap, void *addr,
+                                            size_t len, struct doca_buf **buf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct doca_comm_channel_ep_t;
+struct doca_comm_channel_addr_t;
+
+enum doca_comm_channel_msg_flags {
+    DOCA_CC_MSG_FLAG_NONE = 0,
+};
+
+doca_error_t doca_comm_channel_ep_create(struct doca_comm_channel_ep_t **ep);
+doca_error_t doca_comm_channel_ep_destroy(struct doca_comm_channel_ep_t *ep);
+doca_error_t doca_comm_channel_ep_set_device(struct doca_comm_channel_ep_t *ep, struct doca_dev *device);
+doca_error_t doca_comm_channel_ep_set_max_msg_size(struct doca_comm_channel_ep_t *ep, uint16_t max_msg_size);
+doca_error_t doca_comm_channel_ep_set_send_queue_size(struct doca_comm_channel_ep_t *ep, uint16_t send_queue_size);
+doca_error_t doca_comm_channel_ep_set_recv_queue_size(struct doca_comm_channel_ep_t *ep, uint16_t recv_queue_size);
+doca_error_t doca_comm_channel_ep_set_device_rep(struct doca_comm_channel_ep_t *ep, struct doca_dev_rep *device_rep);
+doca_error_t doca_comm_channel_ep_listen(struct doca_comm_channel_ep_t *local_ep, const char *name);
+doca_error_t doca_comm_channel_ep_connect(struct doca_comm_channel_ep_t *local_ep, const char *name,
+                                          struct doca_comm_channel_addr_t **peer_addr);
+doca_error_t doca_comm_channel_ep_sendto(struct doca_comm_channel_ep_t *local_ep, const void *msg, size_t len,
+                                         int flags, struct doca_comm_channel_addr_t *peer_addr);
+doca_error_t doca_comm_channel_ep_recvfrom(struct doca_comm_channel_ep_t *local_ep, void *msg, size_t *len,
+                                           int flags, struct doca_comm_channel_addr_t **peer_addr);
+doca_error_t doca_comm_channel_ep_disconnect(struct doca_comm_channel_ep_t *local_ep,
+                                             struct doca_comm_channel_addr_t *peer_addr);
+doca_error_t doca_comm_channel_peer_addr_update_info(struct doca_comm_channel_addr_t *peer_addr);
+doca_error_t doca_comm_channel_get_max_message_size(struct doca_devinfo *devinfo, uint32_t *max_message_size);
+doca_error_t doca_comm_channel_get_max_send_queue_size(struct doca_devinfo *devinfo, uint32_t *max_send_queue_size);
+doca_error_t doca_comm_channel_get_max_recv_queue_size(struct doca_devinfo *devinfo, uint32_t *max_recv_queue_size);
+
+#ifdef __cplusplus
+}
+#endif
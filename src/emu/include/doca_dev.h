@@ -0,0 +1,49 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include <stdint.h>
+
+#include "doca_error.h"
+#include "doca_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DOCA_DEVINFO_PCI_ADDR_SIZE 13
+#define DOCA_DEVINFO_REP_PCI_ADDR_SIZE 13
+#define DOCA_DEVINFO_PCI_BDF_SIZE 8
+#define DOCA_DEVINFO_IBDEV_NAME_SIZE 64
+
+struct doca_devinfo;
+struct doca_devinfo_rep;
+struct doca_dev;
+struct doca_dev_rep;
+
+enum doca_dev_rep_filter {
+    DOCA_DEV_REP_FILTER_ALL = 0,
+    DOCA_DEV_REP_FILTER_NET = 1 << 1,
+    DOCA_DEV_REP_FILTER_EMULATED = 1 << 2,
+};
+
+doca_error_t doca_devinfo_list_create(struct doca_devinfo ***dev_list, uint32_t *nb_devs);
+doca_error_t doca_devinfo_list_destroy(struct doca_devinfo **dev_list);
+doca_error_t doca_devinfo_rep_list_create(struct doca_dev *dev, int filter, struct doca_devinfo_rep ***dev_list_rep,
+                                          uint32_t *nb_devs_rep);
+doca_error_t doca_devinfo_rep_list_destroy(struct doca_devinfo_rep **dev_list_rep);
+doca_error_t doca_devinfo_get_pci_addr_str(const struct doca_devinfo *devinfo, char *pci_addr_str);
+doca_error_t doca_devinfo_get_is_pci_addr_equal(const struct doca_devinfo *devinfo, const char *pci_addr_str,
+                                                uint8_t *is_equal);
+doca_error_t doca_devinfo_get_ibdev_name(const struct doca_devinfo *devinfo, char *ibdev_name, uint32_t size);
+doca_error_t doca_devinfo_rep_get_pci_addr_str(const struct doca_devinfo_rep *devinfo_rep, char *pci_addr_str);
+doca_error_t doca_devinfo_rep_get_is_pci_addr_equal(const struct doca_devinfo_rep *devinfo_rep,
+                                                    const char *pci_addr_str, uint8_t *is_equal);
+doca_error_t doca_dev_open(struct doca_devinfo *devinfo, struct doca_dev **dev);
+doca_error_t doca_dev_close(struct doca_dev *dev);
+struct doca_devinfo *doca_dev_as_devinfo(const struct doca_dev *dev);
+doca_error_t doca_dev_rep_open(struct doca_devinfo_rep *devinfo, struct doca_dev_rep **dev_rep);
+doca_error_t doca_dev_rep_close(struct doca_dev_rep *dev);
+
+#ifdef __cplusplus
+}
+#endif
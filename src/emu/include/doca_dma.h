@@ -0,0 +1,35 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_buf.h"
+#include "doca_ctx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct doca_dma;
+
+enum doca_dma_job_types {
+    DOCA_DMA_JOB_MEMCPY = 1,
+};
+
+struct doca_dma_job_memcpy {
+    struct doca_job base;
+    struct doca_buf *dst_buff;
+    struct doca_buf *src_buff;
+};
+
+struct doca_dma_memcpy_result {
+    doca_error_t result;
+};
+
+doca_error_t doca_dma_create(struct doca_dma **dma);
+doca_error_t doca_dma_destroy(struct doca_dma *dma);
+struct doca_ctx *doca_dma_as_ctx(struct doca_dma *dma);
+doca_error_t doca_dma_get_max_buf_size(const struct doca_devinfo *devinfo, uint64_t *buf_size);
+doca_error_t doca_dma_job_get_supported(struct doca_devinfo *devinfo, enum doca_dma_job_types job_type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Emulated DOCA SDK header, used when doca-harness is built without
+ * /opt/mellanox/doca (DOCA_HARNESS_EMU). Only the subset of the DOCA 2.0 API
+ * the harness calls is declared, with the same names and signatures.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum doca_error {
+    DOCA_SUCCESS = 0,
+    DOCA_ERROR_UNKNOWN,
+    DOCA_ERROR_NOT_PERMITTED,
+    DOCA_ERROR_IN_USE,
+    DOCA_ERROR_NOT_SUPPORTED,
+    DOCA_ERROR_AGAIN,
+    DOCA_ERROR_INVALID_VALUE,
+    DOCA_ERROR_NO_MEMORY,
+    DOCA_ERROR_INITIALIZATION,
+    DOCA_ERROR_TIME_OUT,
+    DOCA_ERROR_SHUTDOWN,
+    DOCA_ERROR_CONNECTION_RESET,
+    DOCA_ERROR_CONNECTION_ABORTED,
+    DOCA_ERROR_CONNECTION_INPROGRESS,
+    DOCA_ERROR_NOT_CONNECTED,
+    DOCA_ERROR_NO_LOCK,
+    DOCA_ERROR_NOT_FOUND,
+    DOCA_ERROR_IO_FAILED,
+    DOCA_ERROR_BAD_STATE,
+    DOCA_ERROR_UNSUPPORTED_VERSION,
+    DOCA_ERROR_OPERATING_SYSTEM,
+    DOCA_ERROR_DRIVER,
+    DOCA_ERROR_UNEXPECTED,
+} doca_error_t;
+
+const char *doca_get_error_string(doca_error_t error);
+const char *doca_get_error_name(doca_error_t error);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include <stdio.h>
+
+#include "doca_error.h"
+#include "doca_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum doca_log_level {
+    DOCA_LOG_LEVEL_CRIT = 20,
+    DOCA_LOG_LEVEL_ERROR = 30,
+    DOCA_LOG_LEVEL_WARNING = 40,
+    DOCA_LOG_LEVEL_INFO = 50,
+    DOCA_LOG_LEVEL_DEBUG = 60,
+};
+
+doca_error_t doca_log_create_standard_backend(void);
+void doca_log_global_level_set(int level);
+int doca_log_source_register(const char *source_name);
+void priv_doca_log_developer(int level, int source, const char *file, int line, const char *func, const char *fmt, ...)
+    __attribute__((format(printf, 6, 7)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#define DOCA_LOG_REGISTER(SOURCE) \
+    static int log_source __attribute__((unused)) = doca_log_source_register(#SOURCE)
+
+#define DOCA_LOG(level, format, ...) \
+    priv_doca_log_developer(DOCA_LOG_LEVEL_##level, log_source, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+
+#define DOCA_LOG_CRIT(format, ...) DOCA_LOG(CRIT, format, ##__VA_ARGS__)
+#define DOCA_LOG_ERR(format, ...) DOCA_LOG(ERROR, format, ##__VA_ARGS__)
+#define DOCA_LOG_WARN(format, ...) DOCA_LOG(WARNING, format, ##__VA_ARGS__)
+#define DOCA_LOG_INFO(format, ...) DOCA_LOG(INFO, format, ##__VA_ARGS__)
+#define DOCA_LOG_DBG(format, ...) DOCA_LOG(DEBUG, format, ##__VA_ARGS__)
@@ -0,0 +1,27 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include "doca_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct doca_mmap;
+
+doca_error_t doca_mmap_create(const union doca_data *user_data, struct doca_mmap **mmap);
+doca_error_t doca_mmap_destroy(struct doca_mmap *mmap);
+doca_error_t doca_mmap_start(struct doca_mmap *mmap);
+doca_error_t doca_mmap_stop(struct doca_mmap *mmap);
+doca_error_t doca_mmap_dev_add(struct doca_mmap *mmap, struct doca_dev *dev);
+doca_error_t doca_mmap_dev_rm(struct doca_mmap *mmap, struct doca_dev *dev);
+doca_error_t doca_mmap_set_memrange(struct doca_mmap *mmap, void *addr, size_t len);
+doca_error_t doca_mmap_set_permissions(struct doca_mmap *mmap, uint32_t access_mask);
+doca_error_t doca_mmap_export_dpu(struct doca_mmap *mmap, const struct doca_dev *dev, const void **export_desc,
+                                  size_t *export_desc_len);
+doca_error_t doca_mmap_create_from_export(const union doca_data *user_data, const void *export_desc,
+                                          size_t export_desc_len, struct doca_dev *dev, struct doca_mmap **mmap);
+
+#ifdef __cplusplus
+}
+#endif
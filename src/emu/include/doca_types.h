@@ -0,0 +1,22 @@
+/* Emulated DOCA SDK header, see doca_error.h */
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+union doca_data {
+    void *ptr;
+    uint64_t u64;
+};
+
+enum doca_access_flags {
+    DOCA_ACCESS_LOCAL_READ_ONLY = 0,
+    DOCA_ACCESS_LOCAL_READ_WRITE = 1 << 0,
+    DOCA_ACCESS_RDMA_READ = 1 << 1,
+    DOCA_ACCESS_RDMA_WRITE = 1 << 2,
+    DOCA_ACCESS_RDMA_ATOMIC = 1 << 3,
+    DOCA_ACCESS_DPU_READ_ONLY = 1 << 4,
+    DOCA_ACCESS_DPU_READ_WRITE = 1 << 5,
+};
@@ -0,0 +1,83 @@
+#include <doca_log.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <string>
+#include <deque>
+
+#include "emu.h"
+
+static int global_level = -1;
+
+/* Sources register from static initializers of other translation units, so construct on first use */
+static std::mutex &source_lock() {
+    static std::mutex lock;
+    return lock;
+}
+
+static std::deque<std::string> &sources() {
+    static std::deque<std::string> names; /* Stable addresses, sources are never removed */
+    return names;
+}
+
+static int log_level() {
+    if (global_level < 0) global_level = (int)doca::emu::EnvU64("DOCA_EMU_LOG_LEVEL", DOCA_LOG_LEVEL_INFO);
+    return global_level;
+}
+
+static const char *level_name(int level) {
+    if (level <= DOCA_LOG_LEVEL_CRIT) return "CRIT";
+    if (level <= DOCA_LOG_LEVEL_ERROR) return "ERR";
+    if (level <= DOCA_LOG_LEVEL_WARNING) return "WARN";
+    if (level <= DOCA_LOG_LEVEL_INFO) return "INFO";
+    return "DBG";
+}
+
+doca_error_t doca_log_create_standard_backend(void) { return DOCA_SUCCESS; }
+
+void doca_log_global_level_set(int level) { global_level = level; }
+
+int doca_log_source_register(const char *source_name) {
+    std::lock_guard<std::mutex> guard(source_lock());
+
+    sources().emplace_back(source_name);
+    return (int)sources().size() - 1;
+}
+
+void priv_doca_log_developer(int level, int source, const char *file, int line, const char *func, const char *fmt,
+                             ...) {
+    char msg[1024];
+    struct timeval tv;
+    struct tm tm;
+    const char *base;
+    const char *source_name;
+    va_list args;
+    int n;
+
+    if (level > log_level()) return;
+
+    gettimeofday(&tv, NULL);
+    localtime_r(&tv.tv_sec, &tm);
+    base = strrchr(file, '/');
+    base = base ? base + 1 : file;
+    {
+        std::lock_guard<std::mutex> guard(source_lock());
+        source_name = (source >= 0 && source < (int)sources().size()) ? sources()[source].c_str() : "UNKNOWN";
+    }
+
+    /* Format the whole line first so lines from concurrent threads do not interleave */
+    n = snprintf(msg, sizeof(msg), "[%02d:%02d:%02d:%06ld][%d][DOCA][%s][%s][%s:%d][%s] ", tm.tm_hour, tm.tm_min,
+                 tm.tm_sec, (long)tv.tv_usec, getpid(), level_name(level), source_name, base, line, func);
+    va_start(args, fmt);
+    if (n < (int)sizeof(msg)) n += vsnprintf(msg + n, sizeof(msg) - n, fmt, args);
+    va_end(args);
+    if (n > (int)sizeof(msg) - 2) n = sizeof(msg) - 2;
+    msg[n++] = '\n';
+    fwrite(msg, 1, n, stdout);
+    fflush(stdout);
+}
@@ -0,0 +1,231 @@
+#include <doca_buf.h>
+#include <doca_buf_inventory.h>
+#include <doca_mmap.h>
+#include <stdio.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "emu.h"
+
+/*
+ * An exported mmap is described by the exporter's pid and address range in
+ * printable text; the importer reaches the memory with process_vm_readv/writev.
+ */
+#define EMU_DESC_FMT "doca-emu:pid=%d,addr=%p,len=%zu"
+
+doca_error_t doca_mmap_create(const union doca_data *user_data, struct doca_mmap **mmap) {
+    (void)user_data;
+    if (mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *mmap = new doca_mmap();
+    (*mmap)->pid = getpid();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_destroy(struct doca_mmap *mmap) {
+    if (mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    delete mmap;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_start(struct doca_mmap *mmap) {
+    if (mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (mmap->addr == NULL) return DOCA_ERROR_BAD_STATE;
+    mmap->started = true;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_stop(struct doca_mmap *mmap) {
+    if (mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    mmap->started = false;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_dev_add(struct doca_mmap *mmap, struct doca_dev *dev) {
+    if (mmap == NULL || dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (std::find(mmap->devs.begin(), mmap->devs.end(), dev) != mmap->devs.end()) return DOCA_ERROR_IN_USE;
+    mmap->devs.push_back(dev);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_dev_rm(struct doca_mmap *mmap, struct doca_dev *dev) {
+    if (mmap == NULL || dev == NULL) return DOCA_ERROR_INVALID_VALUE;
+    auto it = std::find(mmap->devs.begin(), mmap->devs.end(), dev);
+    if (it == mmap->devs.end()) return DOCA_ERROR_NOT_FOUND;
+    mmap->devs.erase(it);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_set_memrange(struct doca_mmap *mmap, void *addr, size_t len) {
+    if (mmap == NULL || addr == NULL || len == 0) return DOCA_ERROR_INVALID_VALUE;
+    if (mmap->started) return DOCA_ERROR_BAD_STATE;
+    mmap->addr = (char *)addr;
+    mmap->len = len;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_set_permissions(struct doca_mmap *mmap, uint32_t access_mask) {
+    if (mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (mmap->started) return DOCA_ERROR_BAD_STATE;
+    mmap->access = access_mask;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_export_dpu(struct doca_mmap *mmap, const struct doca_dev *dev, const void **export_desc,
+                                  size_t *export_desc_len) {
+    char desc[128];
+
+    if (mmap == NULL || dev == NULL || export_desc == NULL || export_desc_len == NULL)
+        return DOCA_ERROR_INVALID_VALUE;
+    if (!mmap->started) return DOCA_ERROR_BAD_STATE;
+    if (!(mmap->access & DOCA_ACCESS_DPU_READ_WRITE) && !(mmap->access & DOCA_ACCESS_DPU_READ_ONLY))
+        return DOCA_ERROR_NOT_PERMITTED;
+
+    /* Let the importing process attach with process_vm_readv/writev under Yama ptrace_scope 1 */
+    prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+
+    snprintf(desc, sizeof(desc), EMU_DESC_FMT, mmap->pid, (void *)mmap->addr, mmap->len);
+    mmap->desc = desc;
+    *export_desc = mmap->desc.c_str();
+    *export_desc_len = mmap->desc.size();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_mmap_create_from_export(const union doca_data *user_data, const void *export_desc,
+                                          size_t export_desc_len, struct doca_dev *dev, struct doca_mmap **mmap) {
+    std::string desc((const char *)export_desc, export_desc_len);
+    void *addr;
+    size_t len;
+    int pid;
+
+    (void)user_data;
+    if (export_desc == NULL || dev == NULL || mmap == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (sscanf(desc.c_str(), EMU_DESC_FMT, &pid, &addr, &len) != 3) return DOCA_ERROR_INVALID_VALUE;
+
+    *mmap = new doca_mmap();
+    (*mmap)->pid = pid;
+    (*mmap)->addr = (char *)addr;
+    (*mmap)->len = len;
+    (*mmap)->access = DOCA_ACCESS_DPU_READ_WRITE;
+    (*mmap)->started = true;
+    (*mmap)->devs.push_back(dev);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_create(const union doca_data *user_data, size_t num_elements, uint32_t extensions,
+                                       struct doca_buf_inventory **buf_inventory) {
+    (void)user_data;
+    (void)extensions;
+    if (num_elements == 0 || buf_inventory == NULL) return DOCA_ERROR_INVALID_VALUE;
+
+    *buf_inventory = new doca_buf_inventory();
+    (*buf_inventory)->bufs.resize(num_elements);
+    for (size_t i = num_elements; i > 0; i--) (*buf_inventory)->free_bufs.push_back(&(*buf_inventory)->bufs[i - 1]);
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_destroy(struct doca_buf_inventory *inventory) {
+    if (inventory == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (inventory->free_bufs.size() != inventory->bufs.size()) return DOCA_ERROR_IN_USE;
+    delete inventory;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_start(struct doca_buf_inventory *inventory) {
+    if (inventory == NULL) return DOCA_ERROR_INVALID_VALUE;
+    inventory->started = true;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_stop(struct doca_buf_inventory *inventory) {
+    if (inventory == NULL) return DOCA_ERROR_INVALID_VALUE;
+    inventory->started = false;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_get_num_free_elements(const struct doca_buf_inventory *inventory,
+                                                      uint32_t *num_of_free_elements) {
+    if (inventory == NULL || num_of_free_elements == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *num_of_free_elements = (uint32_t)inventory->free_bufs.size();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_inventory_buf_by_addr(struct doca_buf_inventory *inventory, struct doca_mmap *mmap, void *addr,
+                                            size_t len, struct doca_buf **buf) {
+    char *start = (char *)addr;
+    doca_buf *b;
+
+    if (inventory == NULL || mmap == NULL || buf == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (!inventory->started || !mmap->started) return DOCA_ERROR_BAD_STATE;
+    if (start < mmap->addr || len > mmap->len || start - mmap->addr > (ptrdiff_t)(mmap->len - len))
+        return DOCA_ERROR_INVALID_VALUE;
+    if (inventory->free_bufs.empty()) return DOCA_ERROR_NO_MEMORY;
+
+    b = inventory->free_bufs.back();
+    inventory->free_bufs.pop_back();
+    *b = {mmap, inventory, start, len, start, len, 1};
+    *buf = b;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_refcount_add(struct doca_buf *buf, uint16_t *refcount) {
+    if (buf == NULL || buf->refcount == 0) return DOCA_ERROR_INVALID_VALUE;
+    buf->refcount++;
+    if (refcount) *refcount = buf->refcount;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_refcount_rm(struct doca_buf *buf, uint16_t *refcount) {
+    if (buf == NULL || buf->refcount == 0) return DOCA_ERROR_INVALID_VALUE;
+    if (--buf->refcount == 0) buf->inv->free_bufs.push_back(buf);
+    if (refcount) *refcount = buf->refcount;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_get_refcount(struct doca_buf *buf, uint16_t *refcount) {
+    if (buf == NULL || refcount == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *refcount = buf->refcount;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_get_len(struct doca_buf *buf, size_t *len) {
+    if (buf == NULL || len == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *len = buf->len;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_get_head(struct doca_buf *buf, void **head) {
+    if (buf == NULL || head == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *head = buf->head;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_get_data_len(struct doca_buf *buf, size_t *data_len) {
+    if (buf == NULL || data_len == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *data_len = buf->data_len;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_get_data(struct doca_buf *buf, void **data) {
+    if (buf == NULL || data == NULL) return DOCA_ERROR_INVALID_VALUE;
+    *data = buf->data;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_set_data(struct doca_buf *buf, void *data, size_t data_len) {
+    char *start = (char *)data;
+
+    if (buf == NULL) return DOCA_ERROR_INVALID_VALUE;
+    if (start < buf->head || data_len > buf->len || start - buf->head > (ptrdiff_t)(buf->len - data_len))
+        return DOCA_ERROR_INVALID_VALUE;
+    buf->data = start;
+    buf->data_len = data_len;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t doca_buf_reset_data_len(struct doca_buf *buf) {
+    if (buf == NULL) return DOCA_ERROR_INVALID_VALUE;
+    buf->data_len = 0;
+    return DOCA_SUCCESS;
+}
@@ -21,12 +21,14 @@ MemMap::MemMap() : mode(MMAP_MODE_LOCAL) {
     }
 }
 
-MemMap::MemMap(DOCADma& dma, CommChannel& ch) : mode(MMAP_MODE_REMOTE) {
+MemMap::MemMap(DOCADma<Dpu>& dma, CommChannel<Dpu>& ch) : mode(MMAP_MODE_REMOTE) {
     doca_error_t result;
-    result = RecvDesc(ch);
+    ExportDesc desc;
+
+    result = RecvDesc(ch, &desc);
     if (result != DOCA_SUCCESS) throw std::runtime_error("Failed to receive descriptor");
     /* Create a local DOCA mmap from export descriptor */
-    result = doca_mmap_create_from_export(NULL, (const void *)export_desc.remote_desc, export_desc.len, dma.dev->dev, &mmap);
+    result = doca_mmap_create_from_export(NULL, (const void *)desc.remote_desc, desc.len, dma.dev->dev, &mmap);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to create memory map from export descriptor");
         throw std::runtime_error("Failed to create memory map from export descriptor");
@@ -41,30 +43,41 @@ MemMap::~MemMap() {
         mmap = NULL;
     }
 
-    if (buffer && mode == MMAP_MODE_LOCAL) delete buffer;
+    if (owns_buffer) delete[] buffer;
 }
 
 doca_error_t MemMap::AllocAndPopulate(uint32_t access_flags, size_t buffer_len) {
     doca_error_t result;
+    char *data;
 
-    result = doca_mmap_set_permissions(mmap, access_flags);
+    data = new char[buffer_len];
+    if (!data) {
+        DOCA_LOG_ERR("Failed to allocate memory for source buffer");
+        return DOCA_ERROR_NO_MEMORY;
+    }
+
+    result = Populate(access_flags, data, buffer_len);
     if (result != DOCA_SUCCESS) {
-        DOCA_LOG_ERR("Unable to set access permissions of memory map: %s", doca_get_error_string(result));
+        delete[] data;
         return result;
     }
+    owns_buffer = true;
 
-    buffer = new char[buffer_len];
-    len = buffer_len;
-    if (!buffer) {
-        DOCA_LOG_ERR("Failed to allocate memory for source buffer");
-        return DOCA_ERROR_NO_MEMORY;
+    return result;
+}
+
+doca_error_t MemMap::Populate(uint32_t access_flags, char *data, size_t data_len) {
+    doca_error_t result;
+
+    result = doca_mmap_set_permissions(mmap, access_flags);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Unable to set access permissions of memory map: %s", doca_get_error_string(result));
+        return result;
     }
 
-    result = doca_mmap_set_memrange(mmap, buffer, buffer_len);
+    result = doca_mmap_set_memrange(mmap, data, data_len);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Unable to set memrange of memory map: %s", doca_get_error_string(result));
-        delete buffer;
-        len = 0;
         return result;
     }
 
@@ -72,10 +85,11 @@ doca_error_t MemMap::AllocAndPopulate(uint32_t access_flags, size_t buffer_len)
     result = doca_mmap_start(mmap);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Unable to populate memory map: %s", doca_get_error_string(result));
-        len = 0;
-        delete buffer;
+        return result;
     }
 
+    buffer = data;
+    len = data_len;
     return result;
 }
 
@@ -83,18 +97,19 @@ doca_error_t MemMap::ExportDPU(DOCADevice& dev) {
     doca_error_t result;
 
     /* Export memory map to allow access to this memory region from DPU */
-    result = doca_mmap_export_dpu(mmap, dev.dev, &export_desc.desc, &export_desc.len);
+    result = doca_mmap_export_dpu(mmap, dev.dev, &export_desc, &export_desc_len);
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to export DOCA mmap: %s", doca_get_error_string(result));
+        return result;
     }
-    std::string desc_str((char *)export_desc.desc, export_desc.len);
-    DOCA_LOG_INFO("%ld %s", export_desc.len, desc_str.c_str());
+    std::string desc_str((char *)export_desc, export_desc_len);
+    DOCA_LOG_INFO("%ld %s", export_desc_len, desc_str.c_str());
     return result;
 }
 
-doca_error_t MemMap::SendDesc(CommChannel& ch) {
+doca_error_t MemMap::SendDesc(CommChannel<Host>& ch) {
     doca_error_t result;
-    result = ch.SendTo(export_desc.desc, export_desc.len);
+    result = ch.SendTo(export_desc, export_desc_len);
 
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to send config files to DPU: %s", doca_get_error_string(result));
@@ -108,12 +123,12 @@ doca_error_t MemMap::SendDesc(CommChannel& ch) {
     return DOCA_SUCCESS;
 }
 
-doca_error_t MemMap::RecvDesc(CommChannel& ch) {
+doca_error_t MemMap::RecvDesc(CommChannel<Dpu>& ch, ExportDesc *desc) {
     doca_error_t result;
     size_t msg_len;
 
     msg_len = CC_MAX_MSG_SIZE;
-    result = ch.RecvFrom(export_desc.remote_desc, &msg_len);
+    result = ch.RecvFrom(desc->remote_desc, &msg_len);
 
     if (result != DOCA_SUCCESS) {
         DOCA_LOG_ERR("Failed to receive export descriptor from Host: %s", doca_get_error_string(result));
@@ -121,13 +136,13 @@ doca_error_t MemMap::RecvDesc(CommChannel& ch) {
         return result;
     }
 
-    export_desc.len = msg_len;
+    desc->len = msg_len;
     ch.SendSuccessfulMsg();
 
     return result;
 }
 
-doca_error_t MemMap::SendAddrAndOffset(CommChannel& ch) {
+doca_error_t MemMap::SendAddrAndOffset(CommChannel<Host>& ch) {
     doca_error_t result;
 
     uint64_t addr_to_send = (uintptr_t)buffer;
@@ -156,7 +171,7 @@ doca_error_t MemMap::SendAddrAndOffset(CommChannel& ch) {
     return result;
 }
 
-doca_error_t MemMap::RecvAddrAndOffset(CommChannel& ch) {
+doca_error_t MemMap::RecvAddrAndOffset(CommChannel<Dpu>& ch) {
     doca_error_t result;
     uint64_t received_addr, received_addr_len;
     size_t msg_len;
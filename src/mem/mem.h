@@ -10,40 +10,60 @@
 
 namespace doca {
 
+template <typename Mode>
 class DOCADma;
 
+/* Export descriptor as received by the DPU */
 struct ExportDesc {
-    const void *desc;
     char remote_desc[CC_MAX_MSG_SIZE];
     size_t len;
 };
 
 enum mmap_mode { MMAP_MODE_LOCAL, MMAP_MODE_REMOTE };
 
+/*
+ * A registered memory range. Local mmaps are allocated and populated on
+ * either side; the host exports them, the DPU imports the descriptor into a
+ * remote mmap. Each exchange takes the endpoint of the side it runs on.
+ */
 class MemMap {
+    template <typename Mode>
     friend class DOCADma;
     friend class DOCADevice;
 
    public:
     MemMap();
-    MemMap(DOCADma &dma, CommChannel &ch);
+    /* Remote mmap over the host memory whose export descriptor arrives on ch */
+    MemMap(DOCADma<Dpu> &dma, CommChannel<Dpu> &ch);
     ~MemMap();
+    MemMap(const MemMap &) = delete;
+    MemMap &operator=(const MemMap &) = delete;
+
     doca_error_t AllocAndPopulate(uint32_t access_flags, size_t buffer_len);
+    /* Populate over memory the caller owns and keeps alive for the lifetime of the mmap */
+    doca_error_t Populate(uint32_t access_flags, char *data, size_t data_len);
     doca_error_t ExportDPU(DOCADevice &dev);
-    doca_error_t SendDesc(CommChannel &ch);
-    doca_error_t RecvDesc(CommChannel &ch);
+    doca_error_t SendDesc(CommChannel<Host> &ch);
+
+    doca_error_t SendAddrAndOffset(CommChannel<Host> &ch);
+    doca_error_t RecvAddrAndOffset(CommChannel<Dpu> &ch);
 
-    doca_error_t SendAddrAndOffset(CommChannel &ch);
-    doca_error_t RecvAddrAndOffset(CommChannel &ch);
+    /* Local buffer, or the peer's address for a remote mmap */
+    char *Data() const { return buffer; }
+    size_t Len() const { return len; }
 
    protected:
-    char *buffer;
-    size_t len;
-    struct doca_mmap *mmap;
-    struct doca_buf *doca_buf;
-    ExportDesc export_desc;
+    char *buffer = nullptr;
+    size_t len = 0;
+    bool owns_buffer = false; /* Allocated by AllocAndPopulate, freed with the mmap */
+    struct doca_mmap *mmap = nullptr;
+    struct doca_buf *doca_buf = nullptr;
+    const void *export_desc = nullptr; /* Host only, owned by the mmap */
+    size_t export_desc_len = 0;
 
     mmap_mode mode;
+
+    doca_error_t RecvDesc(CommChannel<Dpu> &ch, ExportDesc *desc);
 };
 
 }  // namespace doca
@@ -0,0 +1,540 @@
+#include "copy_offload.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <stdexcept>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(COPY_OFFLOAD);
+
+CopyOffload::CopyOffload(DOCADma<Host> &dma, CommChannel<Host> &ch) : dma(dma), ch(ch) {
+    msg.resize(ch.MaxPayload());
+    batch_capacity = (ch.MaxPayload() - sizeof(offload_msg_hdr)) / sizeof(offload_copy_desc);
+    fill_batch_capacity = (ch.MaxPayload() - sizeof(offload_msg_hdr)) / sizeof(offload_fill_desc);
+    if (batch_capacity == 0 || fill_batch_capacity == 0)
+        throw std::runtime_error("Comm Channel messages too small for copy descriptors");
+    batch.reserve(batch_capacity);
+    fill_batch.reserve(fill_batch_capacity);
+}
+
+doca_error_t CopyOffload::Register(MemMap &mmap, uint32_t *region) {
+    offload_msg_hdr hdr = {OFFLOAD_MSG_REGISTER, 0};
+    doca_error_t result;
+
+    result = WaitAll();
+    if (result != DOCA_SUCCESS) return result;
+
+    result = ch.SendTo(&hdr, sizeof(hdr));
+    if (result != DOCA_SUCCESS) return result;
+    result = dma.ExportDesc(mmap, ch);
+    if (result != DOCA_SUCCESS) return result;
+    result = mmap.SendAddrAndOffset(ch);
+    if (result != DOCA_SUCCESS) return result;
+
+    regions.push_back({mmap.Data(), mmap.Len()});
+    *region = regions.size() - 1;
+    return DOCA_SUCCESS;
+}
+
+bool CopyOffload::Resolve(const void *addr, size_t len, uint32_t *region, size_t *offset) const {
+    const char *p = (const char *)addr;
+
+    for (size_t i = 0; i < regions.size(); i++) {
+        const region_range &r = regions[i];
+        if (p < r.base || p >= r.base + r.len || len > (size_t)(r.base + r.len - p)) continue;
+        *region = i;
+        *offset = p - r.base;
+        return true;
+    }
+    return false;
+}
+
+doca_error_t CopyOffload::Post(uint32_t dst_region, size_t dst_offset, uint32_t src_region, size_t src_offset,
+                               size_t len, uint64_t *id) {
+    if (dst_region >= regions.size() || src_region >= regions.size() || dst_offset > regions[dst_region].len ||
+        len > regions[dst_region].len - dst_offset || src_offset > regions[src_region].len ||
+        len > regions[src_region].len - src_offset) {
+        DOCA_LOG_ERR("Copy of %zu bytes from region %u offset %zu to region %u offset %zu is out of range", len,
+                     src_region, src_offset, dst_region, dst_offset);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    *id = next_id++;
+    batch.push_back({*id, dst_region, src_region, dst_offset, src_offset, len});
+    outstanding++;
+    if (batch.size() == batch_capacity) return Flush();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CopyOffload::PostFill(uint32_t dst_region, size_t dst_offset, size_t len, uint64_t pattern,
+                                   uint64_t *id) {
+    if (dst_region >= regions.size() || dst_offset > regions[dst_region].len ||
+        len > regions[dst_region].len - dst_offset) {
+        DOCA_LOG_ERR("Fill of %zu bytes at region %u offset %zu is out of range", len, dst_region, dst_offset);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    *id = next_id++;
+    fill_batch.push_back({*id, dst_region, 0, dst_offset, len, pattern});
+    outstanding++;
+    if (fill_batch.size() == fill_batch_capacity) return Flush();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CopyOffload::Flush() {
+    doca_error_t result;
+
+    if (!batch.empty()) {
+        result = SendBatch(OFFLOAD_MSG_COPY, batch.data(), batch.size(), sizeof(offload_copy_desc));
+        if (result != DOCA_SUCCESS) return result;
+        batch.clear();
+    }
+    if (!fill_batch.empty()) {
+        result = SendBatch(OFFLOAD_MSG_FILL, fill_batch.data(), fill_batch.size(), sizeof(offload_fill_desc));
+        if (result != DOCA_SUCCESS) return result;
+        fill_batch.clear();
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CopyOffload::SendBatch(uint32_t type, const void *descs, size_t count, size_t desc_size) {
+    offload_msg_hdr hdr = {type, (uint32_t)count};
+    size_t len = sizeof(hdr) + count * desc_size;
+    doca_error_t result;
+
+    memcpy(msg.data(), &hdr, sizeof(hdr));
+    memcpy(msg.data() + sizeof(hdr), descs, count * desc_size);
+
+    /* The DPU may be blocked on its completions, take them in while the send does not go through */
+    while ((result = ch.TrySendTo(msg.data(), len)) == DOCA_ERROR_AGAIN) {
+        result = ReapCompletions(false);
+        if (result != DOCA_SUCCESS) return result;
+    }
+    if (result != DOCA_SUCCESS)
+        DOCA_LOG_ERR("Failed to post %zu %s: %s", count, type == OFFLOAD_MSG_FILL ? "fills" : "copies",
+                     doca_get_error_string(result));
+    return result;
+}
+
+doca_error_t CopyOffload::ReapCompletions(bool block) {
+    std::vector<char> in(ch.MaxPayload());
+    offload_msg_hdr hdr;
+    offload_completion c;
+    doca_error_t result;
+    size_t len;
+
+    for (;;) {
+        len = in.size();
+        result = block ? ch.RecvFrom(in.data(), &len) : ch.TryRecvFrom(in.data(), &len);
+        if (result == DOCA_ERROR_AGAIN) return DOCA_SUCCESS;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive copy completions: %s", doca_get_error_string(result));
+            return result;
+        }
+        memcpy(&hdr, in.data(), std::min(len, sizeof(hdr)));
+        if (len < sizeof(hdr) || hdr.type != OFFLOAD_MSG_DONE ||
+            len != sizeof(hdr) + hdr.count * sizeof(offload_completion)) {
+            DOCA_LOG_ERR("Malformed completion message of %zu bytes", len);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        for (uint32_t i = 0; i < hdr.count; i++) {
+            memcpy(&c, in.data() + sizeof(hdr) + i * sizeof(c), sizeof(c));
+            done[c.id] = (doca_error_t)c.status;
+            outstanding--;
+        }
+        /* Drain whatever else already arrived without waiting */
+        block = false;
+    }
+}
+
+doca_error_t CopyOffload::Wait(uint64_t id) {
+    doca_error_t result;
+
+    result = Flush();
+    if (result != DOCA_SUCCESS) return result;
+
+    auto it = done.find(id);
+    while (it == done.end()) {
+        if (id == 0 || id >= next_id || outstanding == 0) {
+            DOCA_LOG_ERR("Copy %" PRIu64 " is not outstanding", id);
+            return DOCA_ERROR_NOT_FOUND;
+        }
+        result = ReapCompletions(true);
+        if (result != DOCA_SUCCESS) return result;
+        it = done.find(id);
+    }
+    result = it->second;
+    done.erase(it);
+    return result;
+}
+
+doca_error_t CopyOffload::WaitAll() {
+    doca_error_t result;
+
+    result = Flush();
+    while (result == DOCA_SUCCESS && outstanding > 0) result = ReapCompletions(true);
+    if (result != DOCA_SUCCESS) return result;
+
+    for (auto &entry : done)
+        if (entry.second != DOCA_SUCCESS && result == DOCA_SUCCESS) result = entry.second;
+    done.clear();
+    return result;
+}
+
+doca_error_t CopyOffload::Close() {
+    offload_msg_hdr hdr = {OFFLOAD_MSG_CLOSE, 0};
+    doca_error_t result, close_result;
+
+    result = WaitAll();
+    close_result = ch.SendTo(&hdr, sizeof(hdr));
+    return result != DOCA_SUCCESS ? result : close_result;
+}
+
+doca_error_t offload_memcpy(CopyOffload &offload, void *dst, const void *src, size_t len) {
+    uint32_t dst_region, src_region;
+    size_t dst_offset, src_offset;
+    doca_error_t result;
+    uint64_t id;
+
+    if (!offload.Resolve(dst, len, &dst_region, &dst_offset) || !offload.Resolve(src, len, &src_region, &src_offset)) {
+        DOCA_LOG_ERR("Copy of %zu bytes from %p to %p is outside the registered regions", len, src, dst);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    result = offload.Post(dst_region, dst_offset, src_region, src_offset, len, &id);
+    if (result != DOCA_SUCCESS) return result;
+    return offload.Wait(id);
+}
+
+doca_error_t offload_memset(CopyOffload &offload, void *dst, int c, size_t len) {
+    uint32_t dst_region;
+    size_t dst_offset;
+    doca_error_t result;
+    uint64_t id;
+
+    if (!offload.Resolve(dst, len, &dst_region, &dst_offset)) {
+        DOCA_LOG_ERR("Fill of %zu bytes at %p is outside the registered regions", len, dst);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    result = offload.PostFill(dst_region, dst_offset, len, (uint8_t)c * 0x0101010101010101ULL, &id);
+    if (result != DOCA_SUCCESS) return result;
+    return offload.Wait(id);
+}
+
+CopyService::CopyService(DOCADma<Dpu> &dma, CommChannel<Dpu> &ch, const copy_service_attr &attr)
+    : dma(dma), ch(ch), attr(attr) {
+    doca_error_t result;
+    size_t nb_pieces = WORKQ_DEPTH;
+
+    if (this->attr.max_job == 0 || this->attr.max_job > dma.MaxBufSize()) this->attr.max_job = dma.MaxBufSize();
+    /* Fill jobs start at the beginning of the pattern buffer, they must cover whole periods */
+    this->attr.fill_size = std::min(this->attr.fill_size, this->attr.max_job) & ~(size_t)(sizeof(uint64_t) - 1);
+    if (this->attr.fill_size == 0) throw std::runtime_error("Fill pattern buffer smaller than the pattern");
+    if (attr.bounce) {
+        if (attr.bounce_size == 0 || attr.bounce_size > dma.MaxBufSize() || attr.nb_bounce == 0) {
+            DOCA_LOG_ERR("Invalid bounce buffers: %zu of %zu bytes", attr.nb_bounce, attr.bounce_size);
+            throw std::runtime_error("Invalid bounce buffer settings");
+        }
+        result = dma.AddMMap(bounce);
+        if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to bounce buffers");
+        result = bounce.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.bounce_size * attr.nb_bounce);
+        if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate bounce buffers");
+        nb_pieces = attr.nb_bounce;
+    }
+
+    pieces.resize(nb_pieces);
+    for (size_t i = 0; i < nb_pieces; i++) free_pieces.push_back(nb_pieces - 1 - i);
+    msg.resize(ch.MaxPayload());
+}
+
+doca_error_t CopyService::Run() {
+    doca_error_t result = DOCA_SUCCESS, drained;
+    size_t len, inflight;
+    void *user_data;
+    bool idle;
+
+    while (!closing || !active.empty() || !completions.empty()) {
+        idle = true;
+
+        if (!closing) {
+            len = msg.size();
+            result = ch.TryRecvFrom(msg.data(), &len);
+            if (result == DOCA_SUCCESS) {
+                idle = false;
+                result = HandleMessage(len);
+                if (result != DOCA_SUCCESS) break;
+            } else if (result != DOCA_ERROR_AGAIN) {
+                DOCA_LOG_ERR("Failed to receive copy commands: %s", doca_get_error_string(result));
+                break;
+            }
+        }
+
+        result = Issue();
+        if (result != DOCA_SUCCESS) break;
+        for (;;) {
+            inflight = dma.Inflight();
+            result = dma.Poll(&user_data);
+            if (result == DOCA_ERROR_AGAIN) break;
+            /* The retrieve itself failed and no job came back, there is no piece to retire */
+            if (result != DOCA_SUCCESS && dma.Inflight() == inflight) break;
+            idle = false;
+            PieceDone((uint32_t)(uintptr_t)user_data, result);
+        }
+        if (result != DOCA_ERROR_AGAIN) {
+            DOCA_LOG_ERR("Failed to retrieve copy jobs: %s", doca_get_error_string(result));
+            break;
+        }
+
+        /* Batch completions: send once a round brought nothing new, or a message is full */
+        if (!completions.empty() &&
+            (idle || completions.size() >= (msg.size() - sizeof(offload_msg_hdr)) / sizeof(offload_completion))) {
+            result = SendCompletions(false);
+            if (result != DOCA_SUCCESS) break;
+        }
+    }
+    if (result == DOCA_ERROR_AGAIN) result = DOCA_SUCCESS;
+
+    drained = dma.Drain();
+    if (result == DOCA_SUCCESS) result = drained;
+    if (result == DOCA_SUCCESS)
+        DOCA_LOG_INFO("Copy service closed after %" PRIu64 " copies of %" PRIu64 " bytes", counters.copies,
+                      counters.bytes);
+    return result;
+}
+
+doca_error_t CopyService::HandleMessage(size_t len) {
+    offload_msg_hdr hdr;
+    offload_copy_desc desc;
+    offload_fill_desc fill;
+    fill_pattern *pattern;
+
+    if (len < sizeof(hdr)) {
+        DOCA_LOG_ERR("Malformed command of %zu bytes", len);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    memcpy(&hdr, msg.data(), sizeof(hdr));
+
+    switch (hdr.type) {
+        case OFFLOAD_MSG_REGISTER:
+            return RegisterRegion();
+        case OFFLOAD_MSG_CLOSE:
+            closing = true;
+            return DOCA_SUCCESS;
+        case OFFLOAD_MSG_COPY:
+        case OFFLOAD_MSG_FILL:
+            break;
+        default:
+            DOCA_LOG_ERR("Unknown command %u", hdr.type);
+            return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (len != sizeof(hdr) + hdr.count * (hdr.type == OFFLOAD_MSG_FILL ? sizeof(fill) : sizeof(desc))) {
+        DOCA_LOG_ERR("Malformed batch of %u descriptors in %zu bytes", hdr.count, len);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    counters.cmd_msgs++;
+
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        if (hdr.type == OFFLOAD_MSG_COPY) {
+            memcpy(&desc, msg.data() + sizeof(hdr) + i * sizeof(desc), sizeof(desc));
+            Enqueue(desc, nullptr, InRange(desc.dst_region, desc.dst_offset, desc.len) &&
+                                       InRange(desc.src_region, desc.src_offset, desc.len));
+            continue;
+        }
+
+        memcpy(&fill, msg.data() + sizeof(hdr) + i * sizeof(fill), sizeof(fill));
+        desc = {fill.id, fill.dst_region, OFFLOAD_FILL_SRC, fill.dst_offset, 0, fill.len};
+        if (!InRange(fill.dst_region, fill.dst_offset, fill.len)) {
+            Enqueue(desc, nullptr, false);
+            continue;
+        }
+        pattern = fill.len > 0 ? AcquirePattern(fill.pattern) : nullptr;
+        Enqueue(desc, pattern, fill.len == 0 || pattern != nullptr);
+    }
+    return DOCA_SUCCESS;
+}
+
+bool CopyService::InRange(uint32_t region, size_t offset, size_t len) const {
+    return region < regions.size() && offset <= regions[region]->Len() && len <= regions[region]->Len() - offset;
+}
+
+void CopyService::Enqueue(const offload_copy_desc &desc, fill_pattern *fill, bool valid) {
+    auto it = active.insert(active.end(), active_copy());
+
+    it->desc = desc;
+    it->fill = fill;
+    if (!valid) {
+        DOCA_LOG_ERR("%s %" PRIu64 " is out of range of the registered regions", desc.src_region == OFFLOAD_FILL_SRC ? "Fill" : "Copy",
+                     desc.id);
+        it->status = DOCA_ERROR_INVALID_VALUE;
+        it->next = desc.len;
+    }
+    if (it->next == desc.len)
+        Finish(it);
+    else
+        pending.push_back(it);
+}
+
+CopyService::fill_pattern *CopyService::AcquirePattern(uint64_t pattern) {
+    doca_error_t result;
+
+    for (fill_pattern &p : patterns) {
+        if (p.pattern != pattern) continue;
+        p.users++;
+        return &p;
+    }
+
+    /* Drop idle buffers beyond the cache, the ones in use stay regardless */
+    for (auto it = patterns.begin(); it != patterns.end() && patterns.size() >= FILL_PATTERN_CACHE;)
+        it = it->users == 0 ? patterns.erase(it) : std::next(it);
+
+    fill_pattern &p = patterns.emplace_back();
+    p.pattern = pattern;
+    result = dma.AddMMap(p.mmap);
+    if (result == DOCA_SUCCESS) result = p.mmap.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.fill_size);
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to set up a fill pattern buffer: %s", doca_get_error_string(result));
+        patterns.pop_back();
+        return nullptr;
+    }
+    for (size_t off = 0; off < attr.fill_size; off += sizeof(pattern))
+        memcpy(p.mmap.Data() + off, &pattern, sizeof(pattern));
+    p.users++;
+    return &p;
+}
+
+doca_error_t CopyService::RegisterRegion() {
+    try {
+        regions.push_back(std::make_unique<MemMap>(dma, ch));
+    } catch (const std::exception &e) {
+        DOCA_LOG_ERR("Failed to import region %zu: %s", regions.size(), e.what());
+        return DOCA_ERROR_INITIALIZATION;
+    }
+    return regions.back()->RecvAddrAndOffset(ch);
+}
+
+doca_error_t CopyService::Issue() {
+    size_t max_copy = attr.bounce ? attr.bounce_size : attr.max_job, max_piece;
+    doca_error_t result;
+    uint32_t piece;
+
+    /* Staged pieces hold a bounce buffer, they go first */
+    while (!staged.empty()) {
+        result = SubmitPiece(staged.front());
+        if (result == DOCA_ERROR_AGAIN) return DOCA_SUCCESS;
+        piece = staged.front();
+        staged.pop_front();
+        if (result != DOCA_SUCCESS) PieceDone(piece, result);
+    }
+
+    /*
+     * A lone fill on an idle work queue, as offload_memset posts them, goes to the DMA fill in one call. Nothing
+     * else is queued behind it, so blocking until it is done holds up no other copy.
+     */
+    if (pending.size() == 1 && pending.front()->fill && pending.front()->next == 0 && dma.Inflight() == 0) {
+        auto it = pending.front();
+
+        pending.pop_front();
+        it->next = it->desc.len;
+        it->status = dma.Fill(it->fill->mmap, *regions[it->desc.dst_region], it->desc.dst_offset, it->desc.len);
+        if (it->status == DOCA_SUCCESS) counters.jobs += (it->desc.len + attr.fill_size - 1) / attr.fill_size;
+        Finish(it);
+        return DOCA_SUCCESS;
+    }
+
+    while (!pending.empty() && !free_pieces.empty()) {
+        auto it = pending.front();
+
+        piece = free_pieces.back();
+        max_piece = it->fill ? attr.fill_size : max_copy;
+        pieces[piece] = {it, it->next, std::min<size_t>(it->desc.len - it->next, max_piece), false};
+        result = SubmitPiece(piece);
+        if (result == DOCA_ERROR_AGAIN) return DOCA_SUCCESS;
+        free_pieces.pop_back();
+
+        it->next += pieces[piece].len;
+        it->pieces++;
+        if (it->next == it->desc.len) pending.pop_front();
+        if (result != DOCA_SUCCESS) PieceDone(piece, result);
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t CopyService::SubmitPiece(uint32_t piece) {
+    const copy_piece &p = pieces[piece];
+    const offload_copy_desc &d = p.copy->desc;
+    MemMap &dst = *regions[d.dst_region];
+    void *user_data = (void *)(uintptr_t)piece;
+
+    if (p.copy->fill) return dma.Submit(p.copy->fill->mmap, 0, dst, d.dst_offset + p.offset, p.len, user_data);
+    MemMap &src = *regions[d.src_region];
+    if (!attr.bounce)
+        return dma.Submit(src, d.src_offset + p.offset, dst, d.dst_offset + p.offset, p.len, user_data);
+    if (!p.staged) return dma.Submit(src, d.src_offset + p.offset, bounce, piece * attr.bounce_size, p.len, user_data);
+    return dma.Submit(bounce, piece * attr.bounce_size, dst, d.dst_offset + p.offset, p.len, user_data);
+}
+
+void CopyService::PieceDone(uint32_t piece, doca_error_t result) {
+    copy_piece &p = pieces[piece];
+    auto it = p.copy;
+
+    if (result == DOCA_SUCCESS) counters.jobs++;
+    if (result == DOCA_SUCCESS && attr.bounce && !it->fill && !p.staged) {
+        p.staged = true;
+        staged.push_back(piece);
+        return;
+    }
+
+    if (result != DOCA_SUCCESS && it->status == DOCA_SUCCESS) it->status = result;
+    free_pieces.push_back(piece);
+    it->pieces--;
+    if (it->pieces == 0 && it->next == it->desc.len) Finish(it);
+}
+
+void CopyService::Finish(std::list<active_copy>::iterator copy) {
+    completions.push_back({copy->desc.id, copy->status, 0});
+    if (copy->fill) copy->fill->users--;
+    if (copy->status != DOCA_SUCCESS) {
+        counters.failed++;
+    } else if (copy->desc.src_region == OFFLOAD_FILL_SRC) {
+        counters.fills++;
+        counters.fill_bytes += copy->desc.len;
+    } else {
+        counters.copies++;
+        counters.bytes += copy->desc.len;
+    }
+    active.erase(copy);
+}
+
+doca_error_t CopyService::SendCompletions(bool block) {
+    size_t capacity = (msg.size() - sizeof(offload_msg_hdr)) / sizeof(offload_completion);
+    std::vector<char> out(msg.size());
+    offload_msg_hdr hdr = {OFFLOAD_MSG_DONE, 0};
+    doca_error_t result;
+    size_t n;
+
+    while (!completions.empty()) {
+        n = std::min(completions.size(), capacity);
+        hdr.count = n;
+        memcpy(out.data(), &hdr, sizeof(hdr));
+        memcpy(out.data() + sizeof(hdr), completions.data(), n * sizeof(offload_completion));
+
+        result = block ? ch.SendTo(out.data(), sizeof(hdr) + n * sizeof(offload_completion))
+                       : ch.TrySendTo(out.data(), sizeof(hdr) + n * sizeof(offload_completion));
+        /* The host is busy posting, it takes completions in when its own send stalls */
+        if (result == DOCA_ERROR_AGAIN) return DOCA_SUCCESS;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to send copy completions: %s", doca_get_error_string(result));
+            return result;
+        }
+        completions.erase(completions.begin(), completions.begin() + n);
+        counters.done_msgs++;
+    }
+    return DOCA_SUCCESS;
+}
+
+}  // namespace doca
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../chan/comm_channel.h"
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+namespace doca {
+
+enum offload_msg_type : uint32_t {
+    OFFLOAD_MSG_REGISTER, /* A region export follows, through the usual descriptor exchange */
+    OFFLOAD_MSG_COPY,     /* count offload_copy_desc follow */
+    OFFLOAD_MSG_CLOSE,    /* No further commands */
+    OFFLOAD_MSG_DONE,     /* DPU to host, count offload_completion follow */
+    OFFLOAD_MSG_FILL,     /* count offload_fill_desc follow */
+};
+
+struct offload_msg_hdr {
+    uint32_t type;
+    uint32_t count;
+};
+
+/* A copy between two registered regions, both of the same host */
+struct offload_copy_desc {
+    uint64_t id;
+    uint32_t dst_region;
+    uint32_t src_region;
+    uint64_t dst_offset;
+    uint64_t src_offset;
+    uint64_t len;
+};
+
+/* Fill of a registered region with a repeating 64-bit pattern, starting with its first byte at dst_offset */
+struct offload_fill_desc {
+    uint64_t id;
+    uint32_t dst_region;
+    uint32_t reserved;
+    uint64_t dst_offset;
+    uint64_t len;
+    uint64_t pattern;
+};
+
+struct offload_completion {
+    uint64_t id;
+    int32_t status; /* doca_error_t of the copy */
+    uint32_t reserved;
+};
+
+/*
+ * Host side of the DPU copy service. Regions are exported once with Register;
+ * copies between them, and fills of them, are posted as descriptors, sent in
+ * batches over the Comm Channel, and complete asynchronously when the DPU
+ * reports them done. The host CPU never touches the data.
+ *
+ * Single threaded. Register waits for every outstanding copy first, its
+ * descriptor exchange shares the channel with completions.
+ */
+class CopyOffload {
+   public:
+    CopyOffload(DOCADma<Host> &dma, CommChannel<Host> &ch);
+    CopyOffload(const CopyOffload &) = delete;
+    CopyOffload &operator=(const CopyOffload &) = delete;
+
+    /* Export a populated mmap to the service, *region names it in descriptors */
+    doca_error_t Register(MemMap &mmap, uint32_t *region);
+    /* Region and offset of an address inside a registered mmap, false if there is none covering len bytes */
+    bool Resolve(const void *addr, size_t len, uint32_t *region, size_t *offset) const;
+
+    /* Queue a copy, sent with the next full batch or Flush; *id identifies it to Wait */
+    doca_error_t Post(uint32_t dst_region, size_t dst_offset, uint32_t src_region, size_t src_offset, size_t len,
+                      uint64_t *id);
+    /* Queue a fill of len bytes with pattern, in memory byte order; waited for like a copy */
+    doca_error_t PostFill(uint32_t dst_region, size_t dst_offset, size_t len, uint64_t pattern, uint64_t *id);
+    doca_error_t Flush();
+    /* Flush, then block until the copy completed and return its status */
+    doca_error_t Wait(uint64_t id);
+    doca_error_t WaitAll();
+    size_t Outstanding() const { return outstanding; }
+
+    /* Wait for everything and stop the service */
+    doca_error_t Close();
+
+   protected:
+    DOCADma<Host> &dma;
+    CommChannel<Host> &ch;
+
+    struct region_range {
+        const char *base;
+        size_t len;
+    };
+    std::vector<region_range> regions;
+
+    std::vector<offload_copy_desc> batch;
+    size_t batch_capacity;
+    std::vector<offload_fill_desc> fill_batch;
+    size_t fill_batch_capacity;
+    std::vector<char> msg;
+    uint64_t next_id = 1;
+    size_t outstanding = 0;
+    /* Completions received for copies nobody waited for yet */
+    std::unordered_map<uint64_t, doca_error_t> done;
+
+    /* Send count descriptors of a batch in one message */
+    doca_error_t SendBatch(uint32_t type, const void *descs, size_t count, size_t desc_size);
+    /* Take in the completions already received, or block for at least one */
+    doca_error_t ReapCompletions(bool block);
+};
+
+/*
+ * memcpy through the DPU copy service: dst and src must lie in mmaps
+ * registered with offload. Returns once the copy is complete.
+ */
+doca_error_t offload_memcpy(CopyOffload &offload, void *dst, const void *src, size_t len);
+
+/*
+ * memset through the DPU copy service: dst must lie in an mmap registered
+ * with offload. Returns once the fill is complete.
+ */
+doca_error_t offload_memset(CopyOffload &offload, void *dst, int c, size_t len);
+
+/* Construction time settings of a CopyService */
+struct copy_service_attr {
+    bool bounce = false;            /* Stage every copy through DPU memory instead of host to host DMA */
+    size_t bounce_size = 1 << 20;   /* Bounce buffer size, also the largest job in bounce mode */
+    size_t nb_bounce = WORKQ_DEPTH; /* Bounce buffers, each carries one piece of a copy at a time */
+    size_t max_job = 0;             /* Largest host to host job, the device limit if 0 */
+    size_t fill_size = 1 << 20;     /* Pattern buffer size, also the largest fill job */
+};
+
+#define FILL_PATTERN_CACHE 4         /* Idle pattern buffers kept for reuse */
+#define OFFLOAD_FILL_SRC UINT32_MAX /* Source region of a fill in the service's queue */
+
+/* Point-in-time copy of a CopyService's counters */
+struct copy_service_stats {
+    uint64_t copies = 0;
+    uint64_t failed = 0;
+    uint64_t bytes = 0;
+    uint64_t fills = 0;
+    uint64_t fill_bytes = 0;
+    uint64_t jobs = 0;         /* DMA jobs, two per copy piece in bounce mode */
+    uint64_t cmd_msgs = 0;     /* Descriptor batches received */
+    uint64_t done_msgs = 0;    /* Completion batches sent */
+};
+
+/*
+ * DPU side of the copy service: imports the host's regions as they are
+ * registered and runs posted copies as DMA jobs, split to the device limit,
+ * keeping the work queue full across descriptors. Fills are DMAed from a local
+ * buffer holding the pattern, one per distinct pattern in use; a fill that
+ * finds the service idle is handed to DOCADma::Fill whole. Completions are
+ * batched back to the host as copies finish.
+ */
+class CopyService {
+   public:
+    CopyService(DOCADma<Dpu> &dma, CommChannel<Dpu> &ch, const copy_service_attr &attr = copy_service_attr());
+    CopyService(const CopyService &) = delete;
+    CopyService &operator=(const CopyService &) = delete;
+
+    /* Serve the host until it closes the service */
+    doca_error_t Run();
+
+    void Snapshot(copy_service_stats *stats) const { *stats = counters; }
+
+   protected:
+    /* Local buffer filled with a pattern, the source of fills */
+    struct fill_pattern {
+        uint64_t pattern;
+        MemMap mmap;
+        size_t users = 0; /* Fills using it */
+    };
+
+    /* A copy or fill being run, pieces are carved off it in order */
+    struct active_copy {
+        offload_copy_desc desc;  /* src_region is OFFLOAD_FILL_SRC for fills */
+        fill_pattern *fill = nullptr;
+        size_t next = 0;         /* Bytes handed to pieces so far */
+        size_t pieces = 0;       /* Pieces in flight */
+        doca_error_t status = DOCA_SUCCESS;
+    };
+
+    /* One DMA job's worth of a copy, or two in bounce mode */
+    struct copy_piece {
+        std::list<active_copy>::iterator copy;
+        size_t offset;
+        size_t len;
+        bool staged; /* Bounce mode: in the buffer, on its way to the destination */
+    };
+
+    DOCADma<Dpu> &dma;
+    CommChannel<Dpu> &ch;
+    copy_service_attr attr;
+    MemMap bounce;
+
+    std::vector<std::unique_ptr<MemMap>> regions;
+    std::list<fill_pattern> patterns;
+    std::list<active_copy> active;                        /* Copies with bytes or pieces outstanding */
+    std::deque<std::list<active_copy>::iterator> pending; /* Copies with bytes not handed to pieces yet */
+    std::vector<copy_piece> pieces;                       /* Indexed by bounce buffer in bounce mode */
+    std::vector<uint32_t> free_pieces;
+    std::deque<uint32_t> staged;                          /* Bounce mode: pieces ready for their second job */
+    std::vector<offload_completion> completions;
+    std::vector<char> msg;
+    bool closing = false;
+
+    copy_service_stats counters;
+
+    doca_error_t HandleMessage(size_t len);
+    doca_error_t RegisterRegion();
+    bool InRange(uint32_t region, size_t offset, size_t len) const;
+    /* Queue a copy or fill, or complete it right away if it is empty or invalid */
+    void Enqueue(const offload_copy_desc &desc, fill_pattern *fill, bool valid);
+    /* Pattern buffer for a fill, nullptr if it cannot be set up */
+    fill_pattern *AcquirePattern(uint64_t pattern);
+    /* Start pieces of the queued copies while buffers and work queue entries last */
+    doca_error_t Issue();
+    doca_error_t SubmitPiece(uint32_t piece);
+    void PieceDone(uint32_t piece, doca_error_t result);
+    void Finish(std::list<active_copy>::iterator copy);
+    /* Send the completions gathered so far, without block only as many as the channel takes */
+    doca_error_t SendCompletions(bool block);
+};
+
+}  // namespace doca
@@ -0,0 +1,166 @@
+#include "scan.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+
+/* Jobs carry their buffer and whether they read a chunk or write its bitmap */
+#define SCAN_JOB(buf, write) ((void *)(uintptr_t)((((uintptr_t)(buf)) << 1 | (write)) + 1))
+#define SCAN_JOB_BUF(ud) ((uint32_t)(((uintptr_t)(ud)-1) >> 1))
+#define SCAN_JOB_WRITE(ud) ((((uintptr_t)(ud)-1) & 1) != 0)
+
+namespace doca {
+
+DOCA_LOG_REGISTER(SCAN);
+
+ScanOperator::ScanOperator(DOCADma<Dpu> &dma, MemMap &remote, const scan_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.chunk_size == 0 || attr.chunk_size % 256 != 0 || attr.chunk_size > dma.MaxBufSize() ||
+        attr.nb_buffers == 0) {
+        DOCA_LOG_ERR("Invalid scan settings: %u buffers of %zu bytes", attr.nb_buffers, attr.chunk_size);
+        throw std::runtime_error("Invalid scan settings");
+    }
+
+    result = dma.AddMMap(pool);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to the scan buffers");
+    result = pool.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, BitmapArea(attr.nb_buffers));
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate the scan buffers");
+
+    buf_chunk.resize(attr.nb_buffers);
+}
+
+doca_error_t ScanOperator::Scan(size_t offset, size_t nb_rows, const scan_predicate &pred, scan_agg *agg,
+                                MemMap *bitmap_dst, size_t bitmap_offset) {
+    size_t len = nb_rows * sizeof(int32_t);
+
+    if (offset % sizeof(int32_t) != 0 || offset > remote.Len() || len > remote.Len() - offset) {
+        DOCA_LOG_ERR("Scan of %zu rows at offset %zu is outside the %zu byte column region", nb_rows, offset,
+                     remote.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (bitmap_dst != nullptr && (bitmap_offset % sizeof(uint64_t) != 0 || bitmap_offset > bitmap_dst->Len() ||
+                                  (nb_rows + 63) / 64 * sizeof(uint64_t) > bitmap_dst->Len() - bitmap_offset)) {
+        DOCA_LOG_ERR("Bitmap of %zu rows at offset %zu does not fit the %zu byte bitmap region", nb_rows,
+                     bitmap_offset, bitmap_dst->Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    counters.scans++;
+    counters.rows += nb_rows;
+    return Run(offset, len, &pred, agg, bitmap_dst, bitmap_offset);
+}
+
+doca_error_t ScanOperator::Stream(size_t offset, size_t len) {
+    if (offset > remote.Len() || len > remote.Len() - offset) {
+        DOCA_LOG_ERR("Stream of %zu bytes at offset %zu is outside the %zu byte remote region", len, offset,
+                     remote.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    return Run(offset, len, nullptr, nullptr, nullptr, 0);
+}
+
+doca_error_t ScanOperator::Run(size_t offset, size_t len, const scan_predicate *pred, scan_agg *agg,
+                               MemMap *bitmap_dst, size_t bitmap_offset) {
+    size_t nb_chunks = (len + attr.chunk_size - 1) / attr.chunk_size, next = 0, done = 0, chunk_off, chunk_len;
+    uint64_t start = NowNs(), kernel_start, matches;
+    doca_error_t result = DOCA_SUCCESS, status;
+    void *user_data;
+    uint32_t buf;
+
+    free_bufs.clear();
+    for (uint32_t i = attr.nb_buffers; i > 0; i--) free_bufs.push_back(i - 1);
+    blocked.clear();
+
+    while (done < nb_chunks && result == DOCA_SUCCESS) {
+        /* Bitmap writes refused earlier go first, they hold their buffers */
+        while (!blocked.empty()) {
+            buf = blocked.front();
+            chunk_len = std::min(attr.chunk_size, len - buf_chunk[buf] * attr.chunk_size);
+            status = dma.Submit(pool, BitmapArea(buf), *bitmap_dst,
+                                bitmap_offset + buf_chunk[buf] * (attr.chunk_size / 32),
+                                (chunk_len / sizeof(int32_t) + 63) / 64 * sizeof(uint64_t), SCAN_JOB(buf, 1));
+            if (status == DOCA_ERROR_AGAIN) break;
+            blocked.pop_front();
+            if (status != DOCA_SUCCESS) {
+                result = status;
+                break;
+            }
+        }
+
+        while (next < nb_chunks && !free_bufs.empty() && result == DOCA_SUCCESS) {
+            buf = free_bufs.back();
+            chunk_off = next * attr.chunk_size;
+            chunk_len = std::min(attr.chunk_size, len - chunk_off);
+            status = dma.Submit(remote, offset + chunk_off, pool, buf * attr.chunk_size, chunk_len, SCAN_JOB(buf, 0));
+            if (status == DOCA_ERROR_AGAIN) {
+                counters.again++;
+                break;
+            }
+            if (status != DOCA_SUCCESS) {
+                result = status;
+                break;
+            }
+            free_bufs.pop_back();
+            buf_chunk[buf] = next++;
+        }
+
+        while (result == DOCA_SUCCESS) {
+            user_data = nullptr;
+            status = dma.Poll(&user_data);
+            if (status == DOCA_ERROR_AGAIN) break;
+            if (status != DOCA_SUCCESS) {
+                if (user_data == nullptr) DOCA_LOG_ERR("Scan stopped: %s", doca_get_error_string(status));
+                result = status;
+                break;
+            }
+
+            buf = SCAN_JOB_BUF(user_data);
+            if (SCAN_JOB_WRITE(user_data)) {
+                free_bufs.push_back(buf);
+                done++;
+                continue;
+            }
+
+            chunk_len = std::min(attr.chunk_size, len - buf_chunk[buf] * attr.chunk_size);
+            counters.bytes += chunk_len;
+            counters.chunks++;
+            if (pred == nullptr) {
+                free_bufs.push_back(buf);
+                done++;
+                continue;
+            }
+
+            kernel_start = NowNs();
+            matches = agg->count;
+            ScanFilterAggregate((const int32_t *)(pool.Data() + buf * attr.chunk_size), chunk_len / sizeof(int32_t),
+                                *pred, agg,
+                                bitmap_dst != nullptr ? (uint64_t *)(pool.Data() + BitmapArea(buf)) : nullptr);
+            counters.kernel_ns += NowNs() - kernel_start;
+            counters.matches += agg->count - matches;
+
+            if (bitmap_dst == nullptr) {
+                free_bufs.push_back(buf);
+                done++;
+                continue;
+            }
+            counters.bitmap_bytes += (chunk_len / sizeof(int32_t) + 63) / 64 * sizeof(uint64_t);
+            blocked.push_back(buf);
+            break;
+        }
+    }
+
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Scan failed after %zu of %zu chunks: %s", done, nb_chunks, doca_get_error_string(result));
+        dma.Drain();
+    }
+    counters.busy_ns += NowNs() - start;
+    return result;
+}
+
+}  // namespace doca
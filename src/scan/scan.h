@@ -0,0 +1,81 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+#include "scan_kernels.h"
+
+namespace doca {
+
+/* Construction time settings of a ScanOperator */
+struct scan_attr {
+    size_t chunk_size = 256 << 10; /* Bytes per DMA read, a multiple of 256 so every chunk fills whole bitmap words */
+    uint32_t nb_buffers = 8;       /* Chunks in flight or being scanned at once */
+};
+
+/* Counters of a ScanOperator */
+struct scan_stats {
+    uint64_t scans = 0;
+    uint64_t rows = 0;
+    uint64_t matches = 0;
+    uint64_t bytes = 0;        /* Column bytes read from the host */
+    uint64_t bitmap_bytes = 0; /* Bitmap bytes written back to the host */
+    uint64_t chunks = 0;
+    uint64_t again = 0;     /* Jobs held back by a full work queue */
+    uint64_t busy_ns = 0;   /* Time spent in Scan and Stream */
+    uint64_t kernel_ns = 0; /* Time spent in the filter kernel */
+
+    double GBps() const { return busy_ns ? (double)bytes / busy_ns : 0.0; }
+    double KernelGBps() const { return kernel_ns ? (double)bytes / kernel_ns : 0.0; }
+};
+
+/*
+ * Near-data filter and aggregate over a 32-bit column in host memory. The
+ * column is streamed in chunks through a ring of DPU buffers: reads for the
+ * next chunks are in flight while the filter kernel runs over the ones that
+ * arrived, so the kernel hides behind the DMA as long as it keeps up. Only the
+ * aggregates and, if asked for, the match bitmap leave the DPU; the bitmap of
+ * each chunk is written back to the host as soon as it is complete.
+ *
+ * Single threaded: the operator owns dma, which must not be used by anyone
+ * else during Scan or Stream.
+ */
+class ScanOperator {
+   public:
+    ScanOperator(DOCADma<Dpu> &dma, MemMap &remote, const scan_attr &attr = scan_attr());
+    ScanOperator(const ScanOperator &) = delete;
+    ScanOperator &operator=(const ScanOperator &) = delete;
+
+    /*
+     * Scan nb_rows values starting at remote offset, a multiple of 4, and fold the matches of pred into
+     * agg. With bitmap_dst, a host region, the match bitmap goes there from bitmap_offset, a multiple
+     * of 8, in (nb_rows + 63) / 64 little endian words.
+     */
+    doca_error_t Scan(size_t offset, size_t nb_rows, const scan_predicate &pred, scan_agg *agg,
+                      MemMap *bitmap_dst = nullptr, size_t bitmap_offset = 0);
+    /* Read len bytes from remote offset through the same pipeline without scanning, the DMA baseline */
+    doca_error_t Stream(size_t offset, size_t len);
+
+    void Snapshot(scan_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = scan_stats(); }
+
+   protected:
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    scan_attr attr;
+    MemMap pool; /* nb_buffers chunks, then a bitmap area of chunk_size / 32 bytes per chunk */
+
+    std::vector<size_t> buf_chunk; /* Chunk index each buffer holds */
+    std::vector<uint32_t> free_bufs;
+    std::deque<uint32_t> blocked; /* Scanned buffers whose bitmap write is not submitted yet */
+
+    scan_stats counters;
+
+    doca_error_t Run(size_t offset, size_t len, const scan_predicate *pred, scan_agg *agg, MemMap *bitmap_dst,
+                     size_t bitmap_offset);
+    size_t BitmapArea(uint32_t buf) const { return attr.nb_buffers * attr.chunk_size + buf * (attr.chunk_size / 32); }
+};
+
+}  // namespace doca
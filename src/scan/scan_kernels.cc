@@ -0,0 +1,201 @@
+#include "scan_kernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+namespace doca {
+
+void scan_agg::Merge(const scan_agg &other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+namespace {
+
+/* Rows [0, n) of one bitmap word, n at most 64 */
+uint64_t scan_word_sw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg) {
+    uint64_t word = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (v[i] < lo || v[i] > hi) continue;
+        word |= 1ull << i;
+        agg->count++;
+        agg->sum += v[i];
+        agg->min = std::min(agg->min, v[i]);
+        agg->max = std::max(agg->max, v[i]);
+    }
+    return word;
+}
+
+void scan_sw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg, uint64_t *bitmap) {
+    uint64_t word;
+
+    for (size_t i = 0; i < n; i += 64) {
+        word = scan_word_sw(v + i, std::min<size_t>(64, n - i), lo, hi, agg);
+        if (bitmap != nullptr) bitmap[i / 64] = word;
+    }
+}
+
+#if defined(__x86_64__)
+/*
+ * Eight rows per vector: the compare mask gives eight bitmap bits at once and
+ * selects the values folded into min, max and two 64-bit sum accumulators.
+ */
+__attribute__((target("avx2"))) void scan_hw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg,
+                                             uint64_t *bitmap) {
+    const __m256i vlo = _mm256_set1_epi32(lo), vhi = _mm256_set1_epi32(hi);
+    const __m256i vmin_id = _mm256_set1_epi32(INT32_MAX), vmax_id = _mm256_set1_epi32(INT32_MIN);
+    __m256i vmin = vmin_id, vmax = vmax_id, vsum = _mm256_setzero_si256();
+    __m256i x, out, match;
+    int32_t lanes[8];
+    int64_t sums[4];
+    uint64_t word, count = 0;
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64) {
+        word = 0;
+        for (size_t j = 0; j < 64; j += 8) {
+            x = _mm256_loadu_si256((const __m256i *)(v + i + j));
+            out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+            match = _mm256_xor_si256(out, _mm256_set1_epi32(-1));
+            word |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(match)) << j;
+
+            vmin = _mm256_min_epi32(vmin, _mm256_blendv_epi8(vmin_id, x, match));
+            vmax = _mm256_max_epi32(vmax, _mm256_blendv_epi8(vmax_id, x, match));
+            x = _mm256_and_si256(x, match);
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        }
+        count += __builtin_popcountll(word);
+        if (bitmap != nullptr) bitmap[i / 64] = word;
+    }
+
+    _mm256_storeu_si256((__m256i *)sums, vsum);
+    agg->count += count;
+    agg->sum += sums[0] + sums[1] + sums[2] + sums[3];
+    _mm256_storeu_si256((__m256i *)lanes, vmin);
+    agg->min = std::min(agg->min, *std::min_element(lanes, lanes + 8));
+    _mm256_storeu_si256((__m256i *)lanes, vmax);
+    agg->max = std::max(agg->max, *std::max_element(lanes, lanes + 8));
+
+    if (i < n) scan_sw(v + i, n - i, lo, hi, agg, bitmap != nullptr ? bitmap + i / 64 : nullptr);
+}
+
+bool have_hw() {
+    static const bool hw = __builtin_cpu_supports("avx2");
+    return hw;
+}
+
+const char *hw_name() { return "avx2"; }
+#elif defined(__aarch64__)
+/*
+ * Four rows per vector. Matching lanes are all ones, so the lane weights
+ * 1, 2, 4, 8 summed across the vector give four bitmap bits, and subtracting
+ * the mask counts them. Sums widen pairwise into 64-bit lanes.
+ */
+void scan_neon(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg, uint64_t *bitmap) {
+    static const uint32_t weights[4] = {1, 2, 4, 8};
+    const int32x4_t vlo = vdupq_n_s32(lo), vhi = vdupq_n_s32(hi);
+    const int32x4_t vmin_id = vdupq_n_s32(INT32_MAX), vmax_id = vdupq_n_s32(INT32_MIN);
+    const uint32x4_t vweights = vld1q_u32(weights);
+    int32x4_t vmin = vmin_id, vmax = vmax_id, x;
+    int64x2_t vsum = vdupq_n_s64(0);
+    uint32x4_t match;
+    uint64_t word, count = 0;
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64) {
+        word = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            x = vld1q_s32(v + i + j);
+            match = vandq_u32(vcgeq_s32(x, vlo), vcleq_s32(x, vhi));
+            word |= (uint64_t)vaddvq_u32(vandq_u32(match, vweights)) << j;
+
+            vmin = vminq_s32(vmin, vbslq_s32(match, x, vmin_id));
+            vmax = vmaxq_s32(vmax, vbslq_s32(match, x, vmax_id));
+            vsum = vpadalq_s32(vsum, vandq_s32(x, vreinterpretq_s32_u32(match)));
+        }
+        count += __builtin_popcountll(word);
+        if (bitmap != nullptr) bitmap[i / 64] = word;
+    }
+
+    agg->count += count;
+    agg->sum += vaddvq_s64(vsum);
+    agg->min = std::min(agg->min, vminvq_s32(vmin));
+    agg->max = std::max(agg->max, vmaxvq_s32(vmax));
+
+    if (i < n) scan_sw(v + i, n - i, lo, hi, agg, bitmap != nullptr ? bitmap + i / 64 : nullptr);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+/*
+ * Vector length agnostic aggregation: the loop predicate covers the tail, and
+ * the across-vector reductions only look at matching lanes. Reductions per
+ * vector cost more than NEON's deferred ones but pay off on wide SVE units.
+ * SVE has no cheap predicate to bit mask move, bitmaps stay with NEON.
+ */
+void scan_hw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg, uint64_t *bitmap) {
+    const uint64_t step = svcntw();
+    svbool_t pg, match;
+    svint32_t x;
+
+    if (bitmap != nullptr) {
+        scan_neon(v, n, lo, hi, agg, bitmap);
+        return;
+    }
+
+    for (uint64_t i = 0; i < n; i += step) {
+        pg = svwhilelt_b32_u64(i, n);
+        x = svld1_s32(pg, v + i);
+        match = svand_b_z(pg, svcmpge_n_s32(pg, x, lo), svcmple_n_s32(pg, x, hi));
+        if (!svptest_any(pg, match)) continue;
+        agg->count += svcntp_b32(pg, match);
+        agg->sum += svaddv_s32(match, x);
+        agg->min = std::min(agg->min, svminv_s32(match, x));
+        agg->max = std::max(agg->max, svmaxv_s32(match, x));
+    }
+}
+
+const char *hw_name() { return "sve"; }
+#else
+void scan_hw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg, uint64_t *bitmap) {
+    scan_neon(v, n, lo, hi, agg, bitmap);
+}
+
+const char *hw_name() { return "neon"; }
+#endif
+
+bool have_hw() { return true; }
+#else
+void scan_hw(const int32_t *v, size_t n, int32_t lo, int32_t hi, scan_agg *agg, uint64_t *bitmap) {
+    scan_sw(v, n, lo, hi, agg, bitmap);
+}
+
+bool have_hw() { return false; }
+
+const char *hw_name() { return "scalar"; }
+#endif
+
+}  // namespace
+
+void ScanFilterAggregate(const int32_t *values, size_t n, const scan_predicate &pred, scan_agg *agg,
+                         uint64_t *bitmap) {
+    if (have_hw())
+        scan_hw(values, n, pred.lo, pred.hi, agg, bitmap);
+    else
+        scan_sw(values, n, pred.lo, pred.hi, agg, bitmap);
+}
+
+const char *ScanKernelName() { return have_hw() ? hw_name() : "scalar"; }
+
+}  // namespace doca
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace doca {
+
+/* Rows with lo <= value <= hi match */
+struct scan_predicate {
+    int32_t lo = INT32_MIN;
+    int32_t hi = INT32_MAX;
+};
+
+/* Aggregates over the matching rows */
+struct scan_agg {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t min = INT32_MAX; /* INT32_MAX and INT32_MIN while count is 0 */
+    int32_t max = INT32_MIN;
+
+    void Merge(const scan_agg &other);
+};
+
+/*
+ * Filter n values of a 32-bit column and fold the matches into agg. With a
+ * bitmap, bit i % 64 of word i / 64 is set if row i matches; (n + 63) / 64
+ * words are written. Uses the CPU's vector unit when it has one (AVX2, NEON,
+ * SVE), plain C otherwise.
+ */
+void ScanFilterAggregate(const int32_t *values, size_t n, const scan_predicate &pred, scan_agg *agg,
+                         uint64_t *bitmap);
+
+/* Name of the kernel ScanFilterAggregate runs on this CPU */
+const char *ScanKernelName();
+
+}  // namespace doca
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+namespace doca {
+
+/* Monotonic timestamp in nanoseconds, used for all latency samples */
+inline uint64_t NowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* CPU time consumed by the calling thread in nanoseconds, to tell busy time from wall time */
+inline uint64_t ThreadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+}  // namespace doca
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace doca {
+
+/*
+ * Add to a counter that only one thread writes while others may read it. A
+ * relaxed load and store is enough then, and keeps the writer off a locked add.
+ */
+inline void CounterAdd(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+}  // namespace doca
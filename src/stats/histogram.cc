@@ -0,0 +1,100 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "counter.h"
+
+namespace doca {
+
+/* Buckets [0, 2 * SUB) are exact, every further power of two adds SUB buckets */
+static constexpr size_t HIST_NUM_BUCKETS =
+    (65 - LatencyHistogram::HIST_SUB_BUCKET_BITS) * LatencyHistogram::HIST_SUB_BUCKETS;
+
+LatencyHistogram::LatencyHistogram() : counts(HIST_NUM_BUCKETS, 0) { Reset(); }
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+    if (value < 2 * HIST_SUB_BUCKETS) return value;
+
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HIST_SUB_BUCKET_BITS;
+    return (shift + 1) * HIST_SUB_BUCKETS + ((value >> shift) - HIST_SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::BucketUpper(size_t index) {
+    if (index < 2 * HIST_SUB_BUCKETS) return index;
+
+    int shift = index / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = index % HIST_SUB_BUCKETS + HIST_SUB_BUCKETS;
+    /* Wraps to UINT64_MAX for the topmost bucket */
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+    counts[BucketIndex(value)]++;
+    count++;
+    sum += value;
+    if (value < min) min = value;
+    if (value > max) max = value;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < counts.size(); i++) counts[i] += other.counts[i];
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    count = 0;
+    min = std::numeric_limits<uint64_t>::max();
+    max = 0;
+    sum = 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+    if (count == 0) return 0;
+
+    uint64_t target = (uint64_t)(p / 100.0 * count + 0.5);
+    if (target < 1) target = 1;
+    if (target > count) target = count;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= target) return std::min(std::max(BucketUpper(i), Min()), max);
+    }
+
+    return max;
+}
+
+ConcurrentHistogram::ConcurrentHistogram() : counts(HIST_NUM_BUCKETS) { Reset(); }
+
+void ConcurrentHistogram::Record(uint64_t value) {
+    CounterAdd(counts[LatencyHistogram::BucketIndex(value)], 1);
+    CounterAdd(sum, value);
+    if (value < min.load(std::memory_order_relaxed)) min.store(value, std::memory_order_relaxed);
+    if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+}
+
+void ConcurrentHistogram::Reset() {
+    for (auto &c : counts) c.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+void ConcurrentHistogram::Snapshot(LatencyHistogram *out) const {
+    out->count = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        out->counts[i] = counts[i].load(std::memory_order_relaxed);
+        out->count += out->counts[i];
+    }
+    out->sum = sum.load(std::memory_order_relaxed);
+    out->min = min.load(std::memory_order_relaxed);
+    out->max = max.load(std::memory_order_relaxed);
+}
+
+}  // namespace doca
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+namespace doca {
+
+/*
+ * HDR-style log-bucketed histogram. Values below 2 * HIST_SUB_BUCKETS are
+ * recorded exactly, larger values land in one of HIST_SUB_BUCKETS linear
+ * sub-buckets of their power-of-two range, so the relative error of any
+ * reported value is bounded by 1 / HIST_SUB_BUCKETS.
+ */
+class LatencyHistogram {
+    friend class ConcurrentHistogram;
+
+   public:
+    static constexpr int HIST_SUB_BUCKET_BITS = 6;
+    static constexpr uint64_t HIST_SUB_BUCKETS = 1ull << HIST_SUB_BUCKET_BITS;
+
+    LatencyHistogram();
+
+    void Record(uint64_t value);
+    void Merge(const LatencyHistogram &other);
+    void Reset();
+
+    uint64_t Count() const { return count; }
+    uint64_t Min() const { return count ? min : 0; }
+    uint64_t Max() const { return max; }
+    double Mean() const { return count ? sum / count : 0.0; }
+    /* Smallest recorded bucket value such that p percent (0-100) of the samples are at or below it */
+    uint64_t Percentile(double p) const;
+
+   protected:
+    std::vector<uint64_t> counts;
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpper(size_t index);
+};
+
+/*
+ * LatencyHistogram with the same buckets that one thread records into while
+ * others take snapshots. Recording is a handful of relaxed loads and stores,
+ * no read-modify-write; a snapshot may miss samples recorded concurrently.
+ */
+class ConcurrentHistogram {
+   public:
+    ConcurrentHistogram();
+
+    /* Owner thread only */
+    void Record(uint64_t value);
+    void Reset();
+    /* Any thread */
+    void Snapshot(LatencyHistogram *out) const;
+
+   protected:
+    std::vector<std::atomic<uint64_t>> counts;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+};
+
+}  // namespace doca
@@ -0,0 +1,179 @@
+#include "perf_counters.h"
+
+#include <doca_log.h>
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(PERF);
+
+/* Layout of a PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING | ID read */
+struct perf_group_read {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    struct {
+        uint64_t value;
+        uint64_t id;
+    } values[PERF_NUM_COUNTERS];
+};
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} counter_events[PERF_NUM_COUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+const char *PerfCounterName(perf_counter counter) {
+    switch (counter) {
+        case PERF_CYCLES:
+            return "cycles";
+        case PERF_INSTRUCTIONS:
+            return "instructions";
+        case PERF_CACHE_MISSES:
+            return "cache_misses";
+        case PERF_CONTEXT_SWITCHES:
+            return "ctx_switches";
+        default:
+            return "unknown";
+    }
+}
+
+double perf_sample::PerOp(perf_counter counter, uint64_t ops) const {
+    return ops ? (double)values[counter] / ops : 0.0;
+}
+
+double perf_sample::Ipc() const {
+    if (!valid[PERF_CYCLES] || !valid[PERF_INSTRUCTIONS] || values[PERF_CYCLES] == 0) return 0.0;
+    return (double)values[PERF_INSTRUCTIONS] / values[PERF_CYCLES];
+}
+
+void perf_sample::Merge(const perf_sample &other) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        values[i] += other.values[i];
+        valid[i] = valid[i] || other.valid[i];
+    }
+}
+
+void perf_sample::Format(uint64_t ops, char *buf, size_t len) const {
+    size_t off = 0;
+
+    for (int i = 0; i < PERF_NUM_COUNTERS && off < len; i++) {
+        if (valid[i])
+            off += snprintf(buf + off, len - off, "%s%s/op %.2f", i ? ", " : "", PerfCounterName((perf_counter)i),
+                            PerOp((perf_counter)i, ops));
+        else
+            off += snprintf(buf + off, len - off, "%s%s/op n/a", i ? ", " : "", PerfCounterName((perf_counter)i));
+    }
+    if (off < len && valid[PERF_CYCLES] && valid[PERF_INSTRUCTIONS])
+        snprintf(buf + off, len - off, ", IPC %.2f", Ipc());
+}
+
+PerfCounters::~PerfCounters() { Close(); }
+
+/*
+ * Open one counter of the calling thread, disabled until Start
+ *
+ * @counter [in]: Counter to open
+ * @group_fd [in]: Group leader, -1 to open a new group
+ * @return: file descriptor, -1 with errno set on failure
+ */
+static int open_counter(perf_counter counter, int group_fd) {
+    struct perf_event_attr attr;
+    int fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_events[counter].type;
+    attr.config = counter_events[counter].config;
+    attr.disabled = group_fd < 0;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING |
+                       PERF_FORMAT_ID;
+
+    fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    if (fd < 0 && errno == EACCES) {
+        /* perf_event_paranoid >= 2 without CAP_PERFMON: user space only */
+        attr.exclude_kernel = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+    return fd;
+}
+
+doca_error_t PerfCounters::Open() {
+    Close();
+
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        fds[i] = open_counter((perf_counter)i, leader);
+        if (fds[i] < 0) {
+            DOCA_LOG_DBG("Counter %s unavailable: %s", PerfCounterName((perf_counter)i), strerror(errno));
+            continue;
+        }
+        if (ioctl(fds[i], PERF_EVENT_IOC_ID, &ids[i]) != 0) {
+            DOCA_LOG_ERR("Failed to get id of counter %s: %s", PerfCounterName((perf_counter)i), strerror(errno));
+            close(fds[i]);
+            fds[i] = -1;
+            continue;
+        }
+        if (leader < 0) leader = fds[i];
+    }
+
+    if (leader < 0) {
+        DOCA_LOG_WARN("No performance counter available, check perf_event_paranoid");
+        return DOCA_ERROR_NOT_SUPPORTED;
+    }
+    return DOCA_SUCCESS;
+}
+
+void PerfCounters::Close() {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (fds[i] >= 0) close(fds[i]);
+        fds[i] = -1;
+    }
+    leader = -1;
+}
+
+void PerfCounters::Start() {
+    if (leader < 0) return;
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+doca_error_t PerfCounters::Stop(perf_sample *sample) {
+    struct perf_group_read data;
+    double scale = 1.0;
+
+    *sample = perf_sample();
+    if (leader < 0) return DOCA_ERROR_BAD_STATE;
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(leader, &data, sizeof(data)) < (ssize_t)(3 * sizeof(uint64_t))) {
+        DOCA_LOG_ERR("Failed to read performance counters: %s", strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    /* The group is scheduled as a whole; if the PMU was shared it ran only part of the time */
+    if (data.time_running > 0 && data.time_running < data.time_enabled)
+        scale = (double)data.time_enabled / data.time_running;
+
+    for (uint64_t n = 0; n < data.nr && n < PERF_NUM_COUNTERS; n++) {
+        for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+            if (fds[i] < 0 || ids[i] != data.values[n].id) continue;
+            sample->values[i] = (uint64_t)(data.values[n].value * scale);
+            sample->valid[i] = true;
+        }
+    }
+    return DOCA_SUCCESS;
+}
+
+}  // namespace doca
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <doca_error.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace doca {
+
+enum perf_counter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_CONTEXT_SWITCHES,
+    PERF_NUM_COUNTERS,
+};
+
+/* Counter deltas over one measured region, see PerfCounters::Stop */
+struct perf_sample {
+    uint64_t values[PERF_NUM_COUNTERS] = {};
+    bool valid[PERF_NUM_COUNTERS] = {}; /* Counter could be opened on this machine */
+
+    double PerOp(perf_counter counter, uint64_t ops) const;
+    /* Instructions per cycle, 0 if either counter is missing */
+    double Ipc() const;
+    /* Accumulate the deltas of another region or thread */
+    void Merge(const perf_sample &other);
+    /*
+     * One line of per-operation figures for the log, missing counters are
+     * printed as "n/a".
+     *
+     * @ops [in]: Operations in the measured region
+     * @buf [out]: Text buffer
+     * @len [in]: Size of buf
+     */
+    void Format(uint64_t ops, char *buf, size_t len) const;
+};
+
+const char *PerfCounterName(perf_counter counter);
+
+/*
+ * Group of CPU performance counters around a measured region of the calling
+ * thread, read with perf_event_open. Counters the kernel or the machine does
+ * not provide (no PMU in a VM, perf_event_paranoid) are left out of the group
+ * and reported as invalid, so benchmarks still run. Kernel time is counted
+ * when permitted, to include the syscalls of sleep wait policies.
+ *
+ * Open on the thread to be measured; counters do not follow the region into
+ * other threads.
+ */
+class PerfCounters {
+   public:
+    PerfCounters() = default;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /* DOCA_ERROR_NOT_SUPPORTED if no counter at all could be opened */
+    doca_error_t Open();
+    void Close();
+    bool IsOpen() const { return leader >= 0; }
+
+    /* Reset and enable the group; Stop disables it and reads the deltas */
+    void Start();
+    doca_error_t Stop(perf_sample *sample);
+
+   protected:
+    int leader = -1;
+    int fds[PERF_NUM_COUNTERS] = {-1, -1, -1, -1};
+    uint64_t ids[PERF_NUM_COUNTERS] = {};
+};
+
+}  // namespace doca
@@ -0,0 +1,152 @@
+#include "report.h"
+
+#include <doca_log.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+namespace doca {
+
+DOCA_LOG_REGISTER(REPORT);
+
+/* Write str as the contents of a JSON string, escaping quotes, backslashes and control characters */
+static void json_escape(FILE *file, const std::string &str) {
+    for (unsigned char c : str) {
+        if (c == '"' || c == '\\')
+            fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(file, "\\u%04x", c);
+        else
+            fputc(c, file);
+    }
+}
+
+ReportWriter::~ReportWriter() { Close(); }
+
+doca_error_t ReportWriter::Open(const char *path) {
+    size_t len = strlen(path);
+    bool is_json = len >= 5 && strcmp(path + len - 5, ".json") == 0;
+    return Open(path, is_json ? REPORT_FORMAT_JSON : REPORT_FORMAT_CSV);
+}
+
+doca_error_t ReportWriter::Open(const char *path, report_format fmt) {
+    Close();
+
+    file = fopen(path, "w");
+    if (!file) {
+        DOCA_LOG_ERR("Failed to open report file %s: %s", path, strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+
+    this->fmt = fmt;
+    rows = 0;
+    row.clear();
+    if (fmt == REPORT_FORMAT_JSON) fputs("[\n", file);
+    return DOCA_SUCCESS;
+}
+
+void ReportWriter::Close() {
+    if (!file) return;
+    if (fmt == REPORT_FORMAT_JSON) fputs(rows ? "\n]\n" : "]\n", file);
+    fclose(file);
+    file = nullptr;
+}
+
+ReportWriter &ReportWriter::Add(const char *key, const char *value) {
+    row.emplace_back(key, std::make_pair(std::string(value), true));
+    return *this;
+}
+
+ReportWriter &ReportWriter::Add(const char *key, uint64_t value) {
+    row.emplace_back(key, std::make_pair(std::to_string(value), false));
+    return *this;
+}
+
+ReportWriter &ReportWriter::Add(const char *key, int64_t value) {
+    row.emplace_back(key, std::make_pair(std::to_string(value), false));
+    return *this;
+}
+
+ReportWriter &ReportWriter::Add(const char *key, double value) {
+    char buf[32] = "";
+    /* NaN and infinity are not JSON numbers, left empty like other unavailable values */
+    if (isfinite(value)) snprintf(buf, sizeof(buf), "%.3f", value);
+    row.emplace_back(key, std::make_pair(std::string(buf), false));
+    return *this;
+}
+
+ReportWriter &ReportWriter::AddHistogram(const char *prefix, const LatencyHistogram &hist) {
+    std::string p(prefix);
+    Add((p + "count").c_str(), hist.Count());
+    Add((p + "min_ns").c_str(), hist.Min());
+    Add((p + "mean_ns").c_str(), hist.Mean());
+    Add((p + "p50_ns").c_str(), hist.Percentile(50.0));
+    Add((p + "p99_ns").c_str(), hist.Percentile(99.0));
+    Add((p + "p999_ns").c_str(), hist.Percentile(99.9));
+    Add((p + "max_ns").c_str(), hist.Max());
+    return *this;
+}
+
+ReportWriter &ReportWriter::AddSummary(const char *prefix, const TrialSummary &summary) {
+    std::string p(prefix);
+    Add((p + "mean").c_str(), summary.Mean());
+    Add((p + "stddev").c_str(), summary.Stddev());
+    Add((p + "ci95").c_str(), summary.Ci95());
+    return *this;
+}
+
+ReportWriter &ReportWriter::AddPerf(const char *prefix, const perf_sample &sample, uint64_t ops) {
+    std::string p(prefix);
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        std::string key = p + PerfCounterName((perf_counter)i) + "_per_op";
+        if (sample.valid[i])
+            Add(key.c_str(), sample.PerOp((perf_counter)i, ops));
+        else
+            Add(key.c_str(), "");
+    }
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS])
+        Add((p + "ipc").c_str(), sample.Ipc());
+    else
+        Add((p + "ipc").c_str(), "");
+    return *this;
+}
+
+doca_error_t ReportWriter::EndRow() {
+    if (!file) {
+        row.clear();
+        return DOCA_ERROR_BAD_STATE;
+    }
+
+    if (fmt == REPORT_FORMAT_CSV) {
+        if (rows == 0) {
+            for (size_t i = 0; i < row.size(); i++) fprintf(file, "%s%s", i ? "," : "", row[i].first.c_str());
+            fputc('\n', file);
+        }
+        for (size_t i = 0; i < row.size(); i++) fprintf(file, "%s%s", i ? "," : "", row[i].second.first.c_str());
+        fputc('\n', file);
+    } else {
+        fputs(rows ? ",\n  {" : "  {", file);
+        for (size_t i = 0; i < row.size(); i++) {
+            fprintf(file, "%s\"", i ? ", " : "");
+            json_escape(file, row[i].first);
+            fputs("\": ", file);
+            if (row[i].second.second) {
+                fputc('"', file);
+                json_escape(file, row[i].second.first);
+                fputc('"', file);
+            } else if (row[i].second.first.empty()) {
+                fputs("null", file);
+            } else {
+                fputs(row[i].second.first.c_str(), file);
+            }
+        }
+        fputc('}', file);
+    }
+
+    fflush(file);
+    rows++;
+    row.clear();
+    return DOCA_SUCCESS;
+}
+
+}  // namespace doca
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <doca_error.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "histogram.h"
+#include "perf_counters.h"
+#include "summary.h"
+
+namespace doca {
+
+enum report_format { REPORT_FORMAT_CSV, REPORT_FORMAT_JSON };
+
+/*
+ * Row oriented writer for machine readable benchmark results. Every row is a
+ * set of key/value columns; the CSV header is taken from the first row, the
+ * JSON output is an array with one object per row.
+ */
+class ReportWriter {
+   public:
+    ReportWriter() = default;
+    ~ReportWriter();
+
+    /* Format is JSON if path ends with ".json", CSV otherwise */
+    doca_error_t Open(const char *path);
+    doca_error_t Open(const char *path, report_format fmt);
+    void Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    ReportWriter &Add(const char *key, const char *value);
+    ReportWriter &Add(const char *key, uint64_t value);
+    ReportWriter &Add(const char *key, int64_t value);
+    ReportWriter &Add(const char *key, double value);
+    /* Adds count/min/mean/p50/p99/p99.9/max columns, each prefixed with prefix */
+    ReportWriter &AddHistogram(const char *prefix, const LatencyHistogram &hist);
+    /* Adds mean/stddev/ci95 columns, each prefixed with prefix */
+    ReportWriter &AddSummary(const char *prefix, const TrialSummary &summary);
+    /* Adds <counter>_per_op and ipc columns, each prefixed with prefix; unavailable counters are left empty */
+    ReportWriter &AddPerf(const char *prefix, const perf_sample &sample, uint64_t ops);
+    doca_error_t EndRow();
+
+   protected:
+    FILE *file = nullptr;
+    report_format fmt;
+    size_t rows = 0;
+    /* key, rendered value, whether value needs quoting in JSON; an empty unquoted value is null in JSON */
+    std::vector<std::pair<std::string, std::pair<std::string, bool>>> row;
+};
+
+}  // namespace doca
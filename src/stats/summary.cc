@@ -0,0 +1,37 @@
+#include "summary.h"
+
+#include <math.h>
+
+namespace doca {
+
+/* Two-sided 97.5% quantiles of Student's t for 1 to 30 degrees of freedom */
+static const double t_975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                               2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                               2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+double TrialSummary::Mean() const {
+    double sum = 0.0;
+
+    if (samples.empty()) return 0.0;
+    for (double v : samples) sum += v;
+    return sum / samples.size();
+}
+
+double TrialSummary::Stddev() const {
+    double mean = Mean(), sq = 0.0;
+
+    if (samples.size() < 2) return 0.0;
+    for (double v : samples) sq += (v - mean) * (v - mean);
+    return sqrt(sq / (samples.size() - 1));
+}
+
+double TrialSummary::Ci95() const {
+    size_t dof = samples.size() - 1;
+    double t;
+
+    if (samples.size() < 2) return 0.0;
+    t = dof <= sizeof(t_975) / sizeof(t_975[0]) ? t_975[dof - 1] : 1.960;
+    return t * Stddev() / sqrt(samples.size());
+}
+
+}  // namespace doca
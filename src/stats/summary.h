@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace doca {
+
+/*
+ * Summary of a metric over repeated trials: mean, sample standard deviation
+ * and the half width of a two-sided 95% confidence interval for the mean,
+ * using Student's t distribution so that small trial counts are not
+ * reported with false precision.
+ */
+class TrialSummary {
+   public:
+    void Add(double value) { samples.push_back(value); }
+    void Reset() { samples.clear(); }
+
+    size_t Count() const { return samples.size(); }
+    double Mean() const;
+    double Stddev() const;
+    /* Half width of the 95% confidence interval, 0 with fewer than two trials */
+    double Ci95() const;
+
+   protected:
+    std::vector<double> samples;
+};
+
+}  // namespace doca
@@ -0,0 +1,371 @@
+#include "dirty_sync.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+
+#define PAGEMAP_SOFT_DIRTY (1ULL << 55) /* Soft-dirty bit of a /proc/self/pagemap entry */
+#define CLEAR_REFS_SOFT_DIRTY "4"        /* Clears the soft-dirty bits of all the process' pages */
+
+namespace doca {
+
+DOCA_LOG_REGISTER(DIRTY_SYNC);
+
+DirtyTracker::DirtyTracker(MemMap &region, size_t page_size, dirty_track_mode mode)
+    : region(region), page_size(page_size), mode(mode) {
+    size_t sys_page = sysconf(_SC_PAGESIZE);
+
+    if (page_size == 0 || region.Len() == 0) {
+        DOCA_LOG_ERR("Invalid dirty tracking of %zu bytes in pages of %zu bytes", region.Len(), page_size);
+        throw std::runtime_error("Invalid dirty tracking settings");
+    }
+    nb_pages = (region.Len() + page_size - 1) / page_size;
+    nb_words = (nb_pages + 63) / 64;
+    if (nb_words > UINT32_MAX) throw std::runtime_error("Dirty bitmap too large");
+
+    bitmap.reset(new std::atomic<uint64_t>[nb_words]);
+    for (size_t i = 0; i < nb_words; i++) bitmap[i].store(0, std::memory_order_relaxed);
+    pending.resize(nb_words);
+    /* The DPU mirror starts out empty */
+    MarkDirty(0, region.Len());
+
+    if (mode != DIRTY_TRACK_SOFT_DIRTY) return;
+
+    pagemap_fd = open("/proc/self/pagemap", O_RDONLY);
+    clear_refs_fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (pagemap_fd < 0 || clear_refs_fd < 0) {
+        DOCA_LOG_ERR("Failed to open the pagemap interface: %s", strerror(errno));
+        CloseSoftDirty();
+        throw std::runtime_error("Soft-dirty tracking unavailable");
+    }
+
+    /* Kernels built without CONFIG_MEM_SOFT_DIRTY accept clear_refs but never set the bit */
+    std::unique_ptr<char, decltype(&free)> probe((char *)aligned_alloc(sys_page, sys_page), free);
+    uint64_t entry = 0;
+
+    probe.get()[0] = 0;
+    if (ClearSoftDirty() == DOCA_SUCCESS) {
+        *(volatile char *)probe.get() = 1;
+        if (pread(pagemap_fd, &entry, sizeof(entry), (uintptr_t)probe.get() / sys_page * sizeof(entry)) !=
+            sizeof(entry))
+            entry = 0;
+    }
+    if (!(entry & PAGEMAP_SOFT_DIRTY)) {
+        DOCA_LOG_ERR("The kernel does not report soft-dirty pages, use explicit dirty marking");
+        CloseSoftDirty();
+        throw std::runtime_error("Soft-dirty tracking unavailable");
+    }
+}
+
+DirtyTracker::~DirtyTracker() { CloseSoftDirty(); }
+
+void DirtyTracker::CloseSoftDirty() {
+    if (pagemap_fd >= 0) close(pagemap_fd);
+    if (clear_refs_fd >= 0) close(clear_refs_fd);
+    pagemap_fd = clear_refs_fd = -1;
+}
+
+void DirtyTracker::MarkDirty(size_t offset, size_t len) {
+    size_t first, last;
+
+    if (len == 0 || offset >= region.Len()) return;
+    len = std::min(len, region.Len() - offset);
+    first = offset / page_size;
+    last = (offset + len - 1) / page_size;
+
+    for (size_t page = first; page <= last;) {
+        size_t word = page / 64, bit = page % 64;
+        size_t count = std::min<size_t>(64 - bit, last - page + 1);
+        uint64_t mask = count == 64 ? ~0ULL : ((1ULL << count) - 1) << bit;
+
+        bitmap[word].fetch_or(mask, std::memory_order_relaxed);
+        page += count;
+    }
+}
+
+size_t DirtyTracker::DirtyPages() const {
+    size_t count = 0;
+
+    for (size_t i = 0; i < nb_words; i++) count += __builtin_popcountll(bitmap[i].load(std::memory_order_relaxed));
+    return count;
+}
+
+doca_error_t DirtyTracker::Sync(CommEndpoint &ch) {
+    doca_error_t result;
+    size_t pages = 0;
+
+    if (mode == DIRTY_TRACK_SOFT_DIRTY) {
+        result = CollectSoftDirty();
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    for (size_t i = 0; i < nb_words; i++) {
+        pending[i] = bitmap[i].exchange(0, std::memory_order_relaxed);
+        pages += __builtin_popcountll(pending[i]);
+    }
+
+    result = SendBitmap(ch);
+    if (result == DOCA_SUCCESS) result = ch.WaitForSuccessfulMsg();
+    if (result != DOCA_SUCCESS) {
+        /* Nothing is known to have reached the mirror, the next sync retries it all */
+        for (size_t i = 0; i < nb_words; i++) bitmap[i].fetch_or(pending[i], std::memory_order_relaxed);
+        DOCA_LOG_ERR("Sync of %zu dirty pages failed: %s", pages, doca_get_error_string(result));
+        return result;
+    }
+
+    counters.syncs++;
+    counters.dirty_pages += pages;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t DirtyTracker::Close(CommEndpoint &ch) {
+    dirty_msg_hdr hdr = {(uint32_t)page_size, 0, 0, DIRTY_MSG_CLOSE};
+
+    return ch.SendTo(&hdr, sizeof(hdr));
+}
+
+doca_error_t DirtyTracker::SendBitmap(CommEndpoint &ch) {
+    size_t capacity = (ch.MaxPayload() - sizeof(dirty_msg_hdr)) / sizeof(uint64_t);
+    size_t first = 0, end, next;
+    dirty_msg_hdr hdr;
+    doca_error_t result;
+
+    capacity = std::min<size_t>(capacity, UINT16_MAX);
+    msg.resize(sizeof(hdr) + capacity * sizeof(uint64_t));
+
+    while (first < nb_words && pending[first] == 0) first++;
+    do {
+        /* One message covers up to capacity words from the first dirty one, trailing clean words dropped */
+        end = std::min(first + capacity, nb_words);
+        while (end > first && pending[end - 1] == 0) end--;
+        next = end;
+        while (next < nb_words && pending[next] == 0) next++;
+
+        hdr.page_size = page_size;
+        hdr.first_word = first;
+        hdr.nb_words = end - first;
+        hdr.flags = next == nb_words ? DIRTY_MSG_LAST : 0;
+        memcpy(msg.data(), &hdr, sizeof(hdr));
+        memcpy(msg.data() + sizeof(hdr), pending.data() + first, (end - first) * sizeof(uint64_t));
+
+        result = ch.SendTo(msg.data(), sizeof(hdr) + (end - first) * sizeof(uint64_t));
+        if (result != DOCA_SUCCESS) return result;
+        counters.messages++;
+        counters.wire_bytes += sizeof(hdr) + (end - first) * sizeof(uint64_t);
+        first = next;
+    } while (first < nb_words);
+
+    return DOCA_SUCCESS;
+}
+
+doca_error_t DirtyTracker::CollectSoftDirty() {
+    size_t sys_page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)region.Data() / sys_page;
+    uintptr_t end = ((uintptr_t)region.Data() + region.Len() - 1) / sys_page + 1;
+    std::vector<uint64_t> entries(std::min<size_t>(end - start, 4096));
+    uintptr_t base, addr;
+    ssize_t n;
+
+    for (base = start; base < end; base += entries.size()) {
+        size_t count = std::min<size_t>(entries.size(), end - base);
+
+        n = pread(pagemap_fd, entries.data(), count * sizeof(uint64_t), base * sizeof(uint64_t));
+        if (n != (ssize_t)(count * sizeof(uint64_t))) {
+            DOCA_LOG_ERR("Failed to read the pagemap: %s", n < 0 ? strerror(errno) : "short read");
+            return DOCA_ERROR_IO_FAILED;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!(entries[i] & PAGEMAP_SOFT_DIRTY)) continue;
+            /* The system page may stick out of the region on either side */
+            addr = std::max((base + i) * sys_page, (uintptr_t)region.Data());
+            MarkDirty(addr - (uintptr_t)region.Data(), (base + i + 1) * sys_page - addr);
+        }
+    }
+
+    return ClearSoftDirty();
+}
+
+doca_error_t DirtyTracker::ClearSoftDirty() {
+    if (pwrite(clear_refs_fd, CLEAR_REFS_SOFT_DIRTY, 1, 0) != 1) {
+        DOCA_LOG_ERR("Failed to clear soft-dirty bits: %s", strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+    return DOCA_SUCCESS;
+}
+
+DirtyMirror::DirtyMirror(DOCADma<Dpu> &dma, MemMap &remote, MemMap &mirror, const dirty_mirror_attr &attr)
+    : dma(dma), remote(remote), mirror(mirror), attr(attr) {
+    if (mirror.Len() < remote.Len()) {
+        DOCA_LOG_ERR("Mirror of %zu bytes cannot hold the remote region of %zu bytes", mirror.Len(), remote.Len());
+        throw std::runtime_error("Mirror smaller than the remote region");
+    }
+    if (this->attr.max_job == 0 || this->attr.max_job > dma.MaxBufSize()) this->attr.max_job = dma.MaxBufSize();
+}
+
+doca_error_t DirtyMirror::ServeSync(CommEndpoint &ch, bool *closed) {
+    doca_error_t result, error = DOCA_SUCCESS;
+    dirty_msg_hdr hdr;
+    uint64_t start = 0, word;
+    const uint64_t *words;
+    size_t len;
+
+    *closed = false;
+    msg.resize(ch.MaxPayload());
+    has_run = false;
+    job_error = DOCA_SUCCESS;
+
+    do {
+        len = msg.size();
+        result = ch.RecvFrom(msg.data(), &len);
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive dirty bitmap: %s", doca_get_error_string(result));
+            Reap(true);
+            return result;
+        }
+        if (start == 0) start = NowNs();
+        result = CheckHeader(*(dirty_msg_hdr *)msg.data(), len);
+        if (result != DOCA_SUCCESS) {
+            Reap(true);
+            ch.SendFailMsg();
+            return result;
+        }
+        memcpy(&hdr, msg.data(), sizeof(hdr));
+        if (hdr.flags & DIRTY_MSG_CLOSE) {
+            *closed = true;
+            Reap(true);
+            return DOCA_SUCCESS;
+        }
+        counters.messages++;
+        counters.wire_bytes += len;
+
+        /* After a failure keep draining the sync's messages, the host waits for the final status */
+        words = (const uint64_t *)(msg.data() + sizeof(hdr));
+        for (size_t i = 0; i < hdr.nb_words && error == DOCA_SUCCESS; i++) {
+            for (word = words[i]; word != 0 && error == DOCA_SUCCESS; word &= word - 1)
+                error = AddPage((size_t)(hdr.first_word + i) * 64 + __builtin_ctzll(word));
+        }
+        /* Let jobs finish while the next message is in flight */
+        Reap(false);
+    } while (!(hdr.flags & DIRTY_MSG_LAST));
+
+    if (error == DOCA_SUCCESS) error = FlushRun();
+    Reap(true);
+    if (error == DOCA_SUCCESS) error = job_error;
+
+    counters.busy_ns += NowNs() - start;
+    if (error != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Sync failed: %s", doca_get_error_string(error));
+        ch.SendFailMsg();
+        return error;
+    }
+    counters.syncs++;
+    return ch.SendSuccessfulMsg();
+}
+
+doca_error_t DirtyMirror::CheckHeader(const dirty_msg_hdr &hdr, size_t len) {
+    if (len < sizeof(hdr) || len != sizeof(hdr) + hdr.nb_words * sizeof(uint64_t)) {
+        DOCA_LOG_ERR("Malformed dirty bitmap message of %zu bytes", len);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (page_size == 0) {
+        if (hdr.page_size == 0) {
+            DOCA_LOG_ERR("Dirty bitmap with a page size of 0");
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+        page_size = hdr.page_size;
+        nb_words = ((remote.Len() + page_size - 1) / page_size + 63) / 64;
+    }
+    if (hdr.page_size != page_size || (size_t)hdr.first_word + hdr.nb_words > nb_words) {
+        DOCA_LOG_ERR("Dirty bitmap words %u-%u of %u byte pages do not fit the region (%zu words of %zu byte pages)",
+                     hdr.first_word, hdr.first_word + hdr.nb_words, hdr.page_size, nb_words, page_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t DirtyMirror::AddPage(size_t page) {
+    doca_error_t result;
+
+    if ((size_t)page * page_size >= remote.Len()) {
+        DOCA_LOG_ERR("Dirty page %zu lies beyond the region of %zu bytes", page, remote.Len());
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    counters.dirty_pages++;
+    if (has_run && page <= run_last + attr.merge_gap + 1) {
+        run_last = page;
+        return DOCA_SUCCESS;
+    }
+    result = FlushRun();
+    has_run = true;
+    run_first = run_last = page;
+    return result;
+}
+
+doca_error_t DirtyMirror::FlushRun() {
+    size_t offset, end, len;
+    doca_error_t result;
+
+    if (!has_run) return DOCA_SUCCESS;
+    has_run = false;
+    offset = run_first * page_size;
+    end = std::min((run_last + 1) * page_size, remote.Len());
+
+    for (; offset < end; offset += len) {
+        len = std::min(end - offset, attr.max_job);
+        result = SubmitCopy(offset, len);
+        if (result != DOCA_SUCCESS) return result;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t DirtyMirror::SubmitCopy(size_t offset, size_t len) {
+    doca_error_t result;
+    size_t inflight;
+    void *user_data;
+
+    while ((result = dma.Submit(remote, offset, mirror, offset, len, nullptr)) == DOCA_ERROR_AGAIN) {
+        /* Work queue full, make room */
+        inflight = dma.Inflight();
+        result = dma.Poll(&user_data);
+        if (result == DOCA_SUCCESS || result == DOCA_ERROR_AGAIN) continue;
+        if (job_error == DOCA_SUCCESS) job_error = result;
+        /* The retrieve itself failed and no job came back, room would never be made */
+        if (dma.Inflight() == inflight) break;
+    }
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to submit copy of %zu bytes at offset %zu: %s", len, offset,
+                     doca_get_error_string(result));
+        return result;
+    }
+    counters.dma_jobs++;
+    counters.copied_bytes += len;
+    return DOCA_SUCCESS;
+}
+
+void DirtyMirror::Reap(bool wait) {
+    doca_error_t result;
+    size_t inflight;
+    void *user_data;
+
+    while ((inflight = dma.Inflight()) > 0) {
+        result = dma.Poll(&user_data);
+        if (result == DOCA_ERROR_AGAIN) {
+            if (!wait) return;
+            continue;
+        }
+        if (result == DOCA_SUCCESS) continue;
+        if (job_error == DOCA_SUCCESS) job_error = result;
+        /* The retrieve itself failed and no job came back, waiting for the rest would never end */
+        if (dma.Inflight() == inflight) return;
+    }
+}
+
+}  // namespace doca
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../chan/comm_channel.h"
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+namespace doca {
+
+/* How the host learns which pages of the region were written */
+enum dirty_track_mode {
+    DIRTY_TRACK_EXPLICIT,   /* Writers call MarkDirty */
+    DIRTY_TRACK_SOFT_DIRTY, /* Kernel soft-dirty bits of /proc/self/pagemap, writers need not cooperate */
+};
+
+enum dirty_msg_flags {
+    DIRTY_MSG_LAST = 1 << 0,  /* Last bitmap message of a sync, the DPU acks once its copies are done */
+    DIRTY_MSG_CLOSE = 1 << 1, /* No further syncs, carries no bitmap */
+};
+
+/*
+ * Header of a dirty bitmap message, followed by nb_words 64-bit words of the
+ * bitmap starting at word first_word. Runs of clean words are not sent.
+ */
+struct dirty_msg_hdr {
+    uint32_t page_size;
+    uint32_t first_word;
+    uint16_t nb_words;
+    uint16_t flags;
+};
+
+/* Counters of incremental syncs, the host fills the first four, the DPU all of them */
+struct dirty_sync_stats {
+    uint64_t syncs = 0;
+    uint64_t dirty_pages = 0;
+    uint64_t messages = 0;     /* Bitmap messages on the Comm Channel */
+    uint64_t wire_bytes = 0;   /* Bitmap message bytes, headers included */
+    uint64_t dma_jobs = 0;     /* Copies after merging adjacent dirty pages */
+    uint64_t copied_bytes = 0;
+    uint64_t busy_ns = 0;      /* First bitmap message to the ack, summed over syncs */
+};
+
+/*
+ * Host side of incremental sync: which pages of an exported region changed
+ * since the last sync. Every page starts dirty, so the first Sync copies the
+ * whole region.
+ *
+ * MarkDirty may be called from any thread, also while Sync runs; pages marked
+ * after Sync took its snapshot go out with the next one. With soft-dirty
+ * tracking the bits are collected when Sync starts and cleared right after,
+ * so writers must be quiescent during Sync. clear_refs resets the whole
+ * process, at most one soft-dirty tracker may exist per process.
+ */
+class DirtyTracker {
+   public:
+    DirtyTracker(MemMap &region, size_t page_size, dirty_track_mode mode = DIRTY_TRACK_EXPLICIT);
+    ~DirtyTracker();
+    DirtyTracker(const DirtyTracker &) = delete;
+    DirtyTracker &operator=(const DirtyTracker &) = delete;
+
+    void MarkDirty(size_t offset, size_t len);
+    /* Pages currently marked, soft-dirty pages are only seen by Sync */
+    size_t DirtyPages() const;
+
+    /* Send the dirty bitmap and wait until the DPU copied the pages, failed pages stay dirty */
+    doca_error_t Sync(CommEndpoint &ch);
+    /* Tell the DPU no further syncs follow */
+    doca_error_t Close(CommEndpoint &ch);
+
+    void Snapshot(dirty_sync_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = dirty_sync_stats(); }
+
+   protected:
+    MemMap &region;
+    size_t page_size;
+    size_t nb_pages;
+    dirty_track_mode mode;
+    int pagemap_fd = -1;
+    int clear_refs_fd = -1;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> bitmap;
+    size_t nb_words;
+    std::vector<uint64_t> pending; /* Bitmap taken by the running Sync */
+    std::vector<char> msg;
+
+    dirty_sync_stats counters;
+
+    doca_error_t CollectSoftDirty();
+    doca_error_t ClearSoftDirty();
+    void CloseSoftDirty();
+    doca_error_t SendBitmap(CommEndpoint &ch);
+};
+
+/* Construction time settings of a DirtyMirror */
+struct dirty_mirror_attr {
+    uint32_t merge_gap = 0; /* Clean pages a copy may span to join two dirty runs */
+    size_t max_job = 0;     /* Largest single copy, the device limit if 0 */
+};
+
+/*
+ * DPU side of incremental sync: keeps a local mirror of a host region. Each
+ * sync turns the received bitmap into runs of dirty pages, merges adjacent
+ * ones and submits them as DMA jobs while the next bitmap message is still on
+ * the channel. The page size is the host's, taken from the first message.
+ */
+class DirtyMirror {
+   public:
+    DirtyMirror(DOCADma<Dpu> &dma, MemMap &remote, MemMap &mirror, const dirty_mirror_attr &attr = dirty_mirror_attr());
+
+    /* Serve one sync and ack it, or set *closed if the host closed instead */
+    doca_error_t ServeSync(CommEndpoint &ch, bool *closed);
+
+    void Snapshot(dirty_sync_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = dirty_sync_stats(); }
+
+   protected:
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    MemMap &mirror;
+    dirty_mirror_attr attr;
+    size_t page_size = 0;
+    size_t nb_words = 0;
+
+    /* Dirty run being extended, in pages, [run_first, run_last] */
+    bool has_run = false;
+    size_t run_first = 0;
+    size_t run_last = 0;
+    doca_error_t job_error = DOCA_SUCCESS;
+
+    std::vector<char> msg;
+    dirty_sync_stats counters;
+
+    doca_error_t CheckHeader(const dirty_msg_hdr &hdr, size_t len);
+    doca_error_t AddPage(size_t page);
+    doca_error_t FlushRun();
+    doca_error_t SubmitCopy(size_t offset, size_t len);
+    /* Reap completions, all of them if wait is set */
+    void Reap(bool wait);
+};
+
+}  // namespace doca
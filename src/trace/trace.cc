@@ -0,0 +1,133 @@
+#include "trace.h"
+
+namespace doca {
+
+const char *TraceEventName(uint32_t event) {
+    switch (event) {
+        case TRACE_DMA_SUBMIT:
+            return "dma_submit";
+        case TRACE_DMA_DOORBELL:
+            return "dma_doorbell";
+        case TRACE_DMA_POLL_MISS:
+            return "dma_poll_miss";
+        case TRACE_DMA_COMPLETE:
+            return "dma_complete";
+        case TRACE_CC_SEND:
+            return "cc_send";
+        case TRACE_CC_SEND_RETRY:
+            return "cc_send_retry";
+        case TRACE_CC_RECV:
+            return "cc_recv";
+        case TRACE_CC_RECV_MISS:
+            return "cc_recv_miss";
+        case TRACE_CC_SEND_FAIL:
+            return "cc_send_fail";
+        case TRACE_CC_RECV_FAIL:
+            return "cc_recv_fail";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace doca
+
+#ifdef DOCA_HARNESS_TRACE
+
+#include <doca_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "../stats/clock.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(TRACE);
+
+/* Rings outlive their threads so that the dump at exit sees every thread */
+static std::mutex rings_lock;
+static std::vector<TraceRing *> rings;
+static uint64_t tsc_start;
+static uint64_t ns_start;
+
+static void dump_at_exit() {
+    char path[64];
+    const char *env = getenv("DOCA_TRACE_FILE");
+
+    if (env == NULL || *env == '\0') {
+        snprintf(path, sizeof(path), "doca_trace.%d.bin", getpid());
+        env = path;
+    }
+    if (TraceDump(env)) DOCA_LOG_INFO("Trace written to %s", env);
+}
+
+TraceRing *TraceThreadRing() {
+    uint64_t nb_events = TRACE_DEFAULT_EVENTS;
+    const char *env = getenv("DOCA_TRACE_EVENTS");
+    TraceRing *ring = new TraceRing();
+
+    if (env != NULL && atoll(env) > 0) nb_events = atoll(env);
+    /* Round up to a power of two so the ring index is a mask */
+    while (nb_events & (nb_events - 1)) nb_events += nb_events & -nb_events;
+
+    ring->records = new trace_record[nb_events]();
+    ring->mask = nb_events - 1;
+    ring->head = 0;
+    ring->tid = syscall(SYS_gettid);
+
+    std::lock_guard<std::mutex> guard(rings_lock);
+    if (rings.empty()) {
+        tsc_start = TraceTsc();
+        ns_start = NowNs();
+        atexit(dump_at_exit);
+    }
+    rings.push_back(ring);
+    return ring;
+}
+
+bool TraceDump(const char *path) {
+    struct trace_file_hdr hdr = {};
+    FILE *f;
+
+    std::lock_guard<std::mutex> guard(rings_lock);
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        DOCA_LOG_ERR("Failed to open trace file %s", path);
+        return false;
+    }
+
+    hdr.magic = TRACE_FILE_MAGIC;
+    hdr.tsc_start = tsc_start;
+    hdr.ns_start = ns_start;
+    hdr.tsc_end = TraceTsc();
+    hdr.ns_end = NowNs();
+    hdr.pid = getpid();
+    hdr.nb_threads = rings.size();
+    fwrite(&hdr, sizeof(hdr), 1, f);
+
+    for (TraceRing *ring : rings) {
+        uint64_t head = ring->head;
+        uint64_t size = ring->mask + 1;
+        struct trace_thread_hdr thread = {ring->tid, head < size ? head : size, head < size ? 0 : head - size};
+
+        fwrite(&thread, sizeof(thread), 1, f);
+        /* Oldest record first: after a wrap that is the slot about to be overwritten */
+        uint64_t first = (head - thread.nb_records) & ring->mask;
+        uint64_t tail_len = std::min(thread.nb_records, size - first);
+        fwrite(&ring->records[first], sizeof(trace_record), tail_len, f);
+        fwrite(&ring->records[0], sizeof(trace_record), thread.nb_records - tail_len, f);
+    }
+
+    fclose(f);
+    return true;
+}
+
+}  // namespace doca
+
+#endif
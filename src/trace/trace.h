@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Hot-path tracepoints. Built with -DDOCA_HARNESS_TRACE=ON, every thread that
+ * hits a tracepoint gets its own ring of binary records stamped with the CPU
+ * cycle counter; the rings are written to DOCA_TRACE_FILE (doca_trace.<pid>.bin
+ * by default) at exit and turned into Chrome trace JSON by trace_dump. With the
+ * option off TRACE_EVENT expands to nothing, arguments included.
+ */
+
+enum trace_event : uint32_t {
+    TRACE_DMA_SUBMIT,    /* Job handed to the work queue, id is the job slot, value its size */
+    TRACE_DMA_DOORBELL,  /* Work queue accepted the job */
+    TRACE_DMA_POLL_MISS, /* Completion poll found nothing */
+    TRACE_DMA_COMPLETE,  /* Job completion retrieved, or the submit refused; value is the result */
+    TRACE_CC_SEND,       /* Message queued on the endpoint, value is its length */
+    TRACE_CC_SEND_RETRY, /* Send refused for lack of queue space or credits */
+    TRACE_CC_RECV,       /* Message received, value is its length */
+    TRACE_CC_RECV_MISS,  /* Receive poll found nothing */
+    TRACE_CC_SEND_FAIL,  /* Send failed for another reason than a full queue, value is the result */
+    TRACE_CC_RECV_FAIL,  /* Receive failed for another reason than an empty queue, value is the result */
+    TRACE_NUM_EVENTS,
+};
+
+/* Job slot id of the synchronous DmaCopy, past every asynchronous slot */
+#define TRACE_DMA_SYNC_JOB UINT32_MAX
+
+#define TRACE_FILE_MAGIC 0x3145434152544344ULL /* "DCTRACE1" */
+#define TRACE_DEFAULT_EVENTS (1u << 16)        /* Records per thread ring, DOCA_TRACE_EVENTS */
+
+struct trace_record {
+    uint64_t tsc;
+    uint64_t value;
+    uint32_t event;
+    uint32_t id;
+};
+
+/*
+ * Trace file layout: this header, then for every thread a trace_thread_hdr
+ * followed by its records, oldest first. Two (tsc, CLOCK_MONOTONIC ns) pairs
+ * taken at the first record and at the dump convert cycles to nanoseconds.
+ */
+struct trace_file_hdr {
+    uint64_t magic;
+    uint64_t tsc_start;
+    uint64_t ns_start;
+    uint64_t tsc_end;
+    uint64_t ns_end;
+    uint32_t pid;
+    uint32_t nb_threads;
+};
+
+struct trace_thread_hdr {
+    uint64_t tid;
+    uint64_t nb_records;
+    uint64_t dropped; /* Overwritten because the ring wrapped */
+};
+
+namespace doca {
+
+const char *TraceEventName(uint32_t event);
+
+#ifdef DOCA_HARNESS_TRACE
+
+struct TraceRing {
+    trace_record *records;
+    uint64_t mask;
+    uint64_t head;
+    uint64_t tid;
+};
+
+/* Ring of the calling thread, created and registered for the dump on first use */
+TraceRing *TraceThreadRing();
+/* Write every ring to path now; also done at exit to DOCA_TRACE_FILE */
+bool TraceDump(const char *path);
+
+inline uint64_t TraceTsc() {
+#if defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t tsc;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(tsc));
+    return tsc;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+inline void TraceRecord(uint32_t event, uint32_t id, uint64_t value) {
+    static thread_local TraceRing *ring = TraceThreadRing();
+    trace_record &r = ring->records[ring->head++ & ring->mask];
+
+    r.tsc = TraceTsc();
+    r.value = value;
+    r.event = event;
+    r.id = id;
+}
+
+#define TRACE_EVENT(event, id, value) doca::TraceRecord((event), (uint32_t)(id), (uint64_t)(value))
+
+#else
+
+#define TRACE_EVENT(event, id, value) \
+    do {                              \
+    } while (0)
+
+#endif
+
+}  // namespace doca
@@ -0,0 +1,139 @@
+#include "traversal.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(TRAVERSAL);
+
+TraversalEngine::TraversalEngine(DOCADma<Dpu> &dma, MemMap &remote, const traversal_attr &attr)
+    : dma(dma), remote(remote), attr(attr) {
+    doca_error_t result;
+
+    if (attr.node_size == 0 || attr.node_size > dma.MaxBufSize() || attr.concurrency == 0 || attr.max_hops == 0) {
+        DOCA_LOG_ERR("Invalid traversal settings: %u traversals fetching %zu byte nodes", attr.concurrency,
+                     attr.node_size);
+        throw std::runtime_error("Invalid traversal settings");
+    }
+
+    result = dma.AddMMap(nodes);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to add device to the node buffers");
+    result = nodes.AllocAndPopulate(DOCA_ACCESS_LOCAL_READ_WRITE, attr.node_size * attr.concurrency);
+    if (result != DOCA_SUCCESS) throw std::runtime_error("Unable to populate the node buffers");
+
+    slots.resize(attr.concurrency);
+    for (uint32_t i = attr.concurrency; i > 0; i--) free_slots.push_back(i - 1);
+}
+
+doca_error_t TraversalEngine::Run(traversal *ts, size_t n, traversal_visit_fn visit, void *ctx) {
+    uint64_t start = NowNs(), addr;
+    doca_error_t result;
+    traversal_step step;
+    size_t next = 0;
+    traversal *t;
+    uint32_t slot;
+    void *user_data;
+
+    while (next < n || active > 0) {
+        /* Fetches refused earlier go first, their walks have waited longest */
+        while (!blocked.empty()) {
+            slot = blocked.front();
+            result = dma.Submit(remote, slots[slot].offset, nodes, slot * attr.node_size, slots[slot].len,
+                                (void *)(uintptr_t)(slot + 1));
+            if (result == DOCA_ERROR_AGAIN) break;
+            blocked.pop_front();
+            if (result != DOCA_SUCCESS) Finish(slot, result);
+        }
+
+        while (next < n && !free_slots.empty() && blocked.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            t = &ts[next++];
+            t->hops = 0;
+            t->status = DOCA_ERROR_AGAIN;
+            slots[slot].t = t;
+            active++;
+            Fetch(slot, t->start);
+        }
+
+        for (;;) {
+            user_data = nullptr;
+            result = dma.Poll(&user_data);
+            if (result == DOCA_ERROR_AGAIN) break;
+            if (user_data == nullptr) {
+                /* Not the outcome of a job, the work queue itself failed */
+                DOCA_LOG_ERR("Traversal engine stopped: %s", doca_get_error_string(result));
+                Abort(result);
+                for (; next < n; next++) ts[next].status = result;
+                return result;
+            }
+
+            slot = (uint32_t)(uintptr_t)user_data - 1;
+            t = slots[slot].t;
+            if (result != DOCA_SUCCESS) {
+                Finish(slot, result);
+                continue;
+            }
+
+            t->hops++;
+            counters.hops++;
+            step = visit(ctx, t, nodes.Data() + slot * attr.node_size, slots[slot].len, &addr);
+            if (step == TRAVERSAL_DONE)
+                Finish(slot, DOCA_SUCCESS);
+            else if (t->hops >= attr.max_hops)
+                Finish(slot, DOCA_ERROR_BAD_STATE);
+            else
+                Fetch(slot, addr);
+        }
+    }
+
+    counters.busy_ns += NowNs() - start;
+    return DOCA_SUCCESS;
+}
+
+void TraversalEngine::Fetch(uint32_t slot, uint64_t addr) {
+    uint64_t base = (uint64_t)(uintptr_t)remote.Data();
+    traversal_slot &s = slots[slot];
+    doca_error_t result;
+
+    if (addr < base || addr - base >= remote.Len()) {
+        DOCA_LOG_DBG("Traversal left the remote region at %#" PRIx64 " after %u hops", addr, s.t->hops);
+        Finish(slot, DOCA_ERROR_INVALID_VALUE);
+        return;
+    }
+    s.offset = addr - base;
+    s.len = std::min(attr.node_size, remote.Len() - s.offset);
+
+    result = dma.Submit(remote, s.offset, nodes, slot * attr.node_size, s.len, (void *)(uintptr_t)(slot + 1));
+    if (result == DOCA_ERROR_AGAIN) {
+        counters.again++;
+        blocked.push_back(slot);
+        return;
+    }
+    if (result != DOCA_SUCCESS) Finish(slot, result);
+}
+
+void TraversalEngine::Abort(doca_error_t status) {
+    dma.Drain();
+    blocked.clear();
+    for (uint32_t slot = 0; slot < slots.size(); slot++)
+        if (slots[slot].t != nullptr) Finish(slot, status);
+}
+
+void TraversalEngine::Finish(uint32_t slot, doca_error_t status) {
+    slots[slot].t->status = status;
+    slots[slot].t = nullptr;
+    free_slots.push_back(slot);
+    active--;
+    counters.traversals++;
+    if (status != DOCA_SUCCESS) counters.failed++;
+}
+
+}  // namespace doca
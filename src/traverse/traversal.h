@@ -0,0 +1,105 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+
+namespace doca {
+
+/* What a traversal does once its current node arrived */
+enum traversal_step {
+    TRAVERSAL_NEXT, /* Fetch the node at *next and visit it */
+    TRAVERSAL_DONE, /* Finished, result holds the outcome */
+};
+
+/* One walk over a linked structure in host memory */
+struct traversal {
+    uint64_t start;  /* Host address of the first node */
+    uint64_t key;    /* What the walk looks for, up to the visitor */
+    uint64_t result; /* Set by the visitor */
+    uint32_t hops = 0;
+    doca_error_t status = DOCA_ERROR_AGAIN; /* DOCA_SUCCESS once done, AGAIN while it runs */
+};
+
+/*
+ * Visitor called with every fetched node: node holds the fetched bytes, at
+ * most node_size of them, fewer at the end of the region. Returns
+ * TRAVERSAL_NEXT with *next set to the host address of the next node, or
+ * TRAVERSAL_DONE once t->result is set.
+ */
+typedef traversal_step (*traversal_visit_fn)(void *ctx, traversal *t, const char *node, size_t len, uint64_t *next);
+
+/* Construction time settings of a TraversalEngine */
+struct traversal_attr {
+    size_t node_size = 64;                  /* Bytes fetched per hop */
+    uint32_t concurrency = 2 * WORKQ_DEPTH; /* Traversals in progress at once, each with one fetch in flight */
+    uint32_t max_hops = 1024;               /* A walk failing to finish in this many hops has a cycle */
+};
+
+/* Counters of a TraversalEngine */
+struct traversal_stats {
+    uint64_t traversals = 0;
+    uint64_t failed = 0;
+    uint64_t hops = 0;
+    uint64_t again = 0;   /* Fetches held back by a full work queue */
+    uint64_t busy_ns = 0; /* Time spent in Run */
+
+    double HopsPerSec() const { return busy_ns ? hops * 1e9 / busy_ns : 0.0; }
+};
+
+/*
+ * Pointer chasing over host memory from the DPU. Every traversal is a small
+ * state machine: one node fetch in flight, then a visit that picks the next
+ * node. Up to concurrency traversals run at once and the engine resubmits as
+ * soon as a node was visited, so the work queue stays full and the DMA latency
+ * of a hop overlaps with the others' instead of adding up.
+ *
+ * Single threaded: the engine owns dma, which must not be used by anyone else
+ * during Run.
+ */
+class TraversalEngine {
+   public:
+    TraversalEngine(DOCADma<Dpu> &dma, MemMap &remote, const traversal_attr &attr = traversal_attr());
+    TraversalEngine(const TraversalEngine &) = delete;
+    TraversalEngine &operator=(const TraversalEngine &) = delete;
+
+    /*
+     * Run n traversals to completion. A walk fails with DOCA_ERROR_INVALID_VALUE on a node outside the
+     * remote region, DOCA_ERROR_BAD_STATE past max_hops, or the error of its fetch; the others carry on.
+     * If the work queue itself fails, Run returns that error and so does every walk not done yet.
+     */
+    doca_error_t Run(traversal *ts, size_t n, traversal_visit_fn visit, void *ctx);
+
+    void Snapshot(traversal_stats *stats) const { *stats = counters; }
+    void ResetStats() { counters = traversal_stats(); }
+
+   protected:
+    /* A traversal in progress, with its fetch buffer */
+    struct traversal_slot {
+        traversal *t = nullptr;
+        size_t offset = 0; /* Remote offset of the node being fetched */
+        size_t len = 0;
+    };
+
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    traversal_attr attr;
+    MemMap nodes; /* concurrency fetch buffers of node_size */
+
+    std::vector<traversal_slot> slots;
+    std::vector<uint32_t> free_slots;
+    std::deque<uint32_t> blocked; /* Slots whose fetch the work queue refused */
+    size_t active = 0;            /* Traversals started and not finished */
+
+    traversal_stats counters;
+
+    /* Fetch the node at a host address into the slot, or end the traversal if that is not possible */
+    void Fetch(uint32_t slot, uint64_t addr);
+    void Finish(uint32_t slot, doca_error_t status);
+    /* Drain the fetches in flight and end every running traversal with status, ready for the next Run */
+    void Abort(doca_error_t status);
+};
+
+}  // namespace doca
@@ -0,0 +1,113 @@
+#include "crc32c.h"
+
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+#define CRC32C_POLY 0x82f63b78 /* Reflected Castagnoli polynomial */
+
+namespace doca {
+
+namespace {
+
+struct crc32c_table {
+    uint32_t t[8][256];
+
+    crc32c_table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; k++) crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+            t[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++)
+            for (int s = 1; s < 8; s++) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xff];
+    }
+};
+
+/* Slicing-by-8: eight table lookups per 64-bit word instead of eight bit-serial rounds */
+uint32_t crc32c_sw(const uint8_t *p, size_t len, uint32_t crc) {
+    static const crc32c_table table;
+    const auto &t = table.t;
+    uint64_t word;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&word, p, sizeof(word));
+        word ^= crc;
+        crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^ t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+              t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^ t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+    }
+    for (; len > 0; p++, len--) crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t crc32c_hw(const uint8_t *p, size_t len, uint32_t crc) {
+    uint64_t word, crc64 = crc;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+    for (; len > 0; p++, len--) crc = _mm_crc32_u8(crc, *p);
+    return crc;
+}
+
+bool have_hw() {
+    static const bool hw = __builtin_cpu_supports("sse4.2");
+    return hw;
+}
+
+const char *hw_name() { return "sse4.2"; }
+#elif defined(__aarch64__)
+/* The CRC extension is optional in ARMv8.0, stock aarch64 builds leave it off and ask the kernel at run time */
+__attribute__((target("+crc"))) uint32_t crc32c_hw(const uint8_t *p, size_t len, uint32_t crc) {
+    uint64_t word;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; len > 0; p++, len--) crc = __crc32cb(crc, *p);
+    return crc;
+}
+
+bool have_hw() {
+#if defined(__ARM_FEATURE_CRC32)
+    return true;
+#else
+    static const bool hw = getauxval(AT_HWCAP) & HWCAP_CRC32;
+    return hw;
+#endif
+}
+
+const char *hw_name() { return "armv8-crc"; }
+#else
+uint32_t crc32c_hw(const uint8_t *p, size_t len, uint32_t crc) { return crc32c_sw(p, len, crc); }
+
+bool have_hw() { return false; }
+
+const char *hw_name() { return "table"; }
+#endif
+
+}  // namespace
+
+uint32_t Crc32c(const void *data, size_t len, uint32_t crc) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    crc = have_hw() ? crc32c_hw(p, len, crc) : crc32c_sw(p, len, crc);
+    return ~crc;
+}
+
+const char *Crc32cImplName() { return have_hw() ? hw_name() : "table"; }
+
+}  // namespace doca
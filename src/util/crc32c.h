@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace doca {
+
+/*
+ * CRC32C (Castagnoli) of len bytes. Pass the CRC of the preceding bytes as crc
+ * to checksum data in pieces. Uses the CPU's CRC32C instructions when it has
+ * them (SSE4.2, ARMv8 CRC), a slicing-by-8 table otherwise.
+ */
+uint32_t Crc32c(const void *data, size_t len, uint32_t crc = 0);
+
+/* Name of the implementation Crc32c runs on this CPU */
+const char *Crc32cImplName();
+
+}  // namespace doca
@@ -0,0 +1,425 @@
+#include "replicated_log.h"
+
+#include <doca_error.h>
+#include <doca_log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <stdexcept>
+
+#include "../stats/clock.h"
+#include "../util/crc32c.h"
+
+namespace doca {
+
+DOCA_LOG_REGISTER(REPLICATED_LOG);
+
+/* Bytes a record of len payload bytes takes in the ring */
+static size_t record_size(size_t len) {
+    return sizeof(log_record_hdr) + (len + LOG_RECORD_ALIGN - 1) / LOG_RECORD_ALIGN * LOG_RECORD_ALIGN;
+}
+
+/* Ring size of a log region: what follows the control block, in whole record alignment units */
+static size_t ring_size_of(const MemMap &region) {
+    if (region.Len() <= LOG_CTRL_SIZE) return 0;
+    return (region.Len() - LOG_CTRL_SIZE) / LOG_RECORD_ALIGN * LOG_RECORD_ALIGN;
+}
+
+LogWriter::LogWriter(MemMap &region, CommEndpoint &ch, const log_writer_attr &attr)
+    : region(region), ch(ch), attr(attr) {
+    ring_size = ring_size_of(region);
+    if (ring_size < record_size(0)) {
+        DOCA_LOG_ERR("Log region of %zu bytes leaves no room for records", region.Len());
+        throw std::runtime_error("Log region too small");
+    }
+    ctrl = (log_ctrl *)region.Data();
+    ring = region.Data() + LOG_CTRL_SIZE;
+    __atomic_store_n(&ctrl->committed, 0, __ATOMIC_RELEASE);
+    msg.resize(ch.MaxPayload());
+}
+
+void LogWriter::CopyIn(uint64_t offset, const void *data, size_t len) {
+    size_t pos = offset % ring_size, first = std::min(len, ring_size - pos);
+
+    memcpy(ring + pos, data, first);
+    memcpy(ring, (const char *)data + first, len - first);
+}
+
+doca_error_t LogWriter::Append(const void *data, size_t len, uint64_t *lsn) {
+    log_record_hdr hdr = {(uint32_t)len, Crc32c(data, len)};
+    size_t need = record_size(len);
+    doca_error_t result;
+
+    if (len > UINT32_MAX || need > ring_size) {
+        DOCA_LOG_ERR("Record of %zu bytes does not fit the ring of %zu bytes", len, ring_size);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+
+    if (tail + need - durable > ring_size) {
+        /* The space comes free as the DPU acks, make sure what is waiting for it is committed */
+        counters.full_waits++;
+        Commit();
+        while (tail + need - durable > ring_size) {
+            result = ReapAcks(true);
+            if (result != DOCA_SUCCESS) return result;
+        }
+    }
+
+    CopyIn(tail, &hdr, sizeof(hdr));
+    CopyIn(tail + sizeof(hdr), data, len);
+    if (group_start_ns == 0) group_start_ns = NowNs();
+    tail += need;
+    counters.records++;
+    counters.bytes += len;
+    *lsn = tail;
+
+    if (tail - committed >= attr.group_bytes) Commit();
+    return DOCA_SUCCESS;
+}
+
+void LogWriter::Commit() {
+    if (tail == committed) return;
+
+    /* Records first, then the offset that makes them visible */
+    __atomic_store_n(&ctrl->committed, tail, __ATOMIC_RELEASE);
+    pending.push_back({tail, group_start_ns});
+    committed = tail;
+    group_start_ns = 0;
+    counters.commits++;
+}
+
+doca_error_t LogWriter::Poll() {
+    doca_error_t result;
+
+    result = ReapAcks(false);
+    if (result != DOCA_SUCCESS) return result;
+    if (group_start_ns != 0 && NowNs() - group_start_ns >= attr.group_ns) Commit();
+    return DOCA_SUCCESS;
+}
+
+doca_error_t LogWriter::ReapAcks(bool block) {
+    doca_error_t result;
+    log_msg ack;
+    uint64_t now;
+    size_t len;
+
+    for (;;) {
+        len = msg.size();
+        result = block ? ch.RecvFrom(msg.data(), &len) : ch.TryRecvFrom(msg.data(), &len);
+        if (result == DOCA_ERROR_AGAIN) return DOCA_SUCCESS;
+        if (result != DOCA_SUCCESS) {
+            DOCA_LOG_ERR("Failed to receive durable offsets: %s", doca_get_error_string(result));
+            return result;
+        }
+        if (len != sizeof(ack)) {
+            DOCA_LOG_ERR("Log replica failed");
+            return DOCA_ERROR_IO_FAILED;
+        }
+        memcpy(&ack, msg.data(), sizeof(ack));
+        if (ack.type != LOG_MSG_DURABLE || ack.offset < durable || ack.offset > committed) {
+            DOCA_LOG_ERR("Durable offset %" PRIu64 " outside the committed log [%" PRIu64 ", %" PRIu64 "]",
+                         ack.offset, durable, committed);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+
+        durable = ack.offset;
+        counters.acks++;
+        now = NowNs();
+        while (!pending.empty() && pending.front().offset <= durable) {
+            counters.commit_latency.Record(now - pending.front().start_ns);
+            pending.pop_front();
+        }
+        /* Take whatever else already arrived without waiting */
+        block = false;
+    }
+}
+
+doca_error_t LogWriter::WaitDurable(uint64_t lsn) {
+    doca_error_t result;
+
+    if (lsn > tail) {
+        DOCA_LOG_ERR("Log offset %" PRIu64 " lies beyond the tail %" PRIu64, lsn, tail);
+        return DOCA_ERROR_INVALID_VALUE;
+    }
+    if (lsn > committed) Commit();
+    while (durable < lsn) {
+        result = ReapAcks(true);
+        if (result != DOCA_SUCCESS) return result;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t LogWriter::Close() {
+    log_msg close_msg = {LOG_MSG_CLOSE, 0, tail};
+    doca_error_t result;
+
+    result = WaitDurable(tail);
+    if (result != DOCA_SUCCESS) return result;
+    return ch.SendTo(&close_msg, sizeof(close_msg));
+}
+
+LogReplica::LogReplica(DOCADma<Dpu> &dma, MemMap &remote, MemMap &replica, const log_replica_attr &attr)
+    : dma(dma), remote(remote), replica(replica), attr(attr) {
+    ring_size = ring_size_of(remote);
+    if (ring_size < record_size(0) || replica.Len() < remote.Len()) {
+        DOCA_LOG_ERR("Cannot replicate a log region of %zu bytes into %zu bytes", remote.Len(), replica.Len());
+        throw std::runtime_error("Invalid log replica");
+    }
+    if (this->attr.max_job == 0 || this->attr.max_job > dma.MaxBufSize()) this->attr.max_job = dma.MaxBufSize();
+
+    if (attr.path.empty()) return;
+    fd = open(attr.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        DOCA_LOG_ERR("Failed to open log file %s: %s", attr.path.c_str(), strerror(errno));
+        throw std::runtime_error("Unable to open the log file");
+    }
+}
+
+LogReplica::~LogReplica() {
+    if (fd >= 0) close(fd);
+}
+
+doca_error_t LogReplica::Serve(CommEndpoint &ch) {
+    std::vector<char> msg(ch.MaxPayload());
+    uint64_t committed, pulled = durable, end = 0, start;
+    doca_error_t result = DOCA_SUCCESS;
+    bool closing = false;
+    log_msg m;
+    size_t len;
+
+    struct timespec ts = {
+        .tv_sec = (time_t)(attr.poll_ns / 1000000000),
+        .tv_nsec = (long)(attr.poll_ns % 1000000000),
+    };
+
+    for (;;) {
+        if (!closing) {
+            len = msg.size();
+            result = ch.TryRecvFrom(msg.data(), &len);
+            if (result == DOCA_SUCCESS) {
+                memcpy(&m, msg.data(), std::min(len, sizeof(m)));
+                if (len != sizeof(m) || m.type != LOG_MSG_CLOSE) {
+                    DOCA_LOG_ERR("Unexpected log message of %zu bytes", len);
+                    result = DOCA_ERROR_INVALID_VALUE;
+                    break;
+                }
+                closing = true;
+                end = m.offset;
+            } else if (result != DOCA_ERROR_AGAIN) {
+                DOCA_LOG_ERR("Failed to receive from the log writer: %s", doca_get_error_string(result));
+                break;
+            }
+        }
+
+        /* The work queue is idle here, every pull has been reaped */
+        result = ReadCommitted(&committed);
+        if (result != DOCA_SUCCESS) break;
+        if (committed < pulled || committed - durable > ring_size) {
+            DOCA_LOG_ERR("Committed offset %" PRIu64 " inconsistent with the durable offset %" PRIu64, committed,
+                         durable);
+            result = DOCA_ERROR_INVALID_VALUE;
+            break;
+        }
+
+        if (committed == durable) {
+            if (closing && durable >= end) break;
+            if (attr.poll_ns) nanosleep(&ts, NULL);
+            continue;
+        }
+
+        /*
+         * Reads of the newly committed range land while the previous one, already in place, is checked, synced
+         * and acked. The two never overlap in the replica: the host commits at most a ring ahead of durable.
+         */
+        if (committed > pulled) {
+            start = NowNs();
+            result = StartPull(pulled, committed);
+            counters.pull_ns += NowNs() - start;
+            if (result != DOCA_SUCCESS) break;
+        }
+        if (pulled > durable) {
+            result = Persist(ch, pulled);
+            if (result != DOCA_SUCCESS) break;
+        }
+        if (committed > pulled) {
+            start = NowNs();
+            result = FinishPull(pulled, committed);
+            counters.pull_ns += NowNs() - start;
+            if (result != DOCA_SUCCESS) break;
+            pulled = committed;
+        }
+    }
+
+    if (result != DOCA_SUCCESS) {
+        Reap();
+        DOCA_LOG_ERR("Log replication stopped at offset %" PRIu64 ": %s", durable, doca_get_error_string(result));
+        ch.SendFailMsg();
+    }
+    return result;
+}
+
+doca_error_t LogReplica::ReadCommitted(uint64_t *committed) {
+    doca_error_t result;
+
+    job_error = DOCA_SUCCESS;
+    result = SubmitRead(0, sizeof(uint64_t));
+    if (result != DOCA_SUCCESS) return result;
+    Reap();
+    if (job_error != DOCA_SUCCESS) return job_error;
+
+    counters.ctrl_reads++;
+    *committed = __atomic_load_n(&((log_ctrl *)replica.Data())->committed, __ATOMIC_ACQUIRE);
+    return DOCA_SUCCESS;
+}
+
+size_t LogReplica::Pieces(uint64_t from, uint64_t to, size_t off[2], size_t len[2]) const {
+    size_t n = to - from, pos = from % ring_size;
+
+    off[0] = LOG_CTRL_SIZE + pos;
+    len[0] = std::min(n, ring_size - pos);
+    if (len[0] == n) return 1;
+    off[1] = LOG_CTRL_SIZE;
+    len[1] = n - len[0];
+    return 2;
+}
+
+doca_error_t LogReplica::StartPull(uint64_t from, uint64_t to) {
+    size_t off[2], len[2], n, chunk;
+    doca_error_t result = DOCA_SUCCESS;
+
+    job_error = DOCA_SUCCESS;
+    n = Pieces(from, to, off, len);
+    for (size_t i = 0; i < n && result == DOCA_SUCCESS; i++) {
+        for (size_t done = 0; done < len[i] && result == DOCA_SUCCESS; done += chunk) {
+            chunk = std::min(len[i] - done, attr.max_job);
+            result = SubmitRead(off[i] + done, chunk);
+            if (result == DOCA_SUCCESS) counters.dma_jobs++;
+        }
+    }
+    return result;
+}
+
+doca_error_t LogReplica::FinishPull(uint64_t from, uint64_t to) {
+    Reap();
+    if (job_error != DOCA_SUCCESS) return job_error;
+    counters.bytes += to - from;
+    return DOCA_SUCCESS;
+}
+
+doca_error_t LogReplica::Persist(CommEndpoint &ch, uint64_t to) {
+    doca_error_t result;
+    uint64_t start;
+    log_msg m;
+
+    if (attr.verify) {
+        start = NowNs();
+        result = Verify(durable, to);
+        counters.verify_ns += NowNs() - start;
+        if (result != DOCA_SUCCESS) return result;
+    }
+    if (fd >= 0) {
+        start = NowNs();
+        result = WriteFile(durable, to);
+        counters.sync_ns += NowNs() - start;
+        if (result != DOCA_SUCCESS) return result;
+    }
+
+    durable = to;
+    counters.groups++;
+    m = {LOG_MSG_DURABLE, 0, durable};
+    return ch.SendTo(&m, sizeof(m));
+}
+
+doca_error_t LogReplica::SubmitRead(size_t offset, size_t len) {
+    doca_error_t result;
+    size_t inflight;
+    void *user_data;
+
+    while ((result = dma.Submit(remote, offset, replica, offset, len, nullptr)) == DOCA_ERROR_AGAIN) {
+        /* Work queue full, make room */
+        inflight = dma.Inflight();
+        result = dma.Poll(&user_data);
+        if (result == DOCA_SUCCESS || result == DOCA_ERROR_AGAIN) continue;
+        if (job_error == DOCA_SUCCESS) job_error = result;
+        /* The retrieve itself failed and no job came back, room would never be made */
+        if (dma.Inflight() == inflight) break;
+    }
+    if (result != DOCA_SUCCESS) {
+        DOCA_LOG_ERR("Failed to submit read of %zu bytes at offset %zu: %s", len, offset,
+                     doca_get_error_string(result));
+        return result;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t LogReplica::Verify(uint64_t from, uint64_t to) {
+    size_t off[2], len[2], n;
+    log_record_hdr hdr;
+    uint32_t crc;
+
+    for (uint64_t pos = from; pos < to; pos += record_size(hdr.len)) {
+        /* Headers are aligned and never wrap */
+        memcpy(&hdr, replica.Data() + LOG_CTRL_SIZE + pos % ring_size, sizeof(hdr));
+        if (record_size(hdr.len) > to - pos) {
+            DOCA_LOG_ERR("Record of %u bytes at offset %" PRIu64 " crosses the committed offset %" PRIu64, hdr.len,
+                         pos, to);
+            return DOCA_ERROR_INVALID_VALUE;
+        }
+
+        crc = 0;
+        n = hdr.len ? Pieces(pos + sizeof(hdr), pos + sizeof(hdr) + hdr.len, off, len) : 0;
+        for (size_t i = 0; i < n; i++) crc = Crc32c(replica.Data() + off[i], len[i], crc);
+        if (crc != hdr.crc) {
+            DOCA_LOG_ERR("Record at offset %" PRIu64 " fails its checksum: %08x instead of %08x", pos, crc, hdr.crc);
+            return DOCA_ERROR_IO_FAILED;
+        }
+        counters.records++;
+    }
+    return DOCA_SUCCESS;
+}
+
+doca_error_t LogReplica::WriteFile(uint64_t from, uint64_t to) {
+    size_t off[2], len[2], n;
+    ssize_t written;
+
+    n = Pieces(from, to, off, len);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t done = 0; done < len[i]; done += written) {
+            written = write(fd, replica.Data() + off[i] + done, len[i] - done);
+            if (written < 0 && errno == EINTR) {
+                written = 0;
+                continue;
+            }
+            if (written < 0) {
+                DOCA_LOG_ERR("Failed to write the log file: %s", strerror(errno));
+                return DOCA_ERROR_IO_FAILED;
+            }
+        }
+    }
+    if (fdatasync(fd) < 0) {
+        DOCA_LOG_ERR("Failed to sync the log file: %s", strerror(errno));
+        return DOCA_ERROR_IO_FAILED;
+    }
+    return DOCA_SUCCESS;
+}
+
+void LogReplica::Reap() {
+    doca_error_t result;
+    size_t inflight;
+    void *user_data;
+
+    while ((inflight = dma.Inflight()) > 0) {
+        result = dma.Poll(&user_data);
+        if (result == DOCA_SUCCESS || result == DOCA_ERROR_AGAIN) continue;
+        if (job_error == DOCA_SUCCESS) job_error = result;
+        /* The retrieve itself failed and no job came back, waiting for the rest would never end */
+        if (dma.Inflight() == inflight) return;
+    }
+}
+
+}  // namespace doca
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../chan/comm_channel.h"
+#include "../dma/dma.h"
+#include "../mem/mem.h"
+#include "../stats/histogram.h"
+
+#define LOG_CTRL_SIZE 64    /* Control block at the start of the log region, the ring follows */
+#define LOG_RECORD_ALIGN 8  /* Records start at multiples of this, the ring size must be one too */
+
+namespace doca {
+
+/*
+ * Start of the log region. The host writer stores committed with release
+ * semantics once the records before it are in place; the DPU reads it by DMA.
+ */
+struct log_ctrl {
+    uint64_t committed; /* Log offset up to which records may be replicated */
+};
+
+/* Precedes every record in the ring, the payload follows padded to LOG_RECORD_ALIGN */
+struct log_record_hdr {
+    uint32_t len;
+    uint32_t crc; /* CRC32C of the payload */
+};
+
+enum log_msg_type : uint32_t {
+    LOG_MSG_DURABLE, /* DPU to host: everything before offset is replicated */
+    LOG_MSG_CLOSE,   /* Host to DPU: offset is the end of the log, no further commits */
+};
+
+struct log_msg {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+/* Construction time settings of a LogWriter */
+struct log_writer_attr {
+    size_t group_bytes = 64 << 10; /* Commit once this many bytes are uncommitted, every record if 0 */
+    uint64_t group_ns = 100000;    /* Commit once the oldest uncommitted record is this old, checked by Poll */
+};
+
+/* Counters of a LogWriter */
+struct log_writer_stats {
+    uint64_t records = 0;
+    uint64_t bytes = 0;      /* Payload bytes appended */
+    uint64_t commits = 0;    /* Committed offsets published, each a group of records */
+    uint64_t acks = 0;       /* Durable offsets received */
+    uint64_t full_waits = 0; /* Appends that waited for the DPU to free ring space */
+    LatencyHistogram commit_latency; /* First record of a group appended to the group durable */
+};
+
+/*
+ * Host side of log replication: appends records to a ring in an exported
+ * region and publishes how far the log is committed. Offsets are logical and
+ * only grow, the ring position is the offset modulo the ring size. Records
+ * are grouped: a commit covers everything appended since the previous one and
+ * is due by size on Append, or by age on Poll. Ring space is reused once the
+ * DPU acked it durable.
+ *
+ * Single threaded. Create the writer before the region is exported: it
+ * resets the committed offset the DPU starts reading right away.
+ */
+class LogWriter {
+   public:
+    LogWriter(MemMap &region, CommEndpoint &ch, const log_writer_attr &attr = log_writer_attr());
+    LogWriter(const LogWriter &) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+
+    /* Append a record, waiting for ring space if needed; *lsn is the log offset just past it */
+    doca_error_t Append(const void *data, size_t len, uint64_t *lsn);
+    /* Publish everything appended so far */
+    void Commit();
+    /* Take in acks without blocking and commit a group that is due by age */
+    doca_error_t Poll();
+    /* Commit if needed and wait until the log is durable up to lsn */
+    doca_error_t WaitDurable(uint64_t lsn);
+    /* Make the whole log durable and tell the DPU it ends here */
+    doca_error_t Close();
+
+    uint64_t Tail() const { return tail; }
+    uint64_t Durable() const { return durable; }
+
+    void Snapshot(log_writer_stats *stats) const { *stats = counters; }
+
+   protected:
+    MemMap &region;
+    CommEndpoint &ch;
+    log_writer_attr attr;
+    log_ctrl *ctrl;
+    char *ring;
+    size_t ring_size;
+
+    uint64_t tail = 0;
+    uint64_t committed = 0;
+    uint64_t durable = 0;
+    uint64_t group_start_ns = 0; /* First uncommitted append, 0 if there is none */
+
+    /* Published commits not yet durable, with the time their group started */
+    struct pending_commit {
+        uint64_t offset;
+        uint64_t start_ns;
+    };
+    std::deque<pending_commit> pending;
+    std::vector<char> msg;
+
+    log_writer_stats counters;
+
+    void CopyIn(uint64_t offset, const void *data, size_t len);
+    /* Take in durable offsets, block for at least one if block is set */
+    doca_error_t ReapAcks(bool block);
+};
+
+/* Construction time settings of a LogReplica */
+struct log_replica_attr {
+    size_t max_job = 0;     /* Largest single read, the device limit if 0 */
+    uint64_t poll_ns = 0;   /* Sleep between reads of the committed offset while there is nothing new */
+    bool verify = true;     /* Check every record's CRC32C before acking it */
+    std::string path;       /* DPU-local file the log is appended to and synced before each ack, none if empty */
+};
+
+/* Counters of a LogReplica */
+struct log_replica_stats {
+    uint64_t groups = 0;     /* Committed ranges pulled and acked */
+    uint64_t records = 0;    /* Records verified, 0 without verify */
+    uint64_t bytes = 0;      /* Log bytes pulled, headers and padding included */
+    uint64_t dma_jobs = 0;
+    uint64_t ctrl_reads = 0; /* Reads of the committed offset */
+    uint64_t pull_ns = 0;    /* Submitting reads and waiting for them, not the time they overlap a Persist */
+    uint64_t verify_ns = 0;
+    uint64_t sync_ns = 0;    /* File writes and fdatasync */
+};
+
+/*
+ * DPU side of log replication: polls the host's committed offset and pulls
+ * each newly committed range into a local replica of the region, as DMA reads
+ * of up to max_job bytes pipelined through the work queue. Once a range is in
+ * place, checked and, with a file, synced, its end is acked to the host as
+ * the durable offset. The check, sync and ack of one range run while the
+ * reads of the range committed after it are in flight.
+ */
+class LogReplica {
+   public:
+    LogReplica(DOCADma<Dpu> &dma, MemMap &remote, MemMap &replica, const log_replica_attr &attr = log_replica_attr());
+    ~LogReplica();
+    LogReplica(const LogReplica &) = delete;
+    LogReplica &operator=(const LogReplica &) = delete;
+
+    /* Replicate until the host closes the log */
+    doca_error_t Serve(CommEndpoint &ch);
+
+    uint64_t Durable() const { return durable; }
+    void Snapshot(log_replica_stats *stats) const { *stats = counters; }
+
+   protected:
+    DOCADma<Dpu> &dma;
+    MemMap &remote;
+    MemMap &replica;
+    log_replica_attr attr;
+    size_t ring_size;
+    int fd = -1;
+
+    uint64_t durable = 0;
+    doca_error_t job_error = DOCA_SUCCESS;
+
+    log_replica_stats counters;
+
+    doca_error_t ReadCommitted(uint64_t *committed);
+    /* Submit the reads of a log range, they complete in FinishPull */
+    doca_error_t StartPull(uint64_t from, uint64_t to);
+    doca_error_t FinishPull(uint64_t from, uint64_t to);
+    /* Check and sync the range from durable to to, which is in the replica, and ack it */
+    doca_error_t Persist(CommEndpoint &ch, uint64_t to);
+    doca_error_t SubmitRead(size_t offset, size_t len);
+    doca_error_t Verify(uint64_t from, uint64_t to);
+    doca_error_t WriteFile(uint64_t from, uint64_t to);
+    /* Wait for every job in flight, the first failure lands in job_error */
+    void Reap();
+    /* Replica bytes of a log range, as up to two contiguous pieces split at the ring's end */
+    size_t Pieces(uint64_t from, uint64_t to, size_t off[2], size_t len[2]) const;
+};
+
+}  // namespace doca